@@ -3,6 +3,7 @@ function(mmseqs_setup_test NAME)
     string(TOLOWER ${NAME} BASE_NAME)
     string(REGEX REPLACE "\\.[^.]*$" "" BASE_NAME ${BASE_NAME})
     string(REGEX REPLACE "^test" "test_" BASE_NAME ${BASE_NAME})
+    string(REGEX REPLACE "^benchmark" "benchmark_" BASE_NAME ${BASE_NAME})
     add_executable(${BASE_NAME} ${NAME})
 
     mmseqs_setup_derived_target(${BASE_NAME})
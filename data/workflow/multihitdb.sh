@@ -51,6 +51,9 @@ fi
 if [ "$("${MMSEQS}" dbtype "${OUTDB}")" = "Nucleotide" ]; then
     mv -f "${OUTDB}" "${OUTDB}_nucl"
     mv -f "${OUTDB}.index" "${OUTDB}_nucl.index"
+    if [ -f "${OUTDB}.index.bin" ]; then
+        mv -f "${OUTDB}.index.bin" "${OUTDB}_nucl.index.bin"
+    fi
 #    mv -f "${OUTDB}.lookup" "${OUTDB}_nucl.lookup"
 #    mv -f "${OUTDB}.source" "${OUTDB}_nucl.source"
     mv -f "${OUTDB}.dbtype" "${OUTDB}_nucl.dbtype"
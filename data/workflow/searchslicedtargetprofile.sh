@@ -47,7 +47,11 @@ if notExists "${PROFILEDB}.dbtype"; then
     # symlink the profile DB that can be reduced at every iteration the search
     ln -s "${TARGET}" "${PROFILEDB}"
     ln -s "${TARGET}.dbtype" "${PROFILEDB}.dbtype"
-    cp -f "${TARGET}.index" "${PROFILEDB}.index"
+    # keep the mtime, the binary index of the target is only used for an identical index
+    cp -fp "${TARGET}.index" "${PROFILEDB}.index"
+    if [ -f "${TARGET}.index.bin" ]; then
+        cp -fp "${TARGET}.index.bin" "${PROFILEDB}.index.bin"
+    fi
 
     echo "${AVAIL_DISK}" > "${PROFILEDB}.meta"
 else
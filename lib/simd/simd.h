@@ -111,6 +111,7 @@ typedef __m512  simd_float;
 typedef __m512i simd_int;
 #define simdi32_add(x,y)    _mm512_add_epi32(x,y)
 #define simdi16_add(x,y)    _mm512_add_epi16(x,y)
+#define simdi8_add(x,y)     _mm512_add_epi8(x,y)
 #define simdi16_adds(x,y)   _mm512_adds_epi16(x,y)
 #define simdui8_adds(x,y)   _mm512_adds_epu8()
 #define simdi32_sub(x,y)    _mm512_sub_epi32(x,y)
@@ -223,6 +224,7 @@ inline unsigned short extract_epi16(__m256i v, int pos) {
 typedef __m256i simd_int;
 #define simdi32_add(x,y)    _mm256_add_epi32(x,y)
 #define simdi16_add(x,y)    _mm256_add_epi16(x,y)
+#define simdi8_add(x,y)     _mm256_add_epi8(x,y)
 #define simdi16_adds(x,y)   _mm256_adds_epi16(x,y)
 #define simdi16_sub(x,y)    _mm256_sub_epi16(x,y)
 #define simdui8_adds(x,y)   _mm256_adds_epu8(x,y)
@@ -428,6 +430,7 @@ inline unsigned short extract_epi16(__m128i v, int pos) {
 typedef __m128i simd_int;
 #define simdi32_add(x,y)    _mm_add_epi32(x,y)
 #define simdi16_add(x,y)    _mm_add_epi16(x,y)
+#define simdi8_add(x,y)     _mm_add_epi8(x,y)
 #define simdi16_sub(x,y)    _mm_sub_epi16(x,y)
 
 #define simdi16_adds(x,y)   _mm_adds_epi16(x,y)
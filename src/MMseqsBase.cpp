@@ -2,8 +2,9 @@
 #include "Parameters.h"
 #include "CommandDeclarations.h"
 #include "DownloadDatabase.h"
+#include "PrefilteringIndexReader.h"
 
-const char* MMSEQS_CURRENT_INDEX_VERSION = "16";
+const char* MMSEQS_CURRENT_INDEX_VERSION = MMSEQS_INDEX_VERSION;
 
 Parameters& par = Parameters::getInstance();
 std::vector<Command> baseCommands = {
@@ -596,6 +597,15 @@ std::vector<Command> baseCommands = {
                                                            {"targetDB", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA, &DbValidator::sequenceDb },
                                                            {"prefilterDB", DbType::ACCESS_MODE_OUTPUT, DbType::NEED_DATA, &DbValidator::prefilterDb }}},
 
+        {"prefilteralign",       prefilteralign,       &par.prefilteralign,       COMMAND_PREFILTER,
+                "Prefilter and align in one step without writing a prefilter DB",
+                NULL,
+                "Martin Steinegger <martin.steinegger@snu.ac.kr>",
+                "<i:queryDB> <i:targetDB> <o:alignmentDB>",
+                CITATION_MMSEQS2, {{"queryDB", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA, &DbValidator::sequenceDb },
+                                                           {"targetDB", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA, &DbValidator::sequenceDb },
+                                                           {"alignmentDB", DbType::ACCESS_MODE_OUTPUT, DbType::NEED_DATA, &DbValidator::alignmentDb }}},
+
         {"ungappedprefilter",    ungappedprefilter,    &par.ungappedprefilter,    COMMAND_PREFILTER,
                 "Optimal diagonal score search",
                 NULL,
@@ -702,7 +712,7 @@ std::vector<Command> baseCommands = {
 
 
 
-        {"compress",             compress,             &par.onlythreads,          COMMAND_STORAGE,
+        {"compress",             compress,             &par.compress,             COMMAND_STORAGE,
                 "Compress DB entries",
                 NULL,
                 "Milot Mirdita <milot@mirdita.de>",
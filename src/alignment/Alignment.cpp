@@ -12,6 +12,7 @@
 #include "Parameters.h"
 #include "FastSort.h"
 #include "Sequence.h"
+#include "ProfileReport.h"
 
 #ifdef OPENMP
 #include <omp.h>
@@ -22,16 +23,22 @@ Alignment::Alignment(const std::string &querySeqDB, const std::string &targetSeq
                      const std::string &outDB, const std::string &outDBIndex, const Parameters &par, const bool lcaAlign) :
         covThr(par.covThr), canCovThr(par.covThr), covMode(par.covMode), seqIdMode(par.seqIdMode), evalThr(par.evalThr), seqIdThr(par.seqIdThr),
         alnLenThr(par.alnLenThr), includeIdentity(par.includeIdentity), addBacktrace(par.addBacktrace), realign(par.realign), scoreBias(par.scoreBias), realignScoreBias(par.realignScoreBias), realignMaxSeqs(par.realignMaxSeqs),
-        threads(static_cast<unsigned int>(par.threads)), compressed(par.compressed), outDB(outDB), outDBIndex(outDBIndex),
+        threads(static_cast<unsigned int>(par.threads)), compressed(par.compressed), binaryResult(par.binaryResult), asyncWrite(par.asyncWrite), outDB(outDB), outDBIndex(outDBIndex),
         maxSeqLen(par.maxSeqLen), compBiasCorrection(par.compBiasCorrection), compBiasCorrectionScale(par.compBiasCorrectionScale), altAlignment(par.altAlignment), alignmentOutputMode(par.alignmentOutputMode),
         maxAccept(static_cast<unsigned int>(par.maxAccept)), maxReject(static_cast<unsigned int>(par.maxRejected)), wrappedScoring(par.wrappedScoring),
-        lcaAlign(lcaAlign), qdbr(NULL), qDbrIdx(NULL), tdbr(NULL), tDbrIdx(NULL) {
+        lcaAlign(lcaAlign), qdbr(NULL), qDbrIdx(NULL), tdbr(NULL), tDbrIdx(NULL), prefdbr(NULL),
+        reversePrefilterResult(false), binaryPrefilterResult(false) {
     unsigned int alignmentMode = par.alignmentMode;
     if (alignmentMode == Parameters::ALIGNMENT_MODE_UNGAPPED) {
         Debug(Debug::ERROR) << "Use rescorediagonal for ungapped alignment mode.\n";
         EXIT(EXIT_FAILURE);
     }
 
+    if (binaryResult == true && compressed == true) {
+        Debug(Debug::ERROR) << "--binary-result cannot be combined with --compressed.\n";
+        EXIT(EXIT_FAILURE);
+    }
+
     if (lcaAlign == false && addBacktrace == true) {
         alignmentMode = Parameters::ALIGNMENT_MODE_SCORE_COV_SEQID;
     }
@@ -55,7 +62,7 @@ Alignment::Alignment(const std::string &querySeqDB, const std::string &targetSeq
         }
     }
 
-    uint16_t extended = DBReader<unsigned int>::getExtendedDbtype(FileUtil::parseDbType(prefDB.c_str()));
+    uint16_t extended = prefDB.empty() ? 0 : DBReader<unsigned int>::getExtendedDbtype(FileUtil::parseDbType(prefDB.c_str()));
     bool touch = (par.preloadMode != Parameters::PRELOAD_MODE_MMAP);
     tDbrIdx = new IndexReader(targetSeqDB, par.threads,
                               extended & Parameters::DBTYPE_EXTENDED_INDEX_NEED_SRC ? IndexReader::SRC_SEQUENCES : IndexReader::SEQUENCES,
@@ -136,9 +143,18 @@ Alignment::Alignment(const std::string &querySeqDB, const std::string &targetSeq
     Debug(Debug::INFO) << "Query database size: "  << qdbr->getSize() << " type: " << Parameters::getDbTypeName(querySeqType) << "\n";
     Debug(Debug::INFO) << "Target database size: " << tdbr->getSize() << " type: " << Parameters::getDbTypeName(targetSeqType) << "\n";
 
-    prefdbr = new DBReader<unsigned int>(prefDB.c_str(), prefDBIndex.c_str(), threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
-    prefdbr->open(DBReader<unsigned int>::LINEAR_ACCCESS);
-    reversePrefilterResult = Parameters::isEqualDbtype(prefdbr->getDbtype(), Parameters::DBTYPE_PREFILTER_REV_RES);
+    if (prefDB.empty() == false) {
+        prefdbr = new DBReader<unsigned int>(prefDB.c_str(), prefDBIndex.c_str(), threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
+        prefdbr->open(DBReader<unsigned int>::LINEAR_ACCCESS);
+        reversePrefilterResult = Parameters::isEqualDbtype(prefdbr->getDbtype(), Parameters::DBTYPE_PREFILTER_REV_RES);
+        binaryPrefilterResult = prefdbr->isBinaryResult();
+        if (binaryPrefilterResult == true
+            && Parameters::isEqualDbtype(prefdbr->getDbtype(), Parameters::DBTYPE_PREFILTER_RES) == false
+            && reversePrefilterResult == false) {
+            Debug(Debug::ERROR) << "Binary " << prefdbr->getDbTypeName() << " input is not supported. Only binary prefilter results can be aligned.\n";
+            EXIT(EXIT_FAILURE);
+        }
+    }
 
     correlationScoreWeight = par.correlationScoreWeight;
     if (Parameters::isEqualDbtype(querySeqType, Parameters::DBTYPE_NUCLEOTIDES)) {
@@ -162,6 +178,8 @@ Alignment::Alignment(const std::string &querySeqDB, const std::string &targetSeq
             realign_m = new SubstitutionMatrix(par.scoringMatrixFile.values.aminoacid().c_str(), 2.0, scoreBias + realignScoreBias);
         }
     }
+
+    evaluer = new EvalueComputation(tdbr->getAminoAcidDBSize(), this->m, gapOpen, gapExtend);
 }
 
 unsigned int Alignment::initSWMode(unsigned int alignmentMode, float covThr, float seqIdThr) {
@@ -191,6 +209,7 @@ unsigned int Alignment::initSWMode(unsigned int alignmentMode, float covThr, flo
 }
 
 Alignment::~Alignment() {
+    delete evaluer;
     if (realign_m != NULL) {
         delete realign_m;
     }
@@ -212,8 +231,10 @@ Alignment::~Alignment() {
         }
     }
 
-    prefdbr->close();
-    delete prefdbr;
+    if (prefdbr != NULL) {
+        prefdbr->close();
+        delete prefdbr;
+    }
 }
 
 void Alignment::run(const unsigned int mpiRank, const unsigned int mpiNumProc) {
@@ -245,13 +266,24 @@ void Alignment::run() {
     run(outDB, outDBIndex, 0, prefdbr->getSize(), false);
 }
 
-void Alignment::run(const std::string &outDB, const std::string &outDBIndex, const size_t dbFrom, const size_t dbSize, bool merge) {
+int Alignment::getOutputDbtype() const {
     int dbtype = Parameters::DBTYPE_ALIGNMENT_RES;
     if (alignmentOutputMode == Parameters::ALIGNMENT_OUTPUT_CLUSTER) {
         dbtype = Parameters::DBTYPE_CLUSTER_RES;
     }
-    dbtype = DBReader<unsigned int>::setExtendedDbtype(dbtype, DBReader<unsigned int>::getExtendedDbtype(prefdbr->getDbtype()));
-    DBWriter dbw(outDB.c_str(), outDBIndex.c_str(), threads, compressed, dbtype);
+    uint16_t extended = 0;
+    if (prefdbr != NULL) {
+        extended = DBReader<unsigned int>::getExtendedDbtype(prefdbr->getDbtype()) & ~Parameters::DBTYPE_EXTENDED_BINARY_RESULT;
+    }
+    if (binaryResult && alignmentOutputMode != Parameters::ALIGNMENT_OUTPUT_CLUSTER) {
+        extended |= Parameters::DBTYPE_EXTENDED_BINARY_RESULT;
+    }
+    return DBReader<unsigned int>::setExtendedDbtype(dbtype, extended);
+}
+
+void Alignment::run(const std::string &outDB, const std::string &outDBIndex, const size_t dbFrom, const size_t dbSize, bool merge) {
+    ProfileReport::Phase phase("alignment");
+    DBWriter dbw(outDB.c_str(), outDBIndex.c_str(), threads, compressed | (asyncWrite ? Parameters::WRITER_ASYNC_MODE : 0), getOutputDbtype());
     dbw.open();
 
     // handle no alignment case early, below would divide by 0 otherwise
@@ -260,8 +292,6 @@ void Alignment::run(const std::string &outDB, const std::string &outDBIndex, con
         return;
     }
 
-    EvalueComputation evaluer(tdbr->getAminoAcidDBSize(), this->m, gapOpen, gapExtend);
-
     size_t totalMemory = Util::getTotalSystemMemory();
     size_t flushSize = 1000000;
     if (totalMemory > prefdbr->getTotalDataSize()) {
@@ -284,29 +314,10 @@ void Alignment::run(const std::string &outDB, const std::string &outDBIndex, con
 #endif
             std::string alnResultsOutString;
             alnResultsOutString.reserve(1024*1024);
-            char buffer[1024 + 32768*4];
-            Sequence qSeq(maxSeqLen, querySeqType, m, 0, false, compBiasCorrection);
-            Sequence dbSeq(maxSeqLen, targetSeqType, m, 0, false, compBiasCorrection);
-            const size_t maxMatcherSeqLen = Parameters::isEqualDbtype(querySeqType, Parameters::DBTYPE_NUCLEOTIDES)
-                                            ? maxSeqLen : std::max(tdbr->getMaxSeqLen(), qdbr->getMaxSeqLen());
-
-            std::vector<Matcher::result_t> swResults;
-            swResults.reserve(300);
-            Matcher matcher(querySeqType, targetSeqType, maxMatcherSeqLen, m, &evaluer, compBiasCorrection, compBiasCorrectionScale, gapOpen, gapExtend, correlationScoreWeight, zdrop);
-
-            std::vector<Matcher::result_t> swRealignResults;
-            Matcher *realigner = NULL;
-            if (realign == true) {
-                swRealignResults.reserve(300);
-                realigner = &matcher;
-                if (realign_m != NULL) {
-                    realigner = new Matcher(querySeqType, targetSeqType, maxMatcherSeqLen, realign_m, &evaluer, compBiasCorrection, compBiasCorrectionScale, gapOpen, gapExtend, 0.0, zdrop);
-                }
-            }
-
-            std::string queryToWrap;
-            queryToWrap.reserve(maxSeqLen * 2);
+            QueryAligner aligner(*this);
 
+            std::vector<hit_t> hits;
+            hits.reserve(300);
             const char* words[10];
 
 #pragma omp for schedule(dynamic, 5) reduction(+: alignmentsNum, totalPassedNum)
@@ -314,231 +325,324 @@ void Alignment::run(const std::string &outDB, const std::string &outDBIndex, con
                 progress.updateProgress();
 
                 // get the prefiltering list
-                char *data, *origData;
-                data = origData = prefdbr->getData(id, thread_idx);
+                char *data = prefdbr->getData(id, thread_idx);
                 unsigned int queryDbKey = prefdbr->getDbKey(id);
-                size_t origQueryLen = 0;
-                // only load query data if data != \0
-                if (*data != '\0') {
-                    size_t qId = qdbr->getId(queryDbKey);
-                    char *querySeqData = qdbr->getData(qId, thread_idx);
-                    if (querySeqData == NULL) {
-                        Debug(Debug::ERROR) << "Query sequence " << queryDbKey
-                                            << " is required in the prefiltering, but is not contained in the query sequence database.\nPlease check your database.\n";
-                        EXIT(EXIT_FAILURE);
+                if (binaryPrefilterResult) {
+                    // binary prefilter entries are indexed by record instead of null terminated lines
+                    const size_t hitCount = QueryMatcher::getBinaryHitCount(prefdbr->getEntryLen(id));
+                    for (size_t hitIdx = 0; hitIdx < hitCount; hitIdx++) {
+                        hits.emplace_back(QueryMatcher::parsePrefilterHitBinary(data + hitIdx * QueryMatcher::BINARY_HIT_SIZE));
                     }
-                    size_t queryLen = qdbr->getSeqLen(qId);
-                    origQueryLen = queryLen;
-                    if (wrappedScoring) {
-                        queryToWrap = std::string(querySeqData, queryLen);
-                        queryToWrap = queryToWrap + queryToWrap;
-                        querySeqData = (char*)(queryToWrap).c_str();
-                        queryLen = origQueryLen*2;
+                } else {
+                    while (*data != '\0') {
+                        size_t elements = Util::getWordsOfLine(data, words, 10);
+                        // Prefilter result (need to make this better)
+                        if (elements == 3) {
+                            hits.emplace_back(QueryMatcher::parsePrefilterHit(data));
+                        } else {
+                            hit_t hit;
+                            hit.seqId = Util::fast_atoi<unsigned int>(data);
+                            hit.prefScore = 0;
+                            hit.diagonal = 0;
+                            hits.emplace_back(hit);
+                        }
+                        data = Util::skipLine(data);
                     }
+                }
 
-                    qSeq.mapSequence(qId, queryDbKey, querySeqData, queryLen);
-                    matcher.initQuery(&qSeq);
+                aligner.align(queryDbKey, hits.data(), hits.size(), alnResultsOutString, thread_idx, alignmentsNum, totalPassedNum);
+                dbw.writeData(alnResultsOutString.c_str(), alnResultsOutString.length(), queryDbKey, thread_idx);
+                alnResultsOutString.clear();
+                hits.clear();
+            }
+            // only remap if we have more than one iteration and we are not at the last iteration
+            if (i != (iterations - 1)) {
+#pragma omp barrier
+                if (thread_idx == 0) {
+                    prefdbr->remapData();
                 }
+#pragma omp barrier
+            }
+        }
+    }
+    dbw.close(merge);
 
-                // parse the prefiltering list and calculate a Smith-Waterman alignment for each sequence in the list
-                size_t passedNum = 0;
-                unsigned int rejected = 0;
-                while (*data != '\0' && passedNum < maxAccept && rejected < maxReject) {
-                    Util::parseKey(data, buffer);
-                    const unsigned int dbKey = (unsigned int) strtoul(buffer, NULL, 10);
-                    size_t elements = Util::getWordsOfLine(data, words, 10);
-
-                    short diagonal = 0;
-                    bool isReverse = false;
-                    // Prefilter result (need to make this better)
-                    if (elements == 3) {
-                        hit_t hit = QueryMatcher::parsePrefilterHit(data);
-                        isReverse = reversePrefilterResult && (hit.prefScore < 0);
-                        diagonal = static_cast<short>(hit.diagonal);
-                    }
-                    data = Util::skipLine(data);
+    printSummary(alignmentsNum, totalPassedNum, dbSize);
+}
 
-                    size_t dbId = tdbr->getId(dbKey);
-                    char *dbSeqData = tdbr->getData(dbId, thread_idx);
-                    if (dbSeqData == NULL) {
-                        Debug(Debug::ERROR) << "Sequence " << dbKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
-                        EXIT(EXIT_FAILURE);
-                    }
-                    dbSeq.mapSequence(dbId, dbKey, dbSeqData, tdbr->getSeqLen(dbId));
+void Alignment::printSummary(size_t alignmentsNum, size_t totalPassedNum, size_t querySize) {
+    Debug(Debug::INFO) << alignmentsNum << " alignments calculated\n";
+    Debug(Debug::INFO) << totalPassedNum << " sequence pairs passed the thresholds";
+    if (alignmentsNum > 0) {
+        Debug(Debug::INFO) << " (" << ((float) totalPassedNum / (float) alignmentsNum) << " of overall calculated)";
+    }
+    Debug(Debug::INFO) << "\n";
+    if (querySize > 0) {
+        size_t hits = totalPassedNum / querySize;
+        size_t hits_rest = totalPassedNum % querySize;
+        float hits_f = ((float) hits) + ((float) hits_rest) / (float) querySize;
+        Debug(Debug::INFO) << hits_f << " hits per query sequence\n";
+    }
+}
 
-                    // check if the sequences could pass the coverage threshold
-                    if (Util::canBeCovered(canCovThr, covMode, static_cast<float>(origQueryLen), static_cast<float>(dbSeq.L)) == false) {
-                        rejected++;
-                        continue;
-                    }
+Alignment::QueryAligner::QueryAligner(Alignment &aln) :
+        aln(aln),
+        qSeq(aln.maxSeqLen, aln.querySeqType, aln.m, 0, false, aln.compBiasCorrection),
+        dbSeq(aln.maxSeqLen, aln.targetSeqType, aln.m, 0, false, aln.compBiasCorrection),
+        matcher(aln.querySeqType, aln.targetSeqType,
+                Parameters::isEqualDbtype(aln.querySeqType, Parameters::DBTYPE_NUCLEOTIDES) ? aln.maxSeqLen : std::max(aln.tdbr->getMaxSeqLen(), aln.qdbr->getMaxSeqLen()),
+                aln.m, aln.evaluer, aln.compBiasCorrection, aln.compBiasCorrectionScale, aln.gapOpen, aln.gapExtend, aln.correlationScoreWeight, aln.zdrop),
+        realigner(NULL),
+        writeBinary(aln.binaryResult && aln.alignmentOutputMode != Parameters::ALIGNMENT_OUTPUT_CLUSTER) {
+    swResults.reserve(300);
+    batchEvalues.resize(Matcher::BATCH_SIZE);
+    batchLanes.reserve(300);
+    if (aln.realign == true) {
+        swRealignResults.reserve(300);
+        realigner = &matcher;
+        if (aln.realign_m != NULL) {
+            const size_t maxMatcherSeqLen = Parameters::isEqualDbtype(aln.querySeqType, Parameters::DBTYPE_NUCLEOTIDES)
+                                            ? aln.maxSeqLen : std::max(aln.tdbr->getMaxSeqLen(), aln.qdbr->getMaxSeqLen());
+            realigner = new Matcher(aln.querySeqType, aln.targetSeqType, maxMatcherSeqLen, aln.realign_m, aln.evaluer, aln.compBiasCorrection, aln.compBiasCorrectionScale, aln.gapOpen, aln.gapExtend, 0.0, aln.zdrop);
+        }
+    }
+    queryToWrap.reserve(aln.maxSeqLen * 2);
+}
 
-                    const bool isIdentity = (queryDbKey == dbKey && (includeIdentity || sameQTDB)) ? true : false;
+Alignment::QueryAligner::~QueryAligner() {
+    if (realigner != NULL && realigner != &matcher) {
+        delete realigner;
+    }
+}
 
-                    // calculate Smith-Waterman alignment
+size_t Alignment::QueryAligner::alignBatch(unsigned int queryDbKey, const hit_t *hits, size_t from, size_t hitCount,
+                                           size_t origQueryLen, unsigned int thread_idx) {
+    DBReader<unsigned int> *tdbr = aln.tdbr;
+    batchLanes.clear();
+    size_t lanes = 0;
+    size_t hitIdx = from;
+    for (; hitIdx < hitCount && lanes < Matcher::BATCH_SIZE; hitIdx++) {
+        const unsigned int dbKey = hits[hitIdx].seqId;
+        const bool isIdentity = (queryDbKey == dbKey && (aln.includeIdentity || aln.sameQTDB));
+        const size_t dbId = tdbr->getId(dbKey);
+        if (isIdentity || dbId == UINT_MAX) {
+            batchLanes.push_back(-1);
+            continue;
+        }
+        const size_t dbLen = tdbr->getSeqLen(dbId);
+        if (dbLen == 0 || Util::canBeCovered(aln.canCovThr, aln.covMode, static_cast<float>(origQueryLen), static_cast<float>(dbLen)) == false) {
+            batchLanes.push_back(-1);
+            continue;
+        }
+        char *dbSeqData = tdbr->getData(dbId, thread_idx);
+        if (dbSeqData == NULL) {
+            batchLanes.push_back(-1);
+            continue;
+        }
+        dbSeq.mapSequence(dbId, dbKey, dbSeqData, dbLen);
+        matcher.setBatchTarget(lanes, &dbSeq);
+        batchLanes.push_back(static_cast<int>(lanes));
+        lanes++;
+    }
+    if (lanes > 0) {
+        matcher.getSWBatchEvalues(lanes, batchEvalues.data());
+    }
+    return hitIdx;
+}
 
-                    Matcher::result_t res = matcher.getSWResult(&dbSeq, static_cast<int>(diagonal), isReverse, covMode, covThr, evalThr, swMode, seqIdMode, isIdentity, wrappedScoring);
-                    alignmentsNum++;
+void Alignment::QueryAligner::align(unsigned int queryDbKey, const hit_t *hits, size_t hitCount, std::string &out,
+                                    unsigned int thread_idx, size_t &alignmentsNum, size_t &totalPassedNum) {
+    DBReader<unsigned int> *qdbr = aln.qdbr;
+    DBReader<unsigned int> *tdbr = aln.tdbr;
+    const bool hasHits = hitCount > 0;
+    size_t origQueryLen = 0;
+    // only load query data if there are hits
+    if (hasHits) {
+        size_t qId = qdbr->getId(queryDbKey);
+        char *querySeqData = qdbr->getData(qId, thread_idx);
+        if (querySeqData == NULL) {
+            Debug(Debug::ERROR) << "Query sequence " << queryDbKey
+                                << " is required in the prefiltering, but is not contained in the query sequence database.\nPlease check your database.\n";
+            EXIT(EXIT_FAILURE);
+        }
+        size_t queryLen = qdbr->getSeqLen(qId);
+        origQueryLen = queryLen;
+        if (aln.wrappedScoring) {
+            queryToWrap = std::string(querySeqData, queryLen);
+            queryToWrap = queryToWrap + queryToWrap;
+            querySeqData = (char*)(queryToWrap).c_str();
+            queryLen = origQueryLen*2;
+        }
 
-                    if (isIdentity) {
-                        // set coverage and seqid of identity
-                        res.qcov = 1.0f;
-                        res.dbcov = 1.0f;
-                        res.seqId = 1.0f;
-                    }
+        qSeq.mapSequence(qId, queryDbKey, querySeqData, queryLen);
+        matcher.initQuery(&qSeq);
+    }
 
-                    if (checkCriteria(res, isIdentity, evalThr, seqIdThr, alnLenThr, covMode, covThr)) {
-                        swResults.emplace_back(res);
-                        passedNum++;
-                        totalPassedNum++;
-                        rejected = 0;
-                    } else {
-                        rejected++;
-                    }
-                }
+    // calculate a Smith-Waterman alignment for each sequence in the hit list
+    const bool batched = hasHits && matcher.canAlignBatch();
+    size_t batchStart = 0;
+    size_t batchEnd = 0;
+    size_t passedNum = 0;
+    unsigned int rejected = 0;
+    for (size_t hitIdx = 0; hitIdx < hitCount && passedNum < aln.maxAccept && rejected < aln.maxReject; hitIdx++) {
+        const hit_t &hit = hits[hitIdx];
+        const unsigned int dbKey = hit.seqId;
+        const bool isReverse = aln.reversePrefilterResult && (hit.prefScore < 0);
+        const short diagonal = static_cast<short>(hit.diagonal);
+
+        if (batched) {
+            if (hitIdx >= batchEnd) {
+                batchStart = hitIdx;
+                batchEnd = alignBatch(queryDbKey, hits, hitIdx, hitCount, origQueryLen, thread_idx);
+            }
+            // the alignment can only score lower than the batch score, so it would fail the e-value threshold as well
+            const int lane = batchLanes[hitIdx - batchStart];
+            if (lane != -1 && batchEvalues[lane] > aln.evalThr) {
+                alignmentsNum++;
+                rejected++;
+                continue;
+            }
+        }
 
-                if (altAlignment > 0 && realign == false && wrappedScoring == false) {
-                    computeAlternativeAlignment(queryDbKey, dbSeq, swResults, matcher, covThr, evalThr, swMode, thread_idx);
-                }
+        size_t dbId = tdbr->getId(dbKey);
+        char *dbSeqData = tdbr->getData(dbId, thread_idx);
+        if (dbSeqData == NULL) {
+            Debug(Debug::ERROR) << "Sequence " << dbKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
+            EXIT(EXIT_FAILURE);
+        }
+        dbSeq.mapSequence(dbId, dbKey, dbSeqData, tdbr->getSeqLen(dbId));
 
-                if (swResults.size() > 1) {
-                    SORT_SERIAL(swResults.begin(), swResults.end(), Matcher::compareHits);
-                }
+        // check if the sequences could pass the coverage threshold
+        if (Util::canBeCovered(aln.canCovThr, aln.covMode, static_cast<float>(origQueryLen), static_cast<float>(dbSeq.L)) == false) {
+            rejected++;
+            continue;
+        }
 
-                std::vector<Matcher::result_t> *returnRes = &swResults;
-                if (realign == true && *origData != '\0') {
-                    realigner->initQuery(&qSeq);
-                    int realignAccepted = 0;
-                    for (size_t result = 0; result < swResults.size() && realignAccepted < realignMaxSeqs; result++) {
-                        size_t dbId = tdbr->getId(swResults[result].dbKey);
-                        char *dbSeqData = tdbr->getData(dbId, thread_idx);
-                        if (dbSeqData == NULL) {
-                            Debug(Debug::ERROR) << "Sequence " << swResults[result].dbKey <<" is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
-                            EXIT(EXIT_FAILURE);
-                        }
-                        dbSeq.mapSequence(dbId, swResults[result].dbKey, dbSeqData, tdbr->getSeqLen(dbId));
-
-                        // recompute alignment boundaries (without changing evalue)
-                        const bool isIdentity = (queryDbKey == swResults[result].dbKey && (includeIdentity || sameQTDB)) ? true : false;
-                        Matcher::result_t res = realigner->getSWResult(&dbSeq, INT_MAX, false, realignCov, covThr, FLT_MAX, realignSwMode, seqIdMode, isIdentity);
-
-                        const bool covOK = Util::hasCoverage(realignCov, covMode, res.qcov, res.dbcov);
-                        if (covOK == true || isIdentity) {
-                            res.score = swResults[result].score;
-                            res.eval  = swResults[result].eval;
-                            swRealignResults.emplace_back(res);
-                            realignAccepted++;
-                        }
-                    }
+        const bool isIdentity = (queryDbKey == dbKey && (aln.includeIdentity || aln.sameQTDB)) ? true : false;
 
-                    if (altAlignment > 0) {
-                        computeAlternativeAlignment(queryDbKey, dbSeq, swRealignResults, *realigner, realignCov, FLT_MAX, realignSwMode, thread_idx);
-                    }
+        // calculate Smith-Waterman alignment
+        Matcher::result_t res = matcher.getSWResult(&dbSeq, static_cast<int>(diagonal), isReverse, aln.covMode, aln.covThr, aln.evalThr, aln.swMode, aln.seqIdMode, isIdentity, aln.wrappedScoring);
+        alignmentsNum++;
 
-                    if (swRealignResults.size() > 1) {
-                        SORT_SERIAL(swRealignResults.begin(), swRealignResults.end(), Matcher::compareHits);
-                    }
+        if (isIdentity) {
+            // set coverage and seqid of identity
+            res.qcov = 1.0f;
+            res.dbcov = 1.0f;
+            res.seqId = 1.0f;
+        }
 
-                    returnRes = &swRealignResults;
-                }
+        if (checkCriteria(res, isIdentity, aln.evalThr, aln.seqIdThr, aln.alnLenThr, aln.covMode, aln.covThr)) {
+            swResults.emplace_back(res);
+            passedNum++;
+            totalPassedNum++;
+            rejected = 0;
+        } else {
+            rejected++;
+        }
+    }
 
-                if (lcaAlign == true && swRealignResults.size() > 0) {
-                    Matcher::result_t& topHit = swRealignResults[0];
-                    const unsigned int topHitKey = topHit.dbKey;
-                    size_t dbId = tdbr->getId(topHitKey);
-                    char *qSeqData = tdbr->getData(dbId, thread_idx);
-                    if (qSeqData == NULL) {
-                        Debug(Debug::ERROR) << "Sequence " << topHitKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
-                        EXIT(EXIT_FAILURE);
-                    }
-                    qSeq.mapSequence(dbId, topHitKey, qSeqData + topHit.dbStartPos, topHit.dbEndPos - topHit.dbStartPos + 1);
-                    realigner->initQuery(&qSeq);
-
-                    const double topHitEval = topHit.eval;
-                    swRealignResults.clear();
-
-                    data = origData;
-                    unsigned int rejected = 0;
-                    while (*data != '\0' && rejected < maxReject) {
-                        Util::parseKey(data, buffer);
-                        const unsigned int dbKey = (unsigned int) strtoul(buffer, NULL, 10);
-//                        size_t elements = Util::getWordsOfLine(data, words, 10);
-//                        short diagonal = 0;
-//                        bool isReverse = false;
-//                        // Prefilter result (need to make this better)
-//                        if (elements == 3) {
-//                            hit_t hit = QueryMatcher::parsePrefilterHit(data);
-//                            isReverse = reversePrefilterResult && (hit.prefScore < 0);
-//                            diagonal = static_cast<short>(hit.diagonal);
-//                        }
-                        data = Util::skipLine(data);
+    if (aln.altAlignment > 0 && aln.realign == false && aln.wrappedScoring == false) {
+        aln.computeAlternativeAlignment(queryDbKey, dbSeq, swResults, matcher, aln.covThr, aln.evalThr, aln.swMode, thread_idx);
+    }
 
-                        dbId = tdbr->getId(dbKey);
-                        char* dbSeqData = tdbr->getData(dbId, thread_idx);
-                        if (dbSeqData == NULL) {
-                            Debug(Debug::ERROR) << "Sequence " << dbKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
-                            EXIT(EXIT_FAILURE);
-                        }
-                        dbSeq.mapSequence(dbId, dbKey, dbSeqData, tdbr->getSeqLen(dbId));
+    if (swResults.size() > 1) {
+        SORT_SERIAL(swResults.begin(), swResults.end(), Matcher::compareHits);
+    }
 
-                        Matcher::result_t res = realigner->getSWResult(&dbSeq, INT_MAX, false, covMode, realignCov, topHitEval, lcaSwMode, seqIdMode, false);
+    std::vector<Matcher::result_t> *returnRes = &swResults;
+    if (aln.realign == true && hasHits) {
+        realigner->initQuery(&qSeq);
+        int realignAccepted = 0;
+        for (size_t result = 0; result < swResults.size() && realignAccepted < aln.realignMaxSeqs; result++) {
+            size_t dbId = tdbr->getId(swResults[result].dbKey);
+            char *dbSeqData = tdbr->getData(dbId, thread_idx);
+            if (dbSeqData == NULL) {
+                Debug(Debug::ERROR) << "Sequence " << swResults[result].dbKey <<" is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
+                EXIT(EXIT_FAILURE);
+            }
+            dbSeq.mapSequence(dbId, swResults[result].dbKey, dbSeqData, tdbr->getSeqLen(dbId));
+
+            // recompute alignment boundaries (without changing evalue)
+            const bool isIdentity = (queryDbKey == swResults[result].dbKey && (aln.includeIdentity || aln.sameQTDB)) ? true : false;
+            Matcher::result_t res = realigner->getSWResult(&dbSeq, INT_MAX, false, aln.realignCov, aln.covThr, FLT_MAX, aln.realignSwMode, aln.seqIdMode, isIdentity);
+
+            const bool covOK = Util::hasCoverage(aln.realignCov, aln.covMode, res.qcov, res.dbcov);
+            if (covOK == true || isIdentity) {
+                res.score = swResults[result].score;
+                res.eval  = swResults[result].eval;
+                swRealignResults.emplace_back(res);
+                realignAccepted++;
+            }
+        }
 
-                        if (checkCriteria(res, false, topHitEval, seqIdThr, alnLenThr, covMode, realignCov)) {
-                            swRealignResults.emplace_back(res);
-                            rejected = 0;
-                        } else {
-                            rejected++;
-                        }
-                    }
+        if (aln.altAlignment > 0) {
+            aln.computeAlternativeAlignment(queryDbKey, dbSeq, swRealignResults, *realigner, aln.realignCov, FLT_MAX, aln.realignSwMode, thread_idx);
+        }
 
-                    if (swRealignResults.size() > 1) {
-                        SORT_SERIAL(swRealignResults.begin(), swRealignResults.end(), Matcher::compareHits);
-                    }
+        if (swRealignResults.size() > 1) {
+            SORT_SERIAL(swRealignResults.begin(), swRealignResults.end(), Matcher::compareHits);
+        }
 
-                    returnRes = &swRealignResults;
-                }
-                if(alignmentOutputMode == Parameters::ALIGNMENT_OUTPUT_CLUSTER) {
-                    for (size_t result = 0; result < returnRes->size(); result++) {
-                        alnResultsOutString.append(SSTR((*returnRes)[result].dbKey));
-                        alnResultsOutString.push_back('\n');
-                    }
-                }else{
-                    for (size_t result = 0; result < returnRes->size(); result++) {
-                        size_t len = Matcher::resultToBuffer(buffer, (*returnRes)[result], addBacktrace);
-                        alnResultsOutString.append(buffer, len);
-                    }
-                }
-                dbw.writeData(alnResultsOutString.c_str(), alnResultsOutString.length(), queryDbKey, thread_idx);
-                alnResultsOutString.clear();
-                swResults.clear();
-                swRealignResults.clear();
-            }
-            if (realigner != NULL && realigner != &matcher) {
-                delete realigner;
+        returnRes = &swRealignResults;
+    }
+
+    if (aln.lcaAlign == true && swRealignResults.size() > 0) {
+        Matcher::result_t& topHit = swRealignResults[0];
+        const unsigned int topHitKey = topHit.dbKey;
+        size_t dbId = tdbr->getId(topHitKey);
+        char *qSeqData = tdbr->getData(dbId, thread_idx);
+        if (qSeqData == NULL) {
+            Debug(Debug::ERROR) << "Sequence " << topHitKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
+            EXIT(EXIT_FAILURE);
+        }
+        qSeq.mapSequence(dbId, topHitKey, qSeqData + topHit.dbStartPos, topHit.dbEndPos - topHit.dbStartPos + 1);
+        realigner->initQuery(&qSeq);
+
+        const double topHitEval = topHit.eval;
+        swRealignResults.clear();
+
+        unsigned int rejected = 0;
+        for (size_t hitIdx = 0; hitIdx < hitCount && rejected < aln.maxReject; hitIdx++) {
+            const unsigned int dbKey = hits[hitIdx].seqId;
+            dbId = tdbr->getId(dbKey);
+            char* dbSeqData = tdbr->getData(dbId, thread_idx);
+            if (dbSeqData == NULL) {
+                Debug(Debug::ERROR) << "Sequence " << dbKey << " is required in the prefiltering, but is not contained in the target sequence database!\nPlease check your database.\n";
+                EXIT(EXIT_FAILURE);
             }
-            // only remap if we have more than one iteration and we are not at the last iteration
-            if (i != (iterations - 1)) {
-#pragma omp barrier
-                if (thread_idx == 0) {
-                    prefdbr->remapData();
-                }
-#pragma omp barrier
+            dbSeq.mapSequence(dbId, dbKey, dbSeqData, tdbr->getSeqLen(dbId));
+
+            Matcher::result_t res = realigner->getSWResult(&dbSeq, INT_MAX, false, aln.covMode, aln.realignCov, topHitEval, aln.lcaSwMode, aln.seqIdMode, false);
+
+            if (checkCriteria(res, false, topHitEval, aln.seqIdThr, aln.alnLenThr, aln.covMode, aln.realignCov)) {
+                swRealignResults.emplace_back(res);
+                rejected = 0;
+            } else {
+                rejected++;
             }
         }
-    }
-    dbw.close(merge);
 
-    Debug(Debug::INFO) << alignmentsNum << " alignments calculated\n";
-    Debug(Debug::INFO) << totalPassedNum << " sequence pairs passed the thresholds";
-    if (alignmentsNum > 0) {
-        Debug(Debug::INFO) << " (" << ((float) totalPassedNum / (float) alignmentsNum) << " of overall calculated)";
+        if (swRealignResults.size() > 1) {
+            SORT_SERIAL(swRealignResults.begin(), swRealignResults.end(), Matcher::compareHits);
+        }
+
+        returnRes = &swRealignResults;
     }
-    Debug(Debug::INFO) << "\n";
-    if (dbSize > 0) {
-        size_t hits = totalPassedNum / dbSize;
-        size_t hits_rest = totalPassedNum % dbSize;
-        float hits_f = ((float) hits) + ((float) hits_rest) / (float) dbSize;
-        Debug(Debug::INFO) << hits_f << " hits per query sequence\n";
+    if (aln.alignmentOutputMode == Parameters::ALIGNMENT_OUTPUT_CLUSTER) {
+        for (size_t result = 0; result < returnRes->size(); result++) {
+            out.append(SSTR((*returnRes)[result].dbKey));
+            out.push_back('\n');
+        }
+    } else if (writeBinary) {
+        Matcher::resultsToBinary(out, *returnRes, aln.addBacktrace);
+    } else {
+        for (size_t result = 0; result < returnRes->size(); result++) {
+            size_t len = Matcher::resultToBuffer(buffer, (*returnRes)[result], aln.addBacktrace);
+            out.append(buffer, len);
+        }
     }
+    swResults.clear();
+    swRealignResults.clear();
 }
 
 size_t Alignment::estimateHDDMemoryConsumption(int dbSize, int maxSeqs) {
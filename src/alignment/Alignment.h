@@ -6,9 +6,13 @@
 #include "Parameters.h"
 #include "BaseMatrix.h"
 #include "Matcher.h"
+#include "QueryMatcher.h"
+#include "Sequence.h"
+#include "EvalueComputation.h"
 
 class Alignment {
 public:
+    // an empty prefDB means that the hits are passed in directly through a QueryAligner
     Alignment(const std::string &querySeqDB,
               const std::string &targetSeqDB,
               const std::string &prefDB, const std::string &prefDBIndex,
@@ -29,6 +33,43 @@ public:
 
     static unsigned int initSWMode(unsigned int alignmentMode, float covThr, float seqIdThr);
 
+    static void printSummary(size_t alignmentsNum, size_t totalPassedNum, size_t querySize);
+
+    int getOutputDbtype() const;
+
+    // per thread alignment state, aligns the hits of one query at a time
+    class QueryAligner {
+    public:
+        QueryAligner(Alignment &aln);
+        ~QueryAligner();
+
+        // appends the formatted alignment results of a query to out
+        void align(unsigned int queryDbKey, const hit_t *hits, size_t hitCount, std::string &out,
+                   unsigned int thread_idx, size_t &alignmentsNum, size_t &totalPassedNum);
+
+    private:
+        Alignment &aln;
+        Sequence qSeq;
+        Sequence dbSeq;
+        Matcher matcher;
+        Matcher *realigner;
+        std::vector<Matcher::result_t> swResults;
+        std::vector<Matcher::result_t> swRealignResults;
+        std::string queryToWrap;
+        bool writeBinary;
+        char buffer[1024 + 32768*4];
+
+        // the next hits are scored in batches first, hits whose optimal score misses the
+        // e-value threshold are rejected without computing the full alignment
+        std::vector<double> batchEvalues;
+        // batch lane of each hit starting at batchStart, -1 if the hit is not part of the batch
+        std::vector<int> batchLanes;
+
+        // returns the index of the first hit after the batch
+        size_t alignBatch(unsigned int queryDbKey, const hit_t *hits, size_t from, size_t hitCount,
+                          size_t origQueryLen, unsigned int thread_idx);
+    };
+
 private:
     // sequence coverage threshold
     double covThr;
@@ -76,6 +117,9 @@ private:
 
     unsigned int threads;
     unsigned int compressed;
+    // write results as packed binary records
+    bool binaryResult;
+    bool asyncWrite;
 
     const std::string outDB;
     const std::string outDBIndex;
@@ -118,7 +162,10 @@ private:
 
     DBReader<unsigned int> *prefdbr;
 
+    EvalueComputation *evaluer;
+
     bool reversePrefilterResult;
+    bool binaryPrefilterResult;
 
     static size_t estimateHDDMemoryConsumption(int dbSize, int maxSeqs);
 
@@ -4,6 +4,7 @@
 #include "Util.h"
 #include "Parameters.h"
 #include "StripedSmithWaterman.h"
+#include "QueryMatcher.h"
 
 
 Matcher::Matcher(int querySeqType, int targetSeqType, int maxSeqLen, BaseMatrix *m, EvalueComputation * evaluer,
@@ -56,6 +57,27 @@ void Matcher::initQuery(Sequence* query){
     }
 }
 
+bool Matcher::canAlignBatch() const {
+    return aligner != NULL && aligner->canAlignBatch() && correlationScoreWeight == 0.0f && currentQuery->L > 0;
+}
+
+void Matcher::setBatchTarget(size_t lane, const Sequence *dbSeq) {
+    aligner->ssw_set_batch_target(lane, dbSeq->numSequence, dbSeq->L);
+}
+
+void Matcher::getSWBatchEvalues(size_t count, double *evalues) {
+    uint16_t scores[BATCH_SIZE];
+    aligner->ssw_score_batch(count, gapOpen, gapExtend, scores);
+    for (size_t i = 0; i < count; i++) {
+        // ssw_align leaves the e-value of alignments without any aligned residue unset
+        if (scores[i] == 0 || scores[i] == UCHAR_MAX) {
+            evalues[i] = 0.0;
+        } else {
+            evalues[i] = evaluer->computeEvalue(scores[i], currentQuery->L);
+        }
+    }
+}
+
 Matcher::result_t Matcher::getSWResult(Sequence* dbSeq, const int diagonal, bool isReverse, const int covMode, const float covThr,
                                        const double evalThr, unsigned int alignmentMode, unsigned int seqIdMode, bool isIdentity,
                                        bool wrappedScoring){
@@ -147,7 +169,8 @@ void Matcher::readAlignmentResults(std::vector<result_t> &result, char *data, bo
     }
 
     while(*data != '\0'){
-        result.emplace_back(parseAlignmentRecord(data, readCompressed));
+        result.emplace_back();
+        parseAlignmentRecord(data, result.back(), readCompressed);
         data = Util::skipLine(data);
     }
 }
@@ -185,9 +208,15 @@ std::string Matcher::compressAlignment(const std::string& bt) {
 
 std::string Matcher::uncompressAlignment(const std::string &cbt) {
     std::string bt;
-    bt.reserve(cbt.size());
+    uncompressAlignment(cbt.c_str(), cbt.size(), bt);
+    return bt;
+}
+
+void Matcher::uncompressAlignment(const char *cbt, size_t length, std::string &bt) {
+    bt.clear();
+    bt.reserve(length);
     size_t count = 0;
-    for (size_t i = 0; i < cbt.size(); ++i) {
+    for (size_t i = 0; i < length; ++i) {
         char c = cbt[i];
         if (c >= '0' && c <= '9') {
             count = count * 10 + c - '0';
@@ -196,10 +225,15 @@ std::string Matcher::uncompressAlignment(const std::string &cbt) {
             count = 0;
         }
     }
-    return bt;
 }
 
 Matcher::result_t Matcher::parseAlignmentRecord(const char *data, bool readCompressed) {
+    result_t result;
+    parseAlignmentRecord(data, result, readCompressed);
+    return result;
+}
+
+void Matcher::parseAlignmentRecord(const char *data, result_t &result, bool readCompressed) {
     const char *entry[255];
     size_t columns = Util::getWordsOfLine(data, entry, 255);
     if (columns < ALN_RES_WITHOUT_BT_COL_CNT) {
@@ -212,65 +246,63 @@ Matcher::result_t Matcher::parseAlignmentRecord(const char *data, bool readCompr
     strncpy(key, data, keySize);
     key[keySize] = '\0';
 
-    unsigned int targetId = Util::fast_atoi<unsigned int>(key);
-    int score = Util::fast_atoi<int>(entry[1]);
-    double seqId = strtod(entry[2],NULL);
-    double eval = strtod(entry[3],NULL);
-
-    int qStart =  Util::fast_atoi<int>(entry[4]);
-    int qEnd = Util::fast_atoi<int>(entry[5]);
-    int qLen = Util::fast_atoi<int>(entry[6]);
-    int dbStart = Util::fast_atoi<int>(entry[7]);
-    int dbEnd = Util::fast_atoi<int>(entry[8]);
-    int dbLen = Util::fast_atoi<int>(entry[9]);
-    int adjustQstart = (qStart==-1)? 0 : qStart;
-    int adjustDBstart = (dbStart==-1)? 0 : dbStart;
-    double qCov = SmithWaterman::computeCov(adjustQstart, qEnd, qLen);
-    double dbCov = SmithWaterman::computeCov(adjustDBstart, dbEnd, dbLen);
-    size_t alnLength = Matcher::computeAlnLength(adjustQstart, qEnd, adjustDBstart, dbEnd);
-
+    result.dbKey = Util::fast_atoi<unsigned int>(key);
+    result.score = Util::fast_atoi<int>(entry[1]);
+    result.seqId = strtod(entry[2],NULL);
+    result.eval = strtod(entry[3],NULL);
+
+    result.qStartPos =  Util::fast_atoi<int>(entry[4]);
+    result.qEndPos = Util::fast_atoi<int>(entry[5]);
+    result.qLen = Util::fast_atoi<int>(entry[6]);
+    result.dbStartPos = Util::fast_atoi<int>(entry[7]);
+    result.dbEndPos = Util::fast_atoi<int>(entry[8]);
+    result.dbLen = Util::fast_atoi<int>(entry[9]);
+    int adjustQstart = (result.qStartPos==-1)? 0 : result.qStartPos;
+    int adjustDBstart = (result.dbStartPos==-1)? 0 : result.dbStartPos;
+    result.qcov = SmithWaterman::computeCov(adjustQstart, result.qEndPos, result.qLen);
+    result.dbcov = SmithWaterman::computeCov(adjustDBstart, result.dbEndPos, result.dbLen);
+    result.alnLength = Matcher::computeAlnLength(adjustQstart, result.qEndPos, adjustDBstart, result.dbEndPos);
+
+    size_t btColumn = 0;
     switch(columns) {
         // 10 no backtrace
         case ALN_RES_WITHOUT_BT_COL_CNT:
-            return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                 alnLength, qStart, qEnd, qLen, dbStart, dbEnd, dbLen, -1, -1, -1, -1, "");
+            break;
         // 11 with backtrace
         case ALN_RES_WITH_BT_COL_CNT:
-            if (readCompressed) {
-                return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                         alnLength, qStart, qEnd, qLen, dbStart, dbEnd,
-                                         dbLen, -1, -1, -1, -1, std::string(entry[10], entry[11] - entry[10]));
-            } else {
-                return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                         alnLength, qStart, qEnd, qLen, dbStart, dbEnd,
-                                         dbLen, -1, -1, -1, -1,
-                                         uncompressAlignment(std::string(entry[10], entry[11] - entry[10])));
-            }
+            btColumn = 10;
+            break;
         // 12 without backtrace but qOrfStart dbOrfStart
         case ALN_RES_WITH_ORF_POS_WITHOUT_BT_COL_CNT:
-            return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                     alnLength, qStart, qEnd, qLen, dbStart, dbEnd,
-                                     dbLen, Util::fast_atoi<int>(entry[10]), Util::fast_atoi<int>(entry[11]),
-                                     Util::fast_atoi<int>(entry[12]), Util::fast_atoi<int>(entry[13]), "");
+            break;
         // 13 without backtrace but qOrfStart dbOrfStart
         case ALN_RES_WITH_ORF_AND_BT_COL_CNT:
-            if (readCompressed) {
-                return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                         alnLength, qStart, qEnd, qLen, dbStart, dbEnd,
-                                         dbLen, Util::fast_atoi<int>(entry[10]), Util::fast_atoi<int>(entry[11]),
-                                         Util::fast_atoi<int>(entry[12]), Util::fast_atoi<int>(entry[13]),
-                                         std::string(entry[14], entry[15] - entry[14]));
-            } else {
-                return Matcher::result_t(targetId, score, qCov, dbCov, seqId, eval,
-                                         alnLength, qStart, qEnd, qLen, dbStart, dbEnd,
-                                         dbLen, Util::fast_atoi<int>(entry[10]), Util::fast_atoi<int>(entry[11]),
-                                         Util::fast_atoi<int>(entry[12]), Util::fast_atoi<int>(entry[13]),
-                                         uncompressAlignment(std::string(entry[14], entry[15] - entry[14])));
-            }
+            btColumn = 14;
+            break;
         default:
             Debug(Debug::ERROR) << "Invalid column count in alignment.\n";
             EXIT(EXIT_FAILURE);
     }
+
+    if (columns >= ALN_RES_WITH_ORF_POS_WITHOUT_BT_COL_CNT) {
+        result.queryOrfStartPos = Util::fast_atoi<int>(entry[10]);
+        result.queryOrfEndPos = Util::fast_atoi<int>(entry[11]);
+        result.dbOrfStartPos = Util::fast_atoi<int>(entry[12]);
+        result.dbOrfEndPos = Util::fast_atoi<int>(entry[13]);
+    } else {
+        result.queryOrfStartPos = -1;
+        result.queryOrfEndPos = -1;
+        result.dbOrfStartPos = -1;
+        result.dbOrfEndPos = -1;
+    }
+
+    if (btColumn == 0) {
+        result.backtrace.clear();
+    } else if (readCompressed) {
+        result.backtrace.assign(entry[btColumn], entry[btColumn + 1] - entry[btColumn]);
+    } else {
+        uncompressAlignment(entry[btColumn], entry[btColumn + 1] - entry[btColumn], result.backtrace);
+    }
 }
 
 
@@ -323,6 +355,128 @@ size_t Matcher::resultToBuffer(char * buff1, const result_t &result, bool addBac
     return tmpBuff - basePos;
 }
 
+void Matcher::resultsToBinary(std::string &out, const std::vector<result_t> &results, bool addBacktrace) {
+    const unsigned int count = static_cast<unsigned int>(results.size());
+    if (count == 0) {
+        return;
+    }
+    const size_t headerSize = sizeof(unsigned int) + count * sizeof(binary_result_t);
+    const size_t recordStart = out.size();
+    out.resize(recordStart + headerSize);
+    memcpy(&out[recordStart], &count, sizeof(unsigned int));
+    unsigned int backtraceOffset = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const result_t &res = results[i];
+        binary_result_t record;
+        record.eval = res.eval;
+        record.dbKey = res.dbKey;
+        record.score = res.score;
+        record.qcov = res.qcov;
+        record.dbcov = res.dbcov;
+        record.seqId = res.seqId;
+        record.alnLength = res.alnLength;
+        record.qStartPos = res.qStartPos;
+        record.qEndPos = res.qEndPos;
+        record.qLen = res.qLen;
+        record.dbStartPos = res.dbStartPos;
+        record.dbEndPos = res.dbEndPos;
+        record.dbLen = res.dbLen;
+        record.queryOrfStartPos = res.queryOrfStartPos;
+        record.queryOrfEndPos = res.queryOrfEndPos;
+        record.dbOrfStartPos = res.dbOrfStartPos;
+        record.dbOrfEndPos = res.dbOrfEndPos;
+        record.backtraceOffset = backtraceOffset;
+        record.backtraceLength = 0;
+        if (addBacktrace == true && res.backtrace.empty() == false) {
+            std::string compressedCigar = Matcher::compressAlignment(res.backtrace);
+            record.backtraceLength = static_cast<unsigned int>(compressedCigar.size());
+            backtraceOffset += record.backtraceLength;
+            out.append(compressedCigar);
+        }
+        memcpy(&out[recordStart + sizeof(unsigned int) + i * sizeof(binary_result_t)], &record, sizeof(binary_result_t));
+    }
+}
+
+size_t Matcher::getBinaryResultCount(const char *data, size_t entryLength) {
+    if (data == NULL || entryLength <= sizeof(unsigned int)) {
+        return 0;
+    }
+    unsigned int count;
+    memcpy(&count, data, sizeof(unsigned int));
+    return count;
+}
+
+Matcher::result_t Matcher::parseAlignmentRecordBinary(const char *data, size_t idx, bool readCompressed) {
+    result_t result;
+    parseAlignmentRecordBinary(data, idx, result, readCompressed);
+    return result;
+}
+
+void Matcher::parseAlignmentRecordBinary(const char *data, size_t idx, result_t &result, bool readCompressed) {
+    unsigned int count;
+    memcpy(&count, data, sizeof(unsigned int));
+    binary_result_t record;
+    memcpy(&record, data + sizeof(unsigned int) + idx * sizeof(binary_result_t), sizeof(binary_result_t));
+    result.dbKey = record.dbKey;
+    result.score = record.score;
+    result.qcov = record.qcov;
+    result.dbcov = record.dbcov;
+    result.seqId = record.seqId;
+    result.eval = record.eval;
+    result.alnLength = record.alnLength;
+    result.qStartPos = record.qStartPos;
+    result.qEndPos = record.qEndPos;
+    result.qLen = record.qLen;
+    result.dbStartPos = record.dbStartPos;
+    result.dbEndPos = record.dbEndPos;
+    result.dbLen = record.dbLen;
+    result.queryOrfStartPos = record.queryOrfStartPos;
+    result.queryOrfEndPos = record.queryOrfEndPos;
+    result.dbOrfStartPos = record.dbOrfStartPos;
+    result.dbOrfEndPos = record.dbOrfEndPos;
+    if (record.backtraceLength == 0) {
+        result.backtrace.clear();
+        return;
+    }
+    const char *blob = data + sizeof(unsigned int) + count * sizeof(binary_result_t);
+    if (readCompressed) {
+        result.backtrace.assign(blob + record.backtraceOffset, record.backtraceLength);
+    } else {
+        uncompressAlignment(blob + record.backtraceOffset, record.backtraceLength, result.backtrace);
+    }
+}
+
+void Matcher::readAlignmentResultsBinary(std::vector<result_t> &result, const char *data, size_t entryLength, bool readCompressed) {
+    const size_t count = getBinaryResultCount(data, entryLength);
+    for (size_t i = 0; i < count; i++) {
+        result.emplace_back();
+        parseAlignmentRecordBinary(data, i, result.back(), readCompressed);
+    }
+}
+
+void Matcher::binaryEntryToBuffer(std::string &out, const char *data, size_t entryLength, int dbtype) {
+    if (Parameters::isEqualDbtype(dbtype, Parameters::DBTYPE_PREFILTER_RES)
+        || Parameters::isEqualDbtype(dbtype, Parameters::DBTYPE_PREFILTER_REV_RES)) {
+        QueryMatcher::binaryHitsToBuffer(out, data, entryLength);
+        return;
+    }
+
+    std::vector<result_t> results;
+    readAlignmentResultsBinary(results, data, entryLength, true);
+    bool hasBacktrace = false;
+    bool hasOrfPosition = false;
+    for (size_t i = 0; i < results.size(); i++) {
+        hasBacktrace |= (results[i].backtrace.empty() == false);
+        hasOrfPosition |= (results[i].queryOrfStartPos != -1 || results[i].dbOrfStartPos != -1);
+    }
+    char buffer[1024 + 32768*4];
+    for (size_t i = 0; i < results.size(); i++) {
+        // backtrace is already run-length compressed
+        size_t len = resultToBuffer(buffer, results[i], hasBacktrace, false, hasOrfPosition);
+        out.append(buffer, len);
+    }
+}
+
 void Matcher::updateResultByRescoringBacktrace(const char *querySeq, const char *targetSeq, const char **subMat, EvalueComputation &evaluer,
                                                 int gapOpen, int gapExtend, result_t &result) {
     int maxScore = 0;
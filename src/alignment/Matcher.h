@@ -153,6 +153,19 @@ public:
     result_t getSWResult(Sequence* dbSeq, const int diagonal, bool isReverse, const int covMode, const float covThr, const double evalThr,
                          unsigned int alignmentMode, unsigned int seqIdMode, bool isIdentical, bool wrappedScoring=false);
 
+    // inter-sequence scoring of up to BATCH_SIZE amino acid targets at once, one target per SIMD lane
+    static const size_t BATCH_SIZE = SmithWaterman::BATCH_SIZE;
+
+    // true if the current query can be aligned in batches
+    bool canAlignBatch() const;
+
+    void setBatchTarget(size_t lane, const Sequence *dbSeq);
+
+    // e-values of the optimal local alignments of the first count targets set with setBatchTarget.
+    // getSWResult can only report an equal or higher e-value for these targets.
+    // Targets that need the full alignment to be decided get an e-value of 0.
+    void getSWBatchEvalues(size_t count, double *evalues);
+
     // need for sorting the results
     static bool compareHits(const result_t &first, const result_t &second) {
         if (first.eval != second.eval) {
@@ -202,11 +215,38 @@ public:
         return firstDbStart < secondDbStart;
     }
 
+    // fixed-width record of the binary alignment result format
+    // an entry consists of an uint32 record count, the records and a blob of compressed backtraces
+    struct binary_result_t {
+        double eval;
+        unsigned int dbKey;
+        int score;
+        float qcov;
+        float dbcov;
+        float seqId;
+        unsigned int alnLength;
+        int qStartPos;
+        int qEndPos;
+        unsigned int qLen;
+        int dbStartPos;
+        int dbEndPos;
+        unsigned int dbLen;
+        int queryOrfStartPos;
+        int queryOrfEndPos;
+        int dbOrfStartPos;
+        int dbOrfEndPos;
+        unsigned int backtraceOffset;
+        unsigned int backtraceLength;
+    };
+
     // map new query into memory (create queryProfile, ...)
     void initQuery(Sequence* query);
 
     static result_t parseAlignmentRecord(const char *data, bool readCompressed=false);
 
+    // decodes into an existing record, reusing the capacity of its backtrace
+    static void parseAlignmentRecord(const char *data, result_t &result, bool readCompressed=false);
+
     static void readAlignmentResults(std::vector<result_t> &result, char *data, bool readCompressed = false);
 
     static float estimateSeqIdByScorePerCol(uint16_t score, unsigned int qLen, unsigned int tLen);
@@ -215,9 +255,24 @@ public:
 
     static std::string uncompressAlignment(const std::string &cbt);
 
+    static void uncompressAlignment(const char *cbt, size_t length, std::string &bt);
+
 
     static size_t resultToBuffer(char * buffer, const result_t &result, bool addBacktrace, bool compress  = true, bool addOrfPosition = false);
 
+    static void resultsToBinary(std::string &out, const std::vector<result_t> &results, bool addBacktrace);
+
+    static size_t getBinaryResultCount(const char *data, size_t entryLength);
+
+    static result_t parseAlignmentRecordBinary(const char *data, size_t idx, bool readCompressed = false);
+
+    static void parseAlignmentRecordBinary(const char *data, size_t idx, result_t &result, bool readCompressed = false);
+
+    static void readAlignmentResultsBinary(std::vector<result_t> &result, const char *data, size_t entryLength, bool readCompressed = false);
+
+    // converts a binary prefilter or alignment entry back to its tab-separated text representation
+    static void binaryEntryToBuffer(std::string &out, const char *data, size_t entryLength, int dbtype);
+
     static int computeAlnLength(int anEnd, int start, int dbEnd, int dbStart);
 
     static void updateResultByRescoringBacktrace(const char *querySeq, const char *targetSeq, const char **subMat, EvalueComputation &evaluer,
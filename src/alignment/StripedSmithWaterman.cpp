@@ -30,24 +30,39 @@
 #include "Util.h"
 #include "SubstitutionMatrix.h"
 #include "Debug.h"
+#include "ProfileReport.h"
 #include <iostream>
 
 SmithWaterman::SmithWaterman(size_t maxSequenceLength, int aaSize, bool aaBiasCorrection,
-                             float aaBiasCorrectionScale, int targetSeqType) {
+                             float aaBiasCorrectionScale, int targetSeqType) : simdKernels(SimdDispatch::kernels()) {
 	maxSequenceLength += 1;
     this->aaBiasCorrectionScale = aaBiasCorrectionScale;
 	this->aaBiasCorrection = aaBiasCorrection;
 
 	int segmentSize = (maxSequenceLength+7)/8;
+	if (simdKernels.swByte != NULL) {
+		// the SimdDispatch kernels share the DP columns and reverse profiles, which hold swWordElements words per vector there
+		const size_t wordElements = simdKernels.swWordElements;
+		segmentSize = std::max(segmentSize, (int) (((maxSequenceLength + wordElements - 1) / wordElements) * wordElements * 2 / sizeof(simd_int)));
+	}
     segSize = segmentSize;
-	vHStore = (simd_int*) mem_align(ALIGN_INT, segSize * sizeof(simd_int));
-	vHLoad  = (simd_int*) mem_align(ALIGN_INT, segSize * sizeof(simd_int));
-	vE      = (simd_int*) mem_align(ALIGN_INT, segSize * sizeof(simd_int));
-	vHmax   = (simd_int*) mem_align(ALIGN_INT, segSize * sizeof(simd_int));
+	vHStore = (simd_int*) mem_align(MAX_ALIGN_INT, segSize * sizeof(simd_int));
+	vHLoad  = (simd_int*) mem_align(MAX_ALIGN_INT, segSize * sizeof(simd_int));
+	vE      = (simd_int*) mem_align(MAX_ALIGN_INT, segSize * sizeof(simd_int));
+	vHmax   = (simd_int*) mem_align(MAX_ALIGN_INT, segSize * sizeof(simd_int));
 
 	// setting up target
 	target_profile_byte = (simd_int*) mem_align(ALIGN_INT, aaSize * segSize * sizeof(simd_int));
 
+	// inter-sequence batch
+	batch_profile = (simd_int*) mem_align(ALIGN_INT, 32 * 32);
+	batch_column = (simd_int*) mem_align(ALIGN_INT, BATCH_COLUMNS * 32 * sizeof(simd_int));
+	hasCompositionBias = false;
+	batch_target = (uint8_t*) mem_align(ALIGN_INT, (maxSequenceLength + BATCH_COLUMNS) * BATCH_SIZE);
+	batch_H = (simd_int*) mem_align(ALIGN_INT, maxSequenceLength * sizeof(simd_int));
+	batch_E = (simd_int*) mem_align(ALIGN_INT, maxSequenceLength * sizeof(simd_int));
+	memset(batch_length, 0, sizeof(batch_length));
+
 
     isTargetProfile = Parameters::isEqualDbtype(targetSeqType, Parameters::DBTYPE_HMM_PROFILE);
     isQueryProfile = false;
@@ -57,8 +72,14 @@ SmithWaterman::SmithWaterman(size_t maxSequenceLength, int aaSize, bool aaBiasCo
 	// query profile
 	profile->profile_byte = (simd_int*)mem_align(ALIGN_INT, aaSize * segSize * sizeof(simd_int));
 	profile->profile_word = (simd_int*)mem_align(ALIGN_INT, aaSize * segSize * sizeof(simd_int));
-    profile->profile_rev_byte = (simd_int*)mem_align(ALIGN_INT, aaSize * segSize * sizeof(simd_int));
-    profile->profile_rev_word = (simd_int*)mem_align(ALIGN_INT, aaSize * segSize * sizeof(simd_int));
+    profile->profile_rev_byte = (simd_int*)mem_align(MAX_ALIGN_INT, aaSize * segSize * sizeof(simd_int));
+    profile->profile_rev_word = (simd_int*)mem_align(MAX_ALIGN_INT, aaSize * segSize * sizeof(simd_int));
+    profile->profile_wide_byte = NULL;
+    profile->profile_wide_word = NULL;
+    if (simdKernels.swByte != NULL) {
+        profile->profile_wide_byte = (simd_int*)mem_align(MAX_ALIGN_INT, aaSize * segSize * sizeof(simd_int));
+        profile->profile_wide_word = (simd_int*)mem_align(MAX_ALIGN_INT, aaSize * segSize * sizeof(simd_int));
+    }
     profile->profile_gDelOpen_byte = (simd_int*)mem_align(ALIGN_INT, segSize * sizeof(simd_int));
     profile->profile_gDelOpen_word = (simd_int*)mem_align(ALIGN_INT, segSize * sizeof(simd_int));
     profile->profile_gDelClose_byte = (simd_int*)mem_align(ALIGN_INT, segSize * sizeof(simd_int));
@@ -112,10 +133,17 @@ SmithWaterman::~SmithWaterman(){
 	free(vE);
 	free(vHmax);
 	free(target_profile_byte);
+	free(batch_profile);
+	free(batch_column);
+	free(batch_target);
+	free(batch_H);
+	free(batch_E);
 	free(profile->profile_byte);
 	free(profile->profile_word);
 	free(profile->profile_rev_byte);
 	free(profile->profile_rev_word);
+	free(profile->profile_wide_byte);
+	free(profile->profile_wide_word);
 	free(profile->consens_byte);
 	free(profile->consens_word);
 	free(profile->consens_rev_byte);
@@ -182,6 +210,22 @@ void SmithWaterman::createQueryProfile(simd_int *profile, const int8_t *query_se
 	}
 }
 
+template <typename T>
+void SmithWaterman::createWideQueryProfile(simd_int *profile, const int8_t *query_sequence, const int8_t * composition_bias, const int8_t *mat,
+        const int32_t query_length, const int32_t aaSize, uint8_t bias, const int32_t offset, const int32_t elements) {
+    switch (elements) {
+        case 64:
+            createQueryProfile<T, 64, SUBSTITUTIONMATRIX>(profile, query_sequence, composition_bias, mat, query_length, aaSize, bias, offset, 0);
+            break;
+        case 32:
+            createQueryProfile<T, 32, SUBSTITUTIONMATRIX>(profile, query_sequence, composition_bias, mat, query_length, aaSize, bias, offset, 0);
+            break;
+        default:
+            createQueryProfile<T, 16, SUBSTITUTIONMATRIX>(profile, query_sequence, composition_bias, mat, query_length, aaSize, bias, offset, 0);
+            break;
+    }
+}
+
 template <typename T, size_t Elements>
 void SmithWaterman::createConsensProfile(simd_int *profile, const int8_t *consens_sequence, const int32_t query_length, const int32_t offset) {
     const int32_t segLen = (query_length + Elements - 1) / Elements;
@@ -333,6 +377,8 @@ s_align SmithWaterman::ssw_align_private (
     const int32_t db_n = db_length;
     const unsigned char * db_consens_seq = db_sequence;
     const int8_t *db_matrix = db_mat;
+    // sequence queries use the SimdDispatch kernels if available, their profiles are only built then
+    const bool useWideKernels = simdKernels.swByte != NULL && (type == SEQ_SEQ || type == SEQ_PROFILE);
 
     // find the alignment position
     if (profile->profile_byte) {
@@ -345,19 +391,31 @@ s_align SmithWaterman::ssw_align_private (
             profile->bias = std::max(db_bias, profile->bias);
             createTargetProfile(db_profile_byte, db_mat, db_length, profile->alphabetSize - 1, profile->bias);
         }
-        bests = sw_sse2_byte<type,posSpecificGaps>(db_sequence, db_profile_byte, 0, db_length, query_length, gap_open, gap_extend,
-                profile->profile_byte, profile->consens_byte, profile->profile_gDelOpen_byte, profile->profile_gDelClose_byte,
-                profile->profile_gIns_byte, UCHAR_MAX, profile->bias, maskLen);
+        if (useWideKernels) {
+            bests = sw_wide_byte(db_sequence, 0, db_length, query_length, gap_open, gap_extend,
+                                 profile->profile_wide_byte, UCHAR_MAX, profile->bias, maskLen);
+        } else {
+            bests = sw_sse2_byte<type,posSpecificGaps>(db_sequence, db_profile_byte, 0, db_length, query_length, gap_open, gap_extend,
+                    profile->profile_byte, profile->consens_byte, profile->profile_gDelOpen_byte, profile->profile_gDelClose_byte,
+                    profile->profile_gIns_byte, UCHAR_MAX, profile->bias, maskLen);
+        }
         if (bests.first.score == 255) {
-            bests = sw_sse2_word<type,posSpecificGaps>(db_sequence, db_profile_byte, 0, db_length, query_length, gap_open, gap_extend,
-                    profile->profile_word, profile->consens_word, profile->profile_gDelOpen_word, profile->profile_gDelClose_word,
-                    profile->profile_gIns_word, USHRT_MAX, profile->bias, maskLen);
+            if (useWideKernels) {
+                bests = sw_wide_word(db_sequence, 0, db_length, query_length, gap_open, gap_extend,
+                                     profile->profile_wide_word, USHRT_MAX, maskLen);
+            } else {
+                bests = sw_sse2_word<type,posSpecificGaps>(db_sequence, db_profile_byte, 0, db_length, query_length, gap_open, gap_extend,
+                        profile->profile_word, profile->consens_word, profile->profile_gDelOpen_word, profile->profile_gDelClose_word,
+                        profile->profile_gIns_word, USHRT_MAX, profile->bias, maskLen);
+            }
             word = 1;
         }
     } else {
         fprintf(stderr, "Please call the function ssw_init before ssw_align.\n");
         EXIT(EXIT_FAILURE);
     }
+    // the word pass recomputes the whole matrix after a byte overflow
+    ProfileReport::add(ProfileReport::SW_CELLS, static_cast<size_t>(query_length) * db_length * (word + 1));
 	r.score1 = bests.first.score;
 	r.dbEndPos1 = bests.first.ref;
 	r.qEndPos1 = bests.first.read;
@@ -395,6 +453,10 @@ s_align SmithWaterman::ssw_align_private (
                 createConsensProfile<int8_t, VECSIZE_INT * 4>(profile->consens_rev_byte, profile->query_consens_rev_sequence,
                                                               r.qEndPos1 + 1, queryOffset);
 	        }
+	    } else if (useWideKernels) {
+            createWideQueryProfile<int8_t>(profile->profile_rev_byte, profile->query_rev_sequence,
+                                           profile->composition_bias_rev, profile->mat, r.qEndPos1 + 1,
+                                           profile->alphabetSize, profile->bias, queryOffset, simdKernels.swByteElements);
 	    } else {
             createQueryProfile<int8_t, VECSIZE_INT * 4, SUBSTITUTIONMATRIX>(profile->profile_rev_byte,
                                                                             profile->query_rev_sequence,
@@ -403,10 +465,15 @@ s_align SmithWaterman::ssw_align_private (
                                                                             profile->alphabetSize, profile->bias,
                                                                             queryOffset, 0);
 	    }
-        bests_reverse = sw_sse2_byte<type,posSpecificGaps>(db_sequence, db_profile_byte, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open,
-                                           gap_extend, profile->profile_rev_byte, profile->consens_rev_byte,
-                                           profile->profile_gDelOpen_rev_byte, profile->profile_gDelClose_rev_byte,
-                                           profile->profile_gIns_rev_byte, r.score1, profile->bias, maskLen);
+        if (useWideKernels) {
+            bests_reverse = sw_wide_byte(db_sequence, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open, gap_extend,
+                                           profile->profile_rev_byte, r.score1, profile->bias, maskLen);
+        } else {
+            bests_reverse = sw_sse2_byte<type,posSpecificGaps>(db_sequence, db_profile_byte, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open,
+                                               gap_extend, profile->profile_rev_byte, profile->consens_rev_byte,
+                                               profile->profile_gDelOpen_rev_byte, profile->profile_gDelClose_rev_byte,
+                                               profile->profile_gIns_rev_byte, r.score1, profile->bias, maskLen);
+        }
 	} else {
         if (type == PROFILE_SEQ || type == PROFILE_PROFILE) {
             createQueryProfile<int16_t, VECSIZE_INT * 2, PROFILE>(profile->profile_rev_word,
@@ -423,6 +490,10 @@ s_align SmithWaterman::ssw_align_private (
                                                                profile->query_consens_rev_sequence,
                                                                r.qEndPos1 + 1, queryOffset);
             }
+        } else if (useWideKernels) {
+            createWideQueryProfile<int16_t>(profile->profile_rev_word, profile->query_rev_sequence,
+                                            profile->composition_bias_rev, profile->mat, r.qEndPos1 + 1,
+                                            profile->alphabetSize, 0, queryOffset, simdKernels.swWordElements);
         } else {
             createQueryProfile<int16_t, VECSIZE_INT * 2, SUBSTITUTIONMATRIX>(profile->profile_rev_word,
                                                                              profile->query_rev_sequence,
@@ -431,14 +502,21 @@ s_align SmithWaterman::ssw_align_private (
                                                                              r.qEndPos1 + 1, profile->alphabetSize, 0,
                                                                              queryOffset, 0);
         }
-        bests_reverse = sw_sse2_word<type,posSpecificGaps>(db_sequence, db_profile_byte, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open,
-                                           gap_extend,
-                                           profile->profile_rev_word, profile->consens_rev_word,
-                                           profile->profile_gDelOpen_rev_word, profile->profile_gDelClose_rev_word,
-                                           profile->profile_gIns_rev_word, r.score1, profile->bias, maskLen);
+        if (useWideKernels) {
+            bests_reverse = sw_wide_word(db_sequence, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open, gap_extend,
+                                           profile->profile_rev_word, r.score1, maskLen);
+        } else {
+            bests_reverse = sw_sse2_word<type,posSpecificGaps>(db_sequence, db_profile_byte, 1, r.dbEndPos1 + 1, r.qEndPos1 + 1, gap_open,
+                                               gap_extend,
+                                               profile->profile_rev_word, profile->consens_rev_word,
+                                               profile->profile_gDelOpen_rev_word, profile->profile_gDelClose_rev_word,
+                                               profile->profile_gIns_rev_word, r.score1, profile->bias, maskLen);
+        }
     }
 
 
+    ProfileReport::add(ProfileReport::SW_CELLS, static_cast<size_t>(r.qEndPos1 + 1) * (r.dbEndPos1 + 1));
+
 	if(bests_reverse.first.score != r.score1){
         fprintf(stderr, "Score of forward/backward SW differ: %d %d. Q: %lu T: %lu.\n", r.score1, bests_reverse.first.score, query_id, target_id);
         fprintf(stderr, "Start: Q: %d, T: %d. End: Q: %d, T %d\n", r.qEndPos1 - bests_reverse.first.read, bests_reverse.first.ref, r.qEndPos1, r.dbEndPos1);
@@ -1156,6 +1234,32 @@ std::pair<SmithWaterman::alignment_end, SmithWaterman::alignment_end> SmithWater
 #undef max8
 }
 
+std::pair<SmithWaterman::alignment_end, SmithWaterman::alignment_end> SmithWaterman::sw_wide_byte(
+        const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length, int32_t query_length,
+        const uint8_t gap_open, const uint8_t gap_extend, const simd_int *query_profile_byte, uint8_t terminate,
+        uint8_t bias, int32_t maskLen) {
+    SimdDispatch::sw_buffers buffers = { vHStore, vHLoad, vE, vHmax, maxColumn };
+    SimdDispatch::alignment_end best, second;
+    simdKernels.swByte(db_sequence, ref_dir, db_length, query_length, gap_open, gap_extend,
+                       query_profile_byte, terminate, bias, maskLen, buffers, best, second);
+    alignment_end best0 = { best.score, best.ref, best.read };
+    alignment_end best1 = { second.score, second.ref, second.read };
+    return std::make_pair(best0, best1);
+}
+
+std::pair<SmithWaterman::alignment_end, SmithWaterman::alignment_end> SmithWaterman::sw_wide_word(
+        const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length, int32_t query_length,
+        const uint8_t gap_open, const uint8_t gap_extend, const simd_int *query_profile_word, uint16_t terminate,
+        int32_t maskLen) {
+    SimdDispatch::sw_buffers buffers = { vHStore, vHLoad, vE, vHmax, maxColumn };
+    SimdDispatch::alignment_end best, second;
+    simdKernels.swWord(db_sequence, ref_dir, db_length, query_length, gap_open, gap_extend,
+                       query_profile_word, terminate, maskLen, buffers, best, second);
+    alignment_end best0 = { best.score, best.ref, best.read };
+    alignment_end best1 = { second.score, second.ref, second.read };
+    return std::make_pair(best0, best1);
+}
+
 void SmithWaterman::ssw_init(const Sequence* q,
 							 const int8_t* mat,
 							 const BaseMatrix *m) {
@@ -1253,6 +1357,10 @@ void SmithWaterman::ssw_init(const Sequence* q,
         createQueryProfile<int8_t, VECSIZE_INT * 4, SUBSTITUTIONMATRIX>(profile->profile_byte, profile->query_sequence, profile->composition_bias, profile->mat, q->L, alphabetSize, bias, 0, 0);
         // create word version of query profile
         createQueryProfile<int16_t, VECSIZE_INT * 2, SUBSTITUTIONMATRIX>(profile->profile_word, profile->query_sequence, profile->composition_bias, profile->mat, q->L, alphabetSize, 0, 0, 0);
+        if (simdKernels.swByte != NULL) {
+            createWideQueryProfile<int8_t>(profile->profile_wide_byte, profile->query_sequence, profile->composition_bias, profile->mat, q->L, alphabetSize, bias, 0, simdKernels.swByteElements);
+            createWideQueryProfile<int16_t>(profile->profile_wide_word, profile->query_sequence, profile->composition_bias, profile->mat, q->L, alphabetSize, 0, 0, simdKernels.swWordElements);
+        }
         // create linear version of word profile
         for (int32_t i = 0; i< alphabetSize; i++) {
             profile->profile_word_linear[i] = &profile_word_linear_data[i*q->L];
@@ -1260,6 +1368,17 @@ void SmithWaterman::ssw_init(const Sequence* q,
                 profile->profile_word_linear[i][j] = mat[i * alphabetSize + q->numSequence[j]] + profile->composition_bias[j];
             }
         }
+        // create inter-sequence batch profile, one row of scores (indexed by target residue) per query residue
+        uint8_t *row = (uint8_t *) batch_profile;
+        for (int32_t j = 0; j < alphabetSize; j++) {
+            for (int32_t i = 0; i < 32; i++) {
+                *row++ = (i >= alphabetSize) ? 0 : mat[i * alphabetSize + j] + bias;
+            }
+        }
+        hasCompositionBias = false;
+        for (int i = 0; i < q->L; i++) {
+            hasCompositionBias |= (profile->composition_bias[i] != 0);
+        }
     }
 
 	// create reverse structures
@@ -1641,6 +1760,130 @@ inline F simd_hmax(const F * in, unsigned int n) {
     return current;
 }
 
+bool SmithWaterman::canAlignBatch() const {
+    return !isQueryProfile && !isTargetProfile && profile->alphabetSize <= BATCH_PAD;
+}
+
+void SmithWaterman::ssw_set_batch_target(size_t lane, const unsigned char *db_sequence, int32_t db_length) {
+    uint8_t *t = batch_target + lane;
+    for (int32_t i = 0; i < db_length; i++) {
+        *t = db_sequence[i];
+        t += BATCH_SIZE;
+    }
+    batch_length[lane] = db_length;
+}
+
+void SmithWaterman::ssw_score_batch(size_t count, const uint8_t gap_open, const uint8_t gap_extend, uint16_t *scores) {
+    // pad all lanes to the longest target rounded up to BATCH_COLUMNS, padded positions never improve a score
+    int32_t db_length = 0;
+    for (size_t lane = 0; lane < BATCH_SIZE; lane++) {
+        if (lane >= count) {
+            batch_length[lane] = 0;
+        }
+        db_length = std::max(db_length, batch_length[lane]);
+    }
+    db_length = (db_length + BATCH_COLUMNS - 1) / BATCH_COLUMNS * BATCH_COLUMNS;
+    for (size_t lane = 0; lane < BATCH_SIZE; lane++) {
+        for (int32_t i = batch_length[lane]; i < db_length; i++) {
+            batch_target[i * BATCH_SIZE + lane] = BATCH_PAD;
+        }
+    }
+
+    ProfileReport::add(ProfileReport::SW_CELLS, static_cast<size_t>(profile->query_length) * db_length * BATCH_SIZE);
+
+    uint8_t maxScore[BATCH_SIZE] __attribute__((aligned(ALIGN_INT)));
+    if (hasCompositionBias) {
+        sw_batch_byte<true>(db_length, gap_open, gap_extend, maxScore);
+    } else {
+        sw_batch_byte<false>(db_length, gap_open, gap_extend, maxScore);
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        scores[lane] = (maxScore[lane] + profile->bias >= 255) ? UCHAR_MAX : maxScore[lane];
+    }
+}
+
+template <const bool compositionBias>
+void SmithWaterman::sw_batch_byte(int32_t db_length, const uint8_t gap_open, const uint8_t gap_extend, uint8_t *maxScore) {
+    const int32_t query_length = profile->query_length;
+    const int32_t alphabetSize = profile->alphabetSize;
+    const int8_t *query_sequence = profile->query_sequence;
+    const int8_t *composition_bias = profile->composition_bias;
+
+    memset(batch_H, 0, query_length * sizeof(simd_int));
+    memset(batch_E, 0, query_length * sizeof(simd_int));
+
+    const simd_int vZero = simdi32_set(0);
+    const simd_int vGapO = simdi8_set(gap_open);
+    const simd_int vGapE = simdi8_set(gap_extend);
+    const simd_int vBias = simdi8_set(profile->bias);
+#ifndef AVX2
+    const simd_int fiveten = simdi8_set(15);
+#endif
+
+#define SW_BATCH_CELL(vH, vDiag, vF, score) \
+    vH = simdui8_subs(simdui8_adds(vDiag, score), vBias); \
+    vH = simdui8_max(vH, e); \
+    vH = simdui8_max(vH, vF); \
+    vMaxScore = simdui8_max(vMaxScore, vH); \
+    vTemp = simdui8_subs(vH, vGapO); \
+    e = simdui8_max(simdui8_subs(e, vGapE), vTemp); \
+    vF = simdui8_max(simdui8_subs(vF, vGapE), vTemp);
+
+    simd_int vMaxScore = vZero;
+    // BATCH_COLUMNS target positions are computed per pass over the query, only the H and E values
+    // of the last one have to be stored
+    for (int32_t i = 0; LIKELY(i < db_length); i += BATCH_COLUMNS) {
+        // scores of every query residue against the residues of all lanes at these target positions
+        for (int32_t c = 0; c < BATCH_COLUMNS; c++) {
+            const simd_int vTarget = simdi_load((simd_int *) (batch_target + (i + c) * BATCH_SIZE));
+            simd_int *column = batch_column + c * 32;
+#ifdef AVX2
+            for (int32_t a = 0; a < alphabetSize; a++) {
+                simdi_store(column + a, UngappedAlignment::Shuffle(simdi_load(batch_profile + a), vTarget));
+            }
+#else
+            const simd_int vUpper = _mm_cmpgt_epi8(vTarget, fiveten);
+            for (int32_t a = 0; a < alphabetSize; a++) {
+                simdi_store(column + a, simdi8_blend(_mm_shuffle_epi8(simdi_load(batch_profile + 2 * a), vTarget),
+                                                     _mm_shuffle_epi8(simdi_load(batch_profile + 2 * a + 1), vTarget), vUpper));
+            }
+#endif
+        }
+
+        simd_int vF0 = vZero, vF1 = vZero, vF2 = vZero, vF3 = vZero;
+        simd_int vDiag0 = vZero, vDiag1 = vZero, vDiag2 = vZero, vDiag3 = vZero;
+        simd_int vH0, vH1, vH2, vH3, vTemp;
+        for (int32_t j = 0; LIKELY(j < query_length); j++) {
+            const simd_int *vP = batch_column + query_sequence[j];
+            simd_int score0 = simdi_load(vP);
+            simd_int score1 = simdi_load(vP + 32);
+            simd_int score2 = simdi_load(vP + 64);
+            simd_int score3 = simdi_load(vP + 96);
+            if (compositionBias) {
+                const simd_int vCompBias = simdi8_set(composition_bias[j]);
+                score0 = simdi8_add(score0, vCompBias);
+                score1 = simdi8_add(score1, vCompBias);
+                score2 = simdi8_add(score2, vCompBias);
+                score3 = simdi8_add(score3, vCompBias);
+            }
+            simd_int e = simdi_load(batch_E + j);
+            const simd_int vHLeft = simdi_load(batch_H + j);
+            SW_BATCH_CELL(vH0, vDiag0, vF0, score0)
+            vDiag0 = vHLeft;
+            SW_BATCH_CELL(vH1, vDiag1, vF1, score1)
+            vDiag1 = vH0;
+            SW_BATCH_CELL(vH2, vDiag2, vF2, score2)
+            vDiag2 = vH1;
+            SW_BATCH_CELL(vH3, vDiag3, vF3, score3)
+            vDiag3 = vH2;
+            simdi_store(batch_H + j, vH3);
+            simdi_store(batch_E + j, e);
+        }
+    }
+#undef SW_BATCH_CELL
+    simdi_store((simd_int *) maxScore, vMaxScore);
+}
+
 int SmithWaterman::ungapped_alignment(const unsigned char *db_sequence, int32_t db_length) {
 #define SWAP(tmp, arg1, arg2) tmp = arg1; arg1 = arg2; arg2 = tmp;
 
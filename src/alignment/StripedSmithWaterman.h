@@ -41,6 +41,7 @@
 #endif
 
 #include "simd.h"
+#include "SimdDispatch.h"
 #include "BaseMatrix.h"
 
 #include "Sequence.h"
@@ -132,6 +133,9 @@ public:
         uint8_t bias;
         short ** profile_word_linear;
         simd_int *target_profile_byte;
+        // query profiles striped for the SimdDispatch kernels, NULL if they are not used
+        simd_int* profile_wide_byte;
+        simd_int* profile_wide_word;
     };
 
     // prints a __m128 vector containing 8 signed shorts
@@ -245,6 +249,19 @@ public:
 
     s_align scoreIdentical(unsigned char *dbSeq, int L, EvalueComputation * evaluer, int alignmentMode, std::string &backtrace);
 
+    // Inter-sequence (SWIPE) layout: every SIMD lane holds a different target, which are all aligned
+    // in one pass over the query. Only available for sequence-sequence alignments.
+    static const size_t BATCH_SIZE = VECSIZE_INT * 4;
+
+    bool canAlignBatch() const;
+
+    // copies a target into a lane of the next batch
+    void ssw_set_batch_target(size_t lane, const unsigned char *db_sequence, int32_t db_length);
+
+    // computes the optimal local alignment scores of the first count staged targets.
+    // A score is UCHAR_MAX if it does not fit into a byte, these targets have to be aligned with ssw_align.
+    void ssw_score_batch(size_t count, const uint8_t gap_open, const uint8_t gap_extend, uint16_t *scores);
+
     static void seq_reverse(int8_t * reverse, const int8_t* seq, int32_t end)	/* end is 0-based alignment ending position */
     {
         int32_t start = 0;
@@ -285,9 +302,24 @@ private:
     simd_int* target_profile_byte;
     int segSize;
 
+    // inter-sequence batch: 32 scores per query residue (indexed by target residue), the scores of the
+    // current target positions, the transposed targets (one byte per lane and target position) and the H and E columns
+    const static uint8_t BATCH_PAD = 31;
+    const static int32_t BATCH_COLUMNS = 4;
+    bool hasCompositionBias;
+    simd_int* batch_profile;
+    simd_int* batch_column;
+    uint8_t* batch_target;
+    int32_t batch_length[BATCH_SIZE];
+    simd_int* batch_H;
+    simd_int* batch_E;
+
     // needed for type checking query and target databases
     bool isTargetProfile, isQueryProfile;
 
+    // sequence queries are aligned with these kernels if they are set (see SimdDispatch)
+    const SimdDispatch::Kernels &simdKernels;
+
     typedef struct {
         uint16_t score;
         int32_t ref;	 //0-based position
@@ -359,6 +391,24 @@ private:
                                  uint16_t bias,
                                  int32_t maskLen);
 
+    // sw_sse2_byte and sw_sse2_word for sequence queries with the kernels of SimdDispatch,
+    // the query profiles have to be striped over swByteElements or swWordElements
+    std::pair<alignment_end, alignment_end> sw_wide_byte(const unsigned char *db_sequence, int8_t ref_dir,
+                                                         int32_t db_length, int32_t query_length,
+                                                         const uint8_t gap_open, const uint8_t gap_extend,
+                                                         const simd_int *query_profile_byte, uint8_t terminate,
+                                                         uint8_t bias, int32_t maskLen);
+
+    std::pair<alignment_end, alignment_end> sw_wide_word(const unsigned char *db_sequence, int8_t ref_dir,
+                                                         int32_t db_length, int32_t query_length,
+                                                         const uint8_t gap_open, const uint8_t gap_extend,
+                                                         const simd_int *query_profile_word, uint16_t terminate,
+                                                         int32_t maskLen);
+
+    // Inter-sequence Smith-Waterman over the staged batch, one target per lane
+    template <const bool compositionBias>
+    void sw_batch_byte(int32_t db_length, const uint8_t gap_open, const uint8_t gap_extend, uint8_t *maxScore);
+
     template <const unsigned int type, const bool posSpecificGaps>
     SmithWaterman::cigar *banded_sw(const unsigned char *db_sequence, const int8_t *query_sequence,
                                     const int8_t *query_consens_sequence, const int8_t * compositionBias,
@@ -385,6 +435,11 @@ private:
     void createQueryProfile(simd_int *profile, const int8_t *query_sequence, const int8_t * composition_bias,
             const int8_t *mat, const int32_t query_length, const int32_t aaSize, uint8_t bias, const int32_t offset, const int32_t entryLength);
 
+    // createQueryProfile for a substitution matrix with the element count of a SimdDispatch kernel
+    template <typename T>
+    void createWideQueryProfile(simd_int *profile, const int8_t *query_sequence, const int8_t * composition_bias,
+            const int8_t *mat, const int32_t query_length, const int32_t aaSize, uint8_t bias, const int32_t offset, const int32_t elements);
+
     float *tmp_composition_bias;
     int8_t * scorePerCol;
     short * profile_word_linear_data;
@@ -0,0 +1,320 @@
+// Striped Smith-Waterman (Farrar) with 256-bit vectors, mirrors SmithWaterman::sw_sse2_byte/sw_sse2_word
+#include "StripedSmithWatermanAVX2.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+namespace {
+// shift the whole vector left by N bytes, shifting in zeros
+template <int N>
+inline __m256i shiftLeft(const __m256i a) {
+    // lower lane moved up with a zero lane 0, alignr then takes the top bytes of the lower lane
+    const __m256i lower = _mm256_permute2x128_si256(a, a, _MM_SHUFFLE(0, 0, 3, 0));
+    return _mm256_alignr_epi8(a, lower, 16 - N);
+}
+
+inline uint8_t hmax8(const __m256i v) {
+    __m128i v128 = _mm_max_epu8(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 8));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 4));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 2));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 1));
+    return static_cast<uint8_t>(_mm_cvtsi128_si32(v128));
+}
+
+inline uint16_t hmax16(const __m256i v) {
+    __m128i v128 = _mm_max_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 8));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 4));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 2));
+    return static_cast<uint16_t>(_mm_cvtsi128_si32(v128));
+}
+
+// one bit per byte, all bits set if every byte is equal
+const uint32_t ALL_EQUAL = 0xFFFFFFFF;
+
+inline uint32_t equalMask8(const __m256i a, const __m256i b) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+}
+
+inline uint32_t equalMask16(const __m256i a, const __m256i b) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+}
+}
+
+void StripedSmithWatermanAVX2::sw_byte(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                         int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                         const void *query_profile_byte, uint8_t terminate, uint8_t bias,
+                                         int32_t maskLen, buffers_t &buffers, alignment_end &best,
+                                         alignment_end &second) {
+    uint8_t max = 0;
+    int32_t end_query = query_length - 1;
+    int32_t end_db = -1;
+    const int32_t segLen = (query_length + BYTE_ELEMENTS - 1) / BYTE_ELEMENTS;
+    uint8_t *maxColumn = buffers.maxColumn;
+    memset(maxColumn, 0, db_length * sizeof(uint8_t));
+
+    __m256i *pvHStore = (__m256i *) buffers.hStore;
+    __m256i *pvHLoad = (__m256i *) buffers.hLoad;
+    __m256i *pvE = (__m256i *) buffers.e;
+    __m256i *pvHmax = (__m256i *) buffers.hMax;
+    memset(pvHStore, 0, segLen * sizeof(__m256i));
+    memset(pvHLoad, 0, segLen * sizeof(__m256i));
+    memset(pvE, 0, segLen * sizeof(__m256i));
+    memset(pvHmax, 0, segLen * sizeof(__m256i));
+
+    const __m256i vZero = _mm256_setzero_si256();
+    const __m256i vGapO = _mm256_set1_epi8(gap_open);
+    const __m256i vGapE = _mm256_set1_epi8(gap_extend);
+    const __m256i vBias = _mm256_set1_epi8(bias);
+    __m256i vMaxScore = vZero;
+    __m256i vMaxMark = vZero;
+
+    int32_t i, j, begin = 0, end = db_length, step = 1;
+    if (ref_dir == 1) {
+        begin = db_length - 1;
+        end = -1;
+        step = -1;
+    }
+
+    const __m256i *profile = (const __m256i *) query_profile_byte;
+    for (i = begin; i != end; i += step) {
+        __m256i e, vF = vZero, vMaxColumn = vZero;
+        __m256i vH = shiftLeft<1>(_mm256_load_si256(pvHStore + segLen - 1));
+        const __m256i *vP = profile + db_sequence[i] * segLen;
+
+        __m256i *pv = pvHLoad;
+        pvHLoad = pvHStore;
+        pvHStore = pv;
+
+        for (j = 0; j < segLen; ++j) {
+            vH = _mm256_adds_epu8(vH, _mm256_load_si256(vP + j));
+            vH = _mm256_subs_epu8(vH, vBias);
+
+            e = _mm256_load_si256(pvE + j);
+            vH = _mm256_max_epu8(vH, e);
+            vH = _mm256_max_epu8(vH, vF);
+            vMaxColumn = _mm256_max_epu8(vMaxColumn, vH);
+            _mm256_store_si256(pvHStore + j, vH);
+
+            vH = _mm256_subs_epu8(vH, vGapO);
+            e = _mm256_subs_epu8(e, vGapE);
+            e = _mm256_max_epu8(e, vH);
+            _mm256_store_si256(pvE + j, e);
+
+            vF = _mm256_subs_epu8(vF, vGapE);
+            vF = _mm256_max_epu8(vF, vH);
+
+            vH = _mm256_load_si256(pvHLoad + j);
+        }
+
+        // Lazy_F loop, disallows adjacent insertion and then deletion
+        j = 0;
+        vH = _mm256_load_si256(pvHStore + j);
+        vF = shiftLeft<1>(vF);
+        // vF > vH - gap_open in any byte
+        uint32_t cmp = equalMask8(_mm256_subs_epu8(vF, _mm256_subs_epu8(vH, vGapO)), vZero);
+        while (cmp != ALL_EQUAL) {
+            vH = _mm256_max_epu8(vH, vF);
+            vMaxColumn = _mm256_max_epu8(vMaxColumn, vH);
+            _mm256_store_si256(pvHStore + j, vH);
+
+            vF = _mm256_subs_epu8(vF, vGapE);
+            j++;
+            if (j >= segLen) {
+                j = 0;
+                vF = shiftLeft<1>(vF);
+            }
+            vH = _mm256_load_si256(pvHStore + j);
+            cmp = equalMask8(_mm256_subs_epu8(vF, _mm256_subs_epu8(vH, vGapO)), vZero);
+        }
+
+        vMaxScore = _mm256_max_epu8(vMaxScore, vMaxColumn);
+        if (equalMask8(vMaxMark, vMaxScore) != ALL_EQUAL) {
+            vMaxMark = vMaxScore;
+            const uint8_t temp = hmax8(vMaxScore);
+            if (temp > max) {
+                max = temp;
+                if (max + bias >= 255) {
+                    break;
+                }
+                end_db = i;
+                // column with the highest score to trace the ending position on the query
+                for (j = 0; j < segLen; ++j) {
+                    pvHmax[j] = pvHStore[j];
+                }
+            }
+        }
+
+        maxColumn[i] = hmax8(vMaxColumn);
+        if (maxColumn[i] == terminate) {
+            break;
+        }
+    }
+
+    const uint8_t *t = (const uint8_t *) pvHmax;
+    const int32_t column_len = segLen * BYTE_ELEMENTS;
+    for (i = 0; i < column_len; ++i) {
+        if (t[i] == max) {
+            const int32_t temp = i / BYTE_ELEMENTS + i % BYTE_ELEMENTS * segLen;
+            if (temp < end_query) {
+                end_query = temp;
+            }
+        }
+    }
+
+    best.score = max + bias >= 255 ? 255 : max;
+    best.ref = end_db;
+    best.read = end_query;
+
+    second.score = 0;
+    second.ref = 0;
+    second.read = 0;
+    int32_t edge = (end_db - maskLen) > 0 ? (end_db - maskLen) : 0;
+    for (i = 0; i < edge; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+    edge = (end_db + maskLen) > db_length ? db_length : (end_db + maskLen);
+    for (i = edge + 1; i < db_length; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+}
+
+void StripedSmithWatermanAVX2::sw_word(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                         int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                         const void *query_profile_word, uint16_t terminate, int32_t maskLen,
+                                         buffers_t &buffers, alignment_end &best, alignment_end &second) {
+    uint16_t max = 0;
+    int32_t end_read = query_length - 1;
+    int32_t end_ref = 0;
+    const int32_t segLen = (query_length + WORD_ELEMENTS - 1) / WORD_ELEMENTS;
+    uint16_t *maxColumn = (uint16_t *) buffers.maxColumn;
+    memset(maxColumn, 0, db_length * sizeof(uint16_t));
+
+    __m256i *pvHStore = (__m256i *) buffers.hStore;
+    __m256i *pvHLoad = (__m256i *) buffers.hLoad;
+    __m256i *pvE = (__m256i *) buffers.e;
+    __m256i *pvHmax = (__m256i *) buffers.hMax;
+    memset(pvHStore, 0, segLen * sizeof(__m256i));
+    memset(pvHLoad, 0, segLen * sizeof(__m256i));
+    memset(pvE, 0, segLen * sizeof(__m256i));
+    memset(pvHmax, 0, segLen * sizeof(__m256i));
+
+    const __m256i vZero = _mm256_setzero_si256();
+    const __m256i vGapO = _mm256_set1_epi16(gap_open);
+    const __m256i vGapE = _mm256_set1_epi16(gap_extend);
+    __m256i vMaxScore = vZero;
+    __m256i vMaxMark = vZero;
+
+    int32_t i, j, k, begin = 0, end = db_length, step = 1;
+    if (ref_dir == 1) {
+        begin = db_length - 1;
+        end = -1;
+        step = -1;
+    }
+
+    const __m256i *profile = (const __m256i *) query_profile_word;
+    for (i = begin; i != end; i += step) {
+        __m256i e, vF = vZero, vMaxColumn = vZero;
+        __m256i vH = shiftLeft<2>(_mm256_load_si256(pvHStore + segLen - 1));
+        const __m256i *vP = profile + db_sequence[i] * segLen;
+
+        __m256i *pv = pvHLoad;
+        pvHLoad = pvHStore;
+        pvHStore = pv;
+
+        for (j = 0; j < segLen; ++j) {
+            vH = _mm256_adds_epi16(vH, _mm256_load_si256(vP + j));
+
+            e = _mm256_load_si256(pvE + j);
+            vH = _mm256_max_epi16(vH, e);
+            vH = _mm256_max_epi16(vH, vF);
+            vMaxColumn = _mm256_max_epi16(vMaxColumn, vH);
+            _mm256_store_si256(pvHStore + j, vH);
+
+            vH = _mm256_subs_epu16(vH, vGapO);
+            e = _mm256_subs_epu16(e, vGapE);
+            e = _mm256_max_epi16(e, vH);
+            _mm256_store_si256(pvE + j, e);
+
+            vF = _mm256_subs_epu16(vF, vGapE);
+            vF = _mm256_max_epi16(vF, vH);
+
+            vH = _mm256_load_si256(pvHLoad + j);
+        }
+
+        // Lazy_F loop, disallows adjacent insertion and then deletion
+        for (k = 0; k < WORD_ELEMENTS; ++k) {
+            vF = shiftLeft<2>(vF);
+            for (j = 0; j < segLen; ++j) {
+                vH = _mm256_load_si256(pvHStore + j);
+                vH = _mm256_max_epi16(vH, vF);
+                vMaxColumn = _mm256_max_epi16(vMaxColumn, vH);
+                _mm256_store_si256(pvHStore + j, vH);
+                vH = _mm256_subs_epu16(vH, vGapO);
+                vF = _mm256_subs_epu16(vF, vGapE);
+                if (_mm256_movemask_epi8(_mm256_cmpgt_epi16(vF, vH)) == 0) {
+                    goto end;
+                }
+            }
+        }
+
+        end:
+        vMaxScore = _mm256_max_epi16(vMaxScore, vMaxColumn);
+        if (equalMask16(vMaxMark, vMaxScore) != ALL_EQUAL) {
+            vMaxMark = vMaxScore;
+            const uint16_t temp = hmax16(vMaxScore);
+            if (temp > max) {
+                max = temp;
+                end_ref = i;
+                for (j = 0; j < segLen; ++j) {
+                    pvHmax[j] = pvHStore[j];
+                }
+            }
+        }
+
+        maxColumn[i] = hmax16(vMaxColumn);
+        if (maxColumn[i] == terminate) {
+            break;
+        }
+    }
+
+    const uint16_t *t = (const uint16_t *) pvHmax;
+    const int32_t column_len = segLen * WORD_ELEMENTS;
+    for (i = 0; i < column_len; ++i) {
+        if (t[i] == max) {
+            const int32_t temp = i / WORD_ELEMENTS + i % WORD_ELEMENTS * segLen;
+            if (temp < end_read) {
+                end_read = temp;
+            }
+        }
+    }
+
+    best.score = max;
+    best.ref = end_ref;
+    best.read = end_read;
+
+    second.score = 0;
+    second.ref = 0;
+    second.read = 0;
+    int32_t edge = (end_ref - maskLen) > 0 ? (end_ref - maskLen) : 0;
+    for (i = 0; i < edge; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+    edge = (end_ref + maskLen) > db_length ? db_length : (end_ref + maskLen);
+    for (i = edge; i < db_length; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef STRIPED_SMITH_WATERMAN_AVX2_H
+#define STRIPED_SMITH_WATERMAN_AVX2_H
+
+// 256-bit versions of SmithWaterman::sw_sse2_byte and sw_sse2_word for sequence queries with
+// global gap penalties. This translation unit is compiled with AVX2 code generation, so it must
+// not include headers with inline code and is only called through SimdDispatch::kernels().
+// Query profiles are striped over 32 (byte) or 16 (word) elements, all buffers are 32 byte aligned.
+#include "SimdDispatch.h"
+
+class StripedSmithWatermanAVX2 {
+public:
+    static const int32_t BYTE_ELEMENTS = 32;
+    static const int32_t WORD_ELEMENTS = 16;
+
+    typedef SimdDispatch::alignment_end alignment_end;
+    typedef SimdDispatch::sw_buffers buffers_t;
+
+    static void sw_byte(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length, int32_t query_length,
+                        uint8_t gap_open, uint8_t gap_extend, const void *query_profile_byte, uint8_t terminate,
+                        uint8_t bias, int32_t maskLen, buffers_t &buffers, alignment_end &best, alignment_end &second);
+
+    static void sw_word(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length, int32_t query_length,
+                        uint8_t gap_open, uint8_t gap_extend, const void *query_profile_word, uint16_t terminate,
+                        int32_t maskLen, buffers_t &buffers, alignment_end &best, alignment_end &second);
+};
+
+#endif
@@ -0,0 +1,310 @@
+// Striped Smith-Waterman (Farrar) with 512-bit vectors, mirrors SmithWaterman::sw_sse2_byte/sw_sse2_word
+#include "StripedSmithWatermanAVX512.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+namespace {
+// shift the whole vector left by N bytes, shifting in zeros
+template <int N>
+inline __m512i shiftLeft(const __m512i a) {
+    // lanes moved up by 128 bit with a zero lane 0, alignr then takes the top bytes of the lower lane
+    const __m512i lower = _mm512_maskz_shuffle_i64x2(0xFC, a, a, 0x90);
+    return _mm512_alignr_epi8(a, lower, 16 - N);
+}
+
+inline uint8_t hmax8(const __m512i v) {
+    const __m256i v256 = _mm256_max_epu8(_mm512_maskz_extracti64x4_epi64(0xFF, v, 0), _mm512_maskz_extracti64x4_epi64(0xFF, v, 1));
+    __m128i v128 = _mm_max_epu8(_mm256_castsi256_si128(v256), _mm256_extracti128_si256(v256, 1));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 8));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 4));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 2));
+    v128 = _mm_max_epu8(v128, _mm_srli_si128(v128, 1));
+    return static_cast<uint8_t>(_mm_cvtsi128_si32(v128));
+}
+
+inline uint16_t hmax16(const __m512i v) {
+    const __m256i v256 = _mm256_max_epi16(_mm512_maskz_extracti64x4_epi64(0xFF, v, 0), _mm512_maskz_extracti64x4_epi64(0xFF, v, 1));
+    __m128i v128 = _mm_max_epi16(_mm256_castsi256_si128(v256), _mm256_extracti128_si256(v256, 1));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 8));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 4));
+    v128 = _mm_max_epi16(v128, _mm_srli_si128(v128, 2));
+    return static_cast<uint16_t>(_mm_cvtsi128_si32(v128));
+}
+}
+
+void StripedSmithWatermanAVX512::sw_byte(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                         int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                         const void *query_profile_byte, uint8_t terminate, uint8_t bias,
+                                         int32_t maskLen, buffers_t &buffers, alignment_end &best,
+                                         alignment_end &second) {
+    uint8_t max = 0;
+    int32_t end_query = query_length - 1;
+    int32_t end_db = -1;
+    const int32_t segLen = (query_length + BYTE_ELEMENTS - 1) / BYTE_ELEMENTS;
+    uint8_t *maxColumn = buffers.maxColumn;
+    memset(maxColumn, 0, db_length * sizeof(uint8_t));
+
+    __m512i *pvHStore = (__m512i *) buffers.hStore;
+    __m512i *pvHLoad = (__m512i *) buffers.hLoad;
+    __m512i *pvE = (__m512i *) buffers.e;
+    __m512i *pvHmax = (__m512i *) buffers.hMax;
+    memset(pvHStore, 0, segLen * sizeof(__m512i));
+    memset(pvHLoad, 0, segLen * sizeof(__m512i));
+    memset(pvE, 0, segLen * sizeof(__m512i));
+    memset(pvHmax, 0, segLen * sizeof(__m512i));
+
+    const __m512i vZero = _mm512_setzero_si512();
+    const __m512i vGapO = _mm512_set1_epi8(gap_open);
+    const __m512i vGapE = _mm512_set1_epi8(gap_extend);
+    const __m512i vBias = _mm512_set1_epi8(bias);
+    __m512i vMaxScore = vZero;
+    __m512i vMaxMark = vZero;
+
+    int32_t i, j, begin = 0, end = db_length, step = 1;
+    if (ref_dir == 1) {
+        begin = db_length - 1;
+        end = -1;
+        step = -1;
+    }
+
+    const __m512i *profile = (const __m512i *) query_profile_byte;
+    for (i = begin; i != end; i += step) {
+        __m512i e, vF = vZero, vMaxColumn = vZero;
+        __m512i vH = shiftLeft<1>(_mm512_load_si512(pvHStore + segLen - 1));
+        const __m512i *vP = profile + db_sequence[i] * segLen;
+
+        __m512i *pv = pvHLoad;
+        pvHLoad = pvHStore;
+        pvHStore = pv;
+
+        for (j = 0; j < segLen; ++j) {
+            vH = _mm512_adds_epu8(vH, _mm512_load_si512(vP + j));
+            vH = _mm512_subs_epu8(vH, vBias);
+
+            e = _mm512_load_si512(pvE + j);
+            vH = _mm512_max_epu8(vH, e);
+            vH = _mm512_max_epu8(vH, vF);
+            vMaxColumn = _mm512_max_epu8(vMaxColumn, vH);
+            _mm512_store_si512(pvHStore + j, vH);
+
+            vH = _mm512_subs_epu8(vH, vGapO);
+            e = _mm512_subs_epu8(e, vGapE);
+            e = _mm512_max_epu8(e, vH);
+            _mm512_store_si512(pvE + j, e);
+
+            vF = _mm512_subs_epu8(vF, vGapE);
+            vF = _mm512_max_epu8(vF, vH);
+
+            vH = _mm512_load_si512(pvHLoad + j);
+        }
+
+        // Lazy_F loop, disallows adjacent insertion and then deletion
+        j = 0;
+        vH = _mm512_load_si512(pvHStore + j);
+        vF = shiftLeft<1>(vF);
+        __mmask64 cmp = _mm512_cmpgt_epu8_mask(vF, _mm512_subs_epu8(vH, vGapO));
+        while (cmp != 0) {
+            vH = _mm512_max_epu8(vH, vF);
+            vMaxColumn = _mm512_max_epu8(vMaxColumn, vH);
+            _mm512_store_si512(pvHStore + j, vH);
+
+            vF = _mm512_subs_epu8(vF, vGapE);
+            j++;
+            if (j >= segLen) {
+                j = 0;
+                vF = shiftLeft<1>(vF);
+            }
+            vH = _mm512_load_si512(pvHStore + j);
+            cmp = _mm512_cmpgt_epu8_mask(vF, _mm512_subs_epu8(vH, vGapO));
+        }
+
+        vMaxScore = _mm512_max_epu8(vMaxScore, vMaxColumn);
+        if (_mm512_cmpneq_epu8_mask(vMaxMark, vMaxScore) != 0) {
+            vMaxMark = vMaxScore;
+            const uint8_t temp = hmax8(vMaxScore);
+            if (temp > max) {
+                max = temp;
+                if (max + bias >= 255) {
+                    break;
+                }
+                end_db = i;
+                // column with the highest score to trace the ending position on the query
+                for (j = 0; j < segLen; ++j) {
+                    pvHmax[j] = pvHStore[j];
+                }
+            }
+        }
+
+        maxColumn[i] = hmax8(vMaxColumn);
+        if (maxColumn[i] == terminate) {
+            break;
+        }
+    }
+
+    const uint8_t *t = (const uint8_t *) pvHmax;
+    const int32_t column_len = segLen * BYTE_ELEMENTS;
+    for (i = 0; i < column_len; ++i) {
+        if (t[i] == max) {
+            const int32_t temp = i / BYTE_ELEMENTS + i % BYTE_ELEMENTS * segLen;
+            if (temp < end_query) {
+                end_query = temp;
+            }
+        }
+    }
+
+    best.score = max + bias >= 255 ? 255 : max;
+    best.ref = end_db;
+    best.read = end_query;
+
+    second.score = 0;
+    second.ref = 0;
+    second.read = 0;
+    int32_t edge = (end_db - maskLen) > 0 ? (end_db - maskLen) : 0;
+    for (i = 0; i < edge; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+    edge = (end_db + maskLen) > db_length ? db_length : (end_db + maskLen);
+    for (i = edge + 1; i < db_length; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+}
+
+void StripedSmithWatermanAVX512::sw_word(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                         int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                         const void *query_profile_word, uint16_t terminate, int32_t maskLen,
+                                         buffers_t &buffers, alignment_end &best, alignment_end &second) {
+    uint16_t max = 0;
+    int32_t end_read = query_length - 1;
+    int32_t end_ref = 0;
+    const int32_t segLen = (query_length + WORD_ELEMENTS - 1) / WORD_ELEMENTS;
+    uint16_t *maxColumn = (uint16_t *) buffers.maxColumn;
+    memset(maxColumn, 0, db_length * sizeof(uint16_t));
+
+    __m512i *pvHStore = (__m512i *) buffers.hStore;
+    __m512i *pvHLoad = (__m512i *) buffers.hLoad;
+    __m512i *pvE = (__m512i *) buffers.e;
+    __m512i *pvHmax = (__m512i *) buffers.hMax;
+    memset(pvHStore, 0, segLen * sizeof(__m512i));
+    memset(pvHLoad, 0, segLen * sizeof(__m512i));
+    memset(pvE, 0, segLen * sizeof(__m512i));
+    memset(pvHmax, 0, segLen * sizeof(__m512i));
+
+    const __m512i vZero = _mm512_setzero_si512();
+    const __m512i vGapO = _mm512_set1_epi16(gap_open);
+    const __m512i vGapE = _mm512_set1_epi16(gap_extend);
+    __m512i vMaxScore = vZero;
+    __m512i vMaxMark = vZero;
+
+    int32_t i, j, k, begin = 0, end = db_length, step = 1;
+    if (ref_dir == 1) {
+        begin = db_length - 1;
+        end = -1;
+        step = -1;
+    }
+
+    const __m512i *profile = (const __m512i *) query_profile_word;
+    for (i = begin; i != end; i += step) {
+        __m512i e, vF = vZero, vMaxColumn = vZero;
+        __m512i vH = shiftLeft<2>(_mm512_load_si512(pvHStore + segLen - 1));
+        const __m512i *vP = profile + db_sequence[i] * segLen;
+
+        __m512i *pv = pvHLoad;
+        pvHLoad = pvHStore;
+        pvHStore = pv;
+
+        for (j = 0; j < segLen; ++j) {
+            vH = _mm512_adds_epi16(vH, _mm512_load_si512(vP + j));
+
+            e = _mm512_load_si512(pvE + j);
+            vH = _mm512_max_epi16(vH, e);
+            vH = _mm512_max_epi16(vH, vF);
+            vMaxColumn = _mm512_max_epi16(vMaxColumn, vH);
+            _mm512_store_si512(pvHStore + j, vH);
+
+            vH = _mm512_subs_epu16(vH, vGapO);
+            e = _mm512_subs_epu16(e, vGapE);
+            e = _mm512_max_epi16(e, vH);
+            _mm512_store_si512(pvE + j, e);
+
+            vF = _mm512_subs_epu16(vF, vGapE);
+            vF = _mm512_max_epi16(vF, vH);
+
+            vH = _mm512_load_si512(pvHLoad + j);
+        }
+
+        // Lazy_F loop, disallows adjacent insertion and then deletion
+        for (k = 0; k < WORD_ELEMENTS; ++k) {
+            vF = shiftLeft<2>(vF);
+            for (j = 0; j < segLen; ++j) {
+                vH = _mm512_load_si512(pvHStore + j);
+                vH = _mm512_max_epi16(vH, vF);
+                vMaxColumn = _mm512_max_epi16(vMaxColumn, vH);
+                _mm512_store_si512(pvHStore + j, vH);
+                vH = _mm512_subs_epu16(vH, vGapO);
+                vF = _mm512_subs_epu16(vF, vGapE);
+                if (_mm512_cmpgt_epi16_mask(vF, vH) == 0) {
+                    goto end;
+                }
+            }
+        }
+
+        end:
+        vMaxScore = _mm512_max_epi16(vMaxScore, vMaxColumn);
+        if (_mm512_cmpneq_epi16_mask(vMaxMark, vMaxScore) != 0) {
+            vMaxMark = vMaxScore;
+            const uint16_t temp = hmax16(vMaxScore);
+            if (temp > max) {
+                max = temp;
+                end_ref = i;
+                for (j = 0; j < segLen; ++j) {
+                    pvHmax[j] = pvHStore[j];
+                }
+            }
+        }
+
+        maxColumn[i] = hmax16(vMaxColumn);
+        if (maxColumn[i] == terminate) {
+            break;
+        }
+    }
+
+    const uint16_t *t = (const uint16_t *) pvHmax;
+    const int32_t column_len = segLen * WORD_ELEMENTS;
+    for (i = 0; i < column_len; ++i) {
+        if (t[i] == max) {
+            const int32_t temp = i / WORD_ELEMENTS + i % WORD_ELEMENTS * segLen;
+            if (temp < end_read) {
+                end_read = temp;
+            }
+        }
+    }
+
+    best.score = max;
+    best.ref = end_ref;
+    best.read = end_read;
+
+    second.score = 0;
+    second.ref = 0;
+    second.read = 0;
+    int32_t edge = (end_ref - maskLen) > 0 ? (end_ref - maskLen) : 0;
+    for (i = 0; i < edge; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+    edge = (end_ref + maskLen) > db_length ? db_length : (end_ref + maskLen);
+    for (i = edge; i < db_length; i++) {
+        if (maxColumn[i] > second.score) {
+            second.score = maxColumn[i];
+            second.ref = i;
+        }
+    }
+}
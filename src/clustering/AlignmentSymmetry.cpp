@@ -9,7 +9,9 @@
 #include "Util.h"
 #include "Debug.h"
 #include "FastSort.h"
+#include "ResultView.h"
 #include <cmath>
+#include <cstring>
 
 #ifdef OPENMP
 #include <omp.h>
@@ -17,6 +19,60 @@
 
 #define LEN(x, y) (x[y+1] - x[y])
 
+static unsigned int recordKey(const unsigned int &key) {
+    return key;
+}
+
+static unsigned int recordKey(const hit_t &hit) {
+    return hit.seqId;
+}
+
+template <int Column>
+static unsigned int recordKey(const AlignmentColumnRecord<Column> &record) {
+    return record.dbKey;
+}
+
+static unsigned short recordScore(const unsigned int &, int) {
+    return (unsigned short) (USHRT_MAX);
+}
+
+static unsigned short recordScore(const hit_t &hit, int) {
+    //column 1 = alignment score or sequence identity [0-100]
+    short sim = static_cast<short>(hit.prefScore);
+    return (unsigned short) (sim > 0 ? sim : -sim);
+}
+
+template <int Column>
+static unsigned short recordScore(const AlignmentColumnRecord<Column> &record, int) {
+    return record.score;
+}
+
+template <typename T>
+static void readInSet(ResultView<T> view, DBReader<unsigned int> *seqDbr, unsigned int *elements,
+                      unsigned short *scores, int scoretype, size_t setSize, size_t setId) {
+    size_t writePos = 0;
+    for (typename ResultView<T>::iterator it = view.begin(); it != view.end(); ++it) {
+        if (writePos >= setSize) {
+            Debug(Debug::ERROR) << "Set " << setId
+                                << " has more elements than allocated (" << setSize
+                                << ")!\n";
+            continue;
+        }
+        const unsigned int key = recordKey(*it);
+        const size_t currElement = seqDbr->getId(key);
+        if (scores != NULL) {
+            scores[writePos] = recordScore(*it, scoretype);
+        }
+        if (currElement == UINT_MAX || currElement > seqDbr->getSize()) {
+            Debug(Debug::ERROR) << "Element " << key
+                                << " contained in some alignment list, but not contained in the sequence database!\n";
+            EXIT(EXIT_FAILURE);
+        }
+        elements[writePos] = currElement;
+        writePos++;
+    }
+}
+
 void AlignmentSymmetry::readInData(DBReader<unsigned int>*alnDbr, DBReader<unsigned int>*seqDbr,
                                    unsigned int **elementLookupTable, unsigned short **elementScoreTable,
                                    int scoretype, size_t *offsets) {
@@ -40,9 +96,9 @@ void AlignmentSymmetry::readInData(DBReader<unsigned int>*alnDbr, DBReader<unsig
                 // seqDbr is descending sorted by length
                 // the assumption is that clustering is B -> B (not A -> B)
                 const unsigned int clusterId = seqDbr->getDbKey(i);
-                char *data = alnDbr->getDataByDBKey(clusterId, thread_idx);
+                ResultView<unsigned int> keys = ResultView<unsigned int>::fromReaderByKey(*alnDbr, clusterId, thread_idx);
 
-                if (*data == '\0') { // check if file contains entry
+                if (keys.empty()) { // check if file contains entry
                     elementLookupTable[i][0] = seqDbr->getId(clusterId);
                     if (elementScoreTable != NULL) {
                         if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_ALIGNMENT_RES)) {
@@ -64,55 +120,22 @@ void AlignmentSymmetry::readInData(DBReader<unsigned int>*alnDbr, DBReader<unsig
                     continue;
                 }
                 size_t setSize = LEN(offsets, i);
-                size_t writePos = 0;
-                while (*data != '\0') {
-                    if (writePos >= setSize) {
-                        Debug(Debug::ERROR) << "Set " << i
-                                            << " has more elements than allocated (" << setSize
-                                            << ")!\n";
-                        continue;
+                if (elementScoreTable == NULL) {
+                    readInSet(keys, seqDbr, elementLookupTable[i], NULL, scoretype, setSize, i);
+                } else if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_ALIGNMENT_RES)) {
+                    if (scoretype == Parameters::APC_ALIGNMENTSCORE) {
+                        readInSet(keys.as<AlignmentScoreRecord>(), seqDbr, elementLookupTable[i], elementScoreTable[i], scoretype, setSize, i);
+                    } else {
+                        readInSet(keys.as<AlignmentIdentityRecord>(), seqDbr, elementLookupTable[i], elementScoreTable[i], scoretype, setSize, i);
                     }
-                    char similarity[255 + 1];
-                    char dbKey[255 + 1];
-                    Util::parseKey(data, dbKey);
-                    const unsigned int key = (unsigned int) strtoul(dbKey, NULL, 10);
-                    const size_t currElement = seqDbr->getId(key);
-                    if (elementScoreTable != NULL) {
-                        if (Parameters::isEqualDbtype(alnType,Parameters::DBTYPE_ALIGNMENT_RES)) {
-                            if (scoretype == Parameters::APC_ALIGNMENTSCORE) {
-                                //column 1 = alignment score
-                                Util::parseByColumnNumber(data, similarity, 1);
-                                elementScoreTable[i][writePos] = (unsigned short) (atof(similarity));
-                            } else {
-                                //column 2 = sequence identity [0-1]
-                                Util::parseByColumnNumber(data, similarity, 2);
-                                elementScoreTable[i][writePos] = (unsigned short) (atof(similarity) * 1000.0f);
-                            }
-                        }
-                        else if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_PREFILTER_RES) ||
-                                 Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_PREFILTER_REV_RES)) {
-                            //column 1 = alignment score or sequence identity [0-100]
-                            Util::parseByColumnNumber(data, similarity, 1);
-                            short sim = atoi(similarity);
-                            elementScoreTable[i][writePos] = (unsigned short) (sim >0 ? sim : -sim);
-                        }
-                        else if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_CLUSTER_RES)) {
-                            elementScoreTable[i][writePos] = (unsigned short) (USHRT_MAX);
-                        }
-                        else {
-                            Debug(Debug::ERROR) << "Alignment format is not supported!\n";
-                            EXIT(EXIT_FAILURE);
-                        }
-
-                    }
-                    if (currElement == UINT_MAX || currElement > seqDbr->getSize()) {
-                        Debug(Debug::ERROR) << "Element " << dbKey
-                                            << " contained in some alignment list, but not contained in the sequence database!\n";
-                        EXIT(EXIT_FAILURE);
-                    }
-                    elementLookupTable[i][writePos] = currElement;
-                    writePos++;
-                    data = Util::skipLine(data);
+                } else if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_PREFILTER_RES) ||
+                           Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_PREFILTER_REV_RES)) {
+                    readInSet(keys.as<hit_t>(), seqDbr, elementLookupTable[i], elementScoreTable[i], scoretype, setSize, i);
+                } else if (Parameters::isEqualDbtype(alnType, Parameters::DBTYPE_CLUSTER_RES)) {
+                    readInSet(keys, seqDbr, elementLookupTable[i], elementScoreTable[i], scoretype, setSize, i);
+                } else {
+                    Debug(Debug::ERROR) << "Alignment format is not supported!\n";
+                    EXIT(EXIT_FAILURE);
                 }
             }
         }
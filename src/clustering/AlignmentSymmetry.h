@@ -6,10 +6,62 @@
 #define MMSEQS_ALIGNMENTSYMMETRY_H
 #include <set>
 #include <list>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <Debug.h>
 #include <Util.h>
 
 #include "DBReader.h"
+#include "ResultView.h"
+
+// target key and a single score column of an alignment record, the remaining columns are not parsed
+// Column is Parameters::APC_ALIGNMENTSCORE (alignment score) or Parameters::APC_SEQID (sequence identity * 1000)
+template <int Column>
+struct AlignmentColumnRecord {
+    unsigned int dbKey;
+    unsigned short score;
+};
+
+typedef AlignmentColumnRecord<Parameters::APC_ALIGNMENTSCORE> AlignmentScoreRecord;
+typedef AlignmentColumnRecord<Parameters::APC_SEQID> AlignmentIdentityRecord;
+
+template <int Column>
+struct ResultRecordDecoder<AlignmentColumnRecord<Column> > {
+    static size_t binaryCount(const char *data, size_t length, int) {
+        return Matcher::getBinaryResultCount(data, length);
+    }
+
+    static void decodeText(const char *data, AlignmentColumnRecord<Column> &record, bool) {
+        record.dbKey = Util::fast_atoi<unsigned int>(data);
+        // the score is column 1 and the sequence identity column 2
+        const char *column = data;
+        for (int i = 0; i < Column; i++) {
+            column += Util::skipNoneWhitespace(column);
+            column += Util::skipWhitespace(column);
+        }
+        if (Column == Parameters::APC_ALIGNMENTSCORE) {
+            record.score = (unsigned short) (Util::fast_atoi<int>(column));
+        } else {
+            record.score = (unsigned short) (strtod(column, NULL) * 1000.0f);
+        }
+    }
+
+    static void decodeBinary(const char *data, size_t idx, AlignmentColumnRecord<Column> &record, int, bool) {
+        const char *entry = data + sizeof(unsigned int) + idx * sizeof(Matcher::binary_result_t);
+        memcpy(&record.dbKey, entry + offsetof(Matcher::binary_result_t, dbKey), sizeof(unsigned int));
+        if (Column == Parameters::APC_ALIGNMENTSCORE) {
+            int score;
+            memcpy(&score, entry + offsetof(Matcher::binary_result_t, score), sizeof(int));
+            record.score = (unsigned short) (score);
+        } else {
+            float seqId;
+            memcpy(&seqId, entry + offsetof(Matcher::binary_result_t, seqId), sizeof(float));
+            // same float truncation as Util::fastSeqIdToBuffer, so text and binary agree
+            record.score = (unsigned short) ((int) (seqId * 1000.0f));
+        }
+    }
+};
 
 class AlignmentSymmetry {
 public:
@@ -3,6 +3,7 @@
 #include "Debug.h"
 #include "AlignmentSymmetry.h"
 #include "Timer.h"
+#include "ResultView.h"
 
 #include <queue>
 #include <algorithm>
@@ -55,9 +56,8 @@ std::pair<unsigned int, unsigned int> * ClusteringAlgorithms::execute(int mode)
 #endif
 #pragma omp for schedule(dynamic, 10)
             for (size_t i = 0; i < alnDbr->getSize(); i++) {
-                const char *data = alnDbr->getData(i, thread_idx);
-                const size_t dataSize = alnDbr->getEntryLen(i);
-                elementCount += (*data == '\0') ? 1 : Util::countLines(data, dataSize);
+                ResultView<unsigned int> members = ResultView<unsigned int>::fromReader(*alnDbr, i, thread_idx);
+                elementCount += members.empty() ? 1 : members.size();
             }
         }
         unsigned int * elements = new(std::nothrow) unsigned int[elementCount];
@@ -294,12 +294,9 @@ void ClusteringAlgorithms::greedyIncrementalLowMem( unsigned int *assignedcluste
 
 
             const size_t alnId = alnDbr->getId(clusterKey);
-            char *data = alnDbr->getData(alnId, thread_idx);
-
-            while (*data != '\0') {
-                char dbKey[255 + 1];
-                Util::parseKey(data, dbKey);
-                const unsigned int key = (unsigned int) strtoul(dbKey, NULL, 10);
+            ResultView<unsigned int> members = ResultView<unsigned int>::fromReader(*alnDbr, alnId, thread_idx);
+            for (ResultView<unsigned int>::iterator it = members.begin(); it != members.end(); ++it) {
+                const unsigned int key = *it;
 
                 unsigned int currElement = seqDbr->getId(key);
                 unsigned int targetId;
@@ -310,11 +307,10 @@ void ClusteringAlgorithms::greedyIncrementalLowMem( unsigned int *assignedcluste
                 } while (!__atomic_compare_exchange(&assignedcluster[currElement],  &targetId,  &clusterId , false,  __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
                 if (currElement == UINT_MAX || currElement > seqDbr->getSize()) {
-                    Debug(Debug::ERROR) << "Element " << dbKey
+                    Debug(Debug::ERROR) << "Element " << key
                                         << " contained in some alignment list, but not contained in the sequence database!\n";
                     EXIT(EXIT_FAILURE);
                 }
-                data = Util::skipLine(data);
             }
         }
     }
@@ -345,9 +341,8 @@ void ClusteringAlgorithms::readInClusterData(unsigned int **elementLookupTable,
         for (size_t i = 0; i < dbSize; i++) {
             const unsigned int clusterId = seqDbr->getDbKey(i);
             const size_t alnId = alnDbr->getId(clusterId);
-            const char *data = alnDbr->getData(alnId, thread_idx);
-            const size_t dataSize = alnDbr->getEntryLen(alnId);
-            elementOffsets[i] = (*data == '\0') ? 1 : Util::countLines(data, dataSize);
+            ResultView<unsigned int> members = ResultView<unsigned int>::fromReader(*alnDbr, alnId, thread_idx);
+            elementOffsets[i] = members.empty() ? 1 : members.size();
         }
     }
 
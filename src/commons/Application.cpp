@@ -4,6 +4,7 @@
 #include "DistanceCalculator.h"
 #include "FileUtil.h"
 #include "Timer.h"
+#include "SimdDispatch.h"
 
 #include <iomanip>
 
@@ -180,6 +181,12 @@ int shellcompletion(int argc, const char **argv) {
 }
 
 int main(int argc, const char **argv) {
+    if (SimdDispatch::cpuSupportsBaseline() == false) {
+        Debug(Debug::ERROR) << "This CPU does not support the instruction set " << tool_name << " was compiled for ("
+                            << SimdDispatch::baselineName() << " baseline). Build with -DRUNTIME_DISPATCH=1 for a binary that runs on all SSE4.1 CPUs\n";
+        EXIT(EXIT_FAILURE);
+    }
+
     if (argc < 2) {
         printUsage(false);
         return EXIT_SUCCESS;
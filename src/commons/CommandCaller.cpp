@@ -1,10 +1,12 @@
 #include "CommandCaller.h"
 #include "Util.h"
 #include "Debug.h"
+#include "ProfileReport.h"
 
 #include <strings.h>
 #include <cstdlib>
 #include <unistd.h>
+#include <sys/wait.h>
 #include <sstream>
 
 #ifdef OPENMP
@@ -77,6 +79,31 @@ void CommandCaller::execProgram(const char* program, const std::vector<std::stri
     }
     pArgv[argv.size() + 1] = NULL;
 
+    // the owner of a profile report has to outlive the program to merge the reports of its modules
+    if (ProfileReport::ownsReport()) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            execvp(program, (char * const *) pArgv);
+            Debug(Debug::ERROR) << "Failed to execute " << program << " with error " << errno << ".\n";
+            _exit(EXIT_FAILURE);
+        } else if (pid == -1) {
+            Debug(Debug::ERROR) << "Failed to fork " << program << " with error " << errno << ".\n";
+            delete[] pArgv;
+            EXIT(EXIT_FAILURE);
+        }
+        int status;
+        while (waitpid(pid, &status, 0) == -1) {
+            if (errno != EINTR) {
+                Debug(Debug::ERROR) << "Failed to wait for " << program << " with error " << errno << ".\n";
+                delete[] pArgv;
+                EXIT(EXIT_FAILURE);
+            }
+        }
+        delete[] pArgv;
+        EXIT(WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE);
+    }
+    ProfileReport::beforeExec();
+
     int res = execvp(program, (char * const *) pArgv);
 
     if (res == -1) {
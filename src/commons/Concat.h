@@ -14,6 +14,8 @@
 #include <algorithm>
 #include <fcntl.h>
 #include <limits.h>
+#include <errno.h>
+#include <vector>
 
 #include "Debug.h"
 #include "Util.h"
@@ -144,6 +146,83 @@ public:
     }
 
 
+    // writes the files next to each other into outFile, each file is copied by one thread to its final offset
+    static void concatFilesParallel(const std::vector<FILE*> &files, FILE *outFile) {
+        int output_desc = fileno(outFile);
+        std::vector<size_t> offsets(files.size() + 1, 0);
+        for (size_t fileIdx = 0; fileIdx < files.size(); fileIdx++) {
+            struct stat stat_buf;
+            if (fstat(fileno(files[fileIdx]), &stat_buf) < 0) {
+                Debug(Debug::ERROR) << "Error with input descriptor\n";
+                EXIT(EXIT_FAILURE);
+            }
+            offsets[fileIdx + 1] = offsets[fileIdx] + stat_buf.st_size;
+        }
+        if (ftruncate(output_desc, offsets[files.size()]) != 0) {
+            Debug(Debug::ERROR) << "Cannot resize output file, error nr: " << errno << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t fileIdx = 0; fileIdx < files.size(); fileIdx++) {
+            copyToOffset(fileno(files[fileIdx]), output_desc, offsets[fileIdx], offsets[fileIdx + 1] - offsets[fileIdx]);
+        }
+    }
+
+    // copies size bytes from the start of input_desc to out_offset of out_desc without moving the file positions
+    // copy_file_range lets the kernel skip the user space copy or reflink the blocks if the file system supports it
+    static void copyToOffset(int input_desc, int out_desc, size_t out_offset, size_t size) {
+        off_t in_pos = 0;
+        off_t out_pos = out_offset;
+#ifdef HAVE_COPY_FILE_RANGE
+        while (size > 0) {
+            loff_t in = in_pos;
+            loff_t out = out_pos;
+            ssize_t copied = copy_file_range(input_desc, &in, out_desc, &out, size, 0);
+            if (copied < 0 && errno == EINTR) {
+                continue;
+            }
+            if (copied <= 0) {
+                // not supported for these files, copy the rest through a buffer
+                break;
+            }
+            in_pos += copied;
+            out_pos += copied;
+            size -= copied;
+        }
+#endif
+        const size_t bufsize = 1024 * 1024;
+        char *buf = NULL;
+        while (size > 0) {
+            if (buf == NULL) {
+                buf = (char *) malloc(bufsize);
+                Util::checkAllocation(buf, "Cannot allocate copy buffer");
+            }
+            ssize_t n_read;
+            do {
+                n_read = pread(input_desc, buf, std::min(size, bufsize), in_pos);
+            } while (n_read < 0 && errno == EINTR);
+            if (n_read <= 0) {
+                Debug(Debug::ERROR) << "read error nr: " << errno << "\n";
+                EXIT(EXIT_FAILURE);
+            }
+            for (ssize_t written = 0; written < n_read;) {
+                ssize_t n_written = pwrite(out_desc, buf + written, n_read - written, out_pos + written);
+                if (n_written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n_written <= 0) {
+                    Debug(Debug::ERROR) << "write error nr: " << errno << "\n";
+                    EXIT(EXIT_FAILURE);
+                }
+                written += n_written;
+            }
+            in_pos += n_read;
+            out_pos += n_read;
+            size -= n_read;
+        }
+        free(buf);
+    }
+
     static bool doConcat(int input_desc, int out_desc, const char *buf, size_t bufsize) {
         while (true) {
             /* Read a block of input.  */
@@ -10,12 +10,14 @@
 #include <sys/stat.h>
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include "MemoryMapped.h"
 #include "Debug.h"
 #include "Util.h"
 #include "FileUtil.h"
 #include "itoa.h"
+#include "ProfileReport.h"
 
 #ifdef OPENMP
 #include <omp.h>
@@ -26,8 +28,11 @@ DBReader<T>::DBReader(const char* dataFileName_, const char* indexFileName_, int
 threads(threads), dataMode(dataMode), dataFileName(strdup(dataFileName_)),
         indexFileName(strdup(indexFileName_)), size(0), dataFiles(NULL), dataSizeOffset(NULL), dataFileCnt(0),
         totalDataSize(0), dataSize(0), lastKey(T()), closed(1), dbtype(Parameters::DBTYPE_GENERIC_DB),
-        compressedBuffers(NULL), compressedBufferSizes(NULL), index(NULL), id2local(NULL), local2id(NULL),
-        dataMapped(false), accessType(0), externalData(false), didMlock(false)
+        compressedBuffers(NULL), compressedBufferSizes(NULL), ddict(NULL), blockCount(0), blockOffsets(NULL), blockFileOffsets(NULL),
+        cachedBlocks(NULL), inflated(false), prefetcher(NULL), index(NULL), lookupSize(0), lookup(NULL), id2local(NULL), local2id(NULL),
+        dataMapped(false), accessType(0), externalData(false), didMlock(false), indexMapping(NULL), indexMappingSize(0),
+        lookupMapping(NULL), lookupMappingSize(0), lookupKeys(NULL), lookupFileNumbers(NULL), lookupNameOffsets(NULL),
+        lookupAccessionOrder(NULL), lookupHash(NULL), lookupHashSize(0), lookupNames(NULL)
 {}
 
 template <typename T>
@@ -35,8 +40,11 @@ DBReader<T>::DBReader(DBReader<T>::Index *index, size_t size, size_t dataSize, T
         int dbType, unsigned int maxSeqLen, int threads) :
         threads(threads), dataMode(USE_INDEX), dataFileName(NULL), indexFileName(NULL),
         size(size), dataFiles(NULL), dataSizeOffset(NULL), dataFileCnt(0), totalDataSize(0), dataSize(dataSize), lastKey(lastKey),
-        maxSeqLen(maxSeqLen), closed(1), dbtype(dbType), compressedBuffers(NULL), compressedBufferSizes(NULL), index(index), sortedByOffset(true),
-        id2local(NULL), local2id(NULL), dataMapped(false), accessType(NOSORT), externalData(true), didMlock(false)
+        maxSeqLen(maxSeqLen), closed(1), dbtype(dbType), compressedBuffers(NULL), compressedBufferSizes(NULL), ddict(NULL), blockCount(0), blockOffsets(NULL), blockFileOffsets(NULL),
+        cachedBlocks(NULL), inflated(false), prefetcher(NULL), index(index), lookupSize(0), lookup(NULL),
+        sortedByOffset(true), id2local(NULL), local2id(NULL), dataMapped(false), accessType(NOSORT), externalData(true), didMlock(false),
+        indexMapping(NULL), indexMappingSize(0), lookupMapping(NULL), lookupMappingSize(0), lookupKeys(NULL), lookupFileNumbers(NULL),
+        lookupNameOffsets(NULL), lookupAccessionOrder(NULL), lookupHash(NULL), lookupHashSize(0), lookupNames(NULL)
 {}
 
 template <typename T>
@@ -52,7 +60,11 @@ void DBReader<T>::setDataFile(const char* dataFileName_)  {
 
 template <typename T>
 void DBReader<T>::readMmapedDataInMemory(){
-    if ((dataMode & USE_DATA) && (dataMode & USE_FREAD) == 0) {
+    if ((dataMode & USE_DATA) && compression == BLOCK_COMPRESSED) {
+        inflateBlocks();
+        return;
+    }
+    if ((dataMode & USE_DATA) && (dataMode & USE_FREAD) == 0 && inflated == false) {
         //Debug(Debug::INFO) << "Touch data file " << dataFileName << "\n";
         for(size_t fileIdx = 0; fileIdx < dataFileCnt; fileIdx++){
             size_t dataSize = dataSizeOffset[fileIdx+1]-dataSizeOffset[fileIdx];
@@ -81,6 +93,10 @@ void DBReader<T>::printMagicNumber(){
 }
 
 template <typename T> DBReader<T>::~DBReader(){
+    if (prefetcher != NULL) {
+        delete prefetcher;
+    }
+
     if(dataFileName != NULL) {
         free(dataFileName);
     }
@@ -134,8 +150,11 @@ template <typename T> bool DBReader<T>::open(int accessType){
         if (accessType == LINEAR_ACCCESS || accessType == SORT_BY_OFFSET) {
             setSequentialAdvice();
         }
+        if (accessType == LINEAR_ACCCESS && (dataMode & USE_FREAD) == 0 && totalDataSize >= PREFETCH_MIN_SIZE) {
+            prefetcher = new DataPrefetcher(dataFiles, dataSizeOffset, dataFileCnt);
+        }
     }
-    if (dataMode & USE_LOOKUP || dataMode & USE_LOOKUP_REV) {
+    if ((dataMode & USE_LOOKUP || dataMode & USE_LOOKUP_REV) && openBinaryLookup() == false) {
         std::string lookupFilename = (std::string(dataFileName) + ".lookup");
         MemoryMapped lookupData(lookupFilename, MemoryMapped::WholeFile, MemoryMapped::SequentialScan);
         if (lookupData.isValid() == false) {
@@ -156,7 +175,7 @@ template <typename T> bool DBReader<T>::open(int accessType){
         lookupData.close();
     }
     bool isSortedById = false;
-    if (externalData == false) {
+    if (externalData == false && openBinaryIndex() == false) {
         MemoryMapped indexData(indexFileName, MemoryMapped::WholeFile, MemoryMapped::SequentialScan);
         if (!indexData.isValid()){
             Debug(Debug::ERROR) << "Cannot open index file " << indexFileName << "\n";
@@ -185,13 +204,21 @@ template <typename T> bool DBReader<T>::open(int accessType){
     }
 
     compression = isCompressed(dbtype);
-    if(compression == COMPRESSED){
+    size_t maxBlockSize = 0;
+    if (isBlockCompressed(dbtype) && (dataMode & USE_DATA)) {
+        compression = BLOCK_COMPRESSED;
+        maxBlockSize = openBlockTable();
+        cachedBlocks = new size_t[threads];
+        std::fill(cachedBlocks, cachedBlocks + threads, SIZE_MAX);
+    }
+    if(compression != UNCOMPRESSED){
         compressedBufferSizes = new size_t[threads];
         compressedBuffers = new char*[threads];
         dstream = new ZSTD_DStream*[threads];
         for(int i = 0; i < threads; i++){
-            // allocated buffer
-            compressedBufferSizes[i] = std::max(maxSeqLen+1, 1024u);
+            // allocated buffer, block compressed databases keep a whole frame per thread
+            compressedBufferSizes[i] = (compression == BLOCK_COMPRESSED) ? std::max(maxBlockSize, static_cast<size_t>(1))
+                                                                         : std::max(maxSeqLen+1, 1024u);
             compressedBuffers[i] = (char*) malloc(compressedBufferSizes[i]);
             incrementMemory(compressedBufferSizes[i]);
             if(compressedBuffers[i]==NULL){
@@ -204,6 +231,22 @@ template <typename T> bool DBReader<T>::open(int accessType){
                 EXIT(EXIT_FAILURE);
             }
         }
+        if (compression == COMPRESSED && dataFileName != NULL) {
+            std::string dictionaryFile = dictionaryName(dataFileName);
+            if (FileUtil::fileExists(dictionaryFile.c_str())) {
+                MemoryMapped dictionary(dictionaryFile, MemoryMapped::WholeFile, MemoryMapped::SequentialScan);
+                if (dictionary.isValid() == false) {
+                    Debug(Debug::ERROR) << "Cannot open dictionary file " << dictionaryFile << "\n";
+                    EXIT(EXIT_FAILURE);
+                }
+                ddict = ZSTD_createDDict(dictionary.getData(), dictionary.size());
+                dictionary.close();
+                if (ddict == NULL) {
+                    Debug(Debug::ERROR) << "Cannot load dictionary " << dictionaryFile << "\n";
+                    EXIT(EXIT_FAILURE);
+                }
+            }
+        }
     }
 
     closed = 0;
@@ -297,22 +340,13 @@ void DBReader<unsigned int>::sortIndex(bool isSortedById) {
 
     if (accessType == SORT_BY_LENGTH) {
         // sort the entries by the length of the sequences
-        std::pair<unsigned int, unsigned int> *sortForMapping = new std::pair<unsigned int, unsigned int>[size];
         id2local = new unsigned int[size];
         local2id = new unsigned int[size];
         incrementMemory(sizeof(unsigned int) * 2 * size);
+        orderByLength(index, size, local2id);
         for (size_t i = 0; i < size; i++) {
-            id2local[i] = i;
-            local2id[i] = i;
-            sortForMapping[i] = std::make_pair(i, index[i].length);
+            id2local[local2id[i]] = i;
         }
-        //this sort has to be stable to assure same clustering results
-        SORT_PARALLEL(sortForMapping, sortForMapping + size, comparePairBySeqLength());
-        for (size_t i = 0; i < size; i++) {
-            id2local[sortForMapping[i].first] = i;
-            local2id[i] = sortForMapping[i].first;
-        }
-        delete[] sortForMapping;
     } else if (accessType == SHUFFLE) {
         size_t *tmpIndex = new size_t[size];
         for (size_t i = 0; i < size; i++) {
@@ -346,22 +380,13 @@ void DBReader<unsigned int>::sortIndex(bool isSortedById) {
         }
 
         // sort the entries by the offset of the sequences
-        std::pair<unsigned int, size_t> *sortForMapping = new std::pair<unsigned int, size_t>[size];
         id2local = new unsigned int[size];
         local2id = new unsigned int[size];
         incrementMemory(sizeof(unsigned int) * 2 * size);
-
+        orderByOffset(index, size, local2id);
         for (size_t i = 0; i < size; i++) {
-            id2local[i] = i;
-            local2id[i] = i;
-            sortForMapping[i] = std::make_pair(i, index[i].offset);
-        }
-        SORT_PARALLEL(sortForMapping, sortForMapping + size, comparePairByOffset());
-        for (size_t i = 0; i < size; i++) {
-            id2local[sortForMapping[i].first] = i;
-            local2id[i] = sortForMapping[i].first;
+            id2local[local2id[i]] = i;
         }
-        delete[] sortForMapping;
     } else if (accessType == SORT_BY_ID_OFFSET) {
         // sort the entries by the offset of the sequences
         std::pair<unsigned int, Index> *sortForMapping = new std::pair<unsigned int, Index>[size];
@@ -399,6 +424,480 @@ void DBReader<unsigned int>::sortIndex(bool isSortedById) {
     }
 }
 
+template<typename T>
+void DBReader<T>::orderByLength(const Index *entries, size_t count, unsigned int *order) {
+    std::pair<unsigned int, unsigned int> *sortForMapping = new std::pair<unsigned int, unsigned int>[count];
+    for (size_t i = 0; i < count; i++) {
+        sortForMapping[i] = std::make_pair(i, entries[i].length);
+    }
+    //this sort has to be stable to assure same clustering results
+    SORT_PARALLEL(sortForMapping, sortForMapping + count, comparePairBySeqLength());
+    for (size_t i = 0; i < count; i++) {
+        order[i] = sortForMapping[i].first;
+    }
+    delete[] sortForMapping;
+}
+
+template<typename T>
+void DBReader<T>::orderByOffset(const Index *entries, size_t count, unsigned int *order) {
+    std::pair<unsigned int, size_t> *sortForMapping = new std::pair<unsigned int, size_t>[count];
+    for (size_t i = 0; i < count; i++) {
+        sortForMapping[i] = std::make_pair(i, entries[i].offset);
+    }
+    SORT_PARALLEL(sortForMapping, sortForMapping + count, comparePairByOffset());
+    for (size_t i = 0; i < count; i++) {
+        order[i] = sortForMapping[i].first;
+    }
+    delete[] sortForMapping;
+}
+
+namespace {
+const char BINARY_INDEX_MAGIC[8] = { 'M', 'M', 'S', 'I', 'D', 'X', 'B', '2' };
+
+// binary copies store size and mtime of their text file, mv keeps both, any rewrite changes the mtime
+uint64_t modificationTime(const struct stat &st) {
+#ifdef __APPLE__
+    const struct timespec &time = st.st_mtimespec;
+#else
+    const struct timespec &time = st.st_mtim;
+#endif
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec);
+}
+}
+
+template<typename T>
+bool DBReader<T>::openBinaryIndex() {
+    return false;
+}
+
+template<>
+bool DBReader<unsigned int>::openBinaryIndex() {
+    const std::string binaryName = binaryIndexName(indexFileName);
+    struct stat textStat;
+    struct stat binaryStat;
+    if (::stat(binaryName.c_str(), &binaryStat) != 0 || ::stat(indexFileName, &textStat) != 0) {
+        return false;
+    }
+    if (static_cast<size_t>(binaryStat.st_size) < BINARY_INDEX_HEADER_SIZE) {
+        return false;
+    }
+    int fd = ::open(binaryName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    size_t mappingSize = binaryStat.st_size;
+    char *mapping = static_cast<char *>(mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    BinaryIndexHeader header;
+    memcpy(&header, mapping, sizeof(BinaryIndexHeader));
+    const size_t entries = header.entries;
+    const bool valid = memcmp(header.magic, BINARY_INDEX_MAGIC, sizeof(BINARY_INDEX_MAGIC)) == 0
+                       && header.textIndexSize == static_cast<uint64_t>(textStat.st_size)
+                       && header.textIndexMtime == modificationTime(textStat)
+                       && header.indexEntrySize == sizeof(Index)
+                       && mappingSize == BINARY_INDEX_HEADER_SIZE + entries * (sizeof(Index) + 2 * sizeof(unsigned int));
+    // the entries are sorted by id, the original line order is only known if it was sorted already
+    const bool needsLineOrder = accessType == SORT_BY_LINE || accessType == HARDNOSORT || accessType == SORT_BY_OFFSET;
+    if (valid == false || (needsLineOrder && header.sortedById == 0)) {
+        munmap(mapping, mappingSize);
+        return false;
+    }
+
+    indexMapping = mapping;
+    indexMappingSize = mappingSize;
+    size = entries;
+    dataSize = header.dataSize;
+    maxSeqLen = header.maxSeqLen;
+    lastKey = header.lastKey;
+    index = reinterpret_cast<Index *>(mapping + BINARY_INDEX_HEADER_SIZE);
+    const unsigned int *lengthOrder = reinterpret_cast<const unsigned int *>(index + size);
+    const unsigned int *offsetOrder = lengthOrder + size;
+
+    sortedByOffset = header.sortedByOffset != 0;
+    if (accessType == SORT_BY_LENGTH || (accessType == LINEAR_ACCCESS && (header.sortedById == 0 || sortedByOffset == false))) {
+        const unsigned int *order = (accessType == SORT_BY_LENGTH) ? lengthOrder : offsetOrder;
+        id2local = new unsigned int[size];
+        local2id = new unsigned int[size];
+        incrementMemory(sizeof(unsigned int) * 2 * size);
+        memcpy(local2id, order, sizeof(unsigned int) * size);
+        for (size_t i = 0; i < size; i++) {
+            id2local[local2id[i]] = i;
+        }
+    } else if (accessType == LINEAR_ACCCESS) {
+        accessType = NOSORT;
+    } else {
+        sortIndex(true);
+        if (accessType == SORT_BY_OFFSET) {
+            sortedByOffset = true;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+void DBReader<T>::writeBinaryIndex(const std::string &, Index *, size_t) {
+}
+
+template<>
+void DBReader<unsigned int>::writeBinaryIndex(const std::string &indexFileName, Index *entries, size_t count) {
+    // never leave a binary index of an older text index behind
+    const std::string binaryName = binaryIndexName(indexFileName);
+    if (FileUtil::fileExists(binaryName.c_str())) {
+        FileUtil::remove(binaryName.c_str());
+    }
+    struct stat textStat;
+    if (::stat(indexFileName.c_str(), &textStat) != 0 || static_cast<size_t>(textStat.st_size) < BINARY_INDEX_MIN_SIZE) {
+        return;
+    }
+
+    // the entries are still in the order of the text index
+    bool isSortedById = true;
+    for (size_t i = 1; i < count && isSortedById; i++) {
+        isSortedById = entries[i - 1].id <= entries[i].id;
+    }
+    if (isSortedById == false) {
+        SORT_PARALLEL(entries, entries + count, Index::compareById);
+    }
+    bool isSortedByOffset = true;
+    size_t dataSize = 0;
+    unsigned int maxSeqLen = 0;
+    unsigned int lastKey = 0;
+    for (size_t i = 0; i < count; i++) {
+        isSortedByOffset = isSortedByOffset && (i == 0 || entries[i - 1].offset <= entries[i].offset);
+        dataSize += entries[i].length;
+        maxSeqLen = std::max(maxSeqLen, entries[i].length);
+        lastKey = std::max(lastKey, entries[i].id);
+    }
+
+    BinaryIndexHeader header;
+    memset(&header, 0, sizeof(BinaryIndexHeader));
+    memcpy(header.magic, BINARY_INDEX_MAGIC, sizeof(BINARY_INDEX_MAGIC));
+    header.textIndexSize = textStat.st_size;
+    header.textIndexMtime = modificationTime(textStat);
+    header.entries = count;
+    header.dataSize = dataSize;
+    header.maxSeqLen = maxSeqLen;
+    header.lastKey = lastKey;
+    header.sortedById = isSortedById;
+    header.sortedByOffset = isSortedByOffset;
+    header.indexEntrySize = sizeof(Index);
+
+    const std::string tmpName = binaryName + ".tmp";
+    FILE *file = FileUtil::openFileOrDie(tmpName.c_str(), "wb", false);
+    char headerBlock[BINARY_INDEX_HEADER_SIZE];
+    memset(headerBlock, 0, BINARY_INDEX_HEADER_SIZE);
+    memcpy(headerBlock, &header, sizeof(BinaryIndexHeader));
+    bool written = fwrite(headerBlock, 1, BINARY_INDEX_HEADER_SIZE, file) == BINARY_INDEX_HEADER_SIZE;
+    written = written && fwrite(entries, sizeof(Index), count, file) == count;
+    unsigned int *order = new unsigned int[count];
+    orderByLength(entries, count, order);
+    written = written && fwrite(order, sizeof(unsigned int), count, file) == count;
+    orderByOffset(entries, count, order);
+    written = written && fwrite(order, sizeof(unsigned int), count, file) == count;
+    delete[] order;
+    if (fclose(file) != 0 || written == false) {
+        Debug(Debug::WARNING) << "Cannot write binary index " << binaryName << "\n";
+        FileUtil::remove(tmpName.c_str());
+        return;
+    }
+    FileUtil::move(tmpName.c_str(), binaryName.c_str());
+}
+
+namespace {
+const char BINARY_LOOKUP_MAGIC[8] = { 'M', 'M', 'S', 'L', 'K', 'P', 'B', '2' };
+
+// FNV-1a, part of the binary lookup format
+size_t accessionHash(const char *name, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}
+
+template<typename T>
+bool DBReader<T>::openBinaryLookup() {
+    return false;
+}
+
+template<>
+bool DBReader<unsigned int>::openBinaryLookup() {
+    const std::string textName = std::string(dataFileName) + ".lookup";
+    const std::string binaryName = binaryLookupName(dataFileName);
+    struct stat textStat;
+    struct stat binaryStat;
+    if (::stat(binaryName.c_str(), &binaryStat) != 0 || ::stat(textName.c_str(), &textStat) != 0) {
+        return false;
+    }
+    if (static_cast<size_t>(binaryStat.st_size) < BINARY_INDEX_HEADER_SIZE) {
+        return false;
+    }
+    int fd = ::open(binaryName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    size_t mappingSize = binaryStat.st_size;
+    char *mapping = static_cast<char *>(mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0));
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    BinaryLookupHeader header;
+    memcpy(&header, mapping, sizeof(BinaryLookupHeader));
+    // keys, file numbers, name offsets, accession order, hash table and names
+    const size_t expectedSize = BINARY_INDEX_HEADER_SIZE + header.entries * (3 * sizeof(unsigned int) + sizeof(size_t)) + sizeof(size_t)
+                                + header.hashSize * sizeof(unsigned int) + header.namesSize;
+    const bool valid = memcmp(header.magic, BINARY_LOOKUP_MAGIC, sizeof(BINARY_LOOKUP_MAGIC)) == 0
+                       && header.textLookupSize == static_cast<uint64_t>(textStat.st_size)
+                       && header.textLookupMtime == modificationTime(textStat)
+                       && mappingSize == expectedSize;
+    if (valid == false) {
+        munmap(mapping, mappingSize);
+        return false;
+    }
+
+    lookupMapping = mapping;
+    lookupMappingSize = mappingSize;
+    lookupSize = header.entries;
+    lookupHashSize = header.hashSize;
+    lookupKeys = reinterpret_cast<const unsigned int *>(mapping + BINARY_INDEX_HEADER_SIZE);
+    lookupFileNumbers = lookupKeys + lookupSize;
+    lookupNameOffsets = reinterpret_cast<const size_t *>(lookupFileNumbers + lookupSize);
+    lookupAccessionOrder = reinterpret_cast<const unsigned int *>(lookupNameOffsets + lookupSize + 1);
+    lookupHash = lookupAccessionOrder + lookupSize;
+    lookupNames = reinterpret_cast<const char *>(lookupHash + lookupHashSize);
+    return true;
+}
+
+template<typename T>
+size_t DBReader<T>::findMappedAccession(const std::string &accession) const {
+    const size_t mask = lookupHashSize - 1;
+    size_t slot = accessionHash(accession.c_str(), accession.size()) & mask;
+    // ranks were inserted in accession order, so the first hit is the entry with the smallest key
+    while (lookupHash[slot] != 0) {
+        size_t rank = lookupHash[slot] - 1;
+        size_t entry = lookupAccessionOrder[rank];
+        size_t length = lookupNameOffsets[entry + 1] - lookupNameOffsets[entry] - 1;
+        if (length == accession.size() && memcmp(lookupNames + lookupNameOffsets[entry], accession.c_str(), length) == 0) {
+            return rank;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return SIZE_MAX;
+}
+
+template<typename T>
+typename DBReader<T>::LookupEntry* DBReader<T>::getLookup() {
+    if (lookup == NULL && lookupMapping != NULL) {
+        lookup = new(std::nothrow) LookupEntry[lookupSize];
+        Util::checkAllocation(lookup, "Cannot allocate lookup memory in DBReader");
+        incrementMemory(sizeof(LookupEntry) * lookupSize);
+        for (size_t i = 0; i < lookupSize; i++) {
+            size_t entry = mappedLookupEntry(i);
+            lookup[i].id = lookupKeys[entry];
+            lookup[i].entryName = std::string(lookupNames + lookupNameOffsets[entry]);
+            lookup[i].fileNumber = lookupFileNumbers[entry];
+        }
+    }
+    return lookup;
+}
+
+template<typename T>
+void DBReader<T>::writeBinaryLookup(const std::string &, int) {
+}
+
+template<>
+void DBReader<unsigned int>::writeBinaryLookup(const std::string &dataFileName, int threads) {
+    // never leave a binary lookup of an older text lookup behind
+    const std::string binaryName = binaryLookupName(dataFileName);
+    if (FileUtil::fileExists(binaryName.c_str())) {
+        FileUtil::remove(binaryName.c_str());
+    }
+    const std::string textName = dataFileName + ".lookup";
+    struct stat textStat;
+    if (::stat(textName.c_str(), &textStat) != 0 || static_cast<size_t>(textStat.st_size) < BINARY_INDEX_MIN_SIZE) {
+        return;
+    }
+
+    const std::string indexFileName = dataFileName + ".index";
+    DBReader<unsigned int> reader(dataFileName.c_str(), indexFileName.c_str(), threads, USE_LOOKUP);
+    reader.open(NOSORT);
+    const size_t entries = reader.lookupSize;
+    const LookupEntry *entriesById = reader.lookup;
+    if (entries >= UINT_MAX) {
+        Debug(Debug::WARNING) << "Lookup " << textName << " has too many entries for a binary lookup\n";
+        reader.close();
+        return;
+    }
+
+    size_t *nameOffsets = new size_t[entries + 1];
+    nameOffsets[0] = 0;
+    for (size_t i = 0; i < entries; i++) {
+        nameOffsets[i + 1] = nameOffsets[i] + entriesById[i].entryName.size() + 1;
+    }
+    unsigned int *accessionOrder = new unsigned int[entries];
+    for (size_t i = 0; i < entries; i++) {
+        accessionOrder[i] = i;
+    }
+    // the entries are sorted by id, so ties keep the order of compareByAccession
+    SORT_PARALLEL(accessionOrder, accessionOrder + entries, [&entriesById](unsigned int a, unsigned int b) {
+        return LookupEntry::compareByAccession(entriesById[a], entriesById[b]);
+    });
+    size_t hashSize = 1;
+    while (hashSize < 2 * entries) {
+        hashSize *= 2;
+    }
+    unsigned int *hash = new unsigned int[hashSize];
+    memset(hash, 0, sizeof(unsigned int) * hashSize);
+    for (size_t rank = 0; rank < entries; rank++) {
+        const std::string &name = entriesById[accessionOrder[rank]].entryName;
+        size_t slot = accessionHash(name.c_str(), name.size()) & (hashSize - 1);
+        while (hash[slot] != 0) {
+            slot = (slot + 1) & (hashSize - 1);
+        }
+        hash[slot] = rank + 1;
+    }
+
+    BinaryLookupHeader header;
+    memset(&header, 0, sizeof(BinaryLookupHeader));
+    memcpy(header.magic, BINARY_LOOKUP_MAGIC, sizeof(BINARY_LOOKUP_MAGIC));
+    header.textLookupSize = textStat.st_size;
+    header.textLookupMtime = modificationTime(textStat);
+    header.entries = entries;
+    header.hashSize = hashSize;
+    header.namesSize = nameOffsets[entries];
+
+    const std::string tmpName = binaryName + ".tmp";
+    FILE *file = FileUtil::openFileOrDie(tmpName.c_str(), "wb", false);
+    char headerBlock[BINARY_INDEX_HEADER_SIZE];
+    memset(headerBlock, 0, BINARY_INDEX_HEADER_SIZE);
+    memcpy(headerBlock, &header, sizeof(BinaryLookupHeader));
+    bool written = fwrite(headerBlock, 1, BINARY_INDEX_HEADER_SIZE, file) == BINARY_INDEX_HEADER_SIZE;
+    unsigned int *column = new unsigned int[entries];
+    for (size_t i = 0; i < entries; i++) {
+        column[i] = entriesById[i].id;
+    }
+    written = written && fwrite(column, sizeof(unsigned int), entries, file) == entries;
+    for (size_t i = 0; i < entries; i++) {
+        column[i] = entriesById[i].fileNumber;
+    }
+    written = written && fwrite(column, sizeof(unsigned int), entries, file) == entries;
+    delete[] column;
+    written = written && fwrite(nameOffsets, sizeof(size_t), entries + 1, file) == entries + 1;
+    written = written && fwrite(accessionOrder, sizeof(unsigned int), entries, file) == entries;
+    written = written && fwrite(hash, sizeof(unsigned int), hashSize, file) == hashSize;
+    for (size_t i = 0; i < entries && written; i++) {
+        const std::string &name = entriesById[i].entryName;
+        written = fwrite(name.c_str(), sizeof(char), name.size() + 1, file) == name.size() + 1;
+    }
+    delete[] hash;
+    delete[] accessionOrder;
+    delete[] nameOffsets;
+    reader.close();
+    if (fclose(file) != 0 || written == false) {
+        Debug(Debug::WARNING) << "Cannot write binary lookup " << binaryName << "\n";
+        FileUtil::remove(tmpName.c_str());
+        return;
+    }
+    FileUtil::move(tmpName.c_str(), binaryName.c_str());
+}
+
+namespace {
+const char BLOCK_TABLE_MAGIC[8] = { 'M', 'M', 'S', 'Z', 'B', 'L', 'K', '1' };
+}
+
+template <typename T>
+void DBReader<T>::writeBlockTable(const std::string &dataFileName, const std::vector<size_t> &blockOffsets, const std::vector<size_t> &blockFileOffsets) {
+    std::string name = blockTableName(dataFileName);
+    FILE *file = FileUtil::openAndDelete(name.c_str(), "wb");
+    const uint64_t count = blockOffsets.size() - 1;
+    bool written = fwrite(BLOCK_TABLE_MAGIC, 1, sizeof(BLOCK_TABLE_MAGIC), file) == sizeof(BLOCK_TABLE_MAGIC)
+                   && fwrite(&count, sizeof(uint64_t), 1, file) == 1
+                   && fwrite(blockOffsets.data(), sizeof(size_t), count + 1, file) == count + 1
+                   && fwrite(blockFileOffsets.data(), sizeof(size_t), count + 1, file) == count + 1;
+    if (fclose(file) != 0 || written == false) {
+        Debug(Debug::ERROR) << "Cannot write frame table " << name << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+template <typename T>
+size_t DBReader<T>::openBlockTable() {
+    if (dataFileCnt != 1) {
+        Debug(Debug::ERROR) << "Block compressed database " << dataFileName << " has to consist of a single data file\n";
+        EXIT(EXIT_FAILURE);
+    }
+    std::string name = blockTableName(dataFileName);
+    FILE *file = fopen(name.c_str(), "rb");
+    if (file == NULL) {
+        Debug(Debug::ERROR) << "Cannot open frame table " << name << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    char magic[sizeof(BLOCK_TABLE_MAGIC)];
+    uint64_t count = 0;
+    bool valid = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+                 && memcmp(magic, BLOCK_TABLE_MAGIC, sizeof(magic)) == 0
+                 && fread(&count, sizeof(uint64_t), 1, file) == 1;
+    if (valid) {
+        blockCount = count;
+        blockOffsets = new size_t[blockCount + 1];
+        blockFileOffsets = new size_t[blockCount + 1];
+        valid = fread(blockOffsets, sizeof(size_t), blockCount + 1, file) == blockCount + 1
+                && fread(blockFileOffsets, sizeof(size_t), blockCount + 1, file) == blockCount + 1
+                && blockFileOffsets[blockCount] == totalDataSize;
+    }
+    fclose(file);
+    if (valid == false) {
+        Debug(Debug::ERROR) << "Invalid frame table " << name << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    size_t maxBlockSize = 0;
+    for (size_t i = 0; i < blockCount; i++) {
+        maxBlockSize = std::max(maxBlockSize, blockOffsets[i + 1] - blockOffsets[i]);
+    }
+    return maxBlockSize;
+}
+
+template <typename T>
+void DBReader<T>::inflateBlocks() {
+    const size_t inflatedSize = blockOffsets[blockCount];
+    char *data = static_cast<char *>(malloc(std::max(inflatedSize, static_cast<size_t>(1))));
+    Util::checkAllocation(data, "Not enough system memory to decompress the whole data file.");
+    incrementMemory(inflatedSize);
+    // readers of scans are often opened with a single thread, decompress with all threads of the module
+#pragma omp parallel
+    {
+        ZSTD_DCtx *context = ZSTD_createDCtx();
+        Util::checkAllocation(context, "Cannot create decompression context");
+#pragma omp for schedule(dynamic, 1)
+        for (size_t block = 0; block < blockCount; block++) {
+            const size_t expected = blockOffsets[block + 1] - blockOffsets[block];
+            const size_t result = ZSTD_decompressDCtx(context, data + blockOffsets[block], expected,
+                                                      dataFiles[0] + blockFileOffsets[block], blockFileOffsets[block + 1] - blockFileOffsets[block]);
+            if (ZSTD_isError(result) || result != expected) {
+                Debug(Debug::ERROR) << "Cannot decompress block " << block << " of " << dataFileName << "\n";
+                EXIT(EXIT_FAILURE);
+            }
+        }
+        ZSTD_freeDCtx(context);
+    }
+    // the decompressed data replaces the data file, the database is read as an uncompressed one from here on
+    unmapData();
+    dataFiles[0] = data;
+    dataSizeOffset[1] = inflatedSize;
+    totalDataSize = inflatedSize;
+    dataMapped = true;
+    inflated = true;
+    compression = UNCOMPRESSED;
+    dbtype = unsetExtendedDbtype(dbtype & ~(1 << 31), Parameters::DBTYPE_EXTENDED_BLOCK_COMPRESSED);
+}
+
 template <typename T> char* DBReader<T>::mmapData(FILE * file, size_t *dataSize) {
     struct stat sb;
     if (fstat(fileno(file), &sb) < 0) {
@@ -443,7 +942,7 @@ template <typename T> char* DBReader<T>::mmapData(FILE * file, size_t *dataSize)
 }
 
 template <typename T> void DBReader<T>::remapData(){
-    if ((dataMode & USE_DATA) && (dataMode & USE_FREAD) == 0) {
+    if ((dataMode & USE_DATA) && (dataMode & USE_FREAD) == 0 && inflated == false) {
         unmapData();
         for(size_t fileIdx = 0; fileIdx < dataFileNames.size(); fileIdx++){
             FILE* dataFile = fopen(dataFileNames[fileIdx].c_str(), "r");
@@ -465,6 +964,11 @@ template <typename T> void DBReader<T>::remapData(){
 template <typename T> void DBReader<T>::close(){
     if (dataMode & USE_LOOKUP || dataMode & USE_LOOKUP_REV) {
         delete[] lookup;
+        lookup = NULL;
+    }
+    if (lookupMapping != NULL) {
+        munmap(lookupMapping, lookupMappingSize);
+        lookupMapping = NULL;
     }
 
     if(dataMode & USE_DATA){
@@ -490,8 +994,24 @@ template <typename T> void DBReader<T>::close(){
         delete [] compressedBufferSizes;
         delete [] dstream;
     }
+    if (ddict != NULL) {
+        ZSTD_freeDDict(ddict);
+        ddict = NULL;
+    }
+    if (blockOffsets != NULL) {
+        delete[] blockOffsets;
+        delete[] blockFileOffsets;
+        delete[] cachedBlocks;
+        blockOffsets = NULL;
+        blockFileOffsets = NULL;
+        cachedBlocks = NULL;
+        blockCount = 0;
+    }
 
-    if(externalData == false) {
+    if (indexMapping != NULL) {
+        munmap(indexMapping, indexMappingSize);
+        indexMapping = NULL;
+    } else if(externalData == false) {
         delete[] index;
         decrementMemory(size*sizeof(Index));
     }
@@ -514,7 +1034,15 @@ template <typename T> char* DBReader<T>::getDataCompressed(size_t id, int thrIdx
     const void *cBuff = static_cast<void *>(data + sizeof(unsigned int));
     const char *dataStart = data + sizeof(unsigned int);
     bool isCompressed = (dataStart[cSize] == 0) ? true : false;
-    if(isCompressed){
+    if (isCompressed && ddict != NULL) {
+        // entries are single frames that fit into the buffer, decompress them in one call
+        totalSize = ZSTD_decompress_usingDDict(dstream[thrIdx], compressedBuffers[thrIdx], compressedBufferSizes[thrIdx], cBuff, cSize, ddict);
+        if (ZSTD_isError(totalSize)) {
+            Debug(Debug::ERROR) << id << " ZSTD_decompress_usingDDict " << ZSTD_getErrorName(totalSize) << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        compressedBuffers[thrIdx][totalSize] = '\0';
+    } else if(isCompressed){
         ZSTD_inBuffer input = {cBuff, cSize, 0};
         while (input.pos < input.size) {
             ZSTD_outBuffer output = {compressedBuffers[thrIdx], compressedBufferSizes[thrIdx], 0};
@@ -534,6 +1062,31 @@ template <typename T> char* DBReader<T>::getDataCompressed(size_t id, int thrIdx
     return compressedBuffers[thrIdx];
 }
 
+template <typename T> char* DBReader<T>::getDataFromBlock(size_t id, int thrIdx) {
+    checkClosed();
+    const size_t offset = getOffset(id);
+    const size_t block = std::upper_bound(blockOffsets, blockOffsets + blockCount + 1, offset) - blockOffsets - 1;
+    if (block >= blockCount) {
+        Debug(Debug::ERROR) << "Invalid database read for database data file=" << dataFileName << ", database index=" << indexFileName << "\n";
+        Debug(Debug::ERROR) << "Requested offset " << offset << " is not part of a block\n";
+        EXIT(EXIT_FAILURE);
+    }
+    if (cachedBlocks[thrIdx] != block) {
+        const size_t expected = blockOffsets[block + 1] - blockOffsets[block];
+        const size_t result = ZSTD_decompressDCtx(dstream[thrIdx], compressedBuffers[thrIdx], compressedBufferSizes[thrIdx],
+                                                  dataFiles[0] + blockFileOffsets[block], blockFileOffsets[block + 1] - blockFileOffsets[block]);
+        if (ZSTD_isError(result) || result != expected) {
+            Debug(Debug::ERROR) << "Cannot decompress block " << block << " of " << dataFileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        cachedBlocks[thrIdx] = block;
+        if (prefetcher != NULL) {
+            prefetcher->consumed(blockFileOffsets[block]);
+        }
+    }
+    return compressedBuffers[thrIdx] + (offset - blockOffsets[block]);
+}
+
 template <typename T> size_t DBReader<T>::getAminoAcidDBSize() {
     checkClosed();
     if (Parameters::isEqualDbtype(dbtype, Parameters::DBTYPE_HMM_PROFILE)){
@@ -546,8 +1099,13 @@ template <typename T> size_t DBReader<T>::getAminoAcidDBSize() {
 }
 
 template <typename T> char* DBReader<T>::getData(size_t id, int thrIdx){
+    if (ProfileReport::isEnabled()) {
+        ProfileReport::add(ProfileReport::DB_BYTES_READ, getEntryLen(id));
+    }
     if(compression == COMPRESSED){
         return getDataCompressed(id, thrIdx);
+    }else if(compression == BLOCK_COMPRESSED){
+        return getDataFromBlock(id, thrIdx);
     }else{
         return getDataUncompressed(id);
     }
@@ -564,13 +1122,16 @@ template <typename T> char* DBReader<T>::getDataUncompressed(size_t id){
         Debug(Debug::ERROR) << "getData: local id (" << id << ") >= db size (" << size << ")\n";
         EXIT(EXIT_FAILURE);
     }
+    if (compression == BLOCK_COMPRESSED) {
+        Debug(Debug::ERROR) << "Entries of the block compressed database " << dataFileName << " can only be read with getData\n";
+        EXIT(EXIT_FAILURE);
+    }
 
-
-    if (local2id != NULL) {
-        return getDataByOffset(index[local2id[id]].offset);
-    }else{
-        return getDataByOffset(index[id].offset);
+    const size_t offset = (local2id != NULL) ? index[local2id[id]].offset : index[id].offset;
+    if (prefetcher != NULL) {
+        prefetcher->consumed(offset);
     }
+    return getDataByOffset(offset);
 }
 
 template <typename T> char* DBReader<T>::getDataByOffset(size_t offset) {
@@ -601,8 +1162,13 @@ void DBReader<T>::touchData(size_t id) {
 
 template <typename T> char* DBReader<T>::getDataByDBKey(T dbKey, int thrIdx) {
     size_t id = getId(dbKey);
+    if (ProfileReport::isEnabled() && id != UINT_MAX) {
+        ProfileReport::add(ProfileReport::DB_BYTES_READ, index[id].length);
+    }
     if(compression == COMPRESSED ){
         return (id != UINT_MAX) ? getDataCompressed(id, thrIdx) : NULL;
+    }else if(compression == BLOCK_COMPRESSED){
+        return (id != UINT_MAX) ? getDataFromBlock(id, thrIdx) : NULL;
     }else{
         return (id != UINT_MAX) ? getDataByOffset(index[id].offset) : NULL;
     }
@@ -636,6 +1202,10 @@ template <typename T> size_t DBReader<T>::getLookupIdByKey(T dbKey) {
         Debug(Debug::ERROR) << "DBReader for datafile=" << dataFileName << ".lookup was not opened with lookup mode\n";
         EXIT(EXIT_FAILURE);
     }
+    if (lookupMapping != NULL) {
+        size_t id = std::lower_bound(lookupKeys, lookupKeys + lookupSize, dbKey) - lookupKeys;
+        return (id < lookupSize && lookupKeys[id] == dbKey) ? id : SIZE_MAX;
+    }
     LookupEntry val;
     val.id = dbKey;
     size_t id = std::upper_bound(lookup, lookup + lookupSize, val, LookupEntry::compareByIdOnly) - lookup;
@@ -648,6 +1218,9 @@ template <typename T> size_t DBReader<T>::getLookupIdByAccession(const std::stri
         Debug(Debug::ERROR) << "DBReader for datafile=" << dataFileName << ".lookup was not opened with lookup mode\n";
         EXIT(EXIT_FAILURE);
     }
+    if (lookupMapping != NULL) {
+        return findMappedAccession(accession);
+    }
     LookupEntry val;
     val.entryName = accession;
     size_t id = std::upper_bound(lookup, lookup + lookupSize, val, LookupEntry::compareByAccessionOnly) - lookup;
@@ -661,6 +1234,9 @@ template <typename T> T DBReader<T>::getLookupKey(size_t id){
         Debug(Debug::ERROR) << "getLookupKey: local id (" << id << ") >= db size (" << lookupSize << ")\n";
         EXIT(EXIT_FAILURE);
     }
+    if (lookupMapping != NULL) {
+        return lookupKeys[mappedLookupEntry(id)];
+    }
     return lookup[id].id;
 }
 
@@ -670,6 +1246,9 @@ template <typename T> std::string DBReader<T>::getLookupEntryName (size_t id){
         Debug(Debug::ERROR) << "getLookupEntryName: local id (" << id << ") >= db size (" << lookupSize << ")\n";
         EXIT(EXIT_FAILURE);
     }
+    if (lookupMapping != NULL) {
+        return std::string(lookupNames + lookupNameOffsets[mappedLookupEntry(id)]);
+    }
     return lookup[id].entryName;
 }
 
@@ -679,6 +1258,9 @@ template <typename T> unsigned int DBReader<T>::getLookupFileNumber(size_t id){
         Debug(Debug::ERROR) << "getLookupFileNumber: local id (" << id << ") >= db size (" << lookupSize << ")\n";
         EXIT(EXIT_FAILURE);
     }
+    if (lookupMapping != NULL) {
+        return lookupFileNumbers[mappedLookupEntry(id)];
+    }
     return lookup[id].fileNumber;
 }
 
@@ -714,7 +1296,7 @@ template <typename T> size_t DBReader<T>::maxCount(char c) {
     checkClosed();
 
     size_t max = 0;
-    if (compression == COMPRESSED) {
+    if (compression != UNCOMPRESSED) {
         size_t entries = getSize();
 #ifdef OPENMP
         size_t localThreads = std::max(std::min(entries, static_cast<size_t>(threads)), (size_t)1);
@@ -854,7 +1436,17 @@ unsigned int DBReader<unsigned int>::indexIdToNum(unsigned int * id) {
 }
 
 template <typename T> void DBReader<T>::unmapData() {
-    if (dataMapped == true) {
+    if (prefetcher != NULL) {
+        delete prefetcher;
+        prefetcher = NULL;
+    }
+    if (dataMapped == true && inflated == true) {
+        if (didMlock == true) {
+            munlock(dataFiles[0], totalDataSize);
+        }
+        free(dataFiles[0]);
+        decrementMemory(totalDataSize);
+    } else if (dataMapped == true) {
         for(size_t fileIdx = 0; fileIdx < dataFileNames.size(); fileIdx++) {
             size_t fileSize = dataSizeOffset[fileIdx+1] -dataSizeOffset[fileIdx];
             if(fileSize > 0) {
@@ -877,6 +1469,7 @@ template <typename T> void DBReader<T>::unmapData() {
 
     didMlock = false;
     dataMapped = false;
+    inflated = false;
 }
 
 template <typename T>  size_t DBReader<T>::getDataOffset(T i) {
@@ -1054,12 +1647,26 @@ void DBReader<T>::moveDb(const std::string &srcDbName, const std::string &dstDbN
     if (FileUtil::fileExists((srcDbName + ".index").c_str())) {
         FileUtil::move((srcDbName + ".index").c_str(), (dstDbName + ".index").c_str());
     }
+    if (FileUtil::fileExists((srcDbName + ".index.bin").c_str())) {
+        FileUtil::move((srcDbName + ".index.bin").c_str(), (dstDbName + ".index.bin").c_str());
+    } else if (FileUtil::fileExists((dstDbName + ".index.bin").c_str())) {
+        FileUtil::remove((dstDbName + ".index.bin").c_str());
+    }
     if (FileUtil::fileExists((srcDbName + ".dbtype").c_str())) {
         FileUtil::move((srcDbName + ".dbtype").c_str(), (dstDbName + ".dbtype").c_str());
     }
+    if (FileUtil::fileExists(dictionaryName(srcDbName).c_str())) {
+        FileUtil::move(dictionaryName(srcDbName).c_str(), dictionaryName(dstDbName).c_str());
+    }
+    if (FileUtil::fileExists(blockTableName(srcDbName).c_str())) {
+        FileUtil::move(blockTableName(srcDbName).c_str(), blockTableName(dstDbName).c_str());
+    }
     if (FileUtil::fileExists((srcDbName + ".lookup").c_str())) {
         FileUtil::move((srcDbName + ".lookup").c_str(), (dstDbName + ".lookup").c_str());
     }
+    if (FileUtil::fileExists(binaryLookupName(srcDbName).c_str())) {
+        FileUtil::move(binaryLookupName(srcDbName).c_str(), binaryLookupName(dstDbName).c_str());
+    }
 }
 
 template<typename T>
@@ -1072,10 +1679,22 @@ void DBReader<T>::removeDb(const std::string &databaseName){
     if (FileUtil::fileExists(index.c_str())) {
         FileUtil::remove(index.c_str());
     }
+    std::string binaryIndex = binaryIndexName(index);
+    if (FileUtil::fileExists(binaryIndex.c_str())) {
+        FileUtil::remove(binaryIndex.c_str());
+    }
     std::string dbTypeFile = databaseName + ".dbtype";
     if (FileUtil::fileExists(dbTypeFile.c_str())) {
         FileUtil::remove(dbTypeFile.c_str());
     }
+    std::string dictionaryFile = dictionaryName(databaseName);
+    if (FileUtil::fileExists(dictionaryFile.c_str())) {
+        FileUtil::remove(dictionaryFile.c_str());
+    }
+    std::string blockTableFile = blockTableName(databaseName);
+    if (FileUtil::fileExists(blockTableFile.c_str())) {
+        FileUtil::remove(blockTableFile.c_str());
+    }
     std::string sourceFile = databaseName + ".source";
     if (FileUtil::fileExists(sourceFile.c_str())) {
         FileUtil::remove(sourceFile.c_str());
@@ -1084,6 +1703,10 @@ void DBReader<T>::removeDb(const std::string &databaseName){
     if (FileUtil::fileExists(lookupFile.c_str())) {
         FileUtil::remove(lookupFile.c_str());
     }
+    std::string binaryLookup = binaryLookupName(databaseName);
+    if (FileUtil::fileExists(binaryLookup.c_str())) {
+        FileUtil::remove(binaryLookup.c_str());
+    }
 }
 
 typedef void (*DbAction)(const std::string &, const std::string &);
@@ -1115,11 +1738,17 @@ void copyLinkDb(const std::string &databaseName, const std::string &outDb, DBFil
 
     const DBSuffix suffices[] = {
         { DBFiles::DATA_INDEX,    ".index"            },
+        { DBFiles::DATA_INDEX,    ".index.bin"        },
         { DBFiles::DATA_DBTYPE,   ".dbtype"           },
+        { DBFiles::DATA,          ".zdict"            },
+        { DBFiles::DATA,          ".zblocks"          },
         { DBFiles::HEADER,        "_h"                },
+        { DBFiles::HEADER,        "_h.zdict"          },
+        { DBFiles::HEADER,        "_h.zblocks"        },
         { DBFiles::HEADER_INDEX,  "_h.index"          },
         { DBFiles::HEADER_DBTYPE, "_h.dbtype"         },
         { DBFiles::LOOKUP,        ".lookup"           },
+        { DBFiles::LOOKUP,        ".lookup.bin"       },
         { DBFiles::SOURCE,        ".source"           },
         { DBFiles::TAX_MAPPING,   "_mapping"          },
         { DBFiles::TAX_NAMES,     "_names.dmp"        },
@@ -1157,6 +1786,14 @@ void DBReader<T>::copyDb(const std::string &databaseName, const std::string &out
     copyLinkDb(databaseName, outDb, dbFilesFlags, FileUtil::copyFile);
 }
 
+template<typename T>
+void DBReader<T>::copyDictionary(const std::string &srcDataFileName, const std::string &dstDataFileName) {
+    const std::string srcDictionary = dictionaryName(srcDataFileName);
+    if (FileUtil::fileExists(srcDictionary.c_str())) {
+        FileUtil::copyFile(srcDictionary, dictionaryName(dstDataFileName));
+    }
+}
+
 template<typename T>
 void DBReader<T>::decomposeDomainByAminoAcid(size_t worldRank, size_t worldSize, size_t *startEntry, size_t *numEntries){
     const size_t dataSize = getDataSize();
@@ -12,6 +12,7 @@
 #include <string>
 #include "Sequence.h"
 #include "Parameters.h"
+#include "DataPrefetcher.h"
 #include "FileUtil.h"
 #include "Debug.h"
 
@@ -174,6 +175,9 @@ public:
 
     char* getDataCompressed(size_t id, int thrIdx);
 
+    // decompresses the frame holding the entry into the buffer of the thread, unless the thread read from it last
+    char* getDataFromBlock(size_t id, int thrIdx);
+
     char* getDataUncompressed(size_t id);
 
     void touchData(size_t id);
@@ -246,7 +250,8 @@ public:
     std::string getLookupEntryName(size_t id);
     unsigned int getLookupFileNumber(size_t id);
     void lookupEntryToBuffer(std::string& buffer, const LookupEntry& entry);
-    LookupEntry* getLookup() { return lookup; };
+    // entries are created on first use if the lookup was mapped from a binary lookup
+    LookupEntry* getLookup();
 
     static const int NOSORT = 0;
     static const int SORT_BY_LENGTH = 1;
@@ -270,6 +275,7 @@ public:
     // compressed
     static const int UNCOMPRESSED    = 0;
     static const int COMPRESSED     = 1;
+    static const int BLOCK_COMPRESSED = 2;
 
     char * getDataForFile(size_t fileIdx){
         return dataFiles[fileIdx];
@@ -297,6 +303,39 @@ public:
 
     static void removeDb(const std::string &databaseName);
 
+    // Large text indices get a binary copy (<index>.bin) with the id sorted entries and the length and offset orders.
+    // It is built from the entries of the just written text index, which end up sorted by id.
+    // open maps it instead of parsing and sorting the text index as long as size and mtime of the text index match.
+    static void writeBinaryIndex(const std::string &indexFileName, Index *entries, size_t count);
+    static std::string binaryIndexName(const std::string &indexFileName) {
+        return indexFileName + ".bin";
+    }
+    // smaller text indices are parsed about as fast as a binary index is mapped
+    static const size_t BINARY_INDEX_MIN_SIZE = 16 * 1024 * 1024;
+    // LINEAR_ACCCESS readers of larger data files load the data ahead of the reading threads in the background
+    static const size_t PREFETCH_MIN_SIZE = DataPrefetcher::AHEAD_SIZE;
+
+    // Large lookups get a binary copy (<data>.lookup.bin) with the keys, file numbers and names of the id sorted entries,
+    // their accession order and a hash table of accession ranks. open maps it instead of reading and sorting the lookup.
+    static void writeBinaryLookup(const std::string &dataFileName, int threads);
+    static std::string binaryLookupName(const std::string &dataFileName) {
+        return dataFileName + ".lookup.bin";
+    }
+
+    // compressed databases can store the zstd dictionary of their entries next to the data file
+    static std::string dictionaryName(const std::string &dataFileName) {
+        return dataFileName + ".zdict";
+    }
+    // entries copied without decompressing them still need the dictionary they were compressed with
+    static void copyDictionary(const std::string &srcDataFileName, const std::string &dstDataFileName);
+
+    // Block compressed databases store runs of entries as zstd frames. The index offsets point into the decompressed
+    // data, the frame table (<data>.zblocks) has the decompressed and the file offsets of all frames.
+    static std::string blockTableName(const std::string &dataFileName) {
+        return dataFileName + ".zblocks";
+    }
+    static void writeBlockTable(const std::string &dataFileName, const std::vector<size_t> &blockOffsets, const std::vector<size_t> &blockFileOffsets);
+
 
     static void aliasDb(const std::string &databaseName, const std::string &alias, DBFiles::Files dbFilesFlags = DBFiles::ALL);
     static void softlinkDb(const std::string &databaseName, const std::string &outDb, DBFiles::Files dbFilesFlags = DBFiles::ALL);
@@ -312,6 +351,7 @@ public:
 
     unsigned int indexIdToNum(T* id);
 
+    // block compressed data is decompressed into memory in parallel, reads do not decompress anymore afterwards
     void readMmapedDataInMemory();
 
     void mlock();
@@ -359,6 +399,10 @@ public:
         return dbtype | ((extended & 0x7FFE) << 16);
     }
 
+    static inline int unsetExtendedDbtype(int dbtype, uint16_t extended) {
+        return dbtype & ~((extended & 0x7FFE) << 16);
+    }
+
     const char* getDbTypeName() const {
         return Parameters::getDbTypeName(dbtype);
     }
@@ -425,8 +469,37 @@ public:
         return isCompressed(dbtype);
     }
 
+    bool hasDictionary() {
+        return ddict != NULL;
+    }
+
     static int isCompressed(int dbtype);
 
+    bool isBlockCompressed() {
+        return isBlockCompressed(dbtype);
+    }
+
+    static bool isBlockCompressed(int dbtype) {
+        return isCompressed(dbtype) == COMPRESSED && (getExtendedDbtype(dbtype) & Parameters::DBTYPE_EXTENDED_BLOCK_COMPRESSED) != 0;
+    }
+
+    bool isBinaryResult() {
+        return isBinaryResult(dbtype);
+    }
+
+    static bool isBinaryResult(int dbtype) {
+        return (getExtendedDbtype(dbtype) & Parameters::DBTYPE_EXTENDED_BINARY_RESULT) != 0;
+    }
+
+    // exits for modules that only parse text result entries
+    void requireTextResult(const char *module) {
+        if (isBinaryResult()) {
+            Debug(Debug::ERROR) << "Binary result databases are not supported by " << module << ". "
+                                << "Convert " << dataFileName << " with convertalis or createtsv first.\n";
+            EXIT(EXIT_FAILURE);
+        }
+    }
+
     void setSequentialAdvice();
 
     void decomposeDomainByAminoAcid(size_t worldRank, size_t worldSize, size_t *startEntry, size_t *numEntries);
@@ -434,6 +507,52 @@ public:
 private:
     void checkClosed() const;
 
+    struct BinaryIndexHeader {
+        char magic[8];
+        uint64_t textIndexSize;
+        uint64_t entries;
+        uint64_t dataSize;
+        uint32_t maxSeqLen;
+        uint32_t lastKey;
+        uint32_t sortedById;
+        uint32_t sortedByOffset;
+        uint32_t indexEntrySize;
+        // nanoseconds
+        uint64_t textIndexMtime;
+    };
+    static const size_t BINARY_INDEX_HEADER_SIZE = 64;
+
+    // maps a valid binary index, returns false if the text index has to be read
+    bool openBinaryIndex();
+
+    struct BinaryLookupHeader {
+        char magic[8];
+        uint64_t textLookupSize;
+        uint64_t textLookupMtime;
+        uint64_t entries;
+        uint64_t hashSize;
+        uint64_t namesSize;
+    };
+
+    // maps a valid binary lookup, returns false if the text lookup has to be read
+    bool openBinaryLookup();
+
+    // returns the accession rank of the first entry with this accession or SIZE_MAX
+    size_t findMappedAccession(const std::string &accession) const;
+
+    // position of a lookup id in the mapped arrays
+    size_t mappedLookupEntry(size_t id) const {
+        return (dataMode & USE_LOOKUP) ? id : lookupAccessionOrder[id];
+    }
+
+    // returns the largest decompressed frame
+    size_t openBlockTable();
+    void inflateBlocks();
+
+    // local ids ordered as for SORT_BY_LENGTH and LINEAR_ACCCESS
+    static void orderByLength(const Index *entries, size_t count, unsigned int *order);
+    static void orderByOffset(const Index *entries, size_t count, unsigned int *order);
+
     int threads;
 
     int dataMode;
@@ -466,6 +585,18 @@ private:
     char ** compressedBuffers;
     size_t * compressedBufferSizes;
     ZSTD_DStream ** dstream;
+    // trained zstd dictionary of the entries, if the database has one
+    ZSTD_DDict * ddict;
+    // frame table of block compressed databases, blockCount + 1 decompressed and file offsets
+    size_t blockCount;
+    size_t *blockOffsets;
+    size_t *blockFileOffsets;
+    // frame decompressed into the buffer of each thread
+    size_t *cachedBlocks;
+    // the data was decompressed into memory by readMmapedDataInMemory
+    bool inflated;
+    // loads the data ahead of the threads in LINEAR_ACCCESS mode
+    DataPrefetcher *prefetcher;
 
     Index * index;
     size_t lookupSize;
@@ -482,6 +613,21 @@ private:
 
     bool didMlock;
 
+    // index entries mapped from a binary index
+    char *indexMapping;
+    size_t indexMappingSize;
+
+    // lookup mapped from a binary lookup
+    char *lookupMapping;
+    size_t lookupMappingSize;
+    const T *lookupKeys;
+    const unsigned int *lookupFileNumbers;
+    const size_t *lookupNameOffsets;
+    const unsigned int *lookupAccessionOrder;
+    const unsigned int *lookupHash;
+    size_t lookupHashSize;
+    const char *lookupNames;
+
     // needed to prevent the compiler from optimizing away the loop
     char magicBytes;
 
@@ -7,6 +7,10 @@
 #include "itoa.h"
 #include "Timer.h"
 #include "Parameters.h"
+#include "ProfileReport.h"
+#include "FastSort.h"
+
+#include <zdict.h>
 
 #define SIMDE_ENABLE_NATIVE_ALIASES
 #include <simde/simde-common.h>
@@ -34,6 +38,15 @@ DBWriter::DBWriter(const char *dataFileName_, const char *indexFileName_, unsign
     indexFileNames = new char *[threads];
     compressedBuffers=NULL;
     compressedBufferSizes=NULL;
+    cdict = NULL;
+    asyncBlocks = NULL;
+    asyncActive = NULL;
+    asyncNext = NULL;
+    asyncEntryStart = NULL;
+    asyncFirstPart = NULL;
+    asyncStop = 0;
+    // zstd seems to have a hard time with elements < 60
+    minCompressedSize = 60;
     if((mode & Parameters::WRITER_COMPRESSED_MODE) != 0){
         compressedBuffers = new char*[threads];
         compressedBufferSizes = new size_t[threads];
@@ -75,6 +88,9 @@ size_t DBWriter::addToThreadBuffer(const void *data, size_t itmesize, size_t nit
 }
 
 DBWriter::~DBWriter() {
+    if (asyncBlocks != NULL) {
+        stopAsyncWorkers();
+    }
     delete[] offsets;
     delete[] starts;
     delete[] indexFileNames;
@@ -187,10 +203,177 @@ void DBWriter::open(size_t bufferSize) {
         }
     }
 
+    if ((mode & Parameters::WRITER_COMPRESSED_MODE) != 0 && dictionary.empty() == false) {
+        cdict = ZSTD_createCDict(dictionary.c_str(), dictionary.size(), COMPRESSION_LEVEL);
+        if (cdict == NULL) {
+            Debug(Debug::ERROR) << "Cannot create compression dictionary for " << dataFileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        // the dictionary removes most of the frame overhead for short entries
+        minCompressedSize = 16;
+    }
+
+    if ((mode & Parameters::WRITER_ASYNC_MODE) != 0) {
+        asyncBlocks = new AsyncBlock[2 * threads];
+        for (size_t i = 0; i < 2 * threads; i++) {
+            asyncBlocks[i].capacity = ASYNC_BLOCK_SIZE;
+            asyncBlocks[i].data = (char*) malloc(asyncBlocks[i].capacity);
+            Util::checkAllocation(asyncBlocks[i].data, "Cannot allocate async buffer for DBWriter");
+            incrementMemory(asyncBlocks[i].capacity);
+            asyncBlocks[i].size = 0;
+            asyncBlocks[i].ready = 0;
+        }
+        asyncActive = new unsigned int[threads];
+        std::fill(asyncActive, asyncActive + threads, 0);
+        asyncNext = new unsigned int[threads];
+        std::fill(asyncNext, asyncNext + threads, 0);
+        asyncEntryStart = new size_t[threads];
+        std::fill(asyncEntryStart, asyncEntryStart + threads, 0);
+        asyncFirstPart = new size_t[threads];
+        std::fill(asyncFirstPart, asyncFirstPart + threads, SIZE_MAX);
+        asyncStop = 0;
+        // each worker serves a fixed subset of the threads, so the blocks of a thread are written in order
+        const unsigned int workerCount = std::min(threads, ASYNC_MAX_WORKERS);
+        for (unsigned int i = 0; i < workerCount; i++) {
+            asyncWorkers.emplace_back(&DBWriter::runAsyncWorker, this, i, workerCount);
+        }
+    }
+
     closed = false;
 }
 
-void DBWriter::writeDbtypeFile(const char* path, int dbtype, bool isCompressed) {
+void DBWriter::submitBlock(unsigned int thrIdx) {
+    AsyncBlock &block = asyncBlocks[2 * thrIdx + asyncActive[thrIdx]];
+    __sync_fetch_and_add(&block.ready, 1);
+    asyncActive[thrIdx] ^= 1;
+    // back pressure: wait until the worker has written the other block of this thread
+    AsyncBlock &next = asyncBlocks[2 * thrIdx + asyncActive[thrIdx]];
+    while (__sync_fetch_and_add(&next.ready, 0) != 0) {
+        usleep(100);
+    }
+}
+
+void DBWriter::runAsyncWorker(unsigned int workerIdx, unsigned int workerCount) {
+    while (true) {
+        // blocks submitted before the stop flag was set are seen by the following pass
+        const bool stopping = __sync_fetch_and_add(&asyncStop, 0) != 0;
+        bool idle = true;
+        for (unsigned int thrIdx = workerIdx; thrIdx < threads; thrIdx += workerCount) {
+            AsyncBlock &block = asyncBlocks[2 * thrIdx + asyncNext[thrIdx]];
+            if (__sync_fetch_and_add(&block.ready, 0) == 0) {
+                continue;
+            }
+            for (size_t i = 0; i < block.records.size(); i++) {
+                const AsyncRecord &record = block.records[i];
+                startEntry(thrIdx);
+                const size_t firstPart = std::min(record.firstPart, record.length);
+                addToEntry(block.data + record.start, firstPart, thrIdx);
+                if (firstPart < record.length) {
+                    addToEntry(block.data + record.start + firstPart, record.length - firstPart, thrIdx);
+                }
+                endEntry(record.key, thrIdx, record.addNullByte, record.addIndexEntry);
+            }
+            block.size = 0;
+            block.records.clear();
+            asyncNext[thrIdx] ^= 1;
+            __sync_fetch_and_sub(&block.ready, 1);
+            idle = false;
+        }
+        if (idle) {
+            if (stopping) {
+                break;
+            }
+            usleep(1000);
+        }
+    }
+}
+
+void DBWriter::stopAsyncWorkers() {
+    for (unsigned int i = 0; i < threads; i++) {
+        if (asyncBlocks[2 * i + asyncActive[i]].records.empty() == false) {
+            submitBlock(i);
+        }
+    }
+    __sync_fetch_and_add(&asyncStop, 1);
+    for (size_t i = 0; i < asyncWorkers.size(); i++) {
+        asyncWorkers[i].join();
+    }
+    asyncWorkers.clear();
+    for (size_t i = 0; i < 2 * threads; i++) {
+        free(asyncBlocks[i].data);
+        decrementMemory(asyncBlocks[i].capacity);
+    }
+    delete[] asyncBlocks;
+    asyncBlocks = NULL;
+    delete[] asyncActive;
+    delete[] asyncNext;
+    delete[] asyncEntryStart;
+    delete[] asyncFirstPart;
+}
+
+void DBWriter::setDictionary(const std::string &dict) {
+    if (closed == false) {
+        Debug(Debug::ERROR) << "Dictionary of " << dataFileName << " has to be set before opening the DBWriter\n";
+        EXIT(EXIT_FAILURE);
+    }
+    dictionary = dict;
+}
+
+std::string DBWriter::trainDictionary(DBReader<unsigned int> &reader, size_t dictionarySize) {
+    // zstd recommends about 100 times the dictionary size as training input
+    const size_t sampleBudget = 100 * dictionarySize;
+    const size_t maxSampleSize = 128 * 1024;
+    const size_t entries = reader.getSize();
+    const size_t stride = std::max(static_cast<size_t>(1), reader.getDataSize() / std::max(sampleBudget, static_cast<size_t>(1)));
+
+    std::string samples;
+    samples.reserve(std::min(sampleBudget, reader.getDataSize()) + maxSampleSize);
+    std::vector<size_t> sampleSizes;
+    for (size_t id = 0; id < entries && samples.size() < sampleBudget; id += stride) {
+        size_t length = std::min(std::max(reader.getEntryLen(id), static_cast<size_t>(1)) - 1, maxSampleSize);
+        if (length == 0) {
+            continue;
+        }
+        samples.append(reader.getData(id, 0), length);
+        sampleSizes.push_back(length);
+    }
+
+    std::string dict(dictionarySize, '\0');
+    size_t size = ZDICT_trainFromBuffer(&dict[0], dict.size(), samples.c_str(), sampleSizes.data(), sampleSizes.size());
+    if (ZDICT_isError(size)) {
+        Debug(Debug::WARNING) << "Cannot train compression dictionary: " << ZDICT_getErrorName(size) << "\n";
+        return std::string();
+    }
+    dict.resize(size);
+    return dict;
+}
+
+void DBWriter::compressWithDictionary(const std::string &inData, const std::string &inIndex,
+                                      const std::string &outData, const std::string &outIndex,
+                                      size_t dictionarySize, unsigned int threads) {
+    DBReader<unsigned int> reader(inData.c_str(), inIndex.c_str(), threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
+    reader.open(DBReader<unsigned int>::NOSORT);
+
+    DBWriter writer(outData.c_str(), outIndex.c_str(), threads, Parameters::WRITER_COMPRESSED_MODE, reader.getDbtype());
+    writer.setDictionary(trainDictionary(reader, dictionarySize));
+    writer.open();
+#pragma omp parallel num_threads(threads)
+    {
+        unsigned int thread_idx = 0;
+#ifdef OPENMP
+        thread_idx = (unsigned int) omp_get_thread_num();
+#endif
+
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < reader.getSize(); ++i) {
+            writer.writeData(reader.getData(i, thread_idx), std::max(static_cast<unsigned int>(reader.getEntryLen(i)), 1u) - 1u, reader.getDbKey(i), thread_idx);
+        }
+    }
+    writer.close();
+    reader.close();
+}
+
+void DBWriter::writeDbtypeFile(const char* path, int dbtype, bool isCompressed, bool isBlockCompressed) {
     if (dbtype == Parameters::DBTYPE_OMIT_FILE) {
         return;
     }
@@ -198,6 +381,9 @@ void DBWriter::writeDbtypeFile(const char* path, int dbtype, bool isCompressed)
     std::string name = std::string(path) + ".dbtype";
     FILE* file = FileUtil::openAndDelete(name.c_str(), "wb");
     dbtype = isCompressed ? dbtype | (1 << 31) : dbtype & ~(1 << 31);
+    dbtype = (isCompressed && isBlockCompressed)
+             ? DBReader<unsigned int>::setExtendedDbtype(dbtype, Parameters::DBTYPE_EXTENDED_BLOCK_COMPRESSED)
+             : DBReader<unsigned int>::unsetExtendedDbtype(dbtype, Parameters::DBTYPE_EXTENDED_BLOCK_COMPRESSED);
 #if SIMDE_ENDIAN_ORDER == SIMDE_ENDIAN_BIG
     dbtype = __builtin_bswap32(dbtype);
 #endif
@@ -214,6 +400,10 @@ void DBWriter::writeDbtypeFile(const char* path, int dbtype, bool isCompressed)
 
 
 void DBWriter::close(bool merge, bool needsSort) {
+    if (asyncBlocks != NULL) {
+        stopAsyncWorkers();
+    }
+
     // close all datafiles
     for (unsigned int i = 0; i < threads; i++) {
         if (fclose(dataFiles[i]) != 0) {
@@ -241,7 +431,27 @@ void DBWriter::close(bool merge, bool needsSort) {
                  threads, merge, ((mode & Parameters::WRITER_LEXICOGRAPHIC_MODE) != 0), needsSort);
 
     writeDbtypeFile(dataFileName, dbtype, (mode & Parameters::WRITER_COMPRESSED_MODE) != 0);
-
+    const std::string dictionaryFile = DBReader<unsigned int>::dictionaryName(dataFileName);
+    if (cdict != NULL) {
+        FILE *file = FileUtil::openAndDelete(dictionaryFile.c_str(), "wb");
+        if (fwrite(dictionary.c_str(), sizeof(char), dictionary.size(), file) != dictionary.size()) {
+            Debug(Debug::ERROR) << "Cannot write dictionary file " << dictionaryFile << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        if (fclose(file) != 0) {
+            Debug(Debug::ERROR) << "Cannot close file " << dictionaryFile << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        ZSTD_freeCDict(cdict);
+        cdict = NULL;
+    } else if (FileUtil::fileExists(dictionaryFile.c_str())) {
+        // a dictionary of a previous database would break reading the new one
+        FileUtil::remove(dictionaryFile.c_str());
+    }
+    const std::string blockTableFile = DBReader<unsigned int>::blockTableName(dataFileName);
+    if (FileUtil::fileExists(blockTableFile.c_str())) {
+        FileUtil::remove(blockTableFile.c_str());
+    }
     for (unsigned int i = 0; i < threads; i++) {
         delete [] dataFilesBuffer[i];
         decrementMemory(bufferSize);
@@ -257,12 +467,27 @@ void DBWriter::writeStart(unsigned int thrIdx) {
         Debug(Debug::ERROR) << "Thread index " << thrIdx << " > maximum thread number " << threads << "\n";
         EXIT(EXIT_FAILURE);
     }
+    if (asyncBlocks != NULL) {
+        asyncEntryStart[thrIdx] = asyncBlocks[2 * thrIdx + asyncActive[thrIdx]].size;
+        asyncFirstPart[thrIdx] = SIZE_MAX;
+        return;
+    }
+    startEntry(thrIdx);
+}
+
+void DBWriter::startEntry(unsigned int thrIdx) {
     starts[thrIdx] = offsets[thrIdx];
     if((mode & Parameters::WRITER_COMPRESSED_MODE) != 0){
         state[thrIdx] = INIT_STATE;
         threadBufferOffset[thrIdx]=0;
-        int cLevel = 3;
-        size_t const initResult = ZSTD_initCStream(cstream[thrIdx], cLevel);
+        size_t initResult;
+        if (cdict != NULL) {
+            // entries are always read with the dictionary of their database, the frames do not need its id
+            ZSTD_frameParameters frameParams = { 0, 0, 1 };
+            initResult = ZSTD_initCStream_usingCDict_advanced(cstream[thrIdx], cdict, frameParams, ZSTD_CONTENTSIZE_UNKNOWN);
+        } else {
+            initResult = ZSTD_initCStream(cstream[thrIdx], COMPRESSION_LEVEL);
+        }
         if (ZSTD_isError(initResult)) {
             Debug(Debug::ERROR) << "ZSTD_initCStream() error in thread " << thrIdx << ". Error "
                                 << ZSTD_getErrorName(initResult) << "\n";
@@ -277,14 +502,34 @@ size_t DBWriter::writeAdd(const char* data, size_t dataSize, unsigned int thrIdx
         Debug(Debug::ERROR) << "Thread index " << thrIdx << " > maximum thread number " << threads << "\n";
         EXIT(EXIT_FAILURE);
     }
+    ProfileReport::add(ProfileReport::DB_BYTES_WRITTEN, dataSize);
+    if (asyncBlocks != NULL) {
+        AsyncBlock &block = asyncBlocks[2 * thrIdx + asyncActive[thrIdx]];
+        if (block.size + dataSize > block.capacity) {
+            size_t capacity = std::max(block.capacity * 2, block.size + dataSize);
+            block.data = (char*) realloc(block.data, capacity);
+            Util::checkAllocation(block.data, "Cannot grow async buffer for DBWriter");
+            incrementMemory(capacity - block.capacity);
+            block.capacity = capacity;
+        }
+        memcpy(block.data + block.size, data, dataSize);
+        block.size += dataSize;
+        if (asyncFirstPart[thrIdx] == SIZE_MAX) {
+            asyncFirstPart[thrIdx] = dataSize;
+        }
+        return dataSize;
+    }
+    return addToEntry(data, dataSize, thrIdx);
+}
+
+size_t DBWriter::addToEntry(const char* data, size_t dataSize, unsigned int thrIdx) {
     bool isCompressedDB = (mode & Parameters::WRITER_COMPRESSED_MODE) != 0;
-    if(isCompressedDB && state[thrIdx] == INIT_STATE && dataSize < 60){
+    if(isCompressedDB && state[thrIdx] == INIT_STATE && dataSize < minCompressedSize){
         state[thrIdx] = NOTCOMPRESSED;
     }
     size_t totalWriten = 0;
     if(isCompressedDB && (state[thrIdx] == INIT_STATE || state[thrIdx] == COMPRESSED) ) {
         state[thrIdx] = COMPRESSED;
-        // zstd seems to have a hard time with elements < 60
         ZSTD_inBuffer input = { data, dataSize, 0 };
         while (input.pos < input.size) {
             ZSTD_outBuffer output = {compressedBuffers[thrIdx], compressedBufferSizes[thrIdx], 0};
@@ -320,6 +565,19 @@ size_t DBWriter::writeAdd(const char* data, size_t dataSize, unsigned int thrIdx
 }
 
 void DBWriter::writeEnd(unsigned int key, unsigned int thrIdx, bool addNullByte, bool addIndexEntry) {
+    if (asyncBlocks != NULL) {
+        AsyncBlock &block = asyncBlocks[2 * thrIdx + asyncActive[thrIdx]];
+        AsyncRecord record = { key, asyncEntryStart[thrIdx], block.size - asyncEntryStart[thrIdx], asyncFirstPart[thrIdx], addNullByte, addIndexEntry };
+        block.records.push_back(record);
+        if (block.size >= ASYNC_BLOCK_SIZE) {
+            submitBlock(thrIdx);
+        }
+        return;
+    }
+    endEntry(key, thrIdx, addNullByte, addIndexEntry);
+}
+
+void DBWriter::endEntry(unsigned int key, unsigned int thrIdx, bool addNullByte, bool addIndexEntry) {
     // close stream
     bool isCompressedDB = (mode & Parameters::WRITER_COMPRESSED_MODE) != 0;
     if(isCompressedDB) {
@@ -385,11 +643,20 @@ void DBWriter::writeEnd(unsigned int key, unsigned int thrIdx, bool addNullByte,
         if (isCompressedDB && state[thrIdx]==NOTCOMPRESSED) {
             length -= sizeof(unsigned int);
         }
-        writeIndexEntry(key, starts[thrIdx], length, thrIdx);
+        appendIndexEntry(key, starts[thrIdx], length, thrIdx);
     }
 }
 
 void DBWriter::writeIndexEntry(unsigned int key, size_t offset, size_t length, unsigned int thrIdx){
+    // the workers append the index entries of their blocks to the same file
+    if (asyncBlocks != NULL) {
+        Debug(Debug::ERROR) << "writeIndexEntry cannot be used in async mode\n";
+        EXIT(EXIT_FAILURE);
+    }
+    appendIndexEntry(key, offset, length, thrIdx);
+}
+
+void DBWriter::appendIndexEntry(unsigned int key, size_t offset, size_t length, unsigned int thrIdx){
     char buffer[1024];
     size_t len = indexToBuffer(buffer, key, offset, length );
     size_t written = fwrite(buffer, sizeof(char), len, indexFiles[thrIdx]);
@@ -419,6 +686,10 @@ size_t DBWriter::indexToBuffer(char *buff1, unsigned int key, size_t offsetStart
 }
 
 void DBWriter::alignToPageSize(int thrIdx) {
+    if (asyncBlocks != NULL) {
+        Debug(Debug::ERROR) << "alignToPageSize cannot be used in async mode\n";
+        EXIT(EXIT_FAILURE);
+    }
     size_t currentOffset = offsets[thrIdx];
     size_t pageSize = Util::getPageSize();
     size_t newOffset = ((pageSize - 1) & currentOffset) ? ((currentOffset + pageSize) & ~(pageSize - 1)) : currentOffset;
@@ -528,6 +799,7 @@ void DBWriter::mergeResults(const char *outFileName, const char *outFileNameInde
     for (unsigned int i = 0; i < fileCount; ++i) {
         dataFilenames.emplace_back(FileUtil::findDatafiles(dataFileNames[i]));
     }
+    bool indexMerged = false;
 
     // merge results into one result file
     if (dataFilenames.size() > 1) {
@@ -556,7 +828,7 @@ void DBWriter::mergeResults(const char *outFileName, const char *outFileNameInde
 
         if (mergeDatafiles) {
             FILE *outFh = FileUtil::openAndDelete(outFileName, "w");
-            Concat::concatFiles(datafiles, outFh);
+            Concat::concatFilesParallel(datafiles, outFh);
             if (fclose(outFh) != 0) {
                 Debug(Debug::ERROR) << "Cannot close data file " << outFileName << "\n";
                 EXIT(EXIT_FAILURE);
@@ -580,7 +852,12 @@ void DBWriter::mergeResults(const char *outFileName, const char *outFileNameInde
         }
 
         // merge index
-        mergeIndex(indexFileNames, dataFilenames.size(), mergedSizes);
+        if (lexicographicOrder) {
+            mergeIndex(indexFileNames, dataFilenames.size(), mergedSizes);
+        } else {
+            writeMergedIndex(indexFileNames, dataFilenames.size(), mergedSizes, outFileNameIndex, indexNeedsToBeSorted);
+            indexMerged = true;
+        }
     } else if (dataFilenames.size() == 1) {
         std::vector<std::string>& filenames = dataFilenames[0];
         if (filenames.size() == 1) {
@@ -602,7 +879,7 @@ void DBWriter::mergeResults(const char *outFileName, const char *outFileNameInde
             EXIT(EXIT_FAILURE);
         }
     }
-    if (dataFilenames.size() > 0) {
+    if (dataFilenames.size() > 0 && indexMerged == false) {
         if (indexNeedsToBeSorted) {
             DBWriter::sortIndex(indexFileNames[0], outFileNameIndex, lexicographicOrder);
             FileUtil::remove(indexFileNames[0]);
@@ -610,6 +887,12 @@ void DBWriter::mergeResults(const char *outFileName, const char *outFileNameInde
             FileUtil::move(indexFileNames[0], outFileNameIndex);
         }
     }
+    // merged and sorted indices wrote their binary index from memory, a moved index is not worth parsing again
+    const bool binaryIndexWritten = indexMerged || (dataFilenames.size() > 0 && indexNeedsToBeSorted && lexicographicOrder == false);
+    const std::string binaryIndex = DBReader<unsigned int>::binaryIndexName(outFileNameIndex);
+    if (binaryIndexWritten == false && FileUtil::fileExists(binaryIndex.c_str())) {
+        FileUtil::remove(binaryIndex.c_str());
+    }
     Debug(Debug::INFO) << "Time for merging to " << FileUtil::baseName(outFileName) << ": " << timer.lap() << "\n";
 }
 
@@ -642,6 +925,72 @@ void DBWriter::mergeIndex(const char** indexFilenames, unsigned int fileCount, c
     }
 }
 
+void DBWriter::writeMergedIndex(const char** indexFilenames, unsigned int fileCount, const std::vector<size_t> &dataSizes,
+                                const char *outFileNameIndex, bool sortById) {
+    std::vector<DBReader<unsigned int>*> readers(fileCount);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (unsigned int fileIdx = 0; fileIdx < fileCount; fileIdx++) {
+        readers[fileIdx] = new DBReader<unsigned int>(indexFilenames[fileIdx], indexFilenames[fileIdx], 1, DBReader<unsigned int>::USE_INDEX);
+        readers[fileIdx]->open(DBReader<unsigned int>::HARDNOSORT);
+    }
+    std::vector<size_t> entryOffsets(fileCount + 1, 0);
+    std::vector<size_t> dataOffsets(fileCount + 1, 0);
+    for (unsigned int fileIdx = 0; fileIdx < fileCount; fileIdx++) {
+        entryOffsets[fileIdx + 1] = entryOffsets[fileIdx] + readers[fileIdx]->getSize();
+        dataOffsets[fileIdx + 1] = dataOffsets[fileIdx] + dataSizes[fileIdx];
+    }
+    const size_t entries = entryOffsets[fileCount];
+    DBReader<unsigned int>::Index *index = new(std::nothrow) DBReader<unsigned int>::Index[entries];
+    Util::checkAllocation(index, "Cannot allocate index memory in DBWriter");
+#pragma omp parallel for schedule(dynamic, 1)
+    for (unsigned int fileIdx = 0; fileIdx < fileCount; fileIdx++) {
+        DBReader<unsigned int>::Index *fileIndex = readers[fileIdx]->getIndex();
+        DBReader<unsigned int>::Index *out = index + entryOffsets[fileIdx];
+        for (size_t i = 0; i < readers[fileIdx]->getSize(); i++) {
+            out[i] = fileIndex[i];
+            out[i].offset += dataOffsets[fileIdx];
+        }
+        readers[fileIdx]->close();
+        delete readers[fileIdx];
+        FileUtil::remove(indexFilenames[fileIdx]);
+    }
+    if (sortById) {
+        SORT_PARALLEL(index, index + entries, DBReader<unsigned int>::Index::compareById);
+    }
+
+    FILE *indexFile = FileUtil::openAndDelete(outFileNameIndex, "w");
+    // chunks are formatted in parallel and written in order
+    const size_t chunkSize = 64 * 1024;
+    const size_t chunkCount = (entries + chunkSize - 1) / chunkSize;
+#pragma omp parallel
+    {
+        std::string buffer;
+        char line[1024];
+#pragma omp for ordered schedule(static, 1)
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            buffer.clear();
+            const size_t end = std::min((chunk + 1) * chunkSize, entries);
+            for (size_t i = chunk * chunkSize; i < end; i++) {
+                size_t len = indexToBuffer(line, index[i].id, index[i].offset, index[i].length);
+                buffer.append(line, len);
+            }
+#pragma omp ordered
+            {
+                if (fwrite(buffer.c_str(), sizeof(char), buffer.size(), indexFile) != buffer.size()) {
+                    Debug(Debug::ERROR) << "Cannot write index file " << outFileNameIndex << "\n";
+                    EXIT(EXIT_FAILURE);
+                }
+            }
+        }
+    }
+    if (fclose(indexFile) != 0) {
+        Debug(Debug::ERROR) << "Cannot close index file " << outFileNameIndex << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    DBReader<unsigned int>::writeBinaryIndex(outFileNameIndex, index, entries);
+    delete[] index;
+}
+
 void DBWriter::sortIndex(const char *inFileNameIndex, const char *outFileNameIndex, const bool lexicographicOrder){
     if (lexicographicOrder == false) {
         // sort the index
@@ -654,6 +1003,7 @@ void DBWriter::sortIndex(const char *inFileNameIndex, const char *outFileNameInd
             Debug(Debug::ERROR) << "Cannot close index file " << outFileNameIndex << "\n";
             EXIT(EXIT_FAILURE);
         }
+        DBReader<unsigned int>::writeBinaryIndex(outFileNameIndex, index, indexReader.getSize());
         indexReader.close();
 
     } else {
@@ -737,5 +1087,111 @@ void DBWriter::createRenumberedDB(const std::string& dataFile, const std::string
         }
         lookupReader->close();
         delete lookupReader;
+        DBReader<unsigned int>::writeBinaryLookup(dataFile, 1);
+    }
+}
+
+void DBWriter::compressBlocks(const std::string &inData, const std::string &inIndex,
+                              const std::string &outData, const std::string &outIndex,
+                              size_t blockSize, unsigned int threads) {
+    DBReader<unsigned int> reader(inData.c_str(), inIndex.c_str(), threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
+    reader.open(DBReader<unsigned int>::SORT_BY_OFFSET);
+    const size_t entries = reader.getSize();
+
+    // lay out the entries in file order, entries sharing their data keep sharing it
+    std::vector<DBReader<unsigned int>::Index> index(entries);
+    std::vector<size_t> blockOffsets(1, 0);
+    std::vector<size_t> blockEntries(1, 0);
+    size_t offset = 0;
+    for (size_t i = 0; i < entries; i++) {
+        index[i].id = reader.getDbKey(i);
+        index[i].length = reader.getEntryLen(i);
+        if (i > 0 && reader.getOffset(i) == reader.getOffset(i - 1)) {
+            index[i].offset = index[i - 1].offset;
+            continue;
+        }
+        if (offset > blockOffsets.back() && offset - blockOffsets.back() + index[i].length > blockSize) {
+            blockOffsets.push_back(offset);
+            blockEntries.push_back(i);
+        }
+        index[i].offset = offset;
+        offset += index[i].length;
+    }
+    if (blockEntries.back() < entries) {
+        blockOffsets.push_back(offset);
+        blockEntries.push_back(entries);
     }
+    const size_t blockCount = blockOffsets.size() - 1;
+
+    FILE *dataFile = FileUtil::openAndDelete(outData.c_str(), "wb");
+    std::vector<size_t> blockFileOffsets(1, 0);
+    std::vector<ZSTD_CCtx *> contexts(threads);
+    std::vector<std::string> blocks(threads);
+    for (unsigned int i = 0; i < threads; i++) {
+        contexts[i] = ZSTD_createCCtx();
+        Util::checkAllocation(contexts[i], "Cannot create compression context");
+    }
+    // frames of a batch are compressed in parallel and written in order
+    const size_t batchSize = 4 * static_cast<size_t>(threads);
+    std::vector<std::string> frames(batchSize);
+    for (size_t batchStart = 0; batchStart < blockCount; batchStart += batchSize) {
+        const size_t batchEnd = std::min(batchStart + batchSize, blockCount);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+        for (size_t block = batchStart; block < batchEnd; block++) {
+            unsigned int thread_idx = 0;
+#ifdef OPENMP
+            thread_idx = (unsigned int) omp_get_thread_num();
+#endif
+            std::string &buffer = blocks[thread_idx];
+            buffer.assign(blockOffsets[block + 1] - blockOffsets[block], '\0');
+            for (size_t i = blockEntries[block]; i < blockEntries[block + 1]; i++) {
+                if (i > blockEntries[block] && index[i].offset == index[i - 1].offset) {
+                    continue;
+                }
+                // the null byte of the entry is already in the buffer
+                const size_t length = std::max(index[i].length, 1u) - 1;
+                memcpy(&buffer[index[i].offset - blockOffsets[block]], reader.getData(i, thread_idx), length);
+            }
+            std::string &frame = frames[block - batchStart];
+            frame.resize(ZSTD_compressBound(buffer.size()));
+            size_t frameSize = ZSTD_compressCCtx(contexts[thread_idx], &frame[0], frame.size(), buffer.data(), buffer.size(), COMPRESSION_LEVEL);
+            if (ZSTD_isError(frameSize)) {
+                Debug(Debug::ERROR) << "Cannot compress block " << block << " of " << inData << ": " << ZSTD_getErrorName(frameSize) << "\n";
+                EXIT(EXIT_FAILURE);
+            }
+            frame.resize(frameSize);
+        }
+        for (size_t block = batchStart; block < batchEnd; block++) {
+            const std::string &frame = frames[block - batchStart];
+            if (fwrite(frame.data(), sizeof(char), frame.size(), dataFile) != frame.size()) {
+                Debug(Debug::ERROR) << "Cannot write to data file " << outData << "\n";
+                EXIT(EXIT_FAILURE);
+            }
+            blockFileOffsets.push_back(blockFileOffsets.back() + frame.size());
+        }
+    }
+    for (unsigned int i = 0; i < threads; i++) {
+        ZSTD_freeCCtx(contexts[i]);
+    }
+    if (fclose(dataFile) != 0) {
+        Debug(Debug::ERROR) << "Cannot close data file " << outData << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    DBReader<unsigned int>::writeBlockTable(outData, blockOffsets, blockFileOffsets);
+
+    SORT_PARALLEL(index.begin(), index.end(), DBReader<unsigned int>::Index::compareById);
+    FILE *indexFile = FileUtil::openAndDelete(outIndex.c_str(), "w");
+    writeIndex(indexFile, index.size(), index.data());
+    if (fclose(indexFile) != 0) {
+        Debug(Debug::ERROR) << "Cannot close index file " << outIndex << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    DBReader<unsigned int>::writeBinaryIndex(outIndex, index.data(), index.size());
+    writeDbtypeFile(outData.c_str(), reader.getDbtype(), true, true);
+
+    const std::string dictionaryFile = DBReader<unsigned int>::dictionaryName(outData);
+    if (FileUtil::fileExists(dictionaryFile.c_str())) {
+        FileUtil::remove(dictionaryFile.c_str());
+    }
+    reader.close();
 }
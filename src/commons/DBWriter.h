@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <thread>
 
 #include "DBReader.h"
 #include "MemoryTracker.h"
@@ -25,6 +26,10 @@ public:
 
     char* getIndexFileName() { return indexFileName; }
 
+    // In WRITER_ASYNC_MODE the entries of a thread are collected in one of two blocks. A full block is handed to
+    // a background worker that compresses and writes it, while the thread continues with the other block.
+    // Entries of a thread are written in order, the output is the same as without async mode.
+    // Only writeStart/writeAdd/writeEnd/writeData can be used in this mode.
     void writeStart(unsigned int thrIdx = 0);
     size_t writeAdd(const char* data, size_t dataSize, unsigned int thrIdx = 0);
     void writeEnd(unsigned int key, unsigned int thrIdx = 0, bool addNullByte = true, bool addIndexEntry = true);
@@ -43,7 +48,25 @@ public:
 
     void writeIndexEntry(unsigned int key, size_t offset, size_t length, unsigned int thrIdx);
 
-    static void writeDbtypeFile(const char* path, int dbtype, bool isCompressed);
+    // the block compressed flag of dbtype is only kept for databases written by compressBlocks
+    static void writeDbtypeFile(const char* path, int dbtype, bool isCompressed, bool isBlockCompressed = false);
+
+    // compressed entries use this zstd dictionary, it has to be set before open and is stored next to the data file
+    void setDictionary(const std::string &dictionary);
+
+    // trains a zstd dictionary of at most dictionarySize bytes on a sample of the entries, empty if training failed
+    static std::string trainDictionary(DBReader<unsigned int> &reader, size_t dictionarySize);
+
+    // writes a compressed copy of a database using a dictionary trained on its entries
+    static void compressWithDictionary(const std::string &inData, const std::string &inIndex,
+                                       const std::string &outData, const std::string &outIndex,
+                                       size_t dictionarySize, unsigned int threads);
+
+    // writes a block compressed copy of a database, runs of consecutive entries of about blockSize bytes
+    // are compressed together into one zstd frame each
+    static void compressBlocks(const std::string &inData, const std::string &inIndex,
+                               const std::string &outData, const std::string &outIndex,
+                               size_t blockSize, unsigned int threads);
 
     size_t getStart(unsigned int threadIdx){
         return starts[threadIdx];
@@ -67,6 +90,38 @@ public:
 
     static void sortIndex(const char *inFileNameIndex, const char *outFileNameIndex, const bool lexicographicOrder);
 private:
+    struct AsyncRecord {
+        unsigned int key;
+        size_t start;
+        size_t length;
+        // the first part decides whether the entry is compressed
+        size_t firstPart;
+        bool addNullByte;
+        bool addIndexEntry;
+    };
+
+    struct AsyncBlock {
+        char *data;
+        size_t size;
+        size_t capacity;
+        std::vector<AsyncRecord> records;
+        // set while a worker owns the block
+        int ready;
+    };
+
+    // a thread hands over its block once it is this full, the memory per thread is bounded by two blocks
+    static const size_t ASYNC_BLOCK_SIZE = 4 * 1024 * 1024;
+    static const unsigned int ASYNC_MAX_WORKERS = 4;
+
+    void startEntry(unsigned int thrIdx);
+    size_t addToEntry(const char* data, size_t dataSize, unsigned int thrIdx);
+    void endEntry(unsigned int key, unsigned int thrIdx, bool addNullByte, bool addIndexEntry);
+    void appendIndexEntry(unsigned int key, size_t offset, size_t length, unsigned int thrIdx);
+
+    void submitBlock(unsigned int thrIdx);
+    void runAsyncWorker(unsigned int workerIdx, unsigned int workerCount);
+    void stopAsyncWorkers();
+
     size_t addToThreadBuffer(const void *data, size_t itmesize, size_t nitems, int threadIdx);
     void writeThreadBuffer(unsigned int idx, size_t dataSize);
 
@@ -79,6 +134,10 @@ private:
 
     static void mergeIndex(const char** indexFilenames, unsigned int fileCount, const std::vector<size_t> &dataSizes);
 
+    // reads, shifts, sorts and writes the entries of all index files in memory, entries are written in parallel
+    static void writeMergedIndex(const char** indexFilenames, unsigned int fileCount, const std::vector<size_t> &dataSizes,
+                                 const char *outFileNameIndex, bool sortById);
+
     char* dataFileName;
     char* indexFileName;
 
@@ -101,8 +160,23 @@ private:
     static const int INIT_STATE=0;
     static const int NOTCOMPRESSED=1;
     static const int COMPRESSED=2;
+    static const int COMPRESSION_LEVEL=3;
     ZSTD_CStream** cstream;
 
+    // two blocks per thread in async mode
+    AsyncBlock* asyncBlocks;
+    // block the thread writes to and block its worker writes next
+    unsigned int* asyncActive;
+    unsigned int* asyncNext;
+    size_t* asyncEntryStart;
+    size_t* asyncFirstPart;
+    std::vector<std::thread> asyncWorkers;
+    int asyncStop;
+    std::string dictionary;
+    ZSTD_CDict* cdict;
+    // shorter entries are stored uncompressed
+    size_t minCompressedSize;
+
     const unsigned int threads;
     const size_t mode;
     int dbtype;
@@ -0,0 +1,60 @@
+#include "DataPrefetcher.h"
+#include "Util.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+
+DataPrefetcher::DataPrefetcher(char **dataFiles, const size_t *dataSizeOffset, size_t dataFileCnt)
+        : dataFiles(dataFiles), dataSizeOffset(dataSizeOffset), dataFileCnt(dataFileCnt),
+          totalSize(dataSizeOffset[dataFileCnt]), position(0), stopped(0), magicBytes(0) {
+    loader = std::thread(&DataPrefetcher::run, this);
+}
+
+DataPrefetcher::~DataPrefetcher() {
+    __sync_lock_test_and_set(&stopped, 1);
+    if (loader.joinable()) {
+        loader.join();
+    }
+}
+
+void DataPrefetcher::run() {
+    size_t next = 0;
+    while (next < totalSize && __sync_fetch_and_add(&stopped, 0) == 0) {
+        size_t current = __sync_fetch_and_add(&position, 0);
+        size_t target = std::min(current + AHEAD_SIZE, totalSize);
+        if (next >= target) {
+            usleep(1000);
+            continue;
+        }
+        // data the consumers already passed is not loaded anymore
+        next = std::max(next, current);
+        size_t end = std::min(next + CHUNK_SIZE, target);
+        load(next, end);
+        next = end;
+    }
+}
+
+void DataPrefetcher::load(size_t from, size_t to) {
+    const size_t pageSize = Util::getPageSize();
+    for (size_t i = 0; i < dataFileCnt; i++) {
+        size_t start = std::max(from, dataSizeOffset[i]);
+        size_t end = std::min(to, dataSizeOffset[i + 1]);
+        if (start >= end) {
+            continue;
+        }
+        const char *fileData = dataFiles[i];
+        size_t alignedStart = (start - dataSizeOffset[i]) & ~(pageSize - 1);
+        size_t fileEnd = end - dataSizeOffset[i];
+#ifdef HAVE_POSIX_MADVISE
+        if (posix_madvise((void *) (fileData + alignedStart), fileEnd - alignedStart, POSIX_MADV_WILLNEED) != 0) {
+            Debug(Debug::ERROR) << "posix_madvise returned an error (DataPrefetcher)\n";
+        }
+#endif
+        // storage that ignores the advice is read page by page, faults stall this thread only
+        for (size_t pos = alignedStart; pos < fileEnd; pos += pageSize) {
+            magicBytes += fileData[pos];
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef MMSEQS_DATAPREFETCHER_H
+#define MMSEQS_DATAPREFETCHER_H
+
+// Reads the memory mapped data files of a linearly scanned database ahead of its consumers.
+// The consumers report the file offset they reached and a background thread faults in the data behind it,
+// so that on cold or network storage the prefetch thread waits for the disk instead of the consumers.
+#include <cstddef>
+#include <thread>
+
+class DataPrefetcher {
+public:
+    // how far the prefetch thread runs ahead of the consumers and how much it loads at once
+    static const size_t AHEAD_SIZE = 64 * 1024 * 1024;
+    static const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+    // dataSizeOffset has dataFileCnt + 1 entries, the files are concatenated in this order
+    DataPrefetcher(char **dataFiles, const size_t *dataSizeOffset, size_t dataFileCnt);
+    ~DataPrefetcher();
+
+    void consumed(size_t offset) {
+        // the position only moves by whole chunks, the shared value is read much more often than written
+        if (offset >= position + CHUNK_SIZE) {
+            __sync_lock_test_and_set(&position, offset);
+        }
+    }
+
+private:
+    char **dataFiles;
+    const size_t *dataSizeOffset;
+    size_t dataFileCnt;
+    size_t totalSize;
+
+    std::thread loader;
+    size_t position;
+    int stopped;
+
+    // needed to prevent the compiler from optimizing away the loads
+    char magicBytes;
+
+    void run();
+    void load(size_t from, size_t to);
+};
+
+#endif
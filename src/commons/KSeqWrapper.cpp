@@ -4,6 +4,42 @@
 #include "Util.h"
 #include "Debug.h"
 #include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+// kseq reads its input in blocks, raw reads return the rest of its buffer first
+template <typename KSeq>
+static int peekBuffered(KSeq *s) {
+    int c = ks_getc(s->f);
+    if (c >= 0) {
+        s->f->begin--;
+    }
+    return c;
+}
+
+template <typename KSeq, typename Handle, typename Read>
+static size_t readBuffered(KSeq *s, Handle handle, Read read, char *buffer, size_t length) {
+    size_t pos = 0;
+    if (s->f->begin < s->f->end) {
+        pos = std::min(length, static_cast<size_t>(s->f->end - s->f->begin));
+        memcpy(buffer, s->f->buf + s->f->begin, pos);
+        s->f->begin += pos;
+    }
+    while (pos < length && s->f->is_eof == 0) {
+        ssize_t count = read(handle, buffer + pos, std::min(length - pos, static_cast<size_t>(1 << 30)));
+        if (count < 0) {
+            Debug(Debug::ERROR) << "Cannot read KSeq input\n";
+            EXIT(EXIT_FAILURE);
+        }
+        if (count == 0) {
+            s->f->is_eof = 1;
+            break;
+        }
+        pos += count;
+    }
+    return pos;
+}
 
 namespace KSEQFILE {
     KSEQ_INIT(int, read)
@@ -31,6 +67,14 @@ bool KSeqFile::ReadEntry() {
     return true;
 }
 
+int KSeqFile::PeekChar() {
+    return peekBuffered((KSEQFILE::kseq_t*) seq);
+}
+
+size_t KSeqFile::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQFILE::kseq_t*) seq, fileno(file), ::read, buffer, length);
+}
+
 KSeqFile::~KSeqFile() {
     kseq_destroy((KSEQFILE::kseq_t*)seq);
     if (fclose(file) != 0) {
@@ -63,6 +107,14 @@ bool KSeqStream::ReadEntry() {
     return true;
 }
 
+int KSeqStream::PeekChar() {
+    return peekBuffered((KSEQSTREAM::kseq_t*) seq);
+}
+
+size_t KSeqStream::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQSTREAM::kseq_t*) seq, STDIN_FILENO, ::read, buffer, length);
+}
+
 KSeqStream::~KSeqStream() {
     kseq_destroy((KSEQSTREAM::kseq_t*)seq);
 }
@@ -105,10 +157,242 @@ bool KSeqGzip::ReadEntry() {
     return true;
 }
 
+int KSeqGzip::PeekChar() {
+    return peekBuffered((KSEQGZIP::kseq_t*) seq);
+}
+
+size_t KSeqGzip::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQGZIP::kseq_t*) seq, file, gzread, buffer, length);
+}
+
 KSeqGzip::~KSeqGzip() {
     kseq_destroy((KSEQGZIP::kseq_t*)seq);
     gzclose(file);
 }
+
+struct KSeqBgzf::Reader {
+    static const size_t FIXED_HEADER_SIZE = 12;
+    // a gzip header with the largest extra field is larger than any BGZF member
+    static const size_t MAX_HEADER_SIZE = FIXED_HEADER_SIZE + 65535;
+    static const size_t BATCH_BLOCKS = 256;
+
+    enum HeaderType { HEADER_EOF, HEADER_BGZF, HEADER_GZIP, HEADER_INVALID };
+
+    FILE *file;
+    const char *fileName;
+    // inflates the rest of the file once a member is not BGZF
+    gzFile gzStream;
+    std::vector<std::vector<unsigned char>> blocks;
+    std::vector<size_t> headerSizes;
+    std::vector<size_t> blockSizes;
+    std::vector<size_t> outOffsets;
+    std::vector<char> out;
+    size_t outPos;
+    size_t outSize;
+    bool eof;
+
+    // reads the next member into blocks[idx], returns false at the end of the file or of the BGZF members
+    bool readBlock(size_t idx) {
+        std::vector<unsigned char> &block = blocks[idx];
+        block.resize(MAX_HEADER_SIZE);
+        const off_t memberStart = ftello(file);
+        size_t headerSize = 0;
+        size_t blockSize = 0;
+        const int headerType = readHeader(file, block.data(), &headerSize, &blockSize);
+        if (headerType == HEADER_EOF) {
+            return false;
+        }
+        if (headerType == HEADER_GZIP) {
+            openStream(memberStart);
+            return false;
+        }
+        if (headerType == HEADER_INVALID) {
+            Debug(Debug::ERROR) << "Invalid BGZF block in " << fileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        if (fread(block.data() + headerSize, 1, blockSize - headerSize, file) != blockSize - headerSize) {
+            Debug(Debug::ERROR) << "Truncated BGZF block in " << fileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        headerSizes[idx] = headerSize;
+        blockSizes[idx] = blockSize;
+        return true;
+    }
+
+    // plain gzip members do not store their size, so they are inflated by zlib from the start of the member on
+    void openStream(off_t offset) {
+        const int fd = dup(fileno(file));
+        if (fd == -1 || lseek(fd, offset, SEEK_SET) != offset || (gzStream = gzdopen(fd, "r")) == NULL) {
+            Debug(Debug::ERROR) << "Cannot read gzip member in " << fileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+    }
+
+    // reads the gzip header of a member, BGZF members store their size - 1 in a BC subfield of the extra field
+    static int readHeader(FILE *file, unsigned char *header, size_t *headerSize, size_t *blockSize) {
+        const size_t headerRead = fread(header, 1, FIXED_HEADER_SIZE, file);
+        if (headerRead == 0) {
+            return HEADER_EOF;
+        }
+        if (headerRead < 2 || header[0] != 31 || header[1] != 139) {
+            return HEADER_INVALID;
+        }
+        if (headerRead != FIXED_HEADER_SIZE || header[2] != 8 || (header[3] & 4) == 0) {
+            return HEADER_GZIP;
+        }
+        const size_t extraLength = header[10] | (header[11] << 8);
+        if (fread(header + FIXED_HEADER_SIZE, 1, extraLength, file) != extraLength) {
+            return HEADER_GZIP;
+        }
+        *headerSize = FIXED_HEADER_SIZE + extraLength;
+        // subfields have an id of two bytes and the length of their data in two bytes
+        size_t pos = FIXED_HEADER_SIZE;
+        while (pos + 4 <= *headerSize) {
+            const unsigned char *field = header + pos;
+            const size_t fieldLength = field[2] | (field[3] << 8);
+            if (field[0] == 'B' && field[1] == 'C' && fieldLength == 2 && pos + 6 <= *headerSize) {
+                *blockSize = (field[4] | (field[5] << 8)) + 1;
+                return *blockSize >= *headerSize + 8 ? HEADER_BGZF : HEADER_INVALID;
+            }
+            pos += 4 + fieldLength;
+        }
+        return HEADER_GZIP;
+    }
+
+    static uint32_t readUInt32(const unsigned char *data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    void refill() {
+        size_t blockCount = 0;
+        while (blockCount < BATCH_BLOCKS && readBlock(blockCount)) {
+            blockCount++;
+        }
+        if (blockCount < BATCH_BLOCKS) {
+            eof = true;
+        }
+        size_t total = 0;
+        for (size_t i = 0; i < blockCount; i++) {
+            outOffsets[i] = total;
+            total += readUInt32(blocks[i].data() + blockSizes[i] - 4);
+        }
+        out.resize(total);
+        int failed = 0;
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < blockCount; i++) {
+            const unsigned char *block = blocks[i].data();
+            const size_t headerSize = headerSizes[i];
+            const size_t blockSize = blockSizes[i];
+            const uint32_t expectedSize = readUInt32(block + blockSize - 4);
+            const uint32_t expectedCrc = readUInt32(block + blockSize - 8);
+            Bytef *target = reinterpret_cast<Bytef *>(out.data() + outOffsets[i]);
+
+            z_stream stream;
+            memset(&stream, 0, sizeof(z_stream));
+            stream.next_in = const_cast<Bytef *>(block + headerSize);
+            stream.avail_in = blockSize - headerSize - 8;
+            stream.next_out = target;
+            stream.avail_out = expectedSize;
+            bool valid = inflateInit2(&stream, -15) == Z_OK;
+            valid = valid && inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == expectedSize;
+            inflateEnd(&stream);
+            valid = valid && crc32(crc32(0L, Z_NULL, 0), target, expectedSize) == expectedCrc;
+            if (valid == false) {
+                __sync_fetch_and_or(&failed, 1);
+            }
+        }
+        if (failed) {
+            Debug(Debug::ERROR) << "Cannot decompress BGZF block in " << fileName << "\n";
+            EXIT(EXIT_FAILURE);
+        }
+        outPos = 0;
+        outSize = total;
+    }
+
+    static int read(Reader *reader, void *buffer, int length) {
+        // empty members mark the end of file in BGZF, so refill until there is data
+        while (reader->outPos == reader->outSize && reader->eof == false) {
+            reader->refill();
+        }
+        if (reader->outPos == reader->outSize && reader->gzStream != NULL) {
+            return gzread(reader->gzStream, buffer, length);
+        }
+        size_t count = std::min(static_cast<size_t>(length), reader->outSize - reader->outPos);
+        memcpy(buffer, reader->out.data() + reader->outPos, count);
+        reader->outPos += count;
+        return count;
+    }
+};
+
+namespace KSEQBGZF {
+    KSEQ_INIT(KSeqBgzf::Reader*, KSeqBgzf::Reader::read)
+}
+
+bool KSeqBgzf::isBgzf(const char* fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    std::vector<unsigned char> header(Reader::MAX_HEADER_SIZE);
+    size_t headerSize;
+    size_t blockSize;
+    bool result = Reader::readHeader(file, header.data(), &headerSize, &blockSize) == Reader::HEADER_BGZF;
+    fclose(file);
+    return result;
+}
+
+KSeqBgzf::KSeqBgzf(const char* fileName) {
+    reader = new Reader;
+    reader->file = FileUtil::openFileOrDie(fileName, "rb", true);
+    reader->fileName = fileName;
+    reader->gzStream = NULL;
+    reader->blocks.resize(Reader::BATCH_BLOCKS);
+    reader->headerSizes.resize(Reader::BATCH_BLOCKS);
+    reader->blockSizes.resize(Reader::BATCH_BLOCKS);
+    reader->outOffsets.resize(Reader::BATCH_BLOCKS);
+    reader->outPos = 0;
+    reader->outSize = 0;
+    reader->eof = false;
+    seq = (void*) KSEQBGZF::kseq_init(reader);
+    type = KSEQ_BGZF;
+}
+
+bool KSeqBgzf::ReadEntry() {
+    KSEQBGZF::kseq_t* s = (KSEQBGZF::kseq_t*) seq;
+    int result = KSEQBGZF::kseq_read(s);
+    if (result < 0)
+        return false;
+
+    entry.name = s->name;
+    entry.comment = s->comment;
+    entry.sequence = s->seq;
+    entry.qual = s->qual;
+    entry.headerOffset = 0;
+    entry.sequenceOffset = 0;
+    entry.multiline = s->multiline;
+
+    return true;
+}
+
+int KSeqBgzf::PeekChar() {
+    return peekBuffered((KSEQBGZF::kseq_t*) seq);
+}
+
+size_t KSeqBgzf::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQBGZF::kseq_t*) seq, reader, Reader::read, buffer, length);
+}
+
+KSeqBgzf::~KSeqBgzf() {
+    kseq_destroy((KSEQBGZF::kseq_t*)seq);
+    if (reader->gzStream != NULL) {
+        gzclose(reader->gzStream);
+    }
+    if (fclose(reader->file) != 0) {
+        Debug(Debug::ERROR) << "Cannot close KSeq input file\n";
+        EXIT(EXIT_FAILURE);
+    }
+    delete reader;
+}
 #endif
 
 
@@ -150,6 +434,14 @@ bool KSeqBzip::ReadEntry() {
     return true;
 }
 
+int KSeqBzip::PeekChar() {
+    return peekBuffered((KSEQBZIP::kseq_t*) seq);
+}
+
+size_t KSeqBzip::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQBZIP::kseq_t*) seq, file, BZ2_bzread, buffer, length);
+}
+
 KSeqBzip::~KSeqBzip() {
     kseq_destroy((KSEQBZIP::kseq_t*)seq);
     int bzError;
@@ -170,7 +462,11 @@ KSeqWrapper* KSeqFactory(const char* file) {
     }
 #ifdef HAVE_ZLIB
     else if(Util::endsWith(".gz", file) == true) {
-        kseq = new KSeqGzip(file);
+        if (KSeqBgzf::isBgzf(file)) {
+            kseq = new KSeqBgzf(file);
+        } else {
+            kseq = new KSeqGzip(file);
+        }
         return kseq;
     }
 #else
@@ -223,6 +519,14 @@ bool KSeqBuffer::ReadEntry() {
     return true;
 }
 
+int KSeqBuffer::PeekChar() {
+    return peekBuffered((KSEQBUFFER::kseq_t*) seq);
+}
+
+size_t KSeqBuffer::ReadRaw(char* buffer, size_t length) {
+    return readBuffered((KSEQBUFFER::kseq_t*) seq, &d, kseq_buffer_reader, buffer, length);
+}
+
 KSeqBuffer::~KSeqBuffer() {
     kseq_destroy((KSEQBUFFER::kseq_t*)seq);
 }
@@ -22,12 +22,17 @@ public:
         KSEQ_FILE,
         KSEQ_STREAM,
         KSEQ_GZIP,
+        KSEQ_BGZF,
         KSEQ_BZIP,
         KSEQ_BUFFER
     };
     kseq_type type;
 
     virtual bool ReadEntry() = 0;
+    // next input character without consuming it, negative at the end of the input
+    virtual int PeekChar() = 0;
+    // unparsed input for callers that split records themselves, cannot be mixed with ReadEntry
+    virtual size_t ReadRaw(char* buffer, size_t length) = 0;
     virtual ~KSeqWrapper() {};
 
 protected:
@@ -38,6 +43,8 @@ class KSeqFile : public KSeqWrapper {
 public:
     KSeqFile(const char* file);
     bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
     ~KSeqFile();
 private:
     FILE* file;
@@ -48,6 +55,8 @@ class KSeqStream : public KSeqWrapper {
 public:
     KSeqStream();
     bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
     ~KSeqStream();
 };
 
@@ -58,10 +67,29 @@ class KSeqGzip : public KSeqWrapper {
 public:
     KSeqGzip(const char* file);
     bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
     ~KSeqGzip();
 private:
     gzFile file;
 };
+
+// BGZF files (bgzip, htslib) are a series of gzip members that each store their compressed size,
+// a batch of members is read at once and inflated in parallel. After a plain gzip member zlib reads the rest of the file.
+class KSeqBgzf : public KSeqWrapper {
+public:
+    KSeqBgzf(const char* file);
+    bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
+    ~KSeqBgzf();
+
+    static bool isBgzf(const char* file);
+
+    struct Reader;
+private:
+    Reader* reader;
+};
 #endif
 
 #ifdef HAVE_BZLIB
@@ -71,6 +99,8 @@ class KSeqBzip : public KSeqWrapper {
 public:
     KSeqBzip(const char* file);
     bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
     ~KSeqBzip();
 private:
     BZFILE *file;
@@ -81,6 +111,8 @@ class KSeqBuffer : public KSeqWrapper {
 public:
     KSeqBuffer(const char* buffer, size_t length);
     bool ReadEntry();
+    int PeekChar();
+    size_t ReadRaw(char* buffer, size_t length);
     ~KSeqBuffer();
 private:
     kseq_buffer_t d;
@@ -0,0 +1,229 @@
+#include "LargeMemory.h"
+#include "Util.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <dirent.h>
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+int LargeMemory::hugePageMode = LargeMemory::HUGE_PAGES_OFF;
+int LargeMemory::numaMode = LargeMemory::NUMA_OFF;
+size_t LargeMemory::hugePageSize = 2 * 1024 * 1024;
+std::vector<int> LargeMemory::nodes;
+
+namespace {
+// memory policies from linux/mempolicy.h, mbind is called directly to avoid a dependency on libnuma
+const int POLICY_BIND = 2;
+const int POLICY_INTERLEAVE = 3;
+
+bool bindMemory(void *memory, size_t size, int policy, const std::vector<int> &nodeIds) {
+#if defined(__linux__) && defined(SYS_mbind)
+    const size_t bits = 8 * sizeof(unsigned long);
+    int maxNode = 0;
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        maxNode = std::max(maxNode, nodeIds[i]);
+    }
+    std::vector<unsigned long> mask(maxNode / bits + 1, 0);
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        mask[nodeIds[i] / bits] |= 1UL << (nodeIds[i] % bits);
+    }
+    // the kernel reads one bit less than maxnode
+    return syscall(SYS_mbind, memory, size, policy, mask.data(), mask.size() * bits + 1, 0) == 0;
+#else
+    (void) memory; (void) size; (void) policy; (void) nodeIds;
+    return false;
+#endif
+}
+
+// parses a cpulist like 0-3,8-11
+std::vector<int> readCpuList(int node) {
+    std::vector<int> cpus;
+    std::ifstream file(("/sys/devices/system/node/node" + SSTR(node) + "/cpulist").c_str());
+    std::string list;
+    if (!std::getline(file, list)) {
+        return cpus;
+    }
+    std::vector<std::string> ranges = Util::split(list, ",");
+    for (size_t i = 0; i < ranges.size(); i++) {
+        size_t dash = ranges[i].find('-');
+        int from = atoi(ranges[i].c_str());
+        int to = (dash == std::string::npos) ? from : atoi(ranges[i].c_str() + dash + 1);
+        for (int cpu = from; cpu <= to; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+}
+
+void LargeMemory::init(int hugePages, int numa) {
+    hugePageMode = hugePages;
+    numaMode = numa;
+    nodes.clear();
+#ifdef __linux__
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4])) {
+                nodes.push_back(atoi(entry->d_name + 4));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    // MAP_HUGETLB uses the default huge page size, which can also be 1GB
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        if (line.compare(0, 13, "Hugepagesize:") == 0) {
+            size_t kiloBytes = strtoull(line.c_str() + 13, NULL, 10);
+            if (kiloBytes > 0) {
+                hugePageSize = kiloBytes * 1024;
+            }
+            break;
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    if (numaMode != NUMA_OFF && nodes.size() == 1) {
+        Debug(Debug::INFO) << "Only one NUMA node found, NUMA mode has no effect\n";
+    }
+}
+
+size_t LargeMemory::getNodeCount() {
+    return std::max(nodes.size(), static_cast<size_t>(1));
+}
+
+size_t LargeMemory::mappingSize(size_t size) {
+    const size_t unit = (hugePageMode == HUGE_PAGES_OFF) ? Util::getPageSize() : hugePageSize;
+    return std::max((size + unit - 1) / unit, static_cast<size_t>(1)) * unit;
+}
+
+void *LargeMemory::allocate(size_t size, int node) {
+    const size_t length = mappingSize(size);
+    void *memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (hugePageMode == HUGE_PAGES_EXPLICIT) {
+        memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory == MAP_FAILED) {
+            static bool warned = false;
+            if (__sync_bool_compare_and_swap(&warned, false, true)) {
+                Debug(Debug::WARNING) << "Not enough reserved huge pages for " << length << " bytes, using transparent huge pages\n";
+            }
+        }
+    }
+#endif
+    if (memory == MAP_FAILED) {
+        memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        if (hugePageMode != HUGE_PAGES_OFF) {
+            madvise(memory, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // the policy decides where pages go when they are first touched
+    if (nodes.size() > 1 && node >= 0) {
+        std::vector<int> target(1, nodes[node % nodes.size()]);
+        if (bindMemory(memory, length, POLICY_BIND, target) == false) {
+            Debug(Debug::WARNING) << "Could not bind memory to NUMA node " << target[0] << "\n";
+        }
+    } else if (nodes.size() > 1 && numaMode != NUMA_OFF) {
+        if (bindMemory(memory, length, POLICY_INTERLEAVE, nodes) == false) {
+            Debug(Debug::WARNING) << "Could not interleave memory over NUMA nodes\n";
+        }
+    }
+    return memory;
+}
+
+void LargeMemory::release(void *memory, size_t size) {
+    if (memory != NULL) {
+        munmap(memory, mappingSize(size));
+    }
+}
+
+void LargeMemory::adviseMapped(const void *memory, size_t size) {
+#ifdef MADV_HUGEPAGE
+    if (hugePageMode == HUGE_PAGES_OFF || size == 0) {
+        return;
+    }
+    const size_t pageSize = Util::getPageSize();
+    uintptr_t from = reinterpret_cast<uintptr_t>(memory) & ~(pageSize - 1);
+    uintptr_t to = reinterpret_cast<uintptr_t>(memory) + size;
+    // only takes effect if the kernel supports huge pages in the page cache
+    madvise(reinterpret_cast<void *>(from), to - from, MADV_HUGEPAGE);
+#else
+    (void) memory;
+    (void) size;
+#endif
+}
+
+bool LargeMemory::pinThread(size_t node, std::vector<int> &previousCpus) {
+#ifdef __linux__
+    if (nodes.size() < 2) {
+        return false;
+    }
+    std::vector<int> cpus = readCpuList(nodes[node % nodes.size()]);
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+        return false;
+    }
+    previousCpus.clear();
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            previousCpus.push_back(cpu);
+        }
+    }
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < cpus.size(); i++) {
+        if (cpus[i] < CPU_SETSIZE) {
+            CPU_SET(cpus[i], &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+#else
+    (void) node;
+    (void) previousCpus;
+    return false;
+#endif
+}
+
+void LargeMemory::unpinThread(const std::vector<int> &previousCpus) {
+#ifdef __linux__
+    if (previousCpus.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < previousCpus.size(); i++) {
+        CPU_SET(previousCpus[i], &set);
+    }
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+        Debug(Debug::WARNING) << "Could not restore the CPUs of a pinned thread\n";
+    }
+#else
+    (void) previousCpus;
+#endif
+}
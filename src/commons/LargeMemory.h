@@ -0,0 +1,59 @@
+#ifndef MMSEQS_LARGEMEMORY_H
+#define MMSEQS_LARGEMEMORY_H
+
+// Allocations for large, randomly accessed arrays such as the prefilter index table and sequence lookup.
+// They can be backed by huge pages to reduce TLB misses, and interleaved over NUMA nodes or placed on a single node.
+// Memory comes from anonymous mappings, so it is zero initialized and has to be freed with release.
+#include <cstddef>
+#include <vector>
+
+class LargeMemory {
+public:
+    enum HugePageMode {
+        HUGE_PAGES_OFF = 0,
+        // madvise(MADV_HUGEPAGE), the kernel backs the memory with transparent huge pages if it can
+        HUGE_PAGES_TRANSPARENT = 1,
+        // MAP_HUGETLB from the reserved huge page pool, falls back to transparent huge pages
+        HUGE_PAGES_EXPLICIT = 2
+    };
+
+    enum NumaMode {
+        NUMA_OFF = 0,
+        // pages are spread round-robin over all nodes
+        NUMA_INTERLEAVE = 1,
+        // interleaved, and callers keep a copy of their hottest arrays on every node
+        NUMA_REPLICATE = 2
+    };
+
+    static void init(int hugePageMode, int numaMode);
+
+    static int getNumaMode() {
+        return numaMode;
+    }
+
+    static size_t getNodeCount();
+
+    // node is an index into the available NUMA nodes, -1 follows the NUMA mode
+    static void *allocate(size_t size, int node = -1);
+
+    static void release(void *memory, size_t size);
+
+    // huge page hint for data that is memory mapped from a file
+    static void adviseMapped(const void *memory, size_t size);
+
+    // restricts the calling thread to the CPUs of node and keeps its previous CPUs, returns false if this is not supported
+    static bool pinThread(size_t node, std::vector<int> &previousCpus);
+
+    // gives a pinned thread its previous CPUs back, OpenMP threads are reused by later parallel regions
+    static void unpinThread(const std::vector<int> &previousCpus);
+
+private:
+    static int hugePageMode;
+    static int numaMode;
+    static size_t hugePageSize;
+    static std::vector<int> nodes;
+
+    static size_t mappingSize(size_t size);
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include "CommandCaller.h"
 #include "ByteParser.h"
 #include "FileUtil.h"
+#include "ProfileReport.h"
+#include "SimdDispatch.h"
 
 #include <map>
 #include <iomanip>
@@ -39,10 +41,20 @@ Parameters::Parameters():
         PARAM_K(PARAM_K_ID, "-k", "k-mer length", "k-mer length (0: automatically set to optimum)", typeid(int), (void *) &kmerSize, "^[0-9]{1}[0-9]*$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_CLUSTLINEAR | MMseqsParameter::COMMAND_EXPERT),
         PARAM_THREADS(PARAM_THREADS_ID, "--threads", "Threads", "Number of CPU-cores used (all by default)", typeid(int), (void *) &threads, "^[1-9]{1}[0-9]*$", MMseqsParameter::COMMAND_COMMON),
         PARAM_COMPRESSED(PARAM_COMPRESSED_ID, "--compressed", "Compressed", "Write compressed output", typeid(int), (void *) &compressed, "^[0-1]{1}$", MMseqsParameter::COMMAND_COMMON),
+        PARAM_COMPRESSION_DICT_SIZE(PARAM_COMPRESSION_DICT_SIZE_ID, "--compression-dict-size", "Compression dictionary size", "Train a zstd dictionary of this many bytes on the entries of compressed sequence and header DBs (0: no dictionary)", typeid(int), (void *) &compressionDictSize, "^[0-9]{1}[0-9]*$", MMseqsParameter::COMMAND_COMMON | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_COMPRESSION_BLOCK_SIZE(PARAM_COMPRESSION_BLOCK_SIZE_ID, "--compression-block-size", "Compression block size", "Compress consecutive entries together in seekable zstd frames of this size, e.g. 1M. Scans decompress the frames in parallel (0: compress each entry on its own)", typeid(ByteParser), (void *) &compressionBlockSize, "^(0|[1-9]{1}[0-9]*(B|K|M|G|T)?)$", MMseqsParameter::COMMAND_COMMON | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_ASYNC_WRITE(PARAM_ASYNC_WRITE_ID, "--async-write", "Async write", "Compress and write results in background threads while the computation continues", typeid(bool), (void *) &asyncWrite, "", MMseqsParameter::COMMAND_COMMON | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_BINARY_RESULT(PARAM_BINARY_RESULT_ID, "--binary-result", "Binary result", "Write prefilter and alignment results as packed binary records (convert with convertalis or createtsv)", typeid(bool), (void *) &binaryResult, "", MMseqsParameter::COMMAND_EXPERT),
+        PARAM_PROFILE_REPORT(PARAM_PROFILE_REPORT_ID, "--profile-report", "Profile report", "Write wall/CPU time, I/O, k-mer and alignment counters of all called modules as JSON to this file", typeid(std::string), (void *) &profileReport, "", MMseqsParameter::COMMAND_COMMON | MMseqsParameter::COMMAND_EXPERT),
         PARAM_ALPH_SIZE(PARAM_ALPH_SIZE_ID, "--alph-size", "Alphabet size", "Alphabet size (range 2-21)", typeid(MultiParam<NuclAA<int>>), (void *) &alphabetSize, "", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_CLUSTLINEAR | MMseqsParameter::COMMAND_EXPERT),
         PARAM_MAX_SEQ_LEN(PARAM_MAX_SEQ_LEN_ID, "--max-seq-len", "Max sequence length", "Maximum sequence length", typeid(size_t), (void *) &maxSeqLen, "^[0-9]{1}[0-9]*", MMseqsParameter::COMMAND_COMMON | MMseqsParameter::COMMAND_EXPERT),
         PARAM_DIAGONAL_SCORING(PARAM_DIAGONAL_SCORING_ID, "--diag-score", "Diagonal scoring", "Use ungapped diagonal scoring during prefilter", typeid(bool), (void *) &diagonalScoring, "", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
         PARAM_EXACT_KMER_MATCHING(PARAM_EXACT_KMER_MATCHING_ID, "--exact-kmer-matching", "Exact k-mer matching", "Extract only exact k-mers for matching (range 0-1)", typeid(int), (void *) &exactKmerMatching, "^[0-1]{1}$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_QUERY_BATCH_SIZE(PARAM_QUERY_BATCH_SIZE_ID, "--query-batch-size", "Query batch size", "Look up the k-mers of this many queries in k-mer order (0: one query at a time)", typeid(int), (void *) &queryBatchSize, "^[0-9]{1}[0-9]*$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_KMER_CACHE_SIZE(PARAM_KMER_CACHE_SIZE_ID, "--kmer-cache-size", "K-mer list cache size", "Memory for caching the similar k-mer lists of recurring query k-mers, shared by all threads. E.g. 800B, 5K, 10M, 1G. 0: no cache", typeid(ByteParser), (void *) &kmerCacheSize, "^(0|[1-9]{1}[0-9]*(B|K|M|G|T)?)$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_PACK_SEQUENCE_LOOKUP(PARAM_PACK_SEQUENCE_LOOKUP_ID, "--pack-seq-lookup", "Pack sequence lookup", "Keep the target sequences of the diagonal scoring with 2-5 bits per residue instead of a byte", typeid(bool), (void *) &packSequenceLookup, "", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_HUGE_PAGES(PARAM_HUGE_PAGES_ID, "--huge-pages", "Huge pages", "Back the prefilter index table and sequence lookup with huge pages 0: off, 1: transparent huge pages, 2: reserved huge pages (MAP_HUGETLB)", typeid(int), (void *) &hugePages, "^[0-2]{1}$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_NUMA_MODE(PARAM_NUMA_MODE_ID, "--numa-mode", "NUMA mode", "Placement of the prefilter index table and sequence lookup on NUMA nodes 0: default, 1: interleave over all nodes, 2: interleave and keep a copy of the index table per node, threads are pinned to nodes", typeid(int), (void *) &numaMode, "^[0-2]{1}$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
         PARAM_MASK_RESIDUES(PARAM_MASK_RESIDUES_ID, "--mask", "Mask residues", "Mask sequences in k-mer stage: 0: w/o low complexity masking, 1: with low complexity masking", typeid(int), (void *) &maskMode, "^[0-1]{1}", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
         PARAM_MASK_PROBABILTY(PARAM_MASK_PROBABILTY_ID, "--mask-prob", "Mask residues probability", "Mask sequences is probablity is above threshold", typeid(float), (void *) &maskProb, "^0(\\.[0-9]+)?|^1(\\.0+)?$", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
         PARAM_MASK_LOWER_CASE(PARAM_MASK_LOWER_CASE_ID, "--mask-lower-case", "Mask lower case residues", "Lowercase letters will be excluded from k-mer search 0: include region, 1: exclude region", typeid(int), (void *) &maskLowerCaseMode, "^[0-1]{1}", MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_EXPERT),
@@ -167,6 +179,7 @@ Parameters::Parameters():
         PARAM_ORF_FILTER_S(PARAM_ORF_FILTER_S_ID, "--orf-filter-s", "ORF filter sensitivity", "Sensitivity used for query ORF prefiltering", typeid(float), (void *) &orfFilterSens, "^[0-9]*(\\.[0-9]+)?$"),
         PARAM_ORF_FILTER_E(PARAM_ORF_FILTER_E_ID, "--orf-filter-e", "ORF filter e-value", "E-value threshold used for query ORF prefiltering", typeid(double), (void *) &orfFilterEval, "^([-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?)|[0-9]*(\\.[0-9]+)?$"),
         PARAM_LCA_SEARCH(PARAM_LCA_SEARCH_ID, "--lca-search", "LCA search mode", "Efficient search for LCA candidates", typeid(bool), (void *) &lcaSearch, "", MMseqsParameter::COMMAND_PROFILE | MMseqsParameter::COMMAND_EXPERT),
+        PARAM_STREAM_SEARCH(PARAM_STREAM_SEARCH_ID, "--stream-search", "Stream search", "Align prefilter hits in the same process without writing a prefilter database (single step amino acid searches only)", typeid(bool), (void *) &streamSearch, "", MMseqsParameter::COMMAND_EXPERT),
         // easysearch
         PARAM_GREEDY_BEST_HITS(PARAM_GREEDY_BEST_HITS_ID, "--greedy-best-hits", "Greedy best hits", "Choose the best hits greedily to cover the query", typeid(bool), (void *) &greedyBestHits, ""),
         // extractorfs
@@ -317,6 +330,12 @@ Parameters::Parameters():
     onlythreads.push_back(&PARAM_THREADS);
     onlythreads.push_back(&PARAM_V);
 
+    // compress
+    compress.push_back(&PARAM_THREADS);
+    compress.push_back(&PARAM_COMPRESSION_DICT_SIZE);
+    compress.push_back(&PARAM_COMPRESSION_BLOCK_SIZE);
+    compress.push_back(&PARAM_V);
+
     // threadsandcompression
     threadsandcompression.push_back(&PARAM_THREADS);
     threadsandcompression.push_back(&PARAM_COMPRESSED);
@@ -384,8 +403,11 @@ Parameters::Parameters():
     align.push_back(&PARAM_GAP_OPEN);
     align.push_back(&PARAM_GAP_EXTEND);
     align.push_back(&PARAM_ZDROP);
+    align.push_back(&PARAM_BINARY_RESULT);
+    align.push_back(&PARAM_ASYNC_WRITE);
     align.push_back(&PARAM_THREADS);
     align.push_back(&PARAM_COMPRESSED);
+    align.push_back(&PARAM_PROFILE_REPORT);
     align.push_back(&PARAM_V);
 
     // prefilter
@@ -406,6 +428,11 @@ Parameters::Parameters():
     prefilter.push_back(&PARAM_NO_COMP_BIAS_CORR_SCALE);
     prefilter.push_back(&PARAM_DIAGONAL_SCORING);
     prefilter.push_back(&PARAM_EXACT_KMER_MATCHING);
+    prefilter.push_back(&PARAM_QUERY_BATCH_SIZE);
+    prefilter.push_back(&PARAM_KMER_CACHE_SIZE);
+    prefilter.push_back(&PARAM_PACK_SEQUENCE_LOOKUP);
+    prefilter.push_back(&PARAM_HUGE_PAGES);
+    prefilter.push_back(&PARAM_NUMA_MODE);
     prefilter.push_back(&PARAM_MASK_RESIDUES);
     prefilter.push_back(&PARAM_MASK_PROBABILTY);
     prefilter.push_back(&PARAM_MASK_LOWER_CASE);
@@ -417,8 +444,11 @@ Parameters::Parameters():
     prefilter.push_back(&PARAM_PCB);
     prefilter.push_back(&PARAM_SPACED_KMER_PATTERN);
     prefilter.push_back(&PARAM_LOCAL_TMP);
+    prefilter.push_back(&PARAM_BINARY_RESULT);
+    prefilter.push_back(&PARAM_ASYNC_WRITE);
     prefilter.push_back(&PARAM_THREADS);
     prefilter.push_back(&PARAM_COMPRESSED);
+    prefilter.push_back(&PARAM_PROFILE_REPORT);
     prefilter.push_back(&PARAM_V);
 
     // ungappedprefilter
@@ -432,6 +462,7 @@ Parameters::Parameters():
     ungappedprefilter.push_back(&PARAM_MAX_SEQS);
     ungappedprefilter.push_back(&PARAM_THREADS);
     ungappedprefilter.push_back(&PARAM_COMPRESSED);
+    ungappedprefilter.push_back(&PARAM_PROFILE_REPORT);
     ungappedprefilter.push_back(&PARAM_V);
 
     // clustering
@@ -440,6 +471,7 @@ Parameters::Parameters():
     clust.push_back(&PARAM_SIMILARITYSCORE);
     clust.push_back(&PARAM_THREADS);
     clust.push_back(&PARAM_COMPRESSED);
+    clust.push_back(&PARAM_PROFILE_REPORT);
     clust.push_back(&PARAM_V);
 
     // rescorediagonal
@@ -459,6 +491,7 @@ Parameters::Parameters():
     rescorediagonal.push_back(&PARAM_PRELOAD_MODE);
     rescorediagonal.push_back(&PARAM_THREADS);
     rescorediagonal.push_back(&PARAM_COMPRESSED);
+    rescorediagonal.push_back(&PARAM_PROFILE_REPORT);
     rescorediagonal.push_back(&PARAM_V);
 
     // alignbykmer
@@ -525,6 +558,7 @@ Parameters::Parameters():
     result2profile.push_back(&PARAM_GAP_PSEUDOCOUNT);
     result2profile.push_back(&PARAM_THREADS);
     result2profile.push_back(&PARAM_COMPRESSED);
+    result2profile.push_back(&PARAM_ASYNC_WRITE);
     result2profile.push_back(&PARAM_V);
 
     // createtsv
@@ -763,7 +797,11 @@ Parameters::Parameters():
     createdb.push_back(&PARAM_CREATEDB_MODE);
     createdb.push_back(&PARAM_WRITE_LOOKUP);
     createdb.push_back(&PARAM_ID_OFFSET);
+    createdb.push_back(&PARAM_THREADS);
     createdb.push_back(&PARAM_COMPRESSED);
+    createdb.push_back(&PARAM_COMPRESSION_DICT_SIZE);
+    createdb.push_back(&PARAM_COMPRESSION_BLOCK_SIZE);
+    createdb.push_back(&PARAM_PROFILE_REPORT);
     createdb.push_back(&PARAM_V);
 
     // convert2fasta
@@ -937,6 +975,7 @@ Parameters::Parameters():
     kmermatcher.push_back(&PARAM_IGNORE_MULTI_KMER);
     kmermatcher.push_back(&PARAM_THREADS);
     kmermatcher.push_back(&PARAM_COMPRESSED);
+    kmermatcher.push_back(&PARAM_PROFILE_REPORT);
     kmermatcher.push_back(&PARAM_V);
 
     // kmermatcher
@@ -954,6 +993,7 @@ Parameters::Parameters():
     kmersearch.push_back(&PARAM_SPLIT_MEMORY_LIMIT);
     kmersearch.push_back(&PARAM_THREADS);
     kmersearch.push_back(&PARAM_COMPRESSED);
+    kmersearch.push_back(&PARAM_PROFILE_REPORT);
     kmersearch.push_back(&PARAM_V);
 
     // countkmer
@@ -1196,6 +1236,9 @@ Parameters::Parameters():
     sortresult.push_back(&PARAM_THREADS);
     sortresult.push_back(&PARAM_V);
 
+    // prefilter and align in one step
+    prefilteralign = combineList(prefilter, align);
+
     // WORKFLOWS
     searchworkflow = combineList(align, prefilter);
     searchworkflow = combineList(searchworkflow, rescorediagonal);
@@ -1213,6 +1256,7 @@ Parameters::Parameters():
     searchworkflow.push_back(&PARAM_EXHAUSTIVE_SEARCH_FILTER);
     searchworkflow.push_back(&PARAM_STRAND);
     searchworkflow.push_back(&PARAM_LCA_SEARCH);
+    searchworkflow.push_back(&PARAM_STREAM_SEARCH);
     searchworkflow.push_back(&PARAM_DISK_SPACE_LIMIT);
     searchworkflow.push_back(&PARAM_RUNNER);
     searchworkflow.push_back(&PARAM_REUSELATEST);
@@ -1990,6 +2034,8 @@ void Parameters::parseParameters(int argc, const char *pargv[], const Command &c
 
     initMatrices();
 
+    ProfileReport::init(profileReport, command.cmd);
+
     if (ignorePathCountChecks == false) {
         checkIfDatabaseIsValid(command, argc, pargv, isStartVar, isMiddleVar, isEndVar);
     }
@@ -2147,6 +2193,8 @@ void Parameters::printParameters(const std::string &module, int argc, const char
     ss << std::boolalpha;
 
     ss << std::setw(maxWidth) << std::left  << "MMseqs Version:" << "\t" << version << "\n";
+    ss << std::setw(maxWidth) << std::left  << "SIMD kernels:" << "\t" << SimdDispatch::kernelName()
+       << " (" << SimdDispatch::baselineName() << " baseline)\n";
 
 
     for (size_t i = 0; i < par.size(); i++) {
@@ -2226,11 +2274,17 @@ void Parameters::setDefaults() {
     orfFilterSens = 2.0;
     orfFilterEval = 100;
     lcaSearch = false;
+    streamSearch = false;
 
     greedyBestHits = false;
 
     threads = 1;
     compressed = WRITER_ASCII_MODE;
+    compressionDictSize = 0;
+    compressionBlockSize = 0;
+    asyncWrite = false;
+    binaryResult = false;
+    profileReport = "";
 #ifdef OPENMP
     char * threadEnv = getenv("MMSEQS_NUM_THREADS");
     if (threadEnv != NULL) {
@@ -2249,6 +2303,11 @@ void Parameters::setDefaults() {
     compBiasCorrectionScale = 1.0;
     diagonalScoring = true;
     exactKmerMatching = 0;
+    queryBatchSize = 0;
+    kmerCacheSize = 0;
+    packSequenceLookup = false;
+    hugePages = 0;
+    numaMode = 0;
     maskMode = 1;
     maskProb = 0.9;
     maskLowerCaseMode = 0;
@@ -86,6 +86,8 @@ public:
     static const unsigned int DBTYPE_EXTENDED_COMPRESSED = 1;
     static const unsigned int DBTYPE_EXTENDED_INDEX_NEED_SRC = 2;
     static const unsigned int DBTYPE_EXTENDED_CONTEXT_PSEUDO_COUNTS = 4;
+    static const unsigned int DBTYPE_EXTENDED_BINARY_RESULT = 8;
+    static const unsigned int DBTYPE_EXTENDED_BLOCK_COMPRESSED = 16;
 
     // don't forget to add new database types to DBReader::getDbTypeName and Parameters::PARAM_OUTPUT_DBTYPE
 
@@ -123,6 +125,7 @@ public:
     static const unsigned int WRITER_ASCII_MODE = 0;
     static const unsigned int WRITER_COMPRESSED_MODE = 1;
     static const unsigned int WRITER_LEXICOGRAPHIC_MODE = 2;
+    static const unsigned int WRITER_ASYNC_MODE = 4;
 
     // convertalis alignment
     static const int FORMAT_ALIGNMENT_BLAST_TAB = 0;
@@ -367,6 +370,11 @@ public:
     int    verbosity;                    // log level
     int    threads;                      // Amounts of threads
     int    compressed;                   // compressed writer
+    int    compressionDictSize;          // size of the zstd dictionary trained for compressed DBs
+    size_t compressionBlockSize;         // decompressed size of the zstd frames of block compressed DBs
+    bool   asyncWrite;                   // compress and write results in background threads
+    bool   binaryResult;                 // write prefilter/alignment results as packed binary records
+    std::string profileReport;           // JSON file for performance counters
     bool   removeTmpFiles;               // Do not delete temp files
     bool   includeIdentity;              // include identical ids as hit
 
@@ -380,6 +388,11 @@ public:
 
     bool   diagonalScoring;              // switch diagonal scoring
     int    exactKmerMatching;            // only exact k-mer matching
+    int    queryBatchSize;               // queries whose k-mers are looked up together in the prefilter
+    size_t kmerCacheSize;                // memory for cached similar k-mer lists in the prefilter
+    bool   packSequenceLookup;           // bit packed target sequences for the diagonal scoring
+    int    hugePages;                    // huge pages for the prefilter index
+    int    numaMode;                     // NUMA placement of the prefilter index
     int    maskMode;                     // mask low complex areas
     float  maskProb;                     // mask probability
     int    maskLowerCaseMode;            // mask lowercase letters in prefilter and kmermatchers
@@ -441,6 +454,7 @@ public:
     float orfFilterSens;
     double orfFilterEval;
     bool lcaSearch;
+    bool streamSearch;
 
     // easysearch
     bool greedyBestHits;
@@ -707,10 +721,20 @@ public:
     PARAMETER(PARAM_K)
     PARAMETER(PARAM_THREADS)
     PARAMETER(PARAM_COMPRESSED)
+    PARAMETER(PARAM_COMPRESSION_DICT_SIZE)
+    PARAMETER(PARAM_COMPRESSION_BLOCK_SIZE)
+    PARAMETER(PARAM_ASYNC_WRITE)
+    PARAMETER(PARAM_BINARY_RESULT)
+    PARAMETER(PARAM_PROFILE_REPORT)
     PARAMETER(PARAM_ALPH_SIZE)
     PARAMETER(PARAM_MAX_SEQ_LEN)
     PARAMETER(PARAM_DIAGONAL_SCORING)
     PARAMETER(PARAM_EXACT_KMER_MATCHING)
+    PARAMETER(PARAM_QUERY_BATCH_SIZE)
+    PARAMETER(PARAM_KMER_CACHE_SIZE)
+    PARAMETER(PARAM_PACK_SEQUENCE_LOOKUP)
+    PARAMETER(PARAM_HUGE_PAGES)
+    PARAMETER(PARAM_NUMA_MODE)
     PARAMETER(PARAM_MASK_RESIDUES)
     PARAMETER(PARAM_MASK_PROBABILTY)
     PARAMETER(PARAM_MASK_LOWER_CASE)
@@ -735,6 +759,7 @@ public:
     PARAMETER(PARAM_LOCAL_TMP)
     std::vector<MMseqsParameter*> prefilter;
     std::vector<MMseqsParameter*> ungappedprefilter;
+    std::vector<MMseqsParameter*> prefilteralign;
 
     // alignment
     PARAMETER(PARAM_ALIGNMENT_MODE)
@@ -849,6 +874,7 @@ public:
     PARAMETER(PARAM_ORF_FILTER_S)
     PARAMETER(PARAM_ORF_FILTER_E)
     PARAMETER(PARAM_LCA_SEARCH)
+    PARAMETER(PARAM_STREAM_SEARCH)
 
     // easysearch
     PARAMETER(PARAM_GREEDY_BEST_HITS)
@@ -1035,6 +1061,7 @@ public:
     std::vector<MMseqsParameter*> view;
     std::vector<MMseqsParameter*> verbandcompression;
     std::vector<MMseqsParameter*> onlythreads;
+    std::vector<MMseqsParameter*> compress;
     std::vector<MMseqsParameter*> threadsandcompression;
 
     std::vector<MMseqsParameter*> alignall;
@@ -0,0 +1,278 @@
+#include "ProfileReport.h"
+#include "MemoryTracker.h"
+#include "FileUtil.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+bool ProfileReport::enabled = false;
+
+namespace {
+const char *PARTS_VARIABLE = "MMSEQS_PROFILE_REPORT_PARTS";
+const size_t MAX_SLOTS = 256;
+
+// one cache line of counters per thread, threads beyond MAX_SLOTS share slots
+struct CounterSlot {
+    size_t values[ProfileReport::COUNTER_COUNT];
+} __attribute__((aligned(64)));
+CounterSlot slots[MAX_SLOTS];
+
+const char *counterNames[ProfileReport::COUNTER_COUNT] = {
+    "db_bytes_read",
+    "db_bytes_written",
+    "kmers_generated",
+    "db_matches",
+    "double_matches",
+    "diagonal_overflow",
+    "sw_cells",
+    "kmer_cache_hits",
+    "kmer_cache_misses"
+};
+
+struct PhaseRecord {
+    PhaseRecord(const char *name, double wallTime, double cpuTime) : name(name), wallTime(wallTime), cpuTime(cpuTime) {}
+    std::string name;
+    double wallTime;
+    double cpuTime;
+};
+
+std::vector<PhaseRecord> phases;
+std::string moduleName;
+std::string reportFile;
+std::string partsFile;
+bool owner = false;
+bool written = false;
+double startWall = 0;
+double startCpu = 0;
+
+double wallTime() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + 1e-6 * now.tv_usec;
+}
+
+double cpuTime() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + 1e-6 * usage.ru_utime.tv_usec + usage.ru_stime.tv_sec + 1e-6 * usage.ru_stime.tv_usec;
+}
+
+size_t peakRss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    // kilobytes on Linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+size_t counterValue(size_t counter) {
+    size_t sum = 0;
+    for (size_t i = 0; i < MAX_SLOTS; ++i) {
+        sum += slots[i].values[counter];
+    }
+    return sum;
+}
+
+std::string escape(const std::string &value) {
+    std::string out;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '"' || value[i] == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(value[i]);
+    }
+    return out;
+}
+
+// report of this process as a single line JSON object
+std::string processReport() {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"module\":\"" << escape(moduleName) << "\""
+       << ",\"pid\":" << getpid()
+       << ",\"wall_time_s\":" << (wallTime() - startWall)
+       << ",\"cpu_time_s\":" << (cpuTime() - startCpu)
+       << ",\"peak_rss_bytes\":" << peakRss()
+       << ",\"peak_tracked_bytes\":" << MemoryTracker::getPeakSize()
+       << ",\"counters\":{";
+    for (size_t i = 0; i < ProfileReport::COUNTER_COUNT; ++i) {
+        ss << (i > 0 ? "," : "") << "\"" << counterNames[i] << "\":" << counterValue(i);
+    }
+    ss << "},\"phases\":[";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        ss << (i > 0 ? "," : "") << "{\"name\":\"" << escape(phases[i].name) << "\""
+           << ",\"wall_time_s\":" << phases[i].wallTime
+           << ",\"cpu_time_s\":" << phases[i].cpuTime << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+// top level values are written before the phases, so the first occurrence of a key is the process value
+double readValue(const std::string &report, const char *key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = report.find(pattern);
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    return strtod(report.c_str() + pos + pattern.size(), NULL);
+}
+
+void appendPart() {
+    std::string line = processReport();
+    line.push_back('\n');
+    // a single append write keeps lines of concurrently finishing modules intact
+    int fd = open(partsFile.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (fd == -1) {
+        Debug(Debug::WARNING) << "Could not append profile report to " << partsFile << "\n";
+        return;
+    }
+    if (write(fd, line.c_str(), line.size()) != static_cast<ssize_t>(line.size())) {
+        Debug(Debug::WARNING) << "Could not append profile report to " << partsFile << "\n";
+    }
+    close(fd);
+}
+
+void writeReport() {
+    std::string self = processReport();
+    std::vector<std::string> children;
+    std::ifstream parts(partsFile.c_str());
+    std::string line;
+    while (std::getline(parts, line)) {
+        if (line.empty() == false) {
+            children.push_back(line);
+        }
+    }
+    parts.close();
+
+    // CPU time and counters of all modules add up, the wall time is the one of the owner
+    std::vector<double> totals(ProfileReport::COUNTER_COUNT, 0);
+    double cpuTotal = 0;
+    double peakRssMax = 0;
+    for (size_t i = 0; i <= children.size(); ++i) {
+        const std::string &report = (i == children.size()) ? self : children[i];
+        for (size_t j = 0; j < ProfileReport::COUNTER_COUNT; ++j) {
+            totals[j] += readValue(report, counterNames[j]);
+        }
+        cpuTotal += readValue(report, "cpu_time_s");
+        peakRssMax = std::max(peakRssMax, readValue(report, "peak_rss_bytes"));
+    }
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\n\"total\":{\"wall_time_s\":" << readValue(self, "wall_time_s")
+       << ",\"cpu_time_s\":" << cpuTotal
+       << ",\"peak_rss_bytes\":" << static_cast<size_t>(peakRssMax)
+       << ",\"modules\":" << (children.size() + 1)
+       << ",\"counters\":{";
+    for (size_t j = 0; j < ProfileReport::COUNTER_COUNT; ++j) {
+        ss << (j > 0 ? "," : "") << "\"" << counterNames[j] << "\":" << static_cast<size_t>(totals[j]);
+    }
+    ss << "}},\n\"report\":" << self << ",\n\"children\":[";
+    for (size_t i = 0; i < children.size(); ++i) {
+        ss << (i > 0 ? "," : "") << "\n" << children[i];
+    }
+    ss << "\n]}\n";
+
+    std::string report = ss.str();
+    FILE *file = fopen(reportFile.c_str(), "w");
+    if (file == NULL) {
+        Debug(Debug::WARNING) << "Could not write profile report to " << reportFile << "\n";
+        return;
+    }
+    fwrite(report.c_str(), sizeof(char), report.size(), file);
+    fclose(file);
+    if (FileUtil::fileExists(partsFile.c_str())) {
+        FileUtil::remove(partsFile.c_str());
+    }
+}
+
+void finish() {
+    if (written) {
+        return;
+    }
+    written = true;
+    if (owner) {
+        writeReport();
+    } else {
+        appendPart();
+    }
+}
+}
+
+void ProfileReport::init(const std::string &file, const char *module) {
+    if (enabled) {
+        return;
+    }
+    const char *parts = getenv(PARTS_VARIABLE);
+    if (parts != NULL && parts[0] != '\0') {
+        partsFile = parts;
+        owner = false;
+    } else if (file.empty() == false) {
+        reportFile = file;
+        if (reportFile[0] != '/') {
+            reportFile = FileUtil::getCurrentWorkingDirectory() + "/" + reportFile;
+        }
+        partsFile = reportFile + ".parts";
+        if (FileUtil::fileExists(partsFile.c_str())) {
+            FileUtil::remove(partsFile.c_str());
+        }
+        setenv(PARTS_VARIABLE, partsFile.c_str(), true);
+        owner = true;
+    } else {
+        return;
+    }
+    moduleName = module;
+    startWall = wallTime();
+    startCpu = cpuTime();
+    enabled = true;
+    atexit(finish);
+}
+
+bool ProfileReport::ownsReport() {
+    return enabled && owner;
+}
+
+void ProfileReport::beforeExec() {
+    if (enabled && owner == false) {
+        finish();
+    }
+}
+
+void ProfileReport::addCounter(Counter counter, size_t value) {
+    size_t slot = 0;
+#ifdef OPENMP
+    slot = static_cast<size_t>(omp_get_thread_num()) % MAX_SLOTS;
+#endif
+    __sync_fetch_and_add(&slots[slot].values[counter], value);
+}
+
+ProfileReport::Phase::Phase(const char *name) : name(name), wallStart(0), cpuStart(0) {
+    if (enabled) {
+        wallStart = wallTime();
+        cpuStart = cpuTime();
+    }
+}
+
+ProfileReport::Phase::~Phase() {
+    if (enabled) {
+        phases.emplace_back(name, wallTime() - wallStart, cpuTime() - cpuStart);
+    }
+}
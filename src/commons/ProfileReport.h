@@ -0,0 +1,61 @@
+#ifndef MMSEQS_PROFILEREPORT_H
+#define MMSEQS_PROFILEREPORT_H
+
+// Opt-in performance counters written as JSON with --profile-report <file>.
+// Counters are summed over all threads, phases record wall and CPU time of a section of a module.
+// The module that was called with --profile-report owns the report. It exports MMSEQS_PROFILE_REPORT_PARTS,
+// every module it runs appends its own report there, and the owner merges them into its report at exit.
+#include <cstddef>
+#include <string>
+
+class ProfileReport {
+public:
+    enum Counter {
+        DB_BYTES_READ = 0,
+        DB_BYTES_WRITTEN,
+        KMERS_GENERATED,
+        DB_MATCHES,
+        DOUBLE_MATCHES,
+        DIAGONAL_OVERFLOW,
+        SW_CELLS,
+        KMER_CACHE_HITS,
+        KMER_CACHE_MISSES,
+        COUNTER_COUNT
+    };
+
+    // enables the report if reportFile is not empty or a calling module collects reports
+    static void init(const std::string &reportFile, const char *module);
+
+    static bool isEnabled() {
+        return enabled;
+    }
+
+    static void add(Counter counter, size_t value) {
+        if (enabled) {
+            addCounter(counter, value);
+        }
+    }
+
+    // true if this process writes the report file, programs it runs have to finish before it exits
+    static bool ownsReport();
+
+    // a module that replaces itself with another program has to write its report first
+    static void beforeExec();
+
+    // records the wall and CPU time between construction and destruction, not for use in parallel regions
+    class Phase {
+    public:
+        Phase(const char *name);
+        ~Phase();
+    private:
+        const char *name;
+        double wallStart;
+        double cpuStart;
+    };
+
+private:
+    static bool enabled;
+    static void addCounter(Counter counter, size_t value);
+};
+
+#endif
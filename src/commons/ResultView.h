@@ -0,0 +1,244 @@
+#ifndef MMSEQS_RESULTVIEW_H
+#define MMSEQS_RESULTVIEW_H
+
+#include "DBReader.h"
+#include "Matcher.h"
+#include "QueryMatcher.h"
+#include "Parameters.h"
+#include "Util.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <climits>
+
+// Decoders for the record types a ResultView can yield.
+// Text records start at the beginning of a line, binary records are addressed by their index.
+template <typename T>
+struct ResultRecordDecoder;
+
+// prefilter hits
+template <>
+struct ResultRecordDecoder<hit_t> {
+    static size_t binaryCount(const char *, size_t length, int) {
+        return QueryMatcher::getBinaryHitCount(length);
+    }
+
+    static void decodeText(const char *data, hit_t &record, bool) {
+        record = QueryMatcher::parsePrefilterHit(const_cast<char *>(data));
+    }
+
+    static void decodeBinary(const char *data, size_t idx, hit_t &record, int, bool) {
+        record = QueryMatcher::parsePrefilterHitBinary(data + idx * QueryMatcher::BINARY_HIT_SIZE);
+    }
+};
+
+// alignment results, the backtrace capacity of the record is reused between records
+template <>
+struct ResultRecordDecoder<Matcher::result_t> {
+    static size_t binaryCount(const char *data, size_t length, int) {
+        return Matcher::getBinaryResultCount(data, length);
+    }
+
+    static void decodeText(const char *data, Matcher::result_t &record, bool readCompressed) {
+        Matcher::parseAlignmentRecord(data, record, readCompressed);
+    }
+
+    static void decodeBinary(const char *data, size_t idx, Matcher::result_t &record, int, bool readCompressed) {
+        Matcher::parseAlignmentRecordBinary(data, idx, record, readCompressed);
+    }
+};
+
+// first column only (cluster members or the target key of any result)
+template <>
+struct ResultRecordDecoder<unsigned int> {
+    static bool isPrefilter(int dbtype) {
+        return Parameters::isEqualDbtype(dbtype, Parameters::DBTYPE_PREFILTER_RES)
+               || Parameters::isEqualDbtype(dbtype, Parameters::DBTYPE_PREFILTER_REV_RES);
+    }
+
+    static size_t binaryCount(const char *data, size_t length, int dbtype) {
+        return isPrefilter(dbtype) ? QueryMatcher::getBinaryHitCount(length) : Matcher::getBinaryResultCount(data, length);
+    }
+
+    static void decodeText(const char *data, unsigned int &record, bool) {
+        record = Util::fast_atoi<unsigned int>(data);
+    }
+
+    static void decodeBinary(const char *data, size_t idx, unsigned int &record, int dbtype, bool) {
+        if (isPrefilter(dbtype)) {
+            memcpy(&record, data + idx * QueryMatcher::BINARY_HIT_SIZE, sizeof(unsigned int));
+        } else {
+            memcpy(&record, data + sizeof(unsigned int) + idx * sizeof(Matcher::binary_result_t) + offsetof(Matcher::binary_result_t, dbKey), sizeof(unsigned int));
+        }
+    }
+};
+
+// Read-only view over the records of a single text or binary result entry.
+// Records are decoded lazily on dereference into a single record owned by the view,
+// so walking an entry does not allocate per record. Dereferenced records are only
+// valid until the iterator is advanced, decode() copies into caller owned storage.
+template <typename T>
+class ResultView {
+public:
+    // length is either the index entry length (including the null byte) or the raw size of a text buffer
+    ResultView(const char *data, size_t length, int dbtype, bool readCompressed = false)
+            : data(data), length(length), dbtype(dbtype), binary(DBReader<unsigned int>::isBinaryResult(dbtype)),
+              readCompressed(readCompressed), binaryCount(0), decodedPos(END), record() {
+        if (binary && data != NULL) {
+            binaryCount = ResultRecordDecoder<T>::binaryCount(data, length, dbtype);
+        }
+    }
+
+    static ResultView<T> fromReader(DBReader<unsigned int> &reader, size_t id, int thread_idx, bool readCompressed = false) {
+        const char *data = reader.getData(id, thread_idx);
+        // the index of compressed databases stores the compressed length
+        size_t length = (reader.isCompressed() && data != NULL) ? strlen(data) + 1 : reader.getEntryLen(id);
+        return ResultView<T>(data, length, reader.getDbtype(), readCompressed);
+    }
+
+    // empty view if the key does not exist
+    static ResultView<T> fromReaderByKey(DBReader<unsigned int> &reader, unsigned int key, int thread_idx, bool readCompressed = false) {
+        const size_t id = reader.getId(key);
+        if (id == UINT_MAX) {
+            return ResultView<T>(NULL, 0, reader.getDbtype(), readCompressed);
+        }
+        return fromReader(reader, id, thread_idx, readCompressed);
+    }
+
+    static const size_t END = SIZE_MAX;
+
+    class iterator {
+    public:
+        iterator(ResultView<T> *view, size_t pos) : view(view), pos(pos) {}
+
+        const T &operator*() const {
+            return view->decode(pos);
+        }
+
+        const T *operator->() const {
+            return &view->decode(pos);
+        }
+
+        iterator &operator++() {
+            pos = view->next(pos);
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const {
+            return pos == other.pos;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return pos != other.pos;
+        }
+
+        void decode(T &record) const {
+            view->decodeInto(pos, record);
+        }
+
+        // decodes the current record as another record type, e.g. a full alignment while walking keys
+        template <typename U>
+        void decodeAs(U &record, bool readCompressed = false) const {
+            if (view->binary) {
+                ResultRecordDecoder<U>::decodeBinary(view->data, pos, record, view->dbtype, readCompressed);
+            } else {
+                ResultRecordDecoder<U>::decodeText(view->data + pos, record, readCompressed);
+            }
+        }
+
+        // start of the current text line, NULL for binary entries
+        const char *line() const {
+            return view->binary ? NULL : view->data + pos;
+        }
+
+        // length of the current text line including the newline
+        size_t lineLength() const {
+            const char *start = view->data + pos;
+            return Util::skipLine(const_cast<char *>(start)) - start;
+        }
+
+    private:
+        ResultView<T> *view;
+        size_t pos;
+    };
+
+    iterator begin() {
+        return iterator(this, first());
+    }
+
+    iterator end() {
+        return iterator(this, END);
+    }
+
+    bool empty() const {
+        return first() == END;
+    }
+
+    // number of records, text entries are scanned for line breaks
+    size_t size() const {
+        if (binary) {
+            return binaryCount;
+        }
+        return (data == NULL) ? 0 : Util::countLines(data, length);
+    }
+
+    bool isBinary() const {
+        return binary;
+    }
+
+    // the same entry decoded as another record type
+    template <typename U>
+    ResultView<U> as(bool readCompressedRecords = false) const {
+        return ResultView<U>(data, length, dbtype, readCompressedRecords);
+    }
+
+private:
+    const char *data;
+    const size_t length;
+    const int dbtype;
+    const bool binary;
+    const bool readCompressed;
+    size_t binaryCount;
+
+    size_t decodedPos;
+    T record;
+
+    size_t first() const {
+        if (data == NULL) {
+            return END;
+        }
+        if (binary) {
+            return (binaryCount == 0) ? END : 0;
+        }
+        return (length == 0 || data[0] == '\0') ? END : 0;
+    }
+
+    size_t next(size_t pos) const {
+        if (pos == END) {
+            return END;
+        }
+        if (binary) {
+            return (pos + 1 < binaryCount) ? pos + 1 : END;
+        }
+        size_t nextPos = Util::skipLine(const_cast<char *>(data + pos)) - data;
+        return (nextPos >= length || data[nextPos] == '\0') ? END : nextPos;
+    }
+
+    void decodeInto(size_t pos, T &out) const {
+        if (binary) {
+            ResultRecordDecoder<T>::decodeBinary(data, pos, out, dbtype, readCompressed);
+        } else {
+            ResultRecordDecoder<T>::decodeText(data + pos, out, readCompressed);
+        }
+    }
+
+    const T &decode(size_t pos) {
+        if (decodedPos != pos) {
+            decodeInto(pos, record);
+            decodedPos = pos;
+        }
+        return record;
+    }
+};
+
+#endif
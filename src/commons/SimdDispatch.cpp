@@ -0,0 +1,142 @@
+#include "SimdDispatch.h"
+#ifdef HAVE_AVX2_KERNELS
+#include "StripedSmithWatermanAVX2.h"
+#include "UngappedAlignmentAVX2.h"
+#endif
+#ifdef HAVE_AVX512
+#include "StripedSmithWatermanAVX512.h"
+#include "UngappedAlignmentAVX512.h"
+#endif
+
+#include <cstdlib>
+#include <cstring>
+
+#define SIMDE_ENABLE_NATIVE_ALIASES
+#include <simde/simde-features.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_CPU_SUPPORTS 1
+#endif
+
+namespace {
+SimdDispatch::Kernels selectKernels() {
+    SimdDispatch::Kernels kernels;
+    memset(&kernels, 0, sizeof(SimdDispatch::Kernels));
+    kernels.level = SimdDispatch::LEVEL_BASELINE;
+
+    // MMSEQS_SIMD_KERNELS=baseline|avx2 limits the kernels, e.g. to compare results between paths
+    SimdDispatch::Level maxLevel = SimdDispatch::LEVEL_AVX512;
+    const char *limit = getenv("MMSEQS_SIMD_KERNELS");
+    if (limit != NULL) {
+        if (strcmp(limit, "baseline") == 0) {
+            maxLevel = SimdDispatch::LEVEL_BASELINE;
+        } else if (strcmp(limit, "avx2") == 0) {
+            maxLevel = SimdDispatch::LEVEL_AVX2;
+        }
+    }
+#ifdef HAVE_CPU_SUPPORTS
+    __builtin_cpu_init();
+#endif
+
+#ifdef HAVE_AVX512
+    if (maxLevel >= SimdDispatch::LEVEL_AVX512 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        kernels.level = SimdDispatch::LEVEL_AVX512;
+        kernels.swByteElements = StripedSmithWatermanAVX512::BYTE_ELEMENTS;
+        kernels.swWordElements = StripedSmithWatermanAVX512::WORD_ELEMENTS;
+        kernels.swByte = &StripedSmithWatermanAVX512::sw_byte;
+        kernels.swWord = &StripedSmithWatermanAVX512::sw_word;
+        kernels.diagonalLanes = UngappedAlignmentAVX512::LANES;
+        kernels.diagonalScoring = &UngappedAlignmentAVX512::vectorDiagonalScoring;
+        return kernels;
+    }
+#endif
+    // an AVX2 baseline already has the same kernels
+#if defined(HAVE_AVX2_KERNELS) && !defined(SIMDE_X86_AVX2_NATIVE)
+    if (maxLevel >= SimdDispatch::LEVEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        kernels.level = SimdDispatch::LEVEL_AVX2;
+        kernels.swByteElements = StripedSmithWatermanAVX2::BYTE_ELEMENTS;
+        kernels.swWordElements = StripedSmithWatermanAVX2::WORD_ELEMENTS;
+        kernels.swByte = &StripedSmithWatermanAVX2::sw_byte;
+        kernels.swWord = &StripedSmithWatermanAVX2::sw_word;
+        kernels.diagonalLanes = UngappedAlignmentAVX2::LANES;
+        kernels.diagonalScoring = &UngappedAlignmentAVX2::vectorDiagonalScoring;
+        return kernels;
+    }
+#endif
+    (void) maxLevel;
+    return kernels;
+}
+}
+
+const SimdDispatch::Kernels &SimdDispatch::kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+const char *SimdDispatch::baselineName() {
+#if defined(SIMDE_X86_AVX2_NATIVE)
+    return "AVX2";
+#elif defined(SIMDE_X86_SSE4_1_NATIVE)
+    return "SSE4.1";
+#elif defined(SIMDE_X86_SSE2_NATIVE)
+    return "SSE2";
+#elif defined(SIMDE_ARM_NEON_A32V7_NATIVE)
+    return "NEON";
+#elif defined(SIMDE_POWER_ALTIVEC_P7_NATIVE)
+    return "VSX";
+#elif defined(SIMDE_ZARCH_ZVECTOR_14_NATIVE)
+    return "z/Architecture vector";
+#elif defined(SIMDE_WASM_SIMD128_NATIVE)
+    return "WebAssembly SIMD";
+#else
+    return "scalar";
+#endif
+}
+
+const char *SimdDispatch::kernelName() {
+    switch (kernels().level) {
+        case LEVEL_AVX512:
+            return "AVX-512";
+        case LEVEL_AVX2:
+            return "AVX2";
+        default:
+            return baselineName();
+    }
+}
+
+bool SimdDispatch::cpuSupportsBaseline() {
+#ifdef HAVE_CPU_SUPPORTS
+    __builtin_cpu_init();
+#ifdef __AVX512BW__
+    if (__builtin_cpu_supports("avx512bw") == 0) {
+        return false;
+    }
+#endif
+#ifdef __AVX512F__
+    if (__builtin_cpu_supports("avx512f") == 0) {
+        return false;
+    }
+#endif
+#ifdef __AVX2__
+    if (__builtin_cpu_supports("avx2") == 0) {
+        return false;
+    }
+#endif
+#ifdef __FMA__
+    if (__builtin_cpu_supports("fma") == 0) {
+        return false;
+    }
+#endif
+#ifdef __SSE4_2__
+    if (__builtin_cpu_supports("sse4.2") == 0) {
+        return false;
+    }
+#endif
+#ifdef __SSE4_1__
+    if (__builtin_cpu_supports("sse4.1") == 0) {
+        return false;
+    }
+#endif
+#endif
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef MMSEQS_SIMDDISPATCH_H
+#define MMSEQS_SIMDDISPATCH_H
+
+// Selects SIMD kernels at runtime. The baseline kernels are compiled for the instruction set
+// of the build (simd.h), wider kernels are compiled separately (HAVE_AVX2_KERNELS, HAVE_AVX512)
+// and only used if the CPU supports them. The kernel translation units include this header,
+// so it must not contain inline code.
+#include <stdint.h>
+
+class SimdDispatch {
+public:
+    enum Level {
+        LEVEL_BASELINE = 0,
+        LEVEL_AVX2,
+        LEVEL_AVX512
+    };
+
+    // end position of the striped Smith-Waterman kernels, same layout as SmithWaterman::alignment_end
+    struct alignment_end {
+        uint16_t score;
+        int32_t ref;
+        int32_t read;
+    };
+
+    // DP columns of ceil(query_length / elements) vectors each, maxColumn holds db_length scores
+    struct sw_buffers {
+        void *hStore;
+        void *hLoad;
+        void *e;
+        void *hMax;
+        uint8_t *maxColumn;
+    };
+
+    typedef void (*sw_byte_kernel)(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                   int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                   const void *query_profile_byte, uint8_t terminate, uint8_t bias,
+                                   int32_t maskLen, sw_buffers &buffers, alignment_end &best, alignment_end &second);
+
+    typedef void (*sw_word_kernel)(const unsigned char *db_sequence, int8_t ref_dir, int32_t db_length,
+                                   int32_t query_length, uint8_t gap_open, uint8_t gap_extend,
+                                   const void *query_profile_word, uint16_t terminate, int32_t maskLen,
+                                   sw_buffers &buffers, alignment_end &best, alignment_end &second);
+
+    typedef void (*diagonal_kernel)(const char *profile, const char bias, const unsigned int seqLen,
+                                    const unsigned char *dbSeq, unsigned int *scores);
+
+    // kernels used instead of the baseline, all pointers are NULL if the baseline is used
+    struct Kernels {
+        Level level;
+
+        // striped Smith-Waterman for sequence queries with global gap penalties,
+        // query profiles are striped over swByteElements bytes and swWordElements words
+        int32_t swByteElements;
+        int32_t swWordElements;
+        sw_byte_kernel swByte;
+        sw_word_kernel swWord;
+
+        // ungapped diagonal scoring of diagonalLanes db sequences, each 64 byte aligned
+        unsigned int diagonalLanes;
+        diagonal_kernel diagonalScoring;
+    };
+
+    // selected once for the running CPU
+    static const Kernels &kernels();
+
+    // instruction set of the baseline kernels, e.g. "SSE4.1" or "AVX2"
+    static const char *baselineName();
+
+    // instruction set of the selected kernels, the baseline name if no wider kernels are used
+    static const char *kernelName();
+
+    // false if the binary was compiled for instructions the CPU does not have
+    static bool cpuSupportsBaseline();
+};
+
+#endif
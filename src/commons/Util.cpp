@@ -234,15 +234,17 @@ char* Util::fastSeqIdToBuffer(float seqId, char* buffer) {
         buffer++;
         *(buffer) = '.';
         buffer++;
-        if (seqId < 0.10) {
+        // pad from the printed value, 0.01f is below 0.01 but prints as 10
+        const int permille = (int)(seqId * 1000);
+        if (permille < 100) {
             *(buffer) = '0';
             buffer++;
         }
-        if (seqId < 0.01) {
+        if (permille < 10) {
             *(buffer) = '0';
             buffer++;
         }
-        buffer = Itoa::i32toa_sse2((int)(seqId * 1000), buffer);
+        buffer = Itoa::i32toa_sse2(permille, buffer);
     }
     return buffer;
 }
@@ -0,0 +1,117 @@
+#include "KmerGroupIndex.h"
+
+#include <cstring>
+
+static const char KMER_GROUP_INDEX_MAGIC[] = "MMSKIDX2";
+
+KmerGroupIndexHeader kmerGroupIndexHeader(Parameters &par, int seqType, unsigned int maxKey) {
+    KmerGroupIndexHeader header;
+    memset(&header, 0, sizeof(KmerGroupIndexHeader));
+    memcpy(header.magic, KMER_GROUP_INDEX_MAGIC, sizeof(header.magic));
+    const bool isNucleotide = Parameters::isEqualDbtype(seqType, Parameters::DBTYPE_NUCLEOTIDES);
+    header.dbtype = isNucleotide ? Parameters::DBTYPE_NUCLEOTIDES : Parameters::DBTYPE_AMINO_ACIDS;
+    header.kmerSize = par.kmerSize;
+    header.alphabetSize = isNucleotide ? par.alphabetSize.values.nucleotide() : par.alphabetSize.values.aminoacid();
+    header.hashShift = par.hashShift;
+    header.adjustKmerLength = par.adjustKmerLength;
+    header.spacedKmer = par.spacedKmer;
+    header.kmersPerSequence = par.kmersPerSequence;
+    header.kmersPerSequenceScale = isNucleotide ? par.kmersPerSequenceScale.values.nucleotide() : par.kmersPerSequenceScale.values.aminoacid();
+    header.ignoreMultiKmer = par.ignoreMultiKmer;
+    header.maxKey = maxKey;
+    return header;
+}
+
+KmerGroupIndexReader::KmerGroupIndexReader(const std::string &fileName) : fileName(fileName), entries(NULL) {
+    if (file.open(fileName, MemoryMapped::WholeFile, MemoryMapped::RandomAccess) == false) {
+        Debug(Debug::ERROR) << "Cannot open k-mer index " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    const unsigned char *data = file.getData();
+    const size_t size = file.size();
+    if (size < sizeof(KmerGroupIndexHeader) + sizeof(size_t)) {
+        Debug(Debug::ERROR) << "K-mer index " << fileName << " is truncated\n";
+        EXIT(EXIT_FAILURE);
+    }
+    memcpy(&header, data, sizeof(KmerGroupIndexHeader));
+    if (memcmp(header.magic, KMER_GROUP_INDEX_MAGIC, sizeof(header.magic)) != 0) {
+        Debug(Debug::ERROR) << "File " << fileName << " is not a k-mer index\n";
+        EXIT(EXIT_FAILURE);
+    }
+    size_t runCount;
+    memcpy(&runCount, data + size - sizeof(size_t), sizeof(size_t));
+    const size_t runTableSize = runCount * sizeof(KmerGroupIndexRun);
+    if (runTableSize > size - sizeof(KmerGroupIndexHeader) - sizeof(size_t)) {
+        Debug(Debug::ERROR) << "K-mer index " << fileName << " is truncated\n";
+        EXIT(EXIT_FAILURE);
+    }
+    runs.resize(runCount);
+    memcpy(runs.data(), data + size - sizeof(size_t) - runTableSize, runTableSize);
+    entries = reinterpret_cast<const KmerGroupIndexEntry *>(data + sizeof(KmerGroupIndexHeader));
+    const size_t entryCount = (size - sizeof(KmerGroupIndexHeader) - sizeof(size_t) - runTableSize) / sizeof(KmerGroupIndexEntry);
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (runs[i].offset + runs[i].count > entryCount) {
+            Debug(Debug::ERROR) << "K-mer index " << fileName << " is corrupted\n";
+            EXIT(EXIT_FAILURE);
+        }
+    }
+}
+
+KmerGroupIndexReader::~KmerGroupIndexReader() {
+    file.close();
+}
+
+bool KmerGroupIndexReader::isCompatible(const KmerGroupIndexHeader &other) const {
+    return header.dbtype == other.dbtype && header.kmerSize == other.kmerSize
+           && header.alphabetSize == other.alphabetSize && header.hashShift == other.hashShift
+           && header.adjustKmerLength == other.adjustKmerLength && header.spacedKmer == other.spacedKmer
+           && header.kmersPerSequence == other.kmersPerSequence && header.kmersPerSequenceScale == other.kmersPerSequenceScale
+           && header.ignoreMultiKmer == other.ignoreMultiKmer;
+}
+
+KmerGroupIndexWriter::KmerGroupIndexWriter(const std::string &fileName, const KmerGroupIndexHeader &header)
+        : fileName(fileName), entryCount(0) {
+    file = fopen(fileName.c_str(), "wb");
+    if (file == NULL) {
+        perror(fileName.c_str());
+        EXIT(EXIT_FAILURE);
+    }
+    write(&header, sizeof(KmerGroupIndexHeader), 1);
+}
+
+KmerGroupIndexWriter::~KmerGroupIndexWriter() {
+    if (file != NULL) {
+        close();
+    }
+}
+
+void KmerGroupIndexWriter::write(const void *data, size_t size, size_t count) {
+    if (fwrite(data, size, count, file) != count) {
+        Debug(Debug::ERROR) << "Cannot write to " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+void KmerGroupIndexWriter::copyRuns(const KmerGroupIndexReader &reader) {
+    const std::vector<KmerGroupIndexRun> &previousRuns = reader.getRuns();
+    for (size_t i = 0; i < previousRuns.size(); i++) {
+        KmerGroupIndexRun run = previousRuns[i];
+        write(reader.getEntries() + run.offset, sizeof(KmerGroupIndexEntry), run.count);
+        run.offset = entryCount;
+        entryCount += run.count;
+        runs.push_back(run);
+    }
+}
+
+void KmerGroupIndexWriter::close() {
+    size_t runCount = runs.size();
+    if (runCount > 0) {
+        write(runs.data(), sizeof(KmerGroupIndexRun), runCount);
+    }
+    write(&runCount, sizeof(size_t), 1);
+    if (fclose(file) != 0) {
+        Debug(Debug::ERROR) << "Cannot close file " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    file = NULL;
+}
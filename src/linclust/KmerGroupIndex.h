@@ -0,0 +1,187 @@
+#ifndef MMSEQS_KMERGROUPINDEX_H
+#define MMSEQS_KMERGROUPINDEX_H
+
+// Persistent k-mer groups of a linclust run.
+// The index keeps the first entry (longest sequence) of every k-mer group. Each hash range split adds
+// a run sorted in the order of KmerPositionSort::sortByPos, the run table follows the entries at the end of the file.
+// An update keeps the previous runs and adds runs for groups of sequences with a key above the largest indexed key.
+#include "kmermatcher.h"
+#include "MemoryMapped.h"
+#include "Debug.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct KmerGroupIndexEntry {
+    size_t kmer;
+    unsigned int id;
+    int seqLen;
+    int pos;
+    unsigned int padding;
+};
+
+struct KmerGroupIndexHeader {
+    char magic[8];
+    unsigned int dbtype;
+    unsigned int kmerSize;
+    unsigned int alphabetSize;
+    unsigned int hashShift;
+    unsigned int adjustKmerLength;
+    unsigned int spacedKmer;
+    unsigned int kmersPerSequence;
+    float kmersPerSequenceScale;
+    unsigned int ignoreMultiKmer;
+    unsigned int maxKey;
+};
+
+// k-mer parameters of the current run, an index can only be updated with the same ones
+KmerGroupIndexHeader kmerGroupIndexHeader(Parameters &par, int seqType, unsigned int maxKey);
+
+struct KmerGroupIndexRun {
+    size_t hashStart;
+    size_t hashEnd;
+    size_t offset;
+    size_t count;
+};
+
+class KmerGroupIndexReader {
+public:
+    KmerGroupIndexReader(const std::string &fileName);
+    ~KmerGroupIndexReader();
+
+    // the index was built with different k-mer parameters
+    bool isCompatible(const KmerGroupIndexHeader &other) const;
+
+    const KmerGroupIndexHeader &getHeader() const {
+        return header;
+    }
+
+    // sequences with larger keys are new
+    unsigned int getMaxKey() const {
+        return header.maxKey;
+    }
+
+    const std::vector<KmerGroupIndexRun> &getRuns() const {
+        return runs;
+    }
+
+    const KmerGroupIndexEntry *getEntries() const {
+        return entries;
+    }
+
+    // Appends the indexed entries of all k-mers of kmers[0, size) to kmers[size, capacity) and returns their count.
+    // kmers has to be sorted by sortByPos and belong to the hash range [hashStart, hashEnd].
+    template <bool REVERSE, typename T>
+    size_t appendIndexedKmers(KmerPosition<T> *kmers, size_t size, size_t capacity, size_t hashStart, size_t hashEnd) const {
+        size_t added = 0;
+        for (size_t run = 0; run < runs.size(); run++) {
+            if (runs[run].hashEnd < hashStart || runs[run].hashStart > hashEnd) {
+                continue;
+            }
+            const KmerGroupIndexEntry *pos = entries + runs[run].offset;
+            const KmerGroupIndexEntry *end = pos + runs[run].count;
+            size_t i = 0;
+            while (i < size && pos < end) {
+                const size_t kmer = groupKmer<REVERSE>(kmers[i].kmer);
+                // gallop towards the k-mer, the new k-mers are a small subset of the index
+                size_t step = 1;
+                while (pos + step < end && groupKmer<REVERSE>(pos[step].kmer) < kmer) {
+                    step *= 2;
+                }
+                const KmerGroupIndexEntry *last = (pos + step < end) ? pos + step + 1 : end;
+                pos = std::lower_bound(pos + step / 2, last, kmer, compareEntry<REVERSE>);
+                if (pos < end && groupKmer<REVERSE>(pos->kmer) == kmer) {
+                    if (size + added >= capacity) {
+                        Debug(Debug::ERROR) << "Kmer array overflow while merging the k-mer index\n";
+                        EXIT(EXIT_FAILURE);
+                    }
+                    KmerPosition<T> &entry = kmers[size + added];
+                    entry.kmer = pos->kmer;
+                    entry.id = pos->id;
+                    entry.seqLen = static_cast<T>(pos->seqLen);
+                    entry.pos = static_cast<T>(pos->pos);
+                    added++;
+                }
+                while (i < size && groupKmer<REVERSE>(kmers[i].kmer) == kmer) {
+                    i++;
+                }
+            }
+        }
+        return added;
+    }
+
+    // the reverse compare functions ignore the strand bit of nucleotide k-mers
+    template <bool REVERSE>
+    static size_t groupKmer(size_t kmer) {
+        return REVERSE ? BIT_SET(kmer, 63) : kmer;
+    }
+
+private:
+    std::string fileName;
+    MemoryMapped file;
+    KmerGroupIndexHeader header;
+    std::vector<KmerGroupIndexRun> runs;
+    const KmerGroupIndexEntry *entries;
+
+    template <bool REVERSE>
+    static bool compareEntry(const KmerGroupIndexEntry &entry, size_t kmer) {
+        return groupKmer<REVERSE>(entry.kmer) < kmer;
+    }
+};
+
+class KmerGroupIndexWriter {
+public:
+    KmerGroupIndexWriter(const std::string &fileName, const KmerGroupIndexHeader &header);
+    ~KmerGroupIndexWriter();
+
+    // keeps all runs of a previous index
+    void copyRuns(const KmerGroupIndexReader &reader);
+
+    // adds the first entry of every group of kmers[0, size) (sorted by sortByPos) that is not in the previous index
+    template <bool REVERSE, typename T>
+    void writeRun(const KmerPosition<T> *kmers, size_t size, size_t hashStart, size_t hashEnd, const KmerGroupIndexReader *previous) {
+        KmerGroupIndexRun run;
+        run.hashStart = hashStart;
+        run.hashEnd = hashEnd;
+        run.offset = entryCount;
+        run.count = 0;
+        size_t groupStart = 0;
+        while (groupStart < size) {
+            const size_t kmer = KmerGroupIndexReader::groupKmer<REVERSE>(kmers[groupStart].kmer);
+            bool isIndexed = false;
+            size_t groupEnd = groupStart;
+            while (groupEnd < size && KmerGroupIndexReader::groupKmer<REVERSE>(kmers[groupEnd].kmer) == kmer) {
+                isIndexed |= (previous != NULL && kmers[groupEnd].id <= previous->getMaxKey());
+                groupEnd++;
+            }
+            if (isIndexed == false) {
+                KmerGroupIndexEntry entry;
+                entry.kmer = kmers[groupStart].kmer;
+                entry.id = kmers[groupStart].id;
+                entry.seqLen = kmers[groupStart].seqLen;
+                entry.pos = kmers[groupStart].pos;
+                entry.padding = 0;
+                write(&entry, sizeof(KmerGroupIndexEntry), 1);
+                run.count++;
+            }
+            groupStart = groupEnd;
+        }
+        entryCount += run.count;
+        runs.push_back(run);
+    }
+
+    void close();
+
+private:
+    std::string fileName;
+    FILE *file;
+    size_t entryCount;
+    std::vector<KmerGroupIndexRun> runs;
+
+    void write(const void *data, size_t size, size_t count);
+};
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef MMSEQS_KMERPOSITIONSORT_H
+#define MMSEQS_KMERPOSITIONSORT_H
+
+// Sorts KmerPosition arrays in the orders of their compare functions.
+// The keys are fixed width integers, so an in-place MSD radix sort replaces the comparison sort:
+// the top levels distribute the array with all threads (PARADIS), smaller buckets are sorted
+// by one thread each with an American flag sort and tiny buckets with std::sort.
+#include "kmermatcher.h"
+#include "FastSort.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+// big endian byte string of the sort key: kmer, seqLen (descending, only by position), id, pos
+template <typename T, bool REVERSE, bool BY_POS>
+struct KmerPositionRadixKey {
+    typedef typename std::make_unsigned<T>::type U;
+    static const size_t BYTES = sizeof(size_t) + (BY_POS ? sizeof(T) : 0) + sizeof(unsigned int) + sizeof(T);
+
+    // maps signed values to unsigned ones of the same order
+    static U order(T value) {
+        U key = static_cast<U>(value);
+        if (std::numeric_limits<T>::is_signed) {
+            key ^= static_cast<U>(static_cast<U>(1) << (sizeof(T) * 8 - 1));
+        }
+        return key;
+    }
+
+    static unsigned char byte(const KmerPosition<T> &entry, size_t i) {
+        if (i < sizeof(size_t)) {
+            // the reverse compare functions ignore the strand bit
+            size_t kmer = REVERSE ? BIT_SET(entry.kmer, 63) : entry.kmer;
+            return static_cast<unsigned char>(kmer >> ((sizeof(size_t) - 1 - i) * 8));
+        }
+        i -= sizeof(size_t);
+        if (BY_POS) {
+            if (i < sizeof(T)) {
+                U seqLen = static_cast<U>(~order(entry.seqLen));
+                return static_cast<unsigned char>(seqLen >> ((sizeof(T) - 1 - i) * 8));
+            }
+            i -= sizeof(T);
+        }
+        if (i < sizeof(unsigned int)) {
+            return static_cast<unsigned char>(entry.id >> ((sizeof(unsigned int) - 1 - i) * 8));
+        }
+        i -= sizeof(unsigned int);
+        return static_cast<unsigned char>(order(entry.pos) >> ((sizeof(T) - 1 - i) * 8));
+    }
+
+    static bool compare(const KmerPosition<T> &first, const KmerPosition<T> &second) {
+        if (BY_POS) {
+            return REVERSE ? KmerPosition<T>::compareRepSequenceAndIdAndPosReverse(first, second)
+                           : KmerPosition<T>::compareRepSequenceAndIdAndPos(first, second);
+        }
+        return REVERSE ? KmerPosition<T>::compareRepSequenceAndIdAndDiagReverse(first, second)
+                       : KmerPosition<T>::compareRepSequenceAndIdAndDiag(first, second);
+    }
+};
+
+template <typename Key, typename T>
+class KmerPositionRadixSort {
+public:
+    // buckets below this size are sorted by std::sort
+    static const size_t SMALL_SORT_SIZE = 64;
+    // buckets below this size are sorted by a single thread
+    static const size_t PARALLEL_MIN_SIZE = 1 << 16;
+
+    static void sort(KmerPosition<T> *data, size_t size, unsigned int threads) {
+        sortParallel(data, size, 0, threads);
+    }
+
+private:
+    static void sortSerial(KmerPosition<T> *data, size_t size, size_t byte) {
+        while (size > SMALL_SORT_SIZE && byte < Key::BYTES) {
+            size_t count[256] = {};
+            for (size_t i = 0; i < size; i++) {
+                count[Key::byte(data[i], byte)]++;
+            }
+            // skip bytes that are the same for all entries
+            if (count[Key::byte(data[0], byte)] == size) {
+                byte++;
+                continue;
+            }
+            size_t head[256];
+            size_t tail[256];
+            size_t offset = 0;
+            for (size_t b = 0; b < 256; b++) {
+                head[b] = offset;
+                offset += count[b];
+                tail[b] = offset;
+            }
+            for (size_t b = 0; b < 256; b++) {
+                while (head[b] < tail[b]) {
+                    KmerPosition<T> value = data[head[b]];
+                    unsigned char digit = Key::byte(value, byte);
+                    while (digit != b) {
+                        std::swap(value, data[head[digit]++]);
+                        digit = Key::byte(value, byte);
+                    }
+                    data[head[b]++] = value;
+                }
+            }
+            for (size_t b = 0; b < 256; b++) {
+                if (count[b] > 1) {
+                    sortSerial(data + tail[b] - count[b], count[b], byte + 1);
+                }
+            }
+            return;
+        }
+        if (size > 1 && byte < Key::BYTES) {
+            SORT_SERIAL(data, data + size, Key::compare);
+        }
+    }
+
+    static void sortParallel(KmerPosition<T> *data, size_t size, size_t byte, unsigned int threads) {
+        while (byte < Key::BYTES) {
+            if (threads <= 1 || size < PARALLEL_MIN_SIZE) {
+                sortSerial(data, size, byte);
+                return;
+            }
+            std::vector<size_t> threadCount(threads * 256, 0);
+#pragma omp parallel for schedule(static) num_threads(threads)
+            for (unsigned int t = 0; t < threads; t++) {
+                size_t *localCount = threadCount.data() + t * 256;
+                for (size_t i = (size * t) / threads; i < (size * (t + 1)) / threads; i++) {
+                    localCount[Key::byte(data[i], byte)]++;
+                }
+            }
+            size_t count[256] = {};
+            for (unsigned int t = 0; t < threads; t++) {
+                for (size_t b = 0; b < 256; b++) {
+                    count[b] += threadCount[t * 256 + b];
+                }
+            }
+            if (count[Key::byte(data[0], byte)] == size) {
+                byte++;
+                continue;
+            }
+            distribute(data, size, count, byte, threads);
+
+            // large buckets are sorted one after another with all threads, the others in parallel
+            size_t start[256];
+            size_t offset = 0;
+            for (size_t b = 0; b < 256; b++) {
+                start[b] = offset;
+                offset += count[b];
+            }
+            const size_t largeBucket = std::max(size / threads, PARALLEL_MIN_SIZE);
+            for (size_t b = 0; b < 256; b++) {
+                if (count[b] >= largeBucket) {
+                    sortParallel(data + start[b], count[b], byte + 1, threads);
+                }
+            }
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+            for (size_t b = 0; b < 256; b++) {
+                if (count[b] > 1 && count[b] < largeBucket) {
+                    sortSerial(data + start[b], count[b], byte + 1);
+                }
+            }
+            return;
+        }
+    }
+
+    // moves every entry into the bucket of its byte, see Cho et al., PARADIS, VLDB 2015
+    static void distribute(KmerPosition<T> *data, size_t size, const size_t *count, size_t byte, unsigned int threads) {
+        // [globalHead, globalTail) of a bucket holds the entries that might still be misplaced
+        size_t globalHead[256];
+        size_t globalTail[256];
+        size_t offset = 0;
+        for (size_t b = 0; b < 256; b++) {
+            globalHead[b] = offset;
+            offset += count[b];
+            globalTail[b] = offset;
+        }
+        std::vector<size_t> head(threads * 256);
+        std::vector<size_t> tail(threads * 256);
+        size_t remaining = size;
+        unsigned int workers = threads;
+        while (remaining > 0) {
+            // every thread permutes within its own stripe of each bucket
+            for (size_t b = 0; b < 256; b++) {
+                const size_t length = globalTail[b] - globalHead[b];
+                for (unsigned int t = 0; t < workers; t++) {
+                    head[t * 256 + b] = globalHead[b] + (length * t) / workers;
+                    tail[t * 256 + b] = globalHead[b] + (length * (t + 1)) / workers;
+                }
+            }
+#pragma omp parallel for schedule(static, 1) num_threads(workers)
+            for (unsigned int t = 0; t < workers; t++) {
+                permuteStripes(data, head.data() + t * 256, tail.data() + t * 256, byte);
+            }
+
+            // entries that did not fit into the stripes of their thread are moved to the end of their bucket
+#pragma omp parallel for schedule(dynamic, 1) num_threads(workers)
+            for (size_t b = 0; b < 256; b++) {
+                size_t bucketTail = globalTail[b];
+                for (unsigned int t = 0; t < workers; t++) {
+                    size_t pos = head[t * 256 + b];
+                    while (pos < tail[t * 256 + b] && pos < bucketTail) {
+                        KmerPosition<T> value = data[pos++];
+                        if (Key::byte(value, byte) == b) {
+                            continue;
+                        }
+                        bool found = false;
+                        while (pos < bucketTail) {
+                            KmerPosition<T> other = data[--bucketTail];
+                            if (Key::byte(other, byte) == b) {
+                                data[pos - 1] = other;
+                                data[bucketTail] = value;
+                                found = true;
+                                break;
+                            }
+                        }
+                        if (found == false) {
+                            bucketTail = pos - 1;
+                        }
+                    }
+                }
+                globalHead[b] = bucketTail;
+            }
+
+            size_t left = 0;
+            for (size_t b = 0; b < 256; b++) {
+                left += globalTail[b] - globalHead[b];
+            }
+            // a single thread always finishes, it is used if the threads got stuck or little work is left
+            if (left == remaining || left < PARALLEL_MIN_SIZE) {
+                workers = 1;
+            }
+            remaining = left;
+        }
+    }
+
+    static void permuteStripes(KmerPosition<T> *data, size_t *head, const size_t *tail, size_t byte) {
+        for (size_t b = 0; b < 256; b++) {
+            size_t pos = head[b];
+            while (pos < tail[b]) {
+                KmerPosition<T> value = data[pos];
+                unsigned char digit = Key::byte(value, byte);
+                while (digit != b && head[digit] < tail[digit]) {
+                    std::swap(value, data[head[digit]++]);
+                    digit = Key::byte(value, byte);
+                }
+                if (digit == b) {
+                    data[pos++] = data[head[b]];
+                    data[head[b]++] = value;
+                } else {
+                    data[pos++] = value;
+                }
+            }
+        }
+    }
+};
+
+class KmerPositionSort {
+public:
+    // same order as SORT_PARALLEL with compareRepSequenceAndIdAndPos(Reverse)
+    template <bool REVERSE, typename T>
+    static void sortByPos(KmerPosition<T> *data, size_t size) {
+#ifdef ENABLE_KMER_RADIX_SORT
+        radixSort<KmerPositionRadixKey<T, REVERSE, true> >(data, size);
+#else
+        SORT_PARALLEL(data, data + size, KmerPositionRadixKey<T, REVERSE, true>::compare);
+#endif
+    }
+
+    // same order as SORT_PARALLEL with compareRepSequenceAndIdAndDiag(Reverse)
+    template <bool REVERSE, typename T>
+    static void sortByDiag(KmerPosition<T> *data, size_t size) {
+#ifdef ENABLE_KMER_RADIX_SORT
+        radixSort<KmerPositionRadixKey<T, REVERSE, false> >(data, size);
+#else
+        SORT_PARALLEL(data, data + size, KmerPositionRadixKey<T, REVERSE, false>::compare);
+#endif
+    }
+
+    template <typename Key, typename T>
+    static void radixSort(KmerPosition<T> *data, size_t size) {
+        unsigned int threads = 1;
+#ifdef OPENMP
+        threads = static_cast<unsigned int>(omp_get_max_threads());
+#endif
+        KmerPositionRadixSort<Key, T>::sort(data, size, threads);
+    }
+};
+
+#endif
@@ -0,0 +1,313 @@
+#include "KmerSplitFile.h"
+#include "FileUtil.h"
+#include "Debug.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const char SPLIT_FILE_MAGIC[] = "MMSKMER1";
+static const size_t SPLIT_FILE_MAGIC_SIZE = sizeof(SPLIT_FILE_MAGIC) - 1;
+// the files only live until the merge, fast compression is enough
+static const int SPLIT_FILE_COMPRESSION_LEVEL = 1;
+
+KmerSplitWriter::KmerSplitWriter(const std::string &fileName) : fileName(fileName), buffer(NULL), prevRepSeq(0), prevId(0) {
+    // splits without a done file are recomputed and overwrite their old file
+    file = fopen(fileName.c_str(), "wb");
+    if (file == NULL) {
+        perror(fileName.c_str());
+        EXIT(EXIT_FAILURE);
+    }
+    init();
+}
+
+KmerSplitWriter::KmerSplitWriter(std::vector<unsigned char> &buffer)
+        : fileName("memory stream"), file(NULL), buffer(&buffer), prevRepSeq(0), prevId(0) {
+    init();
+}
+
+void KmerSplitWriter::init() {
+    writeBytes(SPLIT_FILE_MAGIC, SPLIT_FILE_MAGIC_SIZE);
+    cctx = ZSTD_createCCtx();
+    block.reserve(BLOCK_SIZE + 32);
+    compressed.resize(ZSTD_compressBound(BLOCK_SIZE + 32));
+}
+
+KmerSplitWriter::~KmerSplitWriter() {
+    if (file != NULL || buffer != NULL) {
+        close();
+    }
+    ZSTD_freeCCtx(cctx);
+}
+
+void KmerSplitWriter::writeBytes(const void *data, size_t size) {
+    if (buffer != NULL) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        buffer->insert(buffer->end(), bytes, bytes + size);
+        return;
+    }
+    if (fwrite(data, sizeof(unsigned char), size, file) != size) {
+        Debug(Debug::ERROR) << "Cannot write to " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+void KmerSplitWriter::putVarint(size_t value) {
+    while (value >= 0x80) {
+        block.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    block.push_back(static_cast<unsigned char>(value));
+}
+
+void KmerSplitWriter::beginGroup(unsigned int repSeq) {
+    if (repSeq < prevRepSeq) {
+        Debug(Debug::ERROR) << "Representative sequences have to be written in ascending order\n";
+        EXIT(EXIT_FAILURE);
+    }
+    putVarint(repSeq - prevRepSeq);
+    prevRepSeq = repSeq;
+    prevId = 0;
+}
+
+void KmerSplitWriter::writeEntry(unsigned int id, short diagonal, unsigned char score, bool reverse) {
+    if (id < prevId) {
+        Debug(Debug::ERROR) << "Members of a group have to be written in ascending order\n";
+        EXIT(EXIT_FAILURE);
+    }
+    // zero terminates a group
+    putVarint(static_cast<size_t>(id - prevId) + 1);
+    prevId = id;
+    // zigzag encoded diagonal with the strand in the lowest bit
+    unsigned int zigzag = (static_cast<unsigned int>(diagonal) << 1) ^ static_cast<unsigned int>(diagonal >> 15);
+    putVarint((static_cast<size_t>(zigzag) << 1) | (reverse ? 1 : 0));
+    block.push_back(score);
+    if (block.size() >= BLOCK_SIZE) {
+        flushBlock();
+    }
+}
+
+void KmerSplitWriter::endGroup() {
+    putVarint(0);
+    if (block.size() >= BLOCK_SIZE) {
+        flushBlock();
+    }
+}
+
+void KmerSplitWriter::flushBlock() {
+    if (block.empty()) {
+        return;
+    }
+    size_t compressedSize = ZSTD_compressCCtx(cctx, compressed.data(), compressed.size(), block.data(), block.size(), SPLIT_FILE_COMPRESSION_LEVEL);
+    if (ZSTD_isError(compressedSize)) {
+        Debug(Debug::ERROR) << "Compression of " << fileName << " failed: " << ZSTD_getErrorName(compressedSize) << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    unsigned int header[2] = { static_cast<unsigned int>(block.size()), static_cast<unsigned int>(compressedSize) };
+    writeBytes(header, sizeof(header));
+    writeBytes(compressed.data(), compressedSize);
+    block.clear();
+}
+
+void KmerSplitWriter::close() {
+    flushBlock();
+    if (buffer != NULL) {
+        buffer = NULL;
+        return;
+    }
+    if (fclose(file) != 0) {
+        Debug(Debug::ERROR) << "Cannot close file " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+    file = NULL;
+}
+
+KmerSplitReader::KmerSplitReader(const std::string &fileName, unsigned int fileIdx)
+        : fileName(fileName), fileIdx(fileIdx), data(NULL), dataSize(0), dataPos(0),
+          blockPos(0), entryPos(0), inGroup(false), repSeq(0), prevId(0) {
+    file = FileUtil::openFileOrDie(fileName.c_str(), "rb", true);
+    init();
+}
+
+KmerSplitReader::KmerSplitReader(const unsigned char *data, size_t size, unsigned int fileIdx)
+        : fileName("memory stream"), fileIdx(fileIdx), file(NULL), data(data), dataSize(size), dataPos(0),
+          blockPos(0), entryPos(0), inGroup(false), repSeq(0), prevId(0) {
+    init();
+}
+
+void KmerSplitReader::init() {
+    char magic[SPLIT_FILE_MAGIC_SIZE];
+    if (readBytes(magic, SPLIT_FILE_MAGIC_SIZE) != SPLIT_FILE_MAGIC_SIZE
+        || memcmp(magic, SPLIT_FILE_MAGIC, SPLIT_FILE_MAGIC_SIZE) != 0) {
+        Debug(Debug::ERROR) << "Split file " << fileName << " is invalid or was written by an older version. Please delete the tmp folder and restart\n";
+        EXIT(EXIT_FAILURE);
+    }
+    dctx = ZSTD_createDCtx();
+    entries.reserve(DECODE_BATCH);
+    decodeEntries();
+}
+
+KmerSplitReader::~KmerSplitReader() {
+    ZSTD_freeDCtx(dctx);
+    if (file != NULL && fclose(file) != 0) {
+        Debug(Debug::ERROR) << "Cannot close file " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+size_t KmerSplitReader::readBytes(void *dest, size_t size) {
+    if (file != NULL) {
+        return fread(dest, sizeof(unsigned char), size, file);
+    }
+    size = std::min(size, dataSize - dataPos);
+    memcpy(dest, data + dataPos, size);
+    dataPos += size;
+    return size;
+}
+
+bool KmerSplitReader::readBlock() {
+    unsigned int header[2];
+    size_t read = readBytes(header, sizeof(header));
+    if (read == 0 && (file == NULL || feof(file))) {
+        return false;
+    }
+    if (read != sizeof(header)) {
+        Debug(Debug::ERROR) << "Split file " << fileName << " is truncated\n";
+        EXIT(EXIT_FAILURE);
+    }
+    compressed.resize(header[1]);
+    block.resize(header[0]);
+    if (readBytes(compressed.data(), header[1]) != header[1]) {
+        Debug(Debug::ERROR) << "Split file " << fileName << " is truncated\n";
+        EXIT(EXIT_FAILURE);
+    }
+    size_t size = ZSTD_decompressDCtx(dctx, block.data(), block.size(), compressed.data(), compressed.size());
+    if (ZSTD_isError(size) || size != header[0]) {
+        Debug(Debug::ERROR) << "Split file " << fileName << " is corrupted\n";
+        EXIT(EXIT_FAILURE);
+    }
+    blockPos = 0;
+    return true;
+}
+
+bool KmerSplitReader::getVarint(size_t &value) {
+    value = 0;
+    for (unsigned int shift = 0; ; shift += 7) {
+        if (blockPos == block.size() && readBlock() == false) {
+            if (shift == 0) {
+                return false;
+            }
+            Debug(Debug::ERROR) << "Split file " << fileName << " is truncated\n";
+            EXIT(EXIT_FAILURE);
+        }
+        unsigned char byte = block[blockPos++];
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+}
+
+void KmerSplitReader::decodeEntries() {
+    entries.clear();
+    entryPos = 0;
+    size_t value;
+    while (entries.size() < DECODE_BATCH) {
+        if (getVarint(value) == false) {
+            if (inGroup) {
+                Debug(Debug::ERROR) << "Split file " << fileName << " is truncated\n";
+                EXIT(EXIT_FAILURE);
+            }
+            return;
+        }
+        if (inGroup == false) {
+            repSeq += static_cast<unsigned int>(value);
+            prevId = 0;
+            inGroup = true;
+            continue;
+        }
+        if (value == 0) {
+            inGroup = false;
+            continue;
+        }
+        unsigned int id = prevId + static_cast<unsigned int>(value - 1);
+        prevId = id;
+        size_t diagonalAndStrand;
+        if (getVarint(diagonalAndStrand) == false || (blockPos == block.size() && readBlock() == false)) {
+            Debug(Debug::ERROR) << "Split file " << fileName << " is truncated\n";
+            EXIT(EXIT_FAILURE);
+        }
+        unsigned char score = block[blockPos++];
+        unsigned int zigzag = static_cast<unsigned int>(diagonalAndStrand >> 1);
+        short diagonal = static_cast<short>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+        entries.emplace_back(repSeq, id, diagonal, score, static_cast<char>(diagonalAndStrand & 1), fileIdx);
+    }
+}
+
+KmerSplitMerger::KmerSplitMerger(const std::vector<std::string> &fileNames) : winner(0) {
+    for (size_t i = 0; i < fileNames.size(); i++) {
+        readers.push_back(new KmerSplitReader(fileNames[i], static_cast<unsigned int>(i)));
+    }
+    init();
+}
+
+KmerSplitMerger::KmerSplitMerger(const std::vector<KmerSplitReader *> &readers) : readers(readers), winner(0) {
+    init();
+}
+
+void KmerSplitMerger::init() {
+    losers.resize(readers.size(), 0);
+    if (readers.empty() == false) {
+        winner = initTree(1);
+    }
+}
+
+KmerSplitMerger::~KmerSplitMerger() {
+    for (size_t i = 0; i < readers.size(); i++) {
+        delete readers[i];
+    }
+}
+
+bool KmerSplitMerger::less(size_t a, size_t b) const {
+    // exhausted files lose every match
+    if (readers[a]->hasEntry() == false || readers[b]->hasEntry() == false) {
+        return readers[a]->hasEntry() && (readers[b]->hasEntry() == false || a < b);
+    }
+    const FileKmerPosition &first = readers[a]->entry();
+    const FileKmerPosition &second = readers[b]->entry();
+    if (first.repSeq != second.repSeq) {
+        return first.repSeq < second.repSeq;
+    }
+    if (first.id != second.id) {
+        return first.id < second.id;
+    }
+    if (first.pos != second.pos) {
+        return first.pos < second.pos;
+    }
+    return a < b;
+}
+
+size_t KmerSplitMerger::initTree(size_t node) {
+    if (node >= readers.size()) {
+        return node - readers.size();
+    }
+    size_t left = initTree(2 * node);
+    size_t right = initTree(2 * node + 1);
+    if (less(right, left)) {
+        losers[node] = left;
+        return right;
+    }
+    losers[node] = right;
+    return left;
+}
+
+void KmerSplitMerger::pop() {
+    readers[winner]->next();
+    size_t current = winner;
+    for (size_t node = (winner + readers.size()) / 2; node > 0; node /= 2) {
+        if (less(losers[node], current)) {
+            std::swap(losers[node], current);
+        }
+    }
+    winner = current;
+}
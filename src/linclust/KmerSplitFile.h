@@ -0,0 +1,122 @@
+#ifndef MMSEQS_KMERSPLITFILE_H
+#define MMSEQS_KMERSPLITFILE_H
+
+// Temporary files of the hash range splits of linclust and kmersearch.
+// A file holds groups in ascending representative order, the members of a group are in ascending id and diagonal order.
+// Representatives and ids are delta and varint encoded, the encoded stream is cut into zstd compressed blocks.
+// The same stream can be kept in memory to shuffle the groups between MPI ranks.
+#include "kmermatcher.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class KmerSplitWriter {
+public:
+    static const size_t BLOCK_SIZE = 1024 * 1024;
+
+    KmerSplitWriter(const std::string &fileName);
+    // appends the stream to buffer instead of a file
+    KmerSplitWriter(std::vector<unsigned char> &buffer);
+    ~KmerSplitWriter();
+
+    void beginGroup(unsigned int repSeq);
+    void writeEntry(unsigned int id, short diagonal, unsigned char score, bool reverse);
+    void endGroup();
+    void close();
+
+private:
+    std::string fileName;
+    FILE *file;
+    std::vector<unsigned char> *buffer;
+    ZSTD_CCtx *cctx;
+    std::vector<unsigned char> block;
+    std::vector<unsigned char> compressed;
+    unsigned int prevRepSeq;
+    unsigned int prevId;
+
+    void init();
+    void writeBytes(const void *data, size_t size);
+    void putVarint(size_t value);
+    void flushBlock();
+};
+
+class KmerSplitReader {
+public:
+    KmerSplitReader(const std::string &fileName, unsigned int fileIdx);
+    // reads a stream of a memory writer, data has to outlive the reader
+    KmerSplitReader(const unsigned char *data, size_t size, unsigned int fileIdx);
+    ~KmerSplitReader();
+
+    bool hasEntry() const {
+        return entryPos < entries.size();
+    }
+
+    const FileKmerPosition &entry() const {
+        return entries[entryPos];
+    }
+
+    void next() {
+        entryPos++;
+        if (entryPos == entries.size()) {
+            decodeEntries();
+        }
+    }
+
+private:
+    // entries are decoded in batches, the merge only touches the batch of each file
+    static const size_t DECODE_BATCH = 4096;
+
+    std::string fileName;
+    unsigned int fileIdx;
+    FILE *file;
+    const unsigned char *data;
+    size_t dataSize;
+    size_t dataPos;
+    ZSTD_DCtx *dctx;
+    std::vector<unsigned char> block;
+    std::vector<unsigned char> compressed;
+    size_t blockPos;
+    std::vector<FileKmerPosition> entries;
+    size_t entryPos;
+    bool inGroup;
+    unsigned int repSeq;
+    unsigned int prevId;
+
+    void init();
+    size_t readBytes(void *dest, size_t size);
+    bool readBlock();
+    bool getVarint(size_t &value);
+    void decodeEntries();
+};
+
+// k-way merge of split files with a loser tree, yields the entries in ascending representative, id and diagonal order
+class KmerSplitMerger {
+public:
+    KmerSplitMerger(const std::vector<std::string> &fileNames);
+    // takes ownership of the readers
+    KmerSplitMerger(const std::vector<KmerSplitReader *> &readers);
+    ~KmerSplitMerger();
+
+    bool empty() const {
+        return readers.empty() || readers[winner]->hasEntry() == false;
+    }
+
+    const FileKmerPosition &top() const {
+        return readers[winner]->entry();
+    }
+
+    void pop();
+
+private:
+    std::vector<KmerSplitReader *> readers;
+    // losers[i] holds the loser of the match at inner node i, leaves are the nodes readers.size() + file
+    std::vector<size_t> losers;
+    size_t winner;
+
+    void init();
+    bool less(size_t a, size_t b) const;
+    size_t initTree(size_t node);
+};
+
+#endif
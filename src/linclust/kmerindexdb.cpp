@@ -229,6 +229,10 @@ int kmerindexdb(int argc, const char **argv, const Command &command) {
 
         DBReader<unsigned int> dbr1(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
         dbr1.open(DBReader<unsigned int>::NOSORT);
+        // the data is copied as is, block compressed data has to be decompressed first
+        if (dbr1.isBlockCompressed()) {
+            dbr1.readMmapedDataInMemory();
+        }
         Debug(Debug::INFO) << "Write DBR1INDEX (" << PrefilteringIndexReader::DBR1INDEX << ")\n";
         char* data = DBReader<unsigned int>::serialize(dbr1);
         size_t offsetIndex = dbw.getOffset(0);
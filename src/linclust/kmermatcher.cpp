@@ -15,6 +15,8 @@
 #include "MarkovKmerScore.h"
 #include "FileUtil.h"
 #include "FastSort.h"
+#include "KmerPositionSort.h"
+#include "KmerSplitFile.h"
 
 #include <sys/stat.h>
 #include <sys/mman.h>
@@ -384,11 +386,10 @@ std::pair<size_t, size_t> fillKmerPositionArray(KmerPosition<T> * kmerArray, siz
     return std::make_pair(offset, longestKmer);
 }
 
+// fills the k-mers of the hash range, groups them by rep. sequence and returns the last position of the groups
 template <typename T>
-KmerPosition<T> * doComputation(size_t totalKmers, size_t hashStartRange, size_t hashEndRange, std::string splitFile,
-                                DBReader<unsigned int> & seqDbr, Parameters & par, BaseMatrix  * subMat) {
-
-    KmerPosition<T> * hashSeqPair = initKmerPositionMemory<T>(totalKmers);
+size_t computeKmerGroups(KmerPosition<T> * hashSeqPair, size_t totalKmers, size_t hashStartRange, size_t hashEndRange,
+                         DBReader<unsigned int> & seqDbr, Parameters & par, BaseMatrix  * subMat) {
     size_t elementsToSort;
     if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)){
         std::pair<size_t, size_t > ret = fillKmerPositionArray<Parameters::DBTYPE_NUCLEOTIDES, T>(hashSeqPair, totalKmers, seqDbr, par, subMat, true, hashStartRange, hashEndRange, NULL);
@@ -406,9 +407,9 @@ KmerPosition<T> * doComputation(size_t totalKmers, size_t hashStartRange, size_t
     Debug(Debug::INFO) << "Sort kmer ";
     Timer timer;
     if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + elementsToSort, KmerPosition<T>::compareRepSequenceAndIdAndPosReverse);
+        KmerPositionSort::sortByPos<true>(hashSeqPair, elementsToSort);
     }else{
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + elementsToSort, KmerPosition<T>::compareRepSequenceAndIdAndPos);
+        KmerPositionSort::sortByPos<false>(hashSeqPair, elementsToSort);
     }
     Debug(Debug::INFO) << timer.lap() << "\n";
 
@@ -425,21 +426,27 @@ KmerPosition<T> * doComputation(size_t totalKmers, size_t hashStartRange, size_t
     Debug(Debug::INFO) << "Sort by rep. sequence ";
     timer.reset();
     if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)){
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + writePos, KmerPosition<T>::compareRepSequenceAndIdAndDiagReverse);
+        KmerPositionSort::sortByDiag<true>(hashSeqPair, writePos);
     }else{
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + writePos, KmerPosition<T>::compareRepSequenceAndIdAndDiag);
+        KmerPositionSort::sortByDiag<false>(hashSeqPair, writePos);
     }
-    //kx::radix_sort(hashSeqPair, hashSeqPair + elementsToSort, SequenceComparision());
 //    for(size_t i = 0; i < writePos; i++){
 //        std::cout << BIT_CLEAR(hashSeqPair[i].kmer, 63) << "\t" << hashSeqPair[i].id << "\t" << hashSeqPair[i].pos << std::endl;
 //    }
     Debug(Debug::INFO) << timer.lap() << "\n";
+    return writePos;
+}
 
+template <typename T>
+KmerPosition<T> * doComputation(size_t totalKmers, size_t hashStartRange, size_t hashEndRange, std::string splitFile,
+                                DBReader<unsigned int> & seqDbr, Parameters & par, BaseMatrix  * subMat) {
+    KmerPosition<T> * hashSeqPair = initKmerPositionMemory<T>(totalKmers);
+    size_t writePos = computeKmerGroups<T>(hashSeqPair, totalKmers, hashStartRange, hashEndRange, seqDbr, par, subMat);
     if(hashEndRange != SIZE_T_MAX){
         if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)){
-            writeKmersToDisk<Parameters::DBTYPE_NUCLEOTIDES, KmerEntryRev, T>(splitFile, hashSeqPair, writePos + 1);
+            writeKmersToDisk<Parameters::DBTYPE_NUCLEOTIDES, T>(splitFile, hashSeqPair, writePos + 1);
         }else{
-            writeKmersToDisk<Parameters::DBTYPE_AMINO_ACIDS, KmerEntry, T>(splitFile, hashSeqPair, writePos + 1);
+            writeKmersToDisk<Parameters::DBTYPE_AMINO_ACIDS, T>(splitFile, hashSeqPair, writePos + 1);
         }
         delete [] hashSeqPair;
         hashSeqPair = NULL;
@@ -590,6 +597,146 @@ size_t computeMemoryNeededLinearfilter(size_t totalKmer) {
 }
 
 
+#ifdef HAVE_MPI
+// sends sendBuffer[rank] to every rank and receives the buffers of all ranks in recvBuffer
+void exchangeKmerStreams(std::vector<std::vector<unsigned char>> &sendBuffer, std::vector<std::vector<unsigned char>> &recvBuffer) {
+    // a single MPI call can only transfer INT_MAX elements
+    const size_t CHUNK_SIZE = 1024 * 1024 * 1024;
+    const int numProc = MMseqsMPI::numProc;
+    std::vector<uint64_t> sendSize(numProc);
+    std::vector<uint64_t> recvSize(numProc);
+    for (int proc = 0; proc < numProc; proc++) {
+        sendSize[proc] = sendBuffer[proc].size();
+    }
+    MPI_Alltoall(sendSize.data(), 1, MPI_UINT64_T, recvSize.data(), 1, MPI_UINT64_T, MPI_COMM_WORLD);
+
+    recvBuffer.resize(numProc);
+    std::vector<MPI_Request> requests;
+    for (int proc = 0; proc < numProc; proc++) {
+        if (proc == MMseqsMPI::rank) {
+            recvBuffer[proc].swap(sendBuffer[proc]);
+            continue;
+        }
+        recvBuffer[proc].resize(recvSize[proc]);
+        for (size_t offset = 0; offset < recvSize[proc]; offset += CHUNK_SIZE) {
+            requests.emplace_back();
+            MPI_Irecv(recvBuffer[proc].data() + offset, static_cast<int>(std::min(CHUNK_SIZE, recvSize[proc] - offset)),
+                      MPI_UNSIGNED_CHAR, proc, 0, MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    for (int proc = 0; proc < numProc; proc++) {
+        if (proc == MMseqsMPI::rank) {
+            continue;
+        }
+        for (size_t offset = 0; offset < sendSize[proc]; offset += CHUNK_SIZE) {
+            requests.emplace_back();
+            MPI_Isend(sendBuffer[proc].data() + offset, static_cast<int>(std::min(CHUNK_SIZE, sendSize[proc] - offset)),
+                      MPI_UNSIGNED_CHAR, proc, 0, MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    for (int proc = 0; proc < numProc; proc++) {
+        std::vector<unsigned char>().swap(sendBuffer[proc]);
+    }
+}
+
+// Every rank computes a contiguous block of hash ranges in memory. The groups are shuffled to the rank
+// owning their rep. sequence (kmerGroupOwner), which merges them into its part of the result database.
+template <typename T>
+void kmermatcherDistributed(Parameters &par, DBReader<unsigned int> &seqDbr, BaseMatrix *subMat,
+                            std::vector<std::pair<size_t, size_t>> &hashRanges, size_t totalKmersPerSplit) {
+    const size_t numProc = MMseqsMPI::numProc;
+    const size_t rank = MMseqsMPI::rank;
+    const size_t lastKey = seqDbr.getLastKey();
+    const bool isNucleotide = Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES);
+    const size_t fromSplit = (hashRanges.size() * rank) / numProc;
+    const size_t toSplit = (hashRanges.size() * (rank + 1)) / numProc;
+
+    // one stream per split and destination, each prefixed by its size
+    std::vector<std::vector<unsigned char>> sendBuffer(numProc);
+    std::vector<std::vector<unsigned char>> streams(numProc);
+    for (size_t split = fromSplit; split < toSplit; split++) {
+        Debug(Debug::INFO) << "Generate k-mers list for " << (split+1) << " split\n";
+        KmerPosition<T> *hashSeqPair = initKmerPositionMemory<T>(totalKmersPerSplit);
+        size_t writePos = computeKmerGroups<T>(hashSeqPair, totalKmersPerSplit, hashRanges[split].first, hashRanges[split].second, seqDbr, par, subMat);
+        std::vector<KmerSplitWriter *> writers;
+        for (size_t proc = 0; proc < numProc; proc++) {
+            writers.push_back(new KmerSplitWriter(streams[proc]));
+        }
+        if (isNucleotide) {
+            writeKmerGroups<Parameters::DBTYPE_NUCLEOTIDES, T>(writers, lastKey, hashSeqPair, writePos + 1);
+        } else {
+            writeKmerGroups<Parameters::DBTYPE_AMINO_ACIDS, T>(writers, lastKey, hashSeqPair, writePos + 1);
+        }
+        delete [] hashSeqPair;
+        for (size_t proc = 0; proc < numProc; proc++) {
+            delete writers[proc];
+            uint64_t size = streams[proc].size();
+            const unsigned char *sizeBytes = reinterpret_cast<const unsigned char *>(&size);
+            sendBuffer[proc].insert(sendBuffer[proc].end(), sizeBytes, sizeBytes + sizeof(uint64_t));
+            sendBuffer[proc].insert(sendBuffer[proc].end(), streams[proc].begin(), streams[proc].end());
+            streams[proc].clear();
+        }
+    }
+    std::vector<std::vector<unsigned char>>().swap(streams);
+    seqDbr.unmapData();
+
+    Debug(Debug::INFO) << "Exchange k-mer groups between " << numProc << " ranks\n";
+    Timer timer;
+    std::vector<std::vector<unsigned char>> recvBuffer;
+    exchangeKmerStreams(sendBuffer, recvBuffer);
+    Debug(Debug::INFO) << "Time for exchange: " << timer.lap() << "\n";
+
+    // the streams arrive in split order, so ties are merged like the split files
+    std::vector<KmerSplitReader *> readers;
+    for (size_t proc = 0; proc < numProc; proc++) {
+        size_t offset = 0;
+        while (offset < recvBuffer[proc].size()) {
+            uint64_t size;
+            memcpy(&size, recvBuffer[proc].data() + offset, sizeof(uint64_t));
+            offset += sizeof(uint64_t);
+            readers.push_back(new KmerSplitReader(recvBuffer[proc].data() + offset, size, static_cast<unsigned int>(readers.size())));
+            offset += size;
+        }
+    }
+
+    std::pair<std::string, std::string> tmpOutput = Util::createTmpFileNames(par.db2, par.db2Index, MMseqsMPI::rank);
+    DBWriter dbw(tmpOutput.first.c_str(), tmpOutput.second.c_str(), 1, par.compressed,
+                 isNucleotide ? Parameters::DBTYPE_PREFILTER_REV_RES : Parameters::DBTYPE_PREFILTER_RES);
+    dbw.open();
+    std::vector<char> repSequence(lastKey + 1, false);
+    {
+        KmerSplitMerger merger(readers);
+        mergeKmerFilesAndOutput(dbw, merger, repSequence);
+    }
+    std::vector<std::vector<unsigned char>>().swap(recvBuffer);
+
+    // add missing entries of the own rep. sequences (needed for clustering)
+    for (size_t id = 0; id < seqDbr.getSize(); id++) {
+        char buffer[100];
+        unsigned int dbKey = seqDbr.getDbKey(id);
+        if (kmerGroupOwner(dbKey, numProc, lastKey) == rank && repSequence[dbKey] == false) {
+            hit_t h;
+            h.prefScore = 0;
+            h.diagonal = 0;
+            h.seqId = dbKey;
+            int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
+            dbw.writeData(buffer, len, dbKey, 0);
+        }
+    }
+    dbw.close();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (MMseqsMPI::isMaster()) {
+        std::vector<std::pair<std::string, std::string>> splitFiles;
+        for (int proc = 0; proc < MMseqsMPI::numProc; ++proc) {
+            splitFiles.push_back(Util::createTmpFileNames(par.db2, par.db2Index, proc));
+        }
+        DBWriter::mergeResults(par.db2, par.db2Index, splitFiles);
+    }
+}
+#endif
+
 template <typename T>
 int kmermatcherInner(Parameters& par, DBReader<unsigned int>& seqDbr) {
 
@@ -621,44 +768,26 @@ int kmermatcherInner(Parameters& par, DBReader<unsigned int>& seqDbr) {
     size_t totalKmersPerSplit = std::max(static_cast<size_t>(1024+1),
                                          static_cast<size_t>(std::min(totalSizeNeeded, memoryLimit)/sizeof(KmerPosition<T>))+1);
 
+#ifdef HAVE_MPI
+    if(MMseqsMPI::numProc > 1){
+        // every rank gets at least one hash range
+        splits = std::max(splits, static_cast<size_t>(MMseqsMPI::numProc));
+        totalKmersPerSplit = std::min(totalKmersPerSplit, std::max(static_cast<size_t>(1024+1), totalKmers / MMseqsMPI::numProc + 1));
+    }
+#endif
     std::vector<std::pair<size_t, size_t>> hashRanges = setupKmerSplits<T>(par, subMat, seqDbr, totalKmersPerSplit, splits);
     if(splits > 1){
         Debug(Debug::INFO) << "Process file into " << hashRanges.size() << " parts\n";
     }
-    std::vector<std::string> splitFiles;
-    KmerPosition<T> *hashSeqPair = NULL;
-
-    size_t mpiRank = 0;
 #ifdef HAVE_MPI
-    splits = hashRanges.size();
-    size_t fromSplit = 0;
-    size_t splitCount = 1;
-    mpiRank = MMseqsMPI::rank;
-    // if split size is great than nodes than we have to
-    // distribute all splits equally over all nodes
-    unsigned int * splitCntPerProc = new unsigned int[MMseqsMPI::numProc];
-    memset(splitCntPerProc, 0, sizeof(unsigned int) * MMseqsMPI::numProc);
-    for(size_t i = 0; i < splits; i++){
-        splitCntPerProc[i % MMseqsMPI::numProc] += 1;
+    if(MMseqsMPI::numProc > 1){
+        kmermatcherDistributed<T>(par, seqDbr, subMat, hashRanges, totalKmersPerSplit);
+        delete subMat;
+        return EXIT_SUCCESS;
     }
-    for(int i = 0; i < MMseqsMPI::rank; i++){
-        fromSplit += splitCntPerProc[i];
-    }
-    splitCount = splitCntPerProc[MMseqsMPI::rank];
-    delete[] splitCntPerProc;
-
-    for(size_t split = fromSplit; split < fromSplit+splitCount; split++) {
-        std::string splitFileName = par.db2 + "_split_" +SSTR(split);
-        hashSeqPair = doComputation<T>(totalKmers, hashRanges[split].first, hashRanges[split].second, splitFileName, seqDbr, par, subMat);
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(mpiRank == 0){
-        for(size_t split = 0; split < splits; split++) {
-            std::string splitFileName = par.db2 + "_split_" +SSTR(split);
-            splitFiles.push_back(splitFileName);
-        }
-    }
-#else
+#endif
+    std::vector<std::string> splitFiles;
+    KmerPosition<T> *hashSeqPair = NULL;
     for(size_t split = 0; split < hashRanges.size(); split++) {
         std::string splitFileName = par.db2 + "_split_" +SSTR(split);
         Debug(Debug::INFO) << "Generate k-mers list for " << (split+1) <<" split\n";
@@ -670,60 +799,53 @@ int kmermatcherInner(Parameters& par, DBReader<unsigned int>& seqDbr) {
 
         splitFiles.push_back(splitFileName);
     }
-#endif
-    if(mpiRank == 0){
-        std::vector<char> repSequence(seqDbr.getLastKey()+1);
-        std::fill(repSequence.begin(), repSequence.end(), false);
-        // write result
-        DBWriter dbw(par.db2.c_str(), par.db2Index.c_str(), 1, par.compressed,
-                     (Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) ? Parameters::DBTYPE_PREFILTER_REV_RES : Parameters::DBTYPE_PREFILTER_RES );
-        dbw.open();
-
-        Timer timer;
-        if(splits > 1) {
-            seqDbr.unmapData();
-            if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
-                mergeKmerFilesAndOutput<Parameters::DBTYPE_NUCLEOTIDES, KmerEntryRev>(dbw, splitFiles, repSequence);
-            }else{
-                mergeKmerFilesAndOutput<Parameters::DBTYPE_AMINO_ACIDS, KmerEntry>(dbw, splitFiles, repSequence);
-            }
-            for(size_t i = 0; i < splitFiles.size(); i++){
-                FileUtil::remove(splitFiles[i].c_str());
-                std::string splitFilesDone = splitFiles[i] + ".done";
-                FileUtil::remove(splitFilesDone.c_str());
-            }
-        } else {
-            if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
-                writeKmerMatcherResult<Parameters::DBTYPE_NUCLEOTIDES>(dbw, hashSeqPair, totalKmersPerSplit, repSequence, 1);
-            }else{
-                writeKmerMatcherResult<Parameters::DBTYPE_AMINO_ACIDS>(dbw, hashSeqPair, totalKmersPerSplit, repSequence, 1);
-            }
+    std::vector<char> repSequence(seqDbr.getLastKey()+1);
+    std::fill(repSequence.begin(), repSequence.end(), false);
+    // write result
+    DBWriter dbw(par.db2.c_str(), par.db2Index.c_str(), 1, par.compressed,
+                 (Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) ? Parameters::DBTYPE_PREFILTER_REV_RES : Parameters::DBTYPE_PREFILTER_RES );
+    dbw.open();
+
+    Timer timer;
+    if(splits > 1) {
+        seqDbr.unmapData();
+        mergeKmerFilesAndOutput(dbw, splitFiles, repSequence);
+        for(size_t i = 0; i < splitFiles.size(); i++){
+            FileUtil::remove(splitFiles[i].c_str());
+            std::string splitFilesDone = splitFiles[i] + ".done";
+            FileUtil::remove(splitFilesDone.c_str());
+        }
+    } else {
+        if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
+            writeKmerMatcherResult<Parameters::DBTYPE_NUCLEOTIDES>(dbw, hashSeqPair, totalKmersPerSplit, repSequence, 1);
+        }else{
+            writeKmerMatcherResult<Parameters::DBTYPE_AMINO_ACIDS>(dbw, hashSeqPair, totalKmersPerSplit, repSequence, 1);
         }
-        Debug(Debug::INFO) << "Time for fill: " << timer.lap() << "\n";
-        // add missing entries to the result (needed for clustering)
+    }
+    Debug(Debug::INFO) << "Time for fill: " << timer.lap() << "\n";
+    // add missing entries to the result (needed for clustering)
 
 #pragma omp parallel num_threads(1)
-        {
-            unsigned int thread_idx = 0;
+    {
+        unsigned int thread_idx = 0;
 #ifdef OPENMP
-            thread_idx = static_cast<unsigned int>(omp_get_thread_num());
+        thread_idx = static_cast<unsigned int>(omp_get_thread_num());
 #endif
 #pragma omp for
-            for (size_t id = 0; id < seqDbr.getSize(); id++) {
-                char buffer[100];
-                unsigned int dbKey = seqDbr.getDbKey(id);
-                if (repSequence[dbKey] == false) {
-                    hit_t h;
-                    h.prefScore = 0;
-                    h.diagonal = 0;
-                    h.seqId = dbKey;
-                    int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
-                    dbw.writeData(buffer, len, dbKey, thread_idx);
-                }
+        for (size_t id = 0; id < seqDbr.getSize(); id++) {
+            char buffer[100];
+            unsigned int dbKey = seqDbr.getDbKey(id);
+            if (repSequence[dbKey] == false) {
+                hit_t h;
+                h.prefScore = 0;
+                h.diagonal = 0;
+                h.seqId = dbKey;
+                int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
+                dbw.writeData(buffer, len, dbKey, thread_idx);
             }
         }
-        dbw.close(false, false);
     }
+    dbw.close(false, false);
     // free memory
     delete subMat;
     if(hashSeqPair){
@@ -923,227 +1045,107 @@ void writeKmerMatcherResult(DBWriter & dbw,
     }
 }
 
-template <int TYPE, typename T>
-size_t queueNextEntry(KmerPositionQueue &queue, int file, size_t offsetPos, T *entries, size_t entrySize) {
-    if(offsetPos + 1 >= entrySize){
-        return offsetPos;
-    }
-    unsigned int repSeqId = entries[offsetPos].seqId;
-    size_t pos = 0;
-    while(entries[offsetPos + pos].seqId != UINT_MAX){
-        if(TYPE == Parameters::DBTYPE_NUCLEOTIDES){
-            queue.push(FileKmerPosition(repSeqId, entries[offsetPos+pos].seqId, entries[offsetPos+pos].diagonal, entries[offsetPos+pos].score, entries[offsetPos+pos].getRev(), file));
-        }else{
-            queue.push(FileKmerPosition(repSeqId, entries[offsetPos+pos].seqId, entries[offsetPos+pos].diagonal, entries[offsetPos+pos].score, file));
-        }
-        pos++;
-    }
-    queue.push(FileKmerPosition(repSeqId, UINT_MAX, 0, 0, file));
-    pos++;
-    return offsetPos+pos;
-}
-
-template <int TYPE, typename T>
 void mergeKmerFilesAndOutput(DBWriter & dbw,
                              std::vector<std::string> tmpFiles,
                              std::vector<char> &repSequence) {
-    Debug(Debug::INFO) << "Merge splits ... ";
+    KmerSplitMerger merger(tmpFiles);
+    mergeKmerFilesAndOutput(dbw, merger, repSequence);
+}
 
-    const int fileCnt = tmpFiles.size();
-    FILE ** files       = new FILE*[fileCnt];
-    T **entries = new T*[fileCnt];
-    size_t * entrySizes = new size_t[fileCnt];
-    size_t * offsetPos  = new size_t[fileCnt];
-    size_t * dataSizes  = new size_t[fileCnt];
-    // init structures
-    for(size_t file = 0; file < tmpFiles.size(); file++){
-        files[file] = FileUtil::openFileOrDie(tmpFiles[file].c_str(),"r",true);
-        size_t dataSize;
-        struct stat sb;
-        fstat(fileno(files[file]) , &sb);
-        if(sb.st_size > 0){
-            entries[file]    = (T*)FileUtil::mmapFile(files[file], &dataSize);
-#if HAVE_POSIX_MADVISE
-            if (posix_madvise (entries[file], dataSize, POSIX_MADV_SEQUENTIAL) != 0){
-                Debug(Debug::ERROR) << "posix_madvise returned an error for file " << tmpFiles[file] << "\n";
-            }
-#endif
-        }else{
-            dataSize = 0;
-        }
+void mergeKmerFilesAndOutput(DBWriter & dbw, KmerSplitMerger &merger, std::vector<char> &repSequence) {
+    Debug(Debug::INFO) << "Merge splits ... ";
 
-        dataSizes[file]  = dataSize;
-        entrySizes[file] = dataSize/sizeof(T);
-    }
-    KmerPositionQueue queue;
-    // read one entry for each file
-    for(int file = 0; file < fileCnt; file++ ){
-        offsetPos[file] = queueNextEntry<TYPE,T>(queue, file, 0, entries[file], entrySizes[file]);
-    }
     std::string prefResultsOutString;
     prefResultsOutString.reserve(100000000);
     char buffer[100];
-    FileKmerPosition res;
     bool hasRepSeq =  repSequence.size()>0;
-    unsigned int currRepSeq = UINT_MAX;
-    if(queue.empty() == false){
-        res = queue.top();
-        currRepSeq = res.repSeq;
-        if(hasRepSeq) {
+    while(merger.empty() == false) {
+        const unsigned int currRepSeq = merger.top().repSeq;
+        if(hasRepSeq){
             hit_t h;
-            h.seqId = res.repSeq;
+            h.seqId = currRepSeq;
             h.prefScore = 0;
             h.diagonal = 0;
             int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
             prefResultsOutString.append(buffer, len);
         }
-    }
-
-//    while(queue.empty() == false) {
-//        res = queue.top();
-//        std::cout << (int)res.repSeq << "\t" << (int)res.id << "\t" <<(int) res.pos << "\t" << (int) res.reverse << std::endl;
-//        queue.pop();
-//        offsetPos[res.file] = queueNextEntry<TYPE,T>(queue, res.file, offsetPos[res.file],
-//                                                     entries[res.file], entrySizes[res.file]);
-//    }
-    while(queue.empty() == false) {
-        res = queue.top();
-        queue.pop();
-        if(res.id == UINT_MAX) {
-            offsetPos[res.file] = queueNextEntry<TYPE,T>(queue, res.file, offsetPos[res.file],
-                                                         entries[res.file], entrySizes[res.file]);
-            dbw.writeData(prefResultsOutString.c_str(), prefResultsOutString.length(), res.repSeq, 0);
-            if(hasRepSeq){
-                repSequence[res.repSeq]=true;
-            }
-            prefResultsOutString.clear();
-            // skipe UINT MAX entries
-            while(queue.empty() == false && queue.top().id==UINT_MAX) {
-                res = queue.top();
-                queue.pop();
-                offsetPos[res.file] = queueNextEntry<TYPE,T>(queue, res.file, offsetPos[res.file],
-                                                             entries[res.file], entrySizes[res.file]);
-            }
-            if(queue.empty() == false) {
-                res = queue.top();
-                currRepSeq = res.repSeq;
-                queue.pop();
-                if(hasRepSeq){
-                    hit_t h;
-                    h.seqId = res.repSeq;
-                    h.prefScore = 0;
-                    h.diagonal = 0;
-                    int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
-                    prefResultsOutString.append(buffer, len);
-                }
-            }
-        }
-
-        bool hitIsRepSeq = (currRepSeq == res.id);
-        // skip rep. seq. if set does not have rep. sequences
-        if(hitIsRepSeq){
-            continue;
-        }
-        // if its not a duplicate
-        // find maximal diagonal and top score
-        int bestDiagonalCnt = 0;
-        int bestRevertMask = 0;
-        short bestDiagonal = res.pos;
-        int topScore = 0;
-        unsigned int hitId;
-        unsigned int prevHitId;
-        int diagonalScore = 0;
-        short prevDiagonal = res.pos;
-        do {
-            prevHitId = res.id;
-            diagonalScore = (diagonalScore == 0 || prevDiagonal!=res.pos) ? res.score : diagonalScore + res.score;
-            if(diagonalScore >= bestDiagonalCnt){
-                bestDiagonalCnt = diagonalScore;
-                bestDiagonal = res.pos;
-                bestRevertMask = res.reverse;
+        while(merger.empty() == false && merger.top().repSeq == currRepSeq) {
+            const unsigned int hitId = merger.top().id;
+            // skip rep. seq. if set does not have rep. sequences
+            if(hitId == currRepSeq){
+                merger.pop();
+                continue;
             }
-            prevDiagonal = res.pos;
-            topScore += res.score;
-            if(queue.empty() == false) {
-                res = queue.top();
-                queue.pop();
-                hitId = res.id;
-                if(hitId != prevHitId){
-                    queue.push(res);
+            // find maximal diagonal and top score
+            int bestDiagonalCnt = 0;
+            int bestRevertMask = 0;
+            short bestDiagonal = merger.top().pos;
+            int topScore = 0;
+            int diagonalScore = 0;
+            short prevDiagonal = merger.top().pos;
+            do {
+                const FileKmerPosition &res = merger.top();
+                diagonalScore = (diagonalScore == 0 || prevDiagonal!=res.pos) ? res.score : diagonalScore + res.score;
+                if(diagonalScore >= bestDiagonalCnt){
+                    bestDiagonalCnt = diagonalScore;
+                    bestDiagonal = res.pos;
+                    bestRevertMask = res.reverse;
                 }
-            }else{
-                hitId = UINT_MAX;
-            }
-
-        } while(hitId == prevHitId && res.repSeq == currRepSeq && hitId != UINT_MAX);
+                prevDiagonal = res.pos;
+                topScore += res.score;
+                merger.pop();
+            } while(merger.empty() == false && merger.top().id == hitId && merger.top().repSeq == currRepSeq);
 
-        hit_t h;
-        h.seqId = prevHitId;
-        h.prefScore =  (bestRevertMask) ? -topScore : topScore;
-        h.diagonal =  bestDiagonal;
-        int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
-        prefResultsOutString.append(buffer, len);
-    }
-    for(size_t file = 0; file < tmpFiles.size(); file++) {
-        if (fclose(files[file]) != 0) {
-            Debug(Debug::ERROR) << "Cannot close file " << tmpFiles[file] << "\n";
-            EXIT(EXIT_FAILURE);
+            hit_t h;
+            h.seqId = hitId;
+            h.prefScore =  (bestRevertMask) ? -topScore : topScore;
+            h.diagonal =  bestDiagonal;
+            int len = QueryMatcher::prefilterHitToBuffer(buffer, h);
+            prefResultsOutString.append(buffer, len);
         }
-        if(dataSizes[file] > 0 && munmap((void*)entries[file], dataSizes[file]) < 0){
-            Debug(Debug::ERROR) << "Failed to munmap memory dataSize=" << dataSizes[file] <<"\n";
-            EXIT(EXIT_FAILURE);
+        dbw.writeData(prefResultsOutString.c_str(), prefResultsOutString.length(), currRepSeq, 0);
+        if(hasRepSeq){
+            repSequence[currRepSeq]=true;
         }
+        prefResultsOutString.clear();
     }
-
-
-    delete [] dataSizes;
-    delete [] offsetPos;
-    delete [] entries;
-    delete [] entrySizes;
-    delete [] files;
 }
 
 
-template <int TYPE, typename T, typename seqLenType>
+template <int TYPE, typename seqLenType>
 void writeKmersToDisk(std::string tmpFile, KmerPosition<seqLenType> *hashSeqPair, size_t totalKmers) {
+    KmerSplitWriter writer(tmpFile);
+    std::vector<KmerSplitWriter *> writers(1, &writer);
+    writeKmerGroups<TYPE, seqLenType>(writers, 0, hashSeqPair, totalKmers);
+    writer.close();
+    std::string fileName = tmpFile + ".done";
+    FILE* done = FileUtil::openFileOrDie(fileName.c_str(),"w", false);
+    if (fclose(done) != 0) {
+        Debug(Debug::ERROR) << "Cannot close file " << fileName << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+template <int TYPE, typename seqLenType>
+void writeKmerGroups(std::vector<KmerSplitWriter *> &writers, size_t lastKey, KmerPosition<seqLenType> *hashSeqPair, size_t totalKmers) {
     size_t repSeqId = SIZE_T_MAX;
     size_t lastTargetId = SIZE_T_MAX;
     seqLenType lastDiagonal=0;
     int diagonalScore=0;
-    FILE* filePtr = fopen(tmpFile.c_str(), "wb");
-    if(filePtr == NULL) { perror(tmpFile.c_str()); EXIT(EXIT_FAILURE); }
-    unsigned int writeSets = 0;
-    const size_t BUFFER_SIZE = 2048;
-    size_t bufferPos = 0;
-    size_t elemenetCnt = 0;
-    T writeBuffer[BUFFER_SIZE];
-    T nullEntry;
-    nullEntry.seqId=UINT_MAX;
-    nullEntry.diagonal=0;
+    KmerSplitWriter *writer = NULL;
     for(size_t kmerPos = 0; kmerPos < totalKmers && hashSeqPair[kmerPos].kmer != SIZE_T_MAX; kmerPos++){
         size_t currKmer=hashSeqPair[kmerPos].kmer;
         if(TYPE == Parameters::DBTYPE_NUCLEOTIDES){
             currKmer = BIT_CLEAR(currKmer, 63);
         }
         if(repSeqId != currKmer) {
-            if (writeSets > 0 && elemenetCnt > 0) {
-                if(bufferPos > 0){
-                    fwrite(writeBuffer, sizeof(T), bufferPos, filePtr);
-                }
-                fwrite(&nullEntry, sizeof(T), 1, filePtr);
+            if (repSeqId != SIZE_T_MAX) {
+                writer->endGroup();
             }
             lastTargetId = SIZE_T_MAX;
-            bufferPos=0;
-            elemenetCnt=0;
             repSeqId = currKmer;
-            writeBuffer[bufferPos].seqId = repSeqId;
-            writeBuffer[bufferPos].score = 0;
-            writeBuffer[bufferPos].diagonal = 0;
-            if(TYPE == Parameters::DBTYPE_NUCLEOTIDES){
-                bool isReverse = BIT_CHECK(hashSeqPair[kmerPos].kmer, 63)==false;
-                writeBuffer[bufferPos].setReverse(isReverse);
-            }
-            bufferPos++;
+            writer = writers[(writers.size() == 1) ? 0 : kmerGroupOwner(repSeqId, writers.size(), lastKey)];
+            writer->beginGroup(repSeqId);
         }
 
         unsigned int targetId = hashSeqPair[kmerPos].id;
@@ -1164,36 +1166,12 @@ void writeKmersToDisk(std::string tmpFile, KmerPosition<seqLenType> *hashSeqPair
         }while(targetId == hashSeqPair[kmerPos].id && hashSeqPair[kmerPos].pos == diagonal && kmerPos < totalKmers && hashSeqPair[kmerPos].kmer != SIZE_T_MAX);
         kmerPos--;
 
-        elemenetCnt++;
-        writeBuffer[bufferPos].seqId = targetId;
-        writeBuffer[bufferPos].score = diagonalScore;
+        writer->writeEntry(targetId, static_cast<short>(diagonal), static_cast<unsigned char>(diagonalScore), reverse > forward);
         diagonalScore = 0;
-        writeBuffer[bufferPos].diagonal = diagonal;
-        if(TYPE == Parameters::DBTYPE_NUCLEOTIDES){
-            bool isReverse = (reverse>forward)? true : false;
-            writeBuffer[bufferPos].setReverse(isReverse);
-        }
-        bufferPos++;
-        if(bufferPos >= BUFFER_SIZE){
-            fwrite(writeBuffer, sizeof(T), bufferPos, filePtr);
-            bufferPos=0;
-        }
         lastTargetId = targetId;
-        writeSets++;
-    }
-    if (writeSets > 0 && elemenetCnt > 0 && bufferPos > 0) {
-        fwrite(writeBuffer, sizeof(T), bufferPos, filePtr);
-        fwrite(&nullEntry,  sizeof(T), 1, filePtr);
     }
-    if (fclose(filePtr) != 0) {
-        Debug(Debug::ERROR) << "Cannot close file " << tmpFile << "\n";
-        EXIT(EXIT_FAILURE);
-    }
-    std::string fileName = tmpFile + ".done";
-    FILE* done = FileUtil::openFileOrDie(fileName.c_str(),"w", false);
-    if (fclose(done) != 0) {
-        Debug(Debug::ERROR) << "Cannot close file " << fileName << "\n";
-        EXIT(EXIT_FAILURE);
+    if (repSeqId != SIZE_T_MAX) {
+        writer->endGroup();
     }
 }
 
@@ -132,31 +132,6 @@ struct __attribute__((__packed__))KmerPosition {
 
 
 
-struct __attribute__((__packed__)) KmerEntry {
-    unsigned int seqId;
-    short diagonal;
-    unsigned char score;
-    void setReverse(bool ){
-        ;
-    }
-    unsigned char getRev(){
-        return 0;
-    }
-};
-
-struct __attribute__((__packed__)) KmerEntryRev {
-    unsigned int seqId;
-    short diagonal;
-    unsigned char score;
-    unsigned char rev;
-    void setReverse(bool rev){
-        this->rev = rev;
-    }
-    unsigned char getRev(){
-        return this->rev;
-    }
-};
-
 struct FileKmerPosition {
     size_t repSeq;
     unsigned int id;
@@ -171,43 +146,29 @@ struct FileKmerPosition {
             repSeq(repSeq), id(id), pos(pos), score(score), file(file), reverse(reverse) {}
 };
 
-class CompareResultBySeqId {
-public:
-    bool operator() (FileKmerPosition & first, FileKmerPosition & second) const {
-        //return (first.eval < second.eval);
-        if(first.repSeq > second.repSeq )
-            return true;
-        if(second.repSeq > first.repSeq )
-            return false;
-        if(first.id > second.id )
-            return true;
-        if(second.id > first.id )
-            return false;
-        if(first.pos > second.pos )
-            return true;
-        if(second.pos > first.pos )
-            return false;
-        return false;
-    }
-};
-
-
 template  <int TYPE, typename T>
 size_t assignGroup(KmerPosition<T> *kmers, size_t splitKmerCount, bool includeOnlyExtendable, int covMode, float covThr);
 
-template <int TYPE, typename T>
-void mergeKmerFilesAndOutput(DBWriter & dbw, std::vector<std::string> tmpFiles, std::vector<char> &repSequence);
+class KmerSplitWriter;
+class KmerSplitMerger;
 
-typedef std::priority_queue<FileKmerPosition, std::vector<FileKmerPosition>, CompareResultBySeqId> KmerPositionQueue;
+void mergeKmerFilesAndOutput(DBWriter & dbw, std::vector<std::string> tmpFiles, std::vector<char> &repSequence);
 
-template <int TYPE, typename T>
-size_t queueNextEntry(KmerPositionQueue &queue, int file, size_t offsetPos, T *entries, size_t entrySize);
+void mergeKmerFilesAndOutput(DBWriter & dbw, KmerSplitMerger &merger, std::vector<char> &repSequence);
 
 void setKmerLengthAndAlphabet(Parameters &parameters, size_t aaDbSize, int seqType);
 
-template <int TYPE, typename T, typename seqLenType>
+template <int TYPE, typename seqLenType>
 void writeKmersToDisk(std::string tmpFile, KmerPosition<seqLenType> *kmers, size_t totalKmers);
 
+// the group of rep. sequence key goes to writers[kmerGroupOwner(key, writers.size(), lastKey)]
+template <int TYPE, typename seqLenType>
+void writeKmerGroups(std::vector<KmerSplitWriter *> &writers, size_t lastKey, KmerPosition<seqLenType> *kmers, size_t totalKmers);
+
+inline size_t kmerGroupOwner(size_t key, size_t parts, size_t lastKey) {
+    return (key * parts) / (lastKey + 1);
+}
+
 template <int TYPE, typename T>
 void writeKmerMatcherResult(DBWriter & dbw, KmerPosition<T> *hashSeqPair, size_t totalKmers,
                             std::vector<char> &repSequence, size_t threads);
@@ -14,7 +14,7 @@
 #include "Timer.h"
 #include "KmerIndex.h"
 #include "FileUtil.h"
-#include "FastSort.h"
+#include "KmerPositionSort.h"
 
 #ifndef SIZE_T_MAX
 #define SIZE_T_MAX ((size_t) -1)
@@ -47,9 +47,9 @@ KmerSearch::ExtractKmerAndSortResult KmerSearch::extractKmerAndSort(size_t total
     Debug(Debug::INFO) << "Sort kmer ... ";
     timer.reset();
     if(Parameters::isEqualDbtype(seqDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + elementsToSort, KmerPosition<short>::compareRepSequenceAndIdAndPosReverse);
+        KmerPositionSort::sortByPos<true>(hashSeqPair, elementsToSort);
     }else{
-        SORT_PARALLEL(hashSeqPair, hashSeqPair + elementsToSort, KmerPosition<short>::compareRepSequenceAndIdAndPos);
+        KmerPositionSort::sortByPos<false>(hashSeqPair, elementsToSort);
     }
 
 
@@ -263,10 +263,9 @@ int kmersearch(int argc, const char **argv, const Command &command) {
                 dbw.close();
             } else {
                 if (Parameters::isEqualDbtype(queryDbr.getDbtype(), Parameters::DBTYPE_NUCLEOTIDES)) {
-                    writeKmersToDisk<Parameters::DBTYPE_NUCLEOTIDES, KmerEntryRev, short>(tmpFiles.first, kmers,
-                                                                                          kmerCount );
+                    writeKmersToDisk<Parameters::DBTYPE_NUCLEOTIDES, short>(tmpFiles.first, kmers, kmerCount );
                 } else {
-                    writeKmersToDisk<Parameters::DBTYPE_AMINO_ACIDS, KmerEntry, short>(tmpFiles.first, kmers, kmerCount );
+                    writeKmersToDisk<Parameters::DBTYPE_AMINO_ACIDS, short>(tmpFiles.first, kmers, kmerCount );
                 }
             }
             delete[] kmers;
@@ -279,11 +278,7 @@ int kmersearch(int argc, const char **argv, const Command &command) {
         DBWriter writer(par.db3.c_str(), par.db3Index.c_str(), 1, par.compressed, outDbType);
         writer.open(); // 1 GB buffer
         std::vector<char> empty;
-        if(Parameters::isEqualDbtype(querySeqType, Parameters::DBTYPE_NUCLEOTIDES)) {
-            mergeKmerFilesAndOutput<Parameters::DBTYPE_NUCLEOTIDES, KmerEntryRev>(writer, splitFiles, empty);
-        }else{
-            mergeKmerFilesAndOutput<Parameters::DBTYPE_AMINO_ACIDS, KmerEntry>(writer, splitFiles, empty);
-        }
+        mergeKmerFilesAndOutput(writer, splitFiles, empty);
         for(size_t i = 0; i < splitFiles.size(); i++){
             FileUtil::remove(splitFiles[i].c_str());
             std::string splitFilesDone = splitFiles[i] + ".done";
@@ -420,9 +415,9 @@ std::pair<KmerPosition<short> *,size_t > KmerSearch::searchInIndex(KmerPosition<
     Debug(Debug::INFO) << "Time to find k-mers: " << timer.lap() << "\n";
     timer.reset();
     if(TYPE == Parameters::DBTYPE_NUCLEOTIDES) {
-        SORT_PARALLEL(kmers, kmers + writePos, KmerPosition<short>::compareRepSequenceAndIdAndDiagReverse);
+        KmerPositionSort::sortByDiag<true>(kmers, writePos);
     }else{
-        SORT_PARALLEL(kmers, kmers + writePos, KmerPosition<short>::compareRepSequenceAndIdAndDiag);
+        KmerPositionSort::sortByDiag<false>(kmers, writePos);
     }
 
     Debug(Debug::INFO) << "Time to sort: " << timer.lap() << "\n";
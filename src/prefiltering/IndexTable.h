@@ -12,6 +12,7 @@
 #include "Indexer.h"
 #include "Debug.h"
 #include "Util.h"
+#include "LargeMemory.h"
 #include "SequenceLookup.h"
 #include "MathUtil.h"
 #include "KmerGenerator.h"
@@ -66,10 +67,10 @@ class IndexTable {
 public:
     IndexTable(int alphabetSize, int kmerSize, bool externalData)
             : tableSize(MathUtil::ipow<size_t>(alphabetSize, kmerSize)), alphabetSize(alphabetSize),
-              kmerSize(kmerSize), externalData(externalData), tableEntriesNum(0), size(0),
+              kmerSize(kmerSize), externalData(externalData), replicaNode(-1), tableEntriesNum(0), size(0),
               indexer(new Indexer(alphabetSize, kmerSize)), entries(NULL), offsets(NULL) {
         if (externalData == false) {
-            offsets = new(std::nothrow) size_t[tableSize + 1];
+            offsets = static_cast<size_t *>(LargeMemory::allocate((tableSize + 1) * sizeof(size_t)));
             Util::checkAllocation(offsets, "Can not allocate entries memory in IndexTable");
             memset(offsets, 0, (tableSize + 1) * sizeof(size_t));
         }
@@ -81,18 +82,36 @@ public:
     }
 
     void deleteEntries() {
-        if (externalData == false) {
+        if (externalData == false || replicaNode != -1) {
             if (entries != NULL) {
-                delete[] entries;
+                LargeMemory::release(entries, tableEntriesNum * sizeof(IndexEntryLocal));
                 entries = NULL;
             }
             if (offsets != NULL) {
-                delete[] offsets;
+                LargeMemory::release(offsets, (tableSize + 1) * sizeof(size_t));
                 offsets = NULL;
             }
         }
     }
 
+    // copy of the table whose memory is bound to a NUMA node
+    IndexTable *replicate(int node) {
+        IndexTable *replica = new IndexTable(alphabetSize, kmerSize, true);
+        IndexEntryLocal *entryCopy = static_cast<IndexEntryLocal *>(LargeMemory::allocate(tableEntriesNum * sizeof(IndexEntryLocal), node));
+        Util::checkAllocation(entryCopy, "Can not allocate entries memory in IndexTable::replicate");
+        size_t *offsetCopy = static_cast<size_t *>(LargeMemory::allocate((tableSize + 1) * sizeof(size_t), node));
+        Util::checkAllocation(offsetCopy, "Can not allocate offsets memory in IndexTable::replicate");
+        const size_t CHUNK = 1024 * 1024;
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t from = 0; from < tableEntriesNum; from += CHUNK) {
+            memcpy(entryCopy + from, entries + from, std::min(CHUNK, static_cast<size_t>(tableEntriesNum) - from) * sizeof(IndexEntryLocal));
+        }
+        memcpy(offsetCopy, offsets, (tableSize + 1) * sizeof(size_t));
+        replica->initTableByExternalData(size, tableEntriesNum, entryCopy, offsetCopy);
+        replica->replicaNode = node;
+        return replica;
+    }
+
     // count k-mers in the sequence, so enough memory for the sequence lists can be allocated in the end
     size_t addSimilarKmerCount(Sequence* s, KmerGenerator* kmerGenerator){
         s->resetCurrPos();
@@ -209,7 +228,7 @@ public:
         this->size = dbSize; // amount of sequences added
 
         // allocate memory for the sequence id lists
-        entries = new(std::nothrow) IndexEntryLocal[tableEntriesNum];
+        entries = static_cast<IndexEntryLocal *>(LargeMemory::allocate(tableEntriesNum * sizeof(IndexEntryLocal)));
         Util::checkAllocation(entries, "Can not allocate entries memory in IndexTable::initMemory");
     }
 
@@ -238,7 +257,7 @@ public:
         this->tableEntriesNum = tableEntriesNum;
         this->size = sequenceCount;
 
-        this->entries = new(std::nothrow) IndexEntryLocal[tableEntriesNum];
+        this->entries = static_cast<IndexEntryLocal *>(LargeMemory::allocate(tableEntriesNum * sizeof(IndexEntryLocal)));
         Util::checkAllocation(entries, "Can not allocate " + SSTR(tableEntriesNum * sizeof(IndexEntryLocal)) + " bytes for entries in IndexTable::initMemory");
         memcpy(this->entries, entries, tableEntriesNum * sizeof(IndexEntryLocal));
 
@@ -466,6 +485,8 @@ protected:
 
     // external data from mmap
     const bool externalData;
+    // NUMA node of a replica, which owns its external data, -1 otherwise
+    int replicaNode;
 
     // number of entries in all sequence lists - must be 64bit
     uint64_t tableEntriesNum;
@@ -0,0 +1,130 @@
+#include "IndexTablePrefetcher.h"
+#include "Util.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+
+IndexTablePrefetcher::IndexTablePrefetcher(IndexTable *indexTable, const size_t *blockOffsets, size_t blockCount, size_t blockSize,
+                                           DBReader<unsigned int> *qdbr, unsigned int readerThread, int querySeqType,
+                                           BaseMatrix *kmerSubMat, ScoreMatrix *three, ScoreMatrix *two,
+                                           short kmerThr, int kmerSize, bool spacedKmer, const std::string &spacedKmerPattern,
+                                           bool takeOnlyBestKmer, unsigned int maxSeqLen)
+        : indexTable(indexTable), blockOffsets(blockOffsets), blockCount(blockCount), blockSize(blockSize),
+          qdbr(qdbr), readerThread(readerThread), takeOnlyBestKmer(takeOnlyBestKmer),
+          seq(maxSeqLen, querySeqType, kmerSubMat, kmerSize, spacedKmer, false, true, spacedKmerPattern),
+          kmerGenerator(kmerSize, indexTable->getAlphabetSize(), kmerThr),
+          idx(indexTable->getAlphabetSize(), kmerSize),
+          marked(blockCount, false), queryFrom(0), queryTo(0), queriesDone(0), stopped(1) {
+    if (seq.profile_matrix != NULL) {
+        kmerGenerator.setDivideStrategy(seq.profile_matrix);
+    } else {
+        kmerGenerator.setDivideStrategy(three, two);
+    }
+}
+
+IndexTablePrefetcher::~IndexTablePrefetcher() {
+    stop();
+}
+
+void IndexTablePrefetcher::start(size_t from, size_t to) {
+    stop();
+    queryFrom = from;
+    queryTo = to;
+    queriesDone = 0;
+    stopped = 0;
+    loader = std::thread(&IndexTablePrefetcher::run, this);
+}
+
+void IndexTablePrefetcher::stop() {
+    __sync_lock_test_and_set(&stopped, 1);
+    if (loader.joinable()) {
+        loader.join();
+    }
+}
+
+void IndexTablePrefetcher::run() {
+    size_t next = queryFrom;
+    while (next < queryTo && __sync_fetch_and_add(&stopped, 0) == 0) {
+        // stay close to the prefilter, pages loaded too early are evicted before they are used
+        if (next - queryFrom >= __sync_fetch_and_add(&queriesDone, 0) + MAX_AHEAD) {
+            usleep(1000);
+            continue;
+        }
+        size_t batchEnd = std::min(next + BATCH_SIZE, queryTo);
+        for (size_t id = next; id < batchEnd; id++) {
+            markQuery(id);
+        }
+        adviseBlocks();
+        next = batchEnd;
+    }
+}
+
+void IndexTablePrefetcher::markQuery(size_t id) {
+    char *seqData = qdbr->getData(id, readerThread);
+    seq.mapSequence(id, qdbr->getDbKey(id), seqData, qdbr->getSeqLen(id));
+    while (seq.hasNextKmer()) {
+        const unsigned char *kmer = seq.nextKmer();
+        if (seq.kmerContainsX()) {
+            continue;
+        }
+        const size_t *index;
+        size_t exactKmer;
+        size_t kmerElementSize;
+        if (takeOnlyBestKmer) {
+            kmerElementSize = 1;
+            exactKmer = idx.int2index(kmer);
+            index = &exactKmer;
+        } else {
+            // without composition bias correction, the prefilter might hit a few more k-mers that fault in on demand
+            std::pair<size_t*, size_t> kmerList = kmerGenerator.generateKmerList(kmer);
+            kmerElementSize = kmerList.second;
+            index = kmerList.first;
+        }
+        for (size_t i = 0; i < kmerElementSize; i++) {
+            size_t block = index[i] / blockSize;
+            if (marked[block] == false) {
+                marked[block] = true;
+                blocks.push_back(block);
+            }
+        }
+    }
+}
+
+void IndexTablePrefetcher::adviseBlocks() {
+    std::sort(blocks.begin(), blocks.end());
+    const size_t pageSize = Util::getPageSize();
+    const char *entries = reinterpret_cast<const char *>(indexTable->getEntries());
+    const char *offsets = reinterpret_cast<const char *>(indexTable->getOffsets());
+    const size_t tableSize = indexTable->getTableSize();
+    for (size_t i = 0; i < blocks.size();) {
+        // merge consecutive blocks into a single request
+        size_t first = blocks[i];
+        size_t last = first;
+        while (i < blocks.size() && blocks[i] <= last + 1) {
+            last = blocks[i];
+            marked[last] = false;
+            i++;
+        }
+        size_t kmerFrom = first * blockSize;
+        size_t kmerTo = std::min((last + 1) * blockSize, tableSize);
+        const char *ranges[2][2] = {
+            { offsets + kmerFrom * sizeof(size_t), offsets + (kmerTo + 1) * sizeof(size_t) },
+            { entries + blockOffsets[first] * sizeof(IndexEntryLocal), entries + blockOffsets[last + 1] * sizeof(IndexEntryLocal) }
+        };
+        for (size_t j = 0; j < 2; j++) {
+            uintptr_t from = reinterpret_cast<uintptr_t>(ranges[j][0]) & ~(pageSize - 1);
+            uintptr_t to = reinterpret_cast<uintptr_t>(ranges[j][1]);
+            if (to <= from) {
+                continue;
+            }
+#ifdef HAVE_POSIX_MADVISE
+            if (posix_madvise(reinterpret_cast<void *>(from), to - from, POSIX_MADV_WILLNEED) != 0) {
+                Debug(Debug::ERROR) << "posix_madvise returned an error (IndexTablePrefetcher)\n";
+            }
+#endif
+        }
+    }
+    blocks.clear();
+}
@@ -0,0 +1,68 @@
+#ifndef MMSEQS_INDEXTABLEPREFETCHER_H
+#define MMSEQS_INDEXTABLEPREFETCHER_H
+
+// Loads the parts of a memory mapped index table that the next queries will hit.
+// A loader thread runs ahead of the prefilter loop, generates the similar k-mers of a batch of queries
+// and advises the kernel to read the k-mer blocks they fall into, in ascending k-mer order.
+// This keeps the search usable if the index does not fit into the page cache.
+#include "IndexTable.h"
+#include "DBReader.h"
+#include "KmerGenerator.h"
+#include "Indexer.h"
+#include "Sequence.h"
+
+#include <thread>
+#include <vector>
+
+class IndexTablePrefetcher {
+public:
+    // number of queries a batch is planned for and how far the loader may run ahead of the prefilter
+    static const size_t BATCH_SIZE = 64;
+    static const size_t MAX_AHEAD = 4 * BATCH_SIZE;
+
+    // blockOffsets has blockCount + 1 entry offsets, block b covers the k-mers [b * blockSize, (b + 1) * blockSize)
+    IndexTablePrefetcher(IndexTable *indexTable, const size_t *blockOffsets, size_t blockCount, size_t blockSize,
+                         DBReader<unsigned int> *qdbr, unsigned int readerThread, int querySeqType,
+                         BaseMatrix *kmerSubMat, ScoreMatrix *three, ScoreMatrix *two,
+                         short kmerThr, int kmerSize, bool spacedKmer, const std::string &spacedKmerPattern,
+                         bool takeOnlyBestKmer, unsigned int maxSeqLen);
+    ~IndexTablePrefetcher();
+
+    // starts loading for the queries [queryFrom, queryTo)
+    void start(size_t queryFrom, size_t queryTo);
+
+    // called by the prefilter threads once per finished query
+    void queryDone() {
+        __sync_fetch_and_add(&queriesDone, 1);
+    }
+
+    void stop();
+
+private:
+    IndexTable *indexTable;
+    const size_t *blockOffsets;
+    size_t blockCount;
+    size_t blockSize;
+    DBReader<unsigned int> *qdbr;
+    unsigned int readerThread;
+    bool takeOnlyBestKmer;
+
+    Sequence seq;
+    KmerGenerator kmerGenerator;
+    Indexer idx;
+
+    std::vector<bool> marked;
+    std::vector<size_t> blocks;
+
+    std::thread loader;
+    size_t queryFrom;
+    size_t queryTo;
+    size_t queriesDone;
+    int stopped;
+
+    void run();
+    void markQuery(size_t id);
+    void adviseBlocks();
+};
+
+#endif
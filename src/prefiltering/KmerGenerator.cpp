@@ -1,16 +1,25 @@
 #include "KmerGenerator.h"
+#include "KmerListCache.h"
+#include "ProfileReport.h"
 #include <algorithm>    // std::reverse
 
 KmerGenerator::KmerGenerator(size_t kmerSize, size_t alphabetSize, short threshold ){
     this->threshold = threshold;
     this->kmerSize = kmerSize;
     this->indexer = new Indexer((int) alphabetSize, (int)kmerSize);
+    this->cache = NULL;
+    this->fixedMatrix = false;
 //    calcDivideStrategy();
 }
 
 void KmerGenerator::setThreshold(short threshold){
     this->threshold = threshold;
 }
+
+void KmerGenerator::setCacheSize(size_t maxBytes){
+    delete cache;
+    cache = (maxBytes > 0) ? new KmerListCache(maxBytes) : NULL;
+}
 KmerGenerator::~KmerGenerator(){
     delete [] this->stepMultiplicator;
     delete [] this->highestScorePerArray;
@@ -25,9 +34,12 @@ KmerGenerator::~KmerGenerator(){
     delete [] outputScoreArray;
     delete [] outputIndexArray;
     delete indexer;
+    delete cache;
 }
 
 void KmerGenerator::setDivideStrategy(ScoreMatrix ** one){
+    // profile matrices are overwritten for every query
+    this->fixedMatrix = false;
     this->divideStepCount = kmerSize;
     this->matrixLookup = new ScoreMatrix*[divideStepCount];
     this->divideStep   = new unsigned int[divideStepCount];
@@ -39,6 +51,10 @@ void KmerGenerator::setDivideStrategy(ScoreMatrix ** one){
 }
 
 void KmerGenerator::setDivideStrategy(ScoreMatrix * three, ScoreMatrix * two){
+    this->fixedMatrix = true;
+    if (cache != NULL) {
+        cache->clear();
+    }
     const size_t threeDivideCount = this->kmerSize / 3;
 
     switch(kmerSize%3){
@@ -105,6 +121,23 @@ void KmerGenerator::initDataStructure(){
 
 
 std::pair<size_t *, size_t> KmerGenerator::generateKmerList(const unsigned char * int_seq, bool addIdentity){
+    if (cache == NULL || fixedMatrix == false || addIdentity) {
+        return computeKmerList(int_seq, addIdentity);
+    }
+    const size_t kmer = this->indexer->int2index(int_seq, 0, static_cast<int>(kmerSize));
+    std::pair<size_t *, size_t> list;
+    if (cache->get(kmer, threshold, list)) {
+        ProfileReport::add(ProfileReport::KMER_CACHE_HITS, 1);
+        ProfileReport::add(ProfileReport::KMERS_GENERATED, list.second);
+        return list;
+    }
+    ProfileReport::add(ProfileReport::KMER_CACHE_MISSES, 1);
+    list = computeKmerList(int_seq, false);
+    cache->put(kmer, threshold, list.first, list.second);
+    return list;
+}
+
+std::pair<size_t *, size_t> KmerGenerator::computeKmerList(const unsigned char * int_seq, bool addIdentity){
     int dividerBefore=0;
     // pre compute phase
     // find first threshold
@@ -177,8 +210,10 @@ std::pair<size_t *, size_t> KmerGenerator::generateKmerList(const unsigned char
             outputIndexArray[0][0] += static_cast<size_t>(nextIndexArray[0]) * stepMultiplicator[z];
         }
 
+        ProfileReport::add(ProfileReport::KMERS_GENERATED, 1);
         return std::make_pair(outputIndexArray[0], 1);
     }
+    ProfileReport::add(ProfileReport::KMERS_GENERATED, sizeInputMatrix);
     return std::make_pair(outputIndexArray[(i-1)%2], sizeInputMatrix);
 }
 
@@ -6,6 +6,8 @@
 #include "ScoreMatrix.h"
 #include "Debug.h"
 
+class KmerListCache;
+
 
 class KmerGenerator 
 {
@@ -24,7 +26,15 @@ class KmerGenerator
         void setDivideStrategy(ScoreMatrix ** one);
 
 	    void setThreshold(short threshold);
+
+        /* caches the lists of up to maxBytes, only used with the fixed (3,2) strategy */
+        void setCacheSize(size_t maxBytes);
+
+        const KmerListCache * getCache() const {
+            return cache;
+        }
     private:
+        std::pair<size_t *, size_t> computeKmerList(const unsigned char * intSeq, bool addIdentity);
     
         /*creates the product between two arrays and write it to the output array */
         size_t calculateArrayProduct(const short        * __restrict scoreArray1,
@@ -59,6 +69,10 @@ class KmerGenerator
         ScoreMatrix  ** matrixLookup;
         short        ** outputScoreArray;
         size_t       ** outputIndexArray;
+        /* lists of recently seen k-mers */
+        KmerListCache * cache;
+        /* the score matrices do not change between queries */
+        bool fixedMatrix;
 
 
         /* init the output vectors for the kmer calculation*/
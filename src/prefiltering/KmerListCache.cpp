@@ -0,0 +1,45 @@
+#include "KmerListCache.h"
+
+KmerListCache::KmerListCache(size_t maxBytes) : maxBytes(maxBytes), usedBytes(0), hits(0), misses(0) {}
+
+bool KmerListCache::get(size_t kmerIndex, short threshold, std::pair<size_t *, size_t> &list) {
+    std::unordered_map<size_t, std::list<Entry>::iterator>::iterator it = lookup.find(makeKey(kmerIndex, threshold));
+    if (it == lookup.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    std::vector<size_t> &kmers = it->second->kmers;
+    list = std::make_pair(kmers.data(), kmers.size());
+    return true;
+}
+
+void KmerListCache::put(size_t kmerIndex, short threshold, const size_t *kmers, size_t size) {
+    const size_t bytes = size * sizeof(size_t) + ENTRY_OVERHEAD;
+    // a single huge list would flush most of the cache
+    if (bytes > maxBytes / 8) {
+        return;
+    }
+    const size_t key = makeKey(kmerIndex, threshold);
+    if (lookup.find(key) != lookup.end()) {
+        return;
+    }
+    while (usedBytes + bytes > maxBytes && entries.empty() == false) {
+        Entry &last = entries.back();
+        usedBytes -= last.kmers.size() * sizeof(size_t) + ENTRY_OVERHEAD;
+        lookup.erase(last.key);
+        entries.pop_back();
+    }
+    entries.push_front(Entry());
+    entries.front().key = key;
+    entries.front().kmers.assign(kmers, kmers + size);
+    lookup[key] = entries.begin();
+    usedBytes += bytes;
+}
+
+void KmerListCache::clear() {
+    entries.clear();
+    lookup.clear();
+    usedBytes = 0;
+}
@@ -0,0 +1,56 @@
+#ifndef MMSEQS_KMERLISTCACHE_H
+#define MMSEQS_KMERLISTCACHE_H
+
+// LRU cache of similar k-mer lists generated with a fixed substitution matrix.
+// A list is identified by the index of the query k-mer and the score threshold it was generated with.
+// Every prefilter thread owns its own KmerGenerator, so the cache is not shared and needs no locking.
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class KmerListCache {
+public:
+    KmerListCache(size_t maxBytes);
+
+    // sets list to the cached k-mers and marks them as recently used, returns false if they are not cached
+    bool get(size_t kmerIndex, short threshold, std::pair<size_t *, size_t> &list);
+
+    // keeps a copy of the list, evicts the least recently used lists to stay within the memory limit
+    void put(size_t kmerIndex, short threshold, const size_t *kmers, size_t size);
+
+    void clear();
+
+    size_t getHits() const {
+        return hits;
+    }
+
+    size_t getMisses() const {
+        return misses;
+    }
+
+private:
+    struct Entry {
+        size_t key;
+        std::vector<size_t> kmers;
+    };
+
+    // approximate bookkeeping cost of an entry (list node, hash node and vector)
+    const static size_t ENTRY_OVERHEAD = 96;
+
+    // k-mer indices stay below alphabetSize^kmerSize, which leaves the lowest 16 bits for the threshold
+    static size_t makeKey(size_t kmerIndex, short threshold) {
+        return (kmerIndex << 16) | static_cast<unsigned short>(threshold);
+    }
+
+    size_t maxBytes;
+    size_t usedBytes;
+    size_t hits;
+    size_t misses;
+    // most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<size_t, std::list<Entry>::iterator> lookup;
+};
+
+#endif
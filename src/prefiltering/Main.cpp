@@ -1,4 +1,5 @@
 #include "Prefiltering.h"
+#include "Alignment.h"
 #include "Util.h"
 #include "Parameters.h"
 #include "MMseqsMPI.h"
@@ -10,15 +11,10 @@
 #include <omp.h>
 #endif
 
-int prefilter(int argc, const char **argv, const Command& command) {
-    MMseqsMPI::init(argc, argv);
-
-    Parameters& par = Parameters::getInstance();
-    par.parseParameters(argc, argv, command, true, 0, MMseqsParameter::COMMAND_PREFILTER);
-
-    Timer timer;
-    int queryDbType = FileUtil::parseDbType(par.db1.c_str());
-    int targetDbType = FileUtil::parseDbType(par.db2.c_str());
+// resolves the sequence types of the query and target database, returns false if they cannot be searched against each other
+static bool getSearchDbTypes(Parameters &par, int &queryDbType, int &targetDbType) {
+    queryDbType = FileUtil::parseDbType(par.db1.c_str());
+    targetDbType = FileUtil::parseDbType(par.db2.c_str());
     if(Parameters::isEqualDbtype(targetDbType, Parameters::DBTYPE_INDEX_DB) == true) {
         DBReader<unsigned int> dbr(par.db2.c_str(), par.db2Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
         dbr.open(DBReader<unsigned int>::NOSORT);
@@ -28,19 +24,34 @@ int prefilter(int argc, const char **argv, const Command& command) {
     }
     if (queryDbType == -1 || targetDbType == -1) {
         Debug(Debug::ERROR) << "Please recreate your database or add a .dbtype file to your sequence/profile database.\n";
-        return EXIT_FAILURE;
+        return false;
     }
     if (Parameters::isEqualDbtype(queryDbType, Parameters::DBTYPE_HMM_PROFILE) && Parameters::isEqualDbtype(targetDbType, Parameters::DBTYPE_HMM_PROFILE)) {
         Debug(Debug::ERROR) << "Only the query OR the target database can be a profile database.\n";
-        return EXIT_FAILURE;
+        return false;
     }
 
     if (Parameters::isEqualDbtype(queryDbType, Parameters::DBTYPE_AMINO_ACIDS) && Parameters::isEqualDbtype(targetDbType, Parameters::DBTYPE_NUCLEOTIDES)) {
         Debug(Debug::ERROR) << "The prefilter can not search amino acids against nucleotides. Something might got wrong while createdb or createindex.\n";
-        return EXIT_FAILURE;
+        return false;
     }
     if (Parameters::isEqualDbtype(queryDbType, Parameters::DBTYPE_NUCLEOTIDES) && Parameters::isEqualDbtype(targetDbType, Parameters::DBTYPE_AMINO_ACIDS)) {
         Debug(Debug::ERROR) << "The prefilter can not search nucleotides against amino acids. Something might got wrong while createdb or createindex.\n";
+        return false;
+    }
+    return true;
+}
+
+int prefilter(int argc, const char **argv, const Command& command) {
+    MMseqsMPI::init(argc, argv);
+
+    Parameters& par = Parameters::getInstance();
+    par.parseParameters(argc, argv, command, true, 0, MMseqsParameter::COMMAND_PREFILTER);
+
+    Timer timer;
+    int queryDbType;
+    int targetDbType;
+    if (getSearchDbTypes(par, queryDbType, targetDbType) == false) {
         return EXIT_FAILURE;
     }
 
@@ -60,3 +71,21 @@ int prefilter(int argc, const char **argv, const Command& command) {
 
     return EXIT_SUCCESS;
 }
+
+int prefilteralign(int argc, const char **argv, const Command& command) {
+    Parameters& par = Parameters::getInstance();
+    par.parseParameters(argc, argv, command, true, 0, MMseqsParameter::COMMAND_PREFILTER | MMseqsParameter::COMMAND_ALIGN);
+
+    int queryDbType;
+    int targetDbType;
+    if (getSearchDbTypes(par, queryDbType, targetDbType) == false) {
+        return EXIT_FAILURE;
+    }
+
+    // the aligner opens the query and target databases (or the target index) itself, hits never reach the disk
+    Alignment aln(par.db1, par.db2, "", "", par.db3, par.db3Index, par, false);
+    Prefiltering pref(par.db1, par.db1Index, par.db2, par.db2Index, queryDbType, targetDbType, par);
+    pref.runAllSplitsAligned(aln, par.db3, par.db3Index);
+
+    return EXIT_SUCCESS;
+}
@@ -1,14 +1,19 @@
 #include "Prefiltering.h"
+#include "Alignment.h"
 #include "NucleotideMatrix.h"
 #include "ReducedMatrix.h"
 #include "ExtendedSubstitutionMatrix.h"
 #include "SubstitutionMatrixProfileStates.h"
 #include "DBWriter.h"
+#include "IndexTablePrefetcher.h"
+#include "KmerListCache.h"
 
 #include "PatternCompiler.h"
 #include "FileUtil.h"
 #include "IndexBuilder.h"
 #include "Timer.h"
+#include "ProfileReport.h"
+#include "LargeMemory.h"
 #include "ByteParser.h"
 #include "Parameters.h"
 #include "MemoryMapped.h"
@@ -49,10 +54,25 @@ Prefiltering::Prefiltering(const std::string &queryDB,
         minDiagScoreThr(static_cast<unsigned int>(par.minDiagScoreThr)),
         aaBiasCorrection(par.compBiasCorrection != 0),
         aaBiasCorrectionScale(par.compBiasCorrectionScale),
+        queryBatchSize(static_cast<size_t>(par.queryBatchSize)),
+        kmerCacheSize(par.kmerCacheSize),
+        packSequenceLookup(par.packSequenceLookup),
         covThr(par.covThr), covMode(par.covMode), includeIdentical(par.includeIdentity),
         preloadMode(par.preloadMode),
-        threads(static_cast<unsigned int>(par.threads)), compressed(par.compressed) {
+        prefetchIndex(false),
+        threads(static_cast<unsigned int>(par.threads)), compressed(par.compressed), binaryResult(par.binaryResult),
+        asyncWrite(par.asyncWrite), aligner(NULL), alignmentsNum(0), alignmentsPassedNum(0) {
     sameQTDB = isSameQTDB();
+    LargeMemory::init(par.hugePages, par.numaMode);
+    resultDbtype = Parameters::DBTYPE_PREFILTER_RES;
+    if (binaryResult) {
+        resultDbtype = DBReader<unsigned int>::setExtendedDbtype(resultDbtype, Parameters::DBTYPE_EXTENDED_BINARY_RESULT);
+        // binary hit counts are derived from the entry length in the index
+        if (compressed) {
+            Debug(Debug::ERROR) << "--binary-result cannot be combined with --compressed.\n";
+            EXIT(EXIT_FAILURE);
+        }
+    }
 
     // init the substitution matrices
     switch (querySeqType & Parameters::DBTYPE_MASK) {
@@ -78,16 +98,20 @@ Prefiltering::Prefiltering(const std::string &queryDB,
     }
 
     if (Parameters::isEqualDbtype(FileUtil::parseDbType(targetDB.c_str()), Parameters::DBTYPE_INDEX_DB)) {
+        tidxdbr = new DBReader<unsigned int>(targetDB.c_str(), targetDBIndex.c_str(), threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
+        tidxdbr->open(DBReader<unsigned int>::NOSORT);
+
         if (preloadMode == Parameters::PRELOAD_MODE_AUTO) {
-            if (sensitivity > 6.0) {
+            if (tidxdbr->getTotalDataSize() > Util::getTotalSystemMemory()) {
+                // reading or touching an index larger than the main memory would thrash the page cache
+                preloadMode = Parameters::PRELOAD_MODE_MMAP;
+            } else if (sensitivity > 6.0) {
                 preloadMode = Parameters::PRELOAD_MODE_FREAD;
             } else {
                 preloadMode = Parameters::PRELOAD_MODE_MMAP_TOUCH;
             }
         }
-
-        tidxdbr = new DBReader<unsigned int>(targetDB.c_str(), targetDBIndex.c_str(), threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
-        tidxdbr->open(DBReader<unsigned int>::NOSORT);
+        prefetchIndex = preloadMode == Parameters::PRELOAD_MODE_MMAP;
 
         templateDBIsIndex = PrefilteringIndexReader::checkIfIndexFile(tidxdbr);
         if (templateDBIsIndex == true) {
@@ -180,7 +204,8 @@ Prefiltering::Prefiltering(const std::string &queryDB,
     if (templateDBIsIndex == false && sameQTDB == true) {
         qdbr = tdbr;
     } else {
-        qdbr = new DBReader<unsigned int>(queryDB.c_str(), queryDBIndex.c_str(), threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
+        // the index prefetcher reads queries with its own thread index
+        qdbr = new DBReader<unsigned int>(queryDB.c_str(), queryDBIndex.c_str(), prefetchIndex ? threads + 1 : threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
         qdbr->open(DBReader<unsigned int>::LINEAR_ACCCESS);
     }
     Debug(Debug::INFO) << "Query database size: " << qdbr->getSize() << " type: " << Parameters::getDbTypeName(querySeqType) << "\n";
@@ -372,9 +397,20 @@ void Prefiltering::mergeTargetSplits(const std::string &outDB, const std::string
 
     Timer timer;
     Debug(Debug::INFO) << "Merging " << splits << " target splits to " << FileUtil::baseName(outDB) << "\n";
+    const int dbtype = FileUtil::parseDbType(fileNames[0].first.c_str());
+    // binary entries may contain null bytes, their boundaries have to be taken from the split indices
+    const bool isBinary = DBReader<unsigned int>::isBinaryResult(dbtype);
+    std::vector<DBReader<unsigned int>*> splitReaders;
     DBReader<unsigned int> reader1(fileNames[0].first.c_str(), fileNames[0].second.c_str(), 1, DBReader<unsigned int>::USE_INDEX);
     reader1.open(DBReader<unsigned int>::NOSORT);
     DBReader<unsigned int>::Index *index1 = reader1.getIndex();
+    if (isBinary) {
+        for (size_t i = 0; i < splits; ++i) {
+            DBReader<unsigned int> *splitReader = new DBReader<unsigned int>(fileNames[i].first.c_str(), fileNames[i].second.c_str(), 1, DBReader<unsigned int>::USE_INDEX);
+            splitReader->open(DBReader<unsigned int>::NOSORT);
+            splitReaders.push_back(splitReader);
+        }
+    }
 
     size_t totalSize = 0;
     for (size_t id = 0; id < reader1.getSize(); id++) {
@@ -414,7 +450,7 @@ void Prefiltering::mergeTargetSplits(const std::string &outDB, const std::string
     Debug(Debug::INFO) << "Preparing offsets for merging: " << timer.lap() << "\n";
     // merge target splits data files and sort the hits at the same time
     // TODO: compressed?
-    DBWriter writer(outDB.c_str(), outDBIndex.c_str(), threads, 0, Parameters::DBTYPE_PREFILTER_RES);
+    DBWriter writer(outDB.c_str(), outDBIndex.c_str(), threads, 0, DBReader<unsigned int>::setExtendedDbtype(Parameters::DBTYPE_PREFILTER_RES, DBReader<unsigned int>::getExtendedDbtype(dbtype)));
     writer.open();
 
     Debug::Progress progress(reader1.getSize());
@@ -435,7 +471,11 @@ void Prefiltering::mergeTargetSplits(const std::string &outDB, const std::string
         size_t prevId = 0;
         while(currentId < reader1.getSize()){
             progress.updateProgress();
-            for(size_t file = 0; file < splits; file++){
+            for(size_t file = 0; file < splits && isBinary; file++){
+                DBReader<unsigned int>::Index *entry = splitReaders[file]->getIndex(currentId);
+                QueryMatcher::parsePrefilterHitsBinary(&dataFile[file][entry->offset], entry->length, hits);
+            }
+            for(size_t file = 0; file < splits && isBinary == false; file++){
                 size_t tmpId = prevId;
                 size_t pos;
                 for(pos = currentDataFileOffset[file]; pos < dataFileSize[file] && tmpId != currentId; pos++){
@@ -449,7 +489,12 @@ void Prefiltering::mergeTargetSplits(const std::string &outDB, const std::string
                 SORT_SERIAL(hits.begin(), hits.end(), hit_t::compareHitsByScoreAndId);
             }
             for (size_t i = 0; i < hits.size(); ++i) {
-                int len = QueryMatcher::prefilterHitToBuffer(buffer, hits[i]);
+                int len;
+                if (isBinary) {
+                    len = QueryMatcher::prefilterHitToBinary(buffer, hits[i]);
+                } else {
+                    len = QueryMatcher::prefilterHitToBuffer(buffer, hits[i]);
+                }
                 result.append(buffer, len);
             }
             writer.writeData(result.c_str(), result.size(), reader1.getDbKey(currentId), thread_idx);
@@ -463,6 +508,10 @@ void Prefiltering::mergeTargetSplits(const std::string &outDB, const std::string
     }
     writer.close();
     reader1.close();
+    for (size_t i = 0; i < splitReaders.size(); ++i) {
+        splitReaders[i]->close();
+        delete splitReaders[i];
+    }
 
     for (size_t i = 0; i < splits; ++i) {
         DBReader<unsigned int>::removeDb(fileNames[i].first);
@@ -504,6 +553,7 @@ void Prefiltering::getIndexTable(int split, size_t dbFrom, size_t dbSize) {
         }
     } else {
         Timer timer;
+        ProfileReport::Phase phase("index table");
 
         Sequence tseq(maxSeqLen, targetSeqType, kmerSubMat, kmerSize, spacedKmer, aaBiasCorrection, true, spacedKmerPattern);
         int localKmerThr = (Parameters::isEqualDbtype(querySeqType, Parameters::DBTYPE_HMM_PROFILE) ||
@@ -532,6 +582,14 @@ void Prefiltering::getIndexTable(int split, size_t dbFrom, size_t dbSize) {
         tdbr->remapData();
         Debug(Debug::INFO) << "Time for index table init: " << timer.lap() << "\n";
     }
+
+    if (packSequenceLookup && sequenceLookup != NULL) {
+        if (sequenceLookup->pack()) {
+            Debug(Debug::INFO) << "Sequence lookup packed to " << sequenceLookup->getBitsPerResidue() << " bits per residue\n";
+        } else {
+            Debug(Debug::WARNING) << "Sequence lookup contains residues that do not fit into 5 bits, it is kept unpacked\n";
+        }
+    }
 }
 
 bool Prefiltering::isSameQTDB() {
@@ -553,6 +611,26 @@ void Prefiltering::runAllSplits(const std::string &resultDB, const std::string &
     runSplits(resultDB, resultDBIndex, 0, splits, false);
 }
 
+void Prefiltering::runAllSplitsAligned(Alignment &aln, const std::string &resultDB, const std::string &resultDBIndex) {
+    // target splits only see part of the hits of a query, these would have to be merged before aligning
+    if (splitMode == Parameters::TARGET_DB_SPLIT && splits > 1) {
+        Debug(Debug::ERROR) << "Prefiltering and aligning in one step needs the whole target database in memory, but " << splits << " target splits are required.\n"
+                            << "Run prefilter and align separately.\n";
+        EXIT(EXIT_FAILURE);
+    }
+
+    aligner = &aln;
+    alignmentsNum = 0;
+    alignmentsPassedNum = 0;
+    const int prefilterDbtype = resultDbtype;
+    resultDbtype = aln.getOutputDbtype();
+    runSplits(resultDB, resultDBIndex, 0, splits, false);
+    resultDbtype = prefilterDbtype;
+    aligner = NULL;
+
+    Alignment::printSummary(alignmentsNum, alignmentsPassedNum, qdbr->getSize());
+}
+
 #ifdef HAVE_MPI
 void Prefiltering::runMpiSplits(const std::string &resultDB, const std::string &resultDBIndex, const std::string &localTmpPath, const int runRandomId) {
     if(compressed == true && splitMode == Parameters::TARGET_DB_SPLIT){
@@ -631,7 +709,7 @@ void Prefiltering::runMpiSplits(const std::string &resultDB, const std::string &
             // merge output databases
             mergePrefilterSplits(resultDB, resultDBIndex, splitFiles);
         } else {
-            DBWriter writer(resultDB.c_str(), resultDBIndex.c_str(), 1, compressed, Parameters::DBTYPE_PREFILTER_RES);
+            DBWriter writer(resultDB.c_str(), resultDBIndex.c_str(), 1, compressed, resultDbtype);
             writer.open();
             writer.close();
         }
@@ -650,7 +728,7 @@ int Prefiltering::runSplits(const std::string &resultDB, const std::string &resu
 
     size_t freeSpace = FileUtil::getFreeSpace(FileUtil::dirName(resultDB).c_str());
     size_t estimatedHDDMemory = estimateHDDMemoryConsumption(qdbr->getSize(), maxResListLen);
-    if (freeSpace < estimatedHDDMemory) {
+    if (aligner == NULL && freeSpace < estimatedHDDMemory) {
         std::string freeSpaceToPrint = ByteParser::format(freeSpace);
         std::string estimatedHDDMemoryToPrint = ByteParser::format(estimatedHDDMemory);
         Debug(Debug::WARNING) << "Hard disk might not have enough free space (" << freeSpaceToPrint << " left)."
@@ -680,7 +758,7 @@ int Prefiltering::runSplits(const std::string &resultDB, const std::string &resu
                 resultReader.open(DBReader<unsigned int>::NOSORT);
                 resultReader.readMmapedDataInMemory();
                 const std::pair<std::string, std::string> tempDb = Util::databaseNames(resultDB + "_tmp");
-                DBWriter resultWriter(tempDb.first.c_str(), tempDb.second.c_str(), threads, compressed, Parameters::DBTYPE_PREFILTER_RES);
+                DBWriter resultWriter(tempDb.first.c_str(), tempDb.second.c_str(), threads, compressed, resultDbtype);
                 resultWriter.open();
                 resultWriter.sortDatafileByIdOrder(resultReader);
                 resultWriter.close(true);
@@ -695,7 +773,7 @@ int Prefiltering::runSplits(const std::string &resultDB, const std::string &resu
             hasResult = true;
         }
     } else if (splitProcessCount == 0) {
-        DBWriter writer(resultDB.c_str(), resultDBIndex.c_str(), 1, compressed, Parameters::DBTYPE_PREFILTER_RES);
+        DBWriter writer(resultDB.c_str(), resultDBIndex.c_str(), 1, compressed, resultDbtype);
         writer.open();
         writer.close();
         hasResult = false;
@@ -706,6 +784,7 @@ int Prefiltering::runSplits(const std::string &resultDB, const std::string &resu
 
 bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resultDBIndex, size_t split, bool merge) {
     Debug(Debug::INFO) << "Process prefiltering step " << (split + 1) << " of " << splits << "\n\n";
+    ProfileReport::Phase phase("prefilter split");
 
     size_t dbFrom = 0;
     size_t dbSize = tdbr->getSize();
@@ -748,13 +827,17 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
     size_t diagonalOverflow = 0;
     size_t trancatedCounter = 0;
     size_t totalQueryDBSize = querySize;
+    size_t splitAlignmentsNum = 0;
+    size_t splitPassedNum = 0;
+    size_t kmerCacheHits = 0;
+    size_t kmerCacheMisses = 0;
 
     size_t localThreads = 1;
 #ifdef OPENMP
     localThreads = std::max(std::min((size_t)threads, querySize), (size_t)1);
 #endif
 
-    DBWriter tmpDbw(resultDB.c_str(), resultDBIndex.c_str(), localThreads, compressed, Parameters::DBTYPE_PREFILTER_RES);
+    DBWriter tmpDbw(resultDB.c_str(), resultDBIndex.c_str(), localThreads, compressed | (asyncWrite ? Parameters::WRITER_ASYNC_MODE : 0), resultDbtype);
     tmpDbw.open();
 
     // init all thread-specific data structures
@@ -771,14 +854,49 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
     Debug(Debug::INFO) << "Target db start " << (dbFrom + 1) << " to " << dbFrom + dbSize << "\n";
     Debug::Progress progress(querySize);
 
+    IndexTablePrefetcher *prefetcher = NULL;
+    if (prefetchIndex && templateDBIsIndex) {
+        size_t blockSize = 0;
+        size_t blockCount = 0;
+        size_t *blocks = PrefilteringIndexReader::getKmerBlocks(splitMode == Parameters::TARGET_DB_SPLIT ? split : 0, tidxdbr, &blockSize, &blockCount);
+        if (blocks != NULL) {
+            prefetcher = new IndexTablePrefetcher(indexTable, blocks, blockCount, blockSize, qdbr, threads, querySeqType, kmerSubMat,
+                                                  _3merSubMatrix.isValid() ? &_3merSubMatrix : NULL, _2merSubMatrix.isValid() ? &_2merSubMatrix : NULL,
+                                                  kmerThr, kmerSize, spacedKmer, spacedKmerPattern, takeOnlyBestKmer, qdbr->getMaxSeqLen());
+            prefetcher->start(queryFrom, queryFrom + querySize);
+        } else {
+            Debug(Debug::INFO) << "Index has no k-mer blocks, recreate it with createindex to prefetch them\n";
+        }
+    }
+
+    // every thread works on the copy of the index table on its NUMA node
+    std::vector<IndexTable *> replicas;
+    if (LargeMemory::getNumaMode() == LargeMemory::NUMA_REPLICATE && LargeMemory::getNodeCount() > 1) {
+        Debug(Debug::INFO) << "Copy index table to " << LargeMemory::getNodeCount() << " NUMA nodes\n";
+        for (size_t node = 0; node < LargeMemory::getNodeCount(); node++) {
+            replicas.push_back(indexTable->replicate(static_cast<int>(node)));
+        }
+    }
+
 #pragma omp parallel num_threads(localThreads)
     {
         unsigned int thread_idx = 0;
 #ifdef OPENMP
         thread_idx = static_cast<unsigned int>(omp_get_thread_num());
 #endif
+        IndexTable *threadIndexTable = indexTable;
+        std::vector<int> previousCpus;
+        bool pinned = false;
+        if (replicas.empty() == false) {
+            const size_t node = thread_idx % replicas.size();
+            pinned = LargeMemory::pinThread(node, previousCpus);
+            if (pinned == false && thread_idx == 0) {
+                Debug(Debug::WARNING) << "Could not pin threads to NUMA nodes\n";
+            }
+            threadIndexTable = replicas[node];
+        }
         Sequence seq(qdbr->getMaxSeqLen(), querySeqType, kmerSubMat, kmerSize, spacedKmer, aaBiasCorrection, true, spacedKmerPattern);
-        QueryMatcher matcher(indexTable, sequenceLookup, kmerSubMat,  ungappedSubMat,
+        QueryMatcher matcher(threadIndexTable, sequenceLookup, kmerSubMat,  ungappedSubMat,
                              kmerThr, kmerSize, dbSize, std::max(tdbr->getMaxSeqLen(),qdbr->getMaxSeqLen()), maxResListLen, aaBiasCorrection, aaBiasCorrectionScale,
                              diagonalScoring, minDiagScoreThr, takeOnlyBestKmer, targetSeqType==Parameters::DBTYPE_NUCLEOTIDES);
 
@@ -786,17 +904,36 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
             matcher.setProfileMatrix(seq.profile_matrix);
         } else if (_3merSubMatrix.isValid() && _2merSubMatrix.isValid()) {
             matcher.setSubstitutionMatrix(&_3merSubMatrix, &_2merSubMatrix);
+            if (kmerCacheSize > 0 && takeOnlyBestKmer == false) {
+                matcher.setKmerCacheSize(kmerCacheSize / localThreads);
+            }
         } else {
             matcher.setSubstitutionMatrix(NULL, NULL);
         }
 
+        Alignment::QueryAligner *queryAligner = NULL;
+        if (aligner != NULL) {
+            queryAligner = new Alignment::QueryAligner(*aligner);
+        }
+
         char buffer[128];
         std::string result;
         result.reserve(1000000);
 
-#pragma omp for schedule(dynamic, 2) reduction (+: kmersPerPos, resSize, dbMatches, doubleMatches, querySeqLenSum, diagonalOverflow, trancatedCounter)
+        // a thread processes consecutive queries of a batch
+        const size_t chunkSize = (queryBatchSize > 1) ? queryBatchSize : 2;
+#pragma omp for schedule(dynamic, chunkSize) reduction (+: kmersPerPos, resSize, dbMatches, doubleMatches, querySeqLenSum, diagonalOverflow, trancatedCounter, splitAlignmentsNum, splitPassedNum)
         for (size_t id = queryFrom; id < queryFrom + querySize; id++) {
             progress.updateProgress();
+            if (queryBatchSize > 1 && matcher.isBatched(id) == false) {
+                const size_t batchEnd = std::min(id - (id - queryFrom) % queryBatchSize + queryBatchSize, queryFrom + querySize);
+                matcher.clearBatch();
+                for (size_t batchId = id; batchId < batchEnd && matcher.isBatchFull() == false; batchId++) {
+                    seq.mapSequence(batchId, qdbr->getDbKey(batchId), qdbr->getData(batchId, thread_idx), qdbr->getSeqLen(batchId));
+                    matcher.addToBatch(&seq);
+                }
+                matcher.sweepBatch();
+            }
             // get query sequence
             char *seqData = qdbr->getData(id, thread_idx);
             unsigned int qKey = qdbr->getDbKey(id);
@@ -819,6 +956,7 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
             std::pair<hit_t *, size_t> prefResults = matcher.matchQuery(&seq, targetSeqId, targetSeqType==Parameters::DBTYPE_NUCLEOTIDES);
             size_t resultSize = prefResults.second;
             const float queryLength = static_cast<float>(qdbr->getSeqLen(id));
+            size_t keptHits = 0;
             for (size_t i = 0; i < resultSize; i++) {
                 hit_t *res = prefResults.first + i;
                 // correct the 0 indexed sequence id again to its real identifier
@@ -839,10 +977,24 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
                     }
                 }
 
+                if (queryAligner != NULL) {
+                    // compact the remaining hits in place, they are aligned below
+                    prefResults.first[keptHits++] = *res;
+                    continue;
+                }
+
                 // write prefiltering results to a string
-                int len = QueryMatcher::prefilterHitToBuffer(buffer, *res);
+                int len;
+                if (binaryResult) {
+                    len = QueryMatcher::prefilterHitToBinary(buffer, *res);
+                } else {
+                    len = QueryMatcher::prefilterHitToBuffer(buffer, *res);
+                }
                 result.append(buffer, len);
             }
+            if (queryAligner != NULL) {
+                queryAligner->align(qKey, prefResults.first, keptHits, result, thread_idx, splitAlignmentsNum, splitPassedNum);
+            }
             tmpDbw.writeData(result.c_str(), result.length(), qKey, thread_idx);
             result.clear();
 
@@ -851,7 +1003,7 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
                 notEmpty[id - queryFrom] = 1;
             }
 
-            if (Debug::debugLevel >= Debug::INFO) {
+            if (Debug::debugLevel >= Debug::INFO || ProfileReport::isEnabled()) {
                 kmersPerPos += matcher.getStatistics()->kmersPerPos;
                 dbMatches += matcher.getStatistics()->dbMatches;
                 doubleMatches += matcher.getStatistics()->doubleMatches;
@@ -862,8 +1014,36 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
                 realResSize += std::min(resultSize, maxResListLen);
                 reslens[thread_idx]->emplace_back(resultSize);
             }
+            if (prefetcher != NULL) {
+                prefetcher->queryDone();
+            }
         } // step end
+
+        const KmerListCache *kmerCache = matcher.getKmerCache();
+        if (kmerCache != NULL) {
+            __sync_fetch_and_add(&kmerCacheHits, kmerCache->getHits());
+            __sync_fetch_and_add(&kmerCacheMisses, kmerCache->getMisses());
+        }
+
+        if (queryAligner != NULL) {
+            delete queryAligner;
+        }
+        // the calling thread is one of the pinned threads
+        if (pinned) {
+            LargeMemory::unpinThread(previousCpus);
+        }
     }
+    if (prefetcher != NULL) {
+        delete prefetcher;
+    }
+    for (size_t i = 0; i < replicas.size(); i++) {
+        delete replicas[i];
+    }
+    alignmentsNum += splitAlignmentsNum;
+    alignmentsPassedNum += splitPassedNum;
+    ProfileReport::add(ProfileReport::DB_MATCHES, dbMatches);
+    ProfileReport::add(ProfileReport::DOUBLE_MATCHES, doubleMatches);
+    ProfileReport::add(ProfileReport::DIAGONAL_OVERFLOW, diagonalOverflow);
 
     if (Debug::debugLevel >= Debug::INFO) {
         statistics_t stats(kmersPerPos / static_cast<double>(totalQueryDBSize),
@@ -880,6 +1060,9 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
         }
 
         printStatistics(stats, reslens, localThreads, empty, maxResListLen);
+        if (kmerCacheHits + kmerCacheMisses > 0) {
+            Debug(Debug::INFO) << (100.0 * kmerCacheHits) / (kmerCacheHits + kmerCacheMisses) << "% k-mer list cache hits\n";
+        }
     }
 
     if (splitMode == Parameters::TARGET_DB_SPLIT && splits == 1) {
@@ -910,7 +1093,7 @@ bool Prefiltering::runSplit(const std::string &resultDB, const std::string &resu
         resultReader.open(DBReader<unsigned int>::NOSORT);
         resultReader.readMmapedDataInMemory();
         const std::pair<std::string, std::string> tempDb = Util::databaseNames((resultDB + "_tmp"));
-        DBWriter resultWriter(tempDb.first.c_str(), tempDb.second.c_str(), localThreads, compressed, Parameters::DBTYPE_PREFILTER_RES);
+        DBWriter resultWriter(tempDb.first.c_str(), tempDb.second.c_str(), localThreads, compressed, resultDbtype);
         resultWriter.open();
         resultWriter.sortDatafileByIdOrder(resultReader);
         resultWriter.close(true);
@@ -975,6 +1158,7 @@ BaseMatrix *Prefiltering::getSubstitutionMatrix(const MultiParam<NuclAA<std::str
 
 void Prefiltering::mergePrefilterSplits(const std::string &outDB, const std::string &outDBIndex,
                               const std::vector<std::pair<std::string, std::string>> &splitFiles) {
+    ProfileReport::Phase phase("merge splits");
     if (splitMode == Parameters::TARGET_DB_SPLIT) {
         mergeTargetSplits(outDB, outDBIndex, splitFiles, threads);
     } else if (splitMode == Parameters::QUERY_DB_SPLIT) {
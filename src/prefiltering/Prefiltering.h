@@ -13,6 +13,8 @@
 #include <list>
 #include <utility>
 
+class Alignment;
+
 class Prefiltering {
 public:
     Prefiltering(
@@ -27,6 +29,9 @@ public:
 
     void runAllSplits(const std::string &resultDB, const std::string &resultDBIndex);
 
+    // aligns the hits of each query right after prefiltering it and writes only the alignment results
+    void runAllSplitsAligned(Alignment &aln, const std::string &resultDB, const std::string &resultDBIndex);
+
 #ifdef HAVE_MPI
     void runMpiSplits(const std::string &resultDB, const std::string &resultDBIndex, const std::string &localTmpPath, const int runRandomId);
 #endif
@@ -93,12 +98,28 @@ private:
     const unsigned int minDiagScoreThr;
     bool aaBiasCorrection;
     float aaBiasCorrectionScale;
+    // number of queries whose k-mers are looked up together
+    const size_t queryBatchSize;
+    // memory for the similar k-mer list caches of all threads
+    const size_t kmerCacheSize;
+    // keep the sequence lookup bit packed
+    const bool packSequenceLookup;
     const float covThr;
     const int covMode;
     const bool includeIdentical;
     int preloadMode;
+    // prefetch the k-mer blocks of upcoming queries from a memory mapped index
+    bool prefetchIndex;
     const unsigned int threads;
     int compressed;
+    const bool binaryResult;
+    const bool asyncWrite;
+    int resultDbtype;
+
+    // set while running aligned splits, prefilter hits are not written then
+    Alignment *aligner;
+    size_t alignmentsNum;
+    size_t alignmentsPassedNum;
 
     bool runSplit(const std::string &resultDB, const std::string &resultDBIndex, size_t split, bool merge);
 
@@ -4,6 +4,7 @@
 #include "ExtendedSubstitutionMatrix.h"
 #include "FileUtil.h"
 #include "IndexBuilder.h"
+#include "LargeMemory.h"
 #include "Parameters.h"
 
 extern const char* index_version_compatible;
@@ -24,6 +25,7 @@ unsigned int PrefilteringIndexReader::SEQCOUNT = 13;
 unsigned int PrefilteringIndexReader::SEQINDEXDATA = 14;
 unsigned int PrefilteringIndexReader::SEQINDEXDATASIZE = 15;
 unsigned int PrefilteringIndexReader::SEQINDEXSEQOFFSET = 16;
+unsigned int PrefilteringIndexReader::ENTRIESBLOCKS = 17;
 unsigned int PrefilteringIndexReader::HDR1INDEX = 18;
 unsigned int PrefilteringIndexReader::HDR1DATA = 19;
 unsigned int PrefilteringIndexReader::HDR2INDEX = 20;
@@ -62,6 +64,14 @@ void PrefilteringIndexReader::createIndexFile(const std::string &outDB,
     const int SPLIT_SEQS = splits > 1 ? 1 : 0;
     const int SPLIT_INDX = splits > 1 ? 2 : 0;
 
+    // the data files are copied as is, block compressed data has to be decompressed first
+    DBReader<unsigned int> *copiedReaders[] = { dbr1, dbr2, hdbr1, hdbr2, alndbr };
+    for (size_t i = 0; i < 5; i++) {
+        if (copiedReaders[i] != NULL && copiedReaders[i]->isBlockCompressed()) {
+            copiedReaders[i]->readMmapedDataInMemory();
+        }
+    }
+
     DBWriter writer(outDB.c_str(), std::string(outDB).append(".index").c_str(), splits > 1 ? splits + 2 : 1, Parameters::WRITER_ASCII_MODE, Parameters::DBTYPE_INDEX_DB);
     writer.open();
 
@@ -245,6 +255,18 @@ void PrefilteringIndexReader::createIndexFile(const std::string &outDB,
         size_t offsetsSize = (indexTable.getTableSize() + 1) * sizeof(size_t);
         writer.writeData(offsets, offsetsSize, (keyOffset + ENTRIESOFFSETS), SPLIT_INDX + s);
         writer.alignToPageSize(SPLIT_INDX + s);
+
+        // block directory, the block size followed by the first entry of every block of k-mers
+        Debug(Debug::INFO) << "Write ENTRIESBLOCKS (" << (keyOffset + ENTRIESBLOCKS) << ")\n";
+        size_t tableSize = indexTable.getTableSize();
+        size_t blockCount = (tableSize + KMER_BLOCK_SIZE - 1) / KMER_BLOCK_SIZE;
+        std::vector<size_t> blocks(blockCount + 2);
+        blocks[0] = KMER_BLOCK_SIZE;
+        for (size_t b = 0; b <= blockCount; b++) {
+            blocks[b + 1] = indexTable.getOffsets()[std::min(b * KMER_BLOCK_SIZE, tableSize)];
+        }
+        writer.writeData((char *) blocks.data(), blocks.size() * sizeof(size_t), (keyOffset + ENTRIESBLOCKS), SPLIT_INDX + s);
+        writer.alignToPageSize(SPLIT_INDX + s);
         indexTable.deleteEntries();
 
         Debug(Debug::INFO) << "Write SEQINDEXDATASIZE (" << (keyOffset + SEQINDEXDATASIZE) << ")\n";
@@ -374,6 +396,8 @@ SequenceLookup *PrefilteringIndexReader::getSequenceLookup(unsigned int split, D
         dbr->touchData(seqOffsetsId);
     }
 
+    LargeMemory::adviseMapped(seqData, dbr->getEntryLen(id));
+    LargeMemory::adviseMapped(seqOffsetsData, dbr->getEntryLen(seqOffsetsId));
     SequenceLookup *sequenceLookup = new SequenceLookup(sequenceCount);
     sequenceLookup->initLookupByExternalData(seqData, seqDataSize, (size_t *) seqOffsetsData);
     return sequenceLookup;
@@ -418,11 +442,24 @@ IndexTable *PrefilteringIndexReader::getIndexTable(unsigned int split, DBReader<
         dbr->touchData(entriesOffsetsDataId);
     }
 
+    LargeMemory::adviseMapped(entriesData, dbr->getEntryLen(entriesDataId));
+    LargeMemory::adviseMapped(entriesOffsetsData, dbr->getEntryLen(entriesOffsetsDataId));
     IndexTable* table = new IndexTable(adjustAlphabetSize, data.kmerSize, true);
     table->initTableByExternalData(sequenceCount, entriesNum, (IndexEntryLocal*) entriesData, (size_t *)entriesOffsetsData);
     return table;
 }
 
+size_t *PrefilteringIndexReader::getKmerBlocks(unsigned int split, DBReader<unsigned int> *dbr, size_t *blockSize, size_t *blockCount) {
+    size_t id = dbr->getId(split * 1000 + ENTRIESBLOCKS);
+    if (id == UINT_MAX) {
+        return NULL;
+    }
+    size_t *blocks = (size_t *) dbr->getDataUncompressed(id);
+    *blockSize = blocks[0];
+    *blockCount = dbr->getEntryLen(id) / sizeof(size_t) - 2;
+    return blocks + 1;
+}
+
 void PrefilteringIndexReader::printSummary(DBReader<unsigned int> *dbr) {
     Debug(Debug::INFO) << "Index version: " << dbr->getDataByDBKey(VERSION, 0) << "\n";
 
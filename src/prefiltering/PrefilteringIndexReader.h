@@ -6,6 +6,9 @@
 #include "DBReader.h"
 #include <string>
 
+// version of the precomputed index written by this tree, index_version_compatible of the mmseqs binary
+#define MMSEQS_INDEX_VERSION "16"
+
 struct PrefilteringIndexData {
     int maxSeqLength;
     int kmerSize;
@@ -32,6 +35,7 @@ public:
     static unsigned int SEQINDEXDATASIZE;
     static unsigned int SEQINDEXSEQOFFSET;
     static unsigned int ENTRIESNUM;
+    static unsigned int ENTRIESBLOCKS;
     static unsigned int SEQCOUNT;
     static unsigned int META;
     static unsigned int SCOREMATRIXNAME;
@@ -51,6 +55,9 @@ public:
     static unsigned int ALNINDEX;
     static unsigned int ALNDATA;
 
+    // number of consecutive k-mers that are prefetched together from a memory mapped index
+    static const size_t KMER_BLOCK_SIZE = 4096;
+
     static bool checkIfIndexFile(DBReader<unsigned int> *reader);
     static std::string indexName(const std::string &outDB);
 
@@ -69,6 +76,9 @@ public:
 
     static IndexTable *getIndexTable(unsigned int split, DBReader<unsigned int> *dbr, int preloadMode);
 
+    // returns the entry offset of every k-mer block and the end of the entries, NULL for indices without ENTRIESBLOCKS
+    static size_t *getKmerBlocks(unsigned int split, DBReader<unsigned int> *dbr, size_t *blockSize, size_t *blockCount);
+
     static void printSummary(DBReader<unsigned int> *dbr);
 
     static PrefilteringIndexData getMetadata(DBReader<unsigned int> *dbr);
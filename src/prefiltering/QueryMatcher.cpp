@@ -65,6 +65,9 @@ QueryMatcher::QueryMatcher(IndexTable *indexTable, SequenceLookup *sequenceLooku
         ungappedAlignment = new UngappedAlignment(maxSeqLen, ungappedAlignmentSubMat, sequenceLookup);
     }
     compositionBias = new float[maxSeqLen];
+    batchPrepared = 0;
+    batchNext = 0;
+    exactKmer = 0;
 }
 
 QueryMatcher::~QueryMatcher(){
@@ -87,18 +90,9 @@ std::pair<hit_t*, size_t> QueryMatcher::matchQuery(Sequence *querySeq, unsigned
 //    std::cout << "Id: " << querySeq->getId() << std::endl;
     memset(scoreSizes, 0, SCORE_RANGE * sizeof(unsigned int));
 
-    // bias correction
-    if(aaBiasCorrection == true){
-        if(Parameters::isEqualDbtype(querySeq->getSeqType(), Parameters::DBTYPE_AMINO_ACIDS)) {
-            SubstitutionMatrix::calcLocalAaBiasCorrection(kmerSubMat, querySeq->numSequence, querySeq->L, compositionBias, scaleBiasCorr);
-        }else{
-            memset(compositionBias, 0, sizeof(float) * querySeq->L);
-        }
-    } else {
-        memset(compositionBias, 0, sizeof(float) * querySeq->L);
-    }
+    computeCompositionBias(querySeq);
 
-    size_t resultSize = match(querySeq, compositionBias);
+    size_t resultSize = isBatched(querySeq->getId()) ? matchBatched(querySeq) : match(querySeq, compositionBias);
     std::pair<hit_t *, size_t> queryResult;
     if (diagonalScoring) {
         // write diagonal scores in count value
@@ -195,6 +189,183 @@ std::pair<hit_t*, size_t> QueryMatcher::matchQuery(Sequence *querySeq, unsigned
     return queryResult;
 }
 
+void QueryMatcher::computeCompositionBias(Sequence *querySeq) {
+    if(aaBiasCorrection == true){
+        if(Parameters::isEqualDbtype(querySeq->getSeqType(), Parameters::DBTYPE_AMINO_ACIDS)) {
+            SubstitutionMatrix::calcLocalAaBiasCorrection(kmerSubMat, querySeq->numSequence, querySeq->L, compositionBias, scaleBiasCorr);
+        }else{
+            memset(compositionBias, 0, sizeof(float) * querySeq->L);
+        }
+    } else {
+        memset(compositionBias, 0, sizeof(float) * querySeq->L);
+    }
+}
+
+inline const size_t *QueryMatcher::getKmerList(Sequence *seq, const unsigned char *kmer, float *compositionBias, size_t *kmerElementSize) {
+    const unsigned char *pos = seq->getAAPosInSpacedPattern();
+    const unsigned short current_i = seq->getCurrentPosition();
+    float biasCorrection = 0;
+    for (int i = 0; i < kmerSize; i++){
+        biasCorrection += compositionBias[current_i + static_cast<short>(pos[i])];
+    }
+    // round bias to next higher or lower value
+    short bias = static_cast<short>((biasCorrection < 0.0) ? biasCorrection - 0.5: biasCorrection + 0.5);
+    short kmerMatchScore = std::max(kmerThr - bias, 0);
+
+    // adjust kmer threshold based on composition bias
+    kmerGenerator->setThreshold(kmerMatchScore);
+
+    if (takeOnlyBestKmer) {
+        *kmerElementSize = 1;
+        exactKmer = idx.int2index(kmer);
+        return &exactKmer;
+    }
+    std::pair<size_t*, size_t> kmerList = kmerGenerator->generateKmerList(kmer);
+    *kmerElementSize = kmerList.second;
+    return kmerList.first;
+}
+
+void QueryMatcher::clearBatch() {
+    batchKmers.clear();
+    batchPositionKmers.clear();
+    batchQueries.clear();
+    batchPrepared = 0;
+    batchNext = 0;
+}
+
+void QueryMatcher::addToBatch(Sequence *querySeq) {
+    BatchQuery query;
+    query.id = querySeq->getId();
+    query.firstPosition = batchPositionKmers.size();
+    query.firstSlot = batchKmers.size();
+    batchQueries.push_back(query);
+
+    computeCompositionBias(querySeq);
+    querySeq->resetCurrPos();
+    while (querySeq->hasNextKmer()) {
+        const unsigned char *kmer = querySeq->nextKmer();
+        if (querySeq->kmerContainsX()) {
+            continue;
+        }
+        size_t kmerElementSize;
+        const size_t *index = getKmerList(querySeq, kmer, compositionBias, &kmerElementSize);
+        for (size_t i = 0; i < kmerElementSize; i++) {
+            BatchKmer batchKmer;
+            batchKmer.kmer = index[i];
+            batchKmer.slot = batchKmers.size();
+            batchKmers.push_back(batchKmer);
+        }
+        batchPositionKmers.push_back(static_cast<unsigned int>(kmerElementSize));
+    }
+}
+
+size_t QueryMatcher::sweepBatch() {
+    batchPrepared = 0;
+    batchNext = 0;
+    if (batchQueries.empty()) {
+        return 0;
+    }
+    // counting sort by the leading bits of the k-mer, neighbouring k-mers share cache lines and pages of the index
+    const size_t tableSize = indexTable->getTableSize();
+    size_t shift = 0;
+    while ((tableSize >> shift) > BATCH_BUCKETS) {
+        shift++;
+    }
+    batchBuckets.assign(BATCH_BUCKETS + 1, 0);
+    for (size_t i = 0; i < batchKmers.size(); i++) {
+        batchBuckets[(batchKmers[i].kmer >> shift) + 1]++;
+    }
+    for (size_t i = 1; i <= BATCH_BUCKETS; i++) {
+        batchBuckets[i] += batchBuckets[i - 1];
+    }
+    batchSorted.resize(batchKmers.size());
+    for (size_t i = 0; i < batchKmers.size(); i++) {
+        batchSorted[batchBuckets[batchKmers[i].kmer >> shift]++] = batchKmers[i];
+    }
+
+    // first pass in k-mer order reads the offsets
+    const size_t *offsets = indexTable->getOffsets();
+    batchSlotHits.resize(batchSorted.size() + 1);
+    for (size_t i = 0; i < batchSorted.size(); i++) {
+        const size_t kmer = batchSorted[i].kmer;
+        batchSlotHits[batchSorted[i].slot] = offsets[kmer + 1] - offsets[kmer];
+        batchSorted[i].kmer = offsets[kmer];
+    }
+
+    // hits are laid out in generation order as match would collect them,
+    // queries that do not fit anymore are left for the next batch
+    size_t hitOffset = 0;
+    size_t slotEnd = 0;
+    for (size_t q = 0; q < batchQueries.size(); q++) {
+        const size_t querySlotEnd = (q + 1 < batchQueries.size()) ? batchQueries[q + 1].firstSlot : batchKmers.size();
+        size_t queryHits = 0;
+        for (size_t slot = batchQueries[q].firstSlot; slot < querySlotEnd; slot++) {
+            queryHits += batchSlotHits[slot];
+        }
+        if (hitOffset + queryHits >= maxDbMatches) {
+            break;
+        }
+        for (size_t slot = batchQueries[q].firstSlot; slot < querySlotEnd; slot++) {
+            const size_t slotHits = batchSlotHits[slot];
+            batchSlotHits[slot] = hitOffset;
+            hitOffset += slotHits;
+        }
+        slotEnd = querySlotEnd;
+        batchPrepared++;
+    }
+    batchSlotHits[slotEnd] = hitOffset;
+
+    // second pass in k-mer order streams the entries
+    const IndexEntryLocal *entries = indexTable->getEntries();
+    for (size_t i = 0; i < batchSorted.size(); i++) {
+        const size_t slot = batchSorted[i].slot;
+        if (slot >= slotEnd) {
+            continue;
+        }
+        const size_t slotHits = batchSlotHits[slot + 1] - batchSlotHits[slot];
+        memcpy(databaseHits + batchSlotHits[slot], entries + batchSorted[i].kmer, sizeof(IndexEntryLocal) * slotHits);
+    }
+    return batchPrepared;
+}
+
+size_t QueryMatcher::matchBatched(Sequence *seq) {
+    const BatchQuery &query = batchQueries[batchNext];
+    size_t position = query.firstPosition;
+    size_t slot = query.firstSlot;
+    IndexEntryLocal *hitsBegin = databaseHits + batchSlotHits[slot];
+    IndexEntryLocal *sequenceHits = hitsBegin;
+    size_t kmerListLen = 0;
+    unsigned short indexTo = 0;
+    while (seq->hasNextKmer()) {
+        seq->nextKmer();
+        const unsigned short current_i = seq->getCurrentPosition();
+        indexPointer[current_i] = sequenceHits;
+        indexTo = current_i;
+        if (seq->kmerContainsX()) {
+            continue;
+        }
+        const size_t kmerElementSize = batchPositionKmers[position++];
+        kmerListLen += kmerElementSize;
+        slot += kmerElementSize;
+        sequenceHits = databaseHits + batchSlotHits[slot];
+    }
+    indexPointer[indexTo + 1] = sequenceHits;
+    batchNext++;
+
+    stats->diagonalOverflow = false;
+    size_t hitCount = findDuplicates(indexPointer, foundDiagonals, foundDiagonalsSize, 0, indexTo, (diagonalScoring == false));
+    stats->doubleMatches = 0;
+    if (diagonalScoring == false) {
+        // remove double entries
+        updateScoreBins(foundDiagonals, hitCount);
+        stats->doubleMatches = getDoubleDiagonalMatches();
+    }
+    stats->kmersPerPos = ((double)kmerListLen/(double)seq->L);
+    stats->querySeqLen = seq->L;
+    stats->dbMatches   = sequenceHits - hitsBegin;
+    return hitCount;
+}
+
 size_t QueryMatcher::match(Sequence *seq, float *compositionBias) {
     // go through the query sequence
     size_t kmerListLen = 0;
@@ -209,37 +380,14 @@ size_t QueryMatcher::match(Sequence *seq, float *compositionBias) {
     unsigned short indexTo = 0;
     while (seq->hasNextKmer()) {
         const unsigned char *kmer = seq->nextKmer();
-        const unsigned char *pos = seq->getAAPosInSpacedPattern();
         const unsigned short current_i = seq->getCurrentPosition();
-
-        float biasCorrection = 0;
-        for (int i = 0; i < kmerSize; i++){
-            biasCorrection += compositionBias[current_i + static_cast<short>(pos[i])];
-        }
         if (seq->kmerContainsX()) {
             indexTo = current_i;
             indexPointer[current_i] = sequenceHits;
             continue;
         }
-        // round bias to next higher or lower value
-        short bias = static_cast<short>((biasCorrection < 0.0) ? biasCorrection - 0.5: biasCorrection + 0.5);
-        short kmerMatchScore = std::max(kmerThr - bias, 0);
-
-        // adjust kmer threshold based on composition bias
-        kmerGenerator->setThreshold(kmerMatchScore);
-
-        const size_t *index;
-        size_t exactKmer;
         size_t kmerElementSize;
-        if (takeOnlyBestKmer) {
-            kmerElementSize = 1;
-            exactKmer = idx.int2index(kmer);
-            index = &exactKmer;
-        } else {
-            std::pair<size_t*, size_t> kmerList = kmerGenerator->generateKmerList(kmer);
-            kmerElementSize = kmerList.second;
-            index = kmerList.first;
-        }
+        const size_t *index = getKmerList(seq, kmer, compositionBias, &kmerElementSize);
         //std::cout << kmer << std::endl;
         indexPointer[current_i] = sequenceHits;
         // match the index table
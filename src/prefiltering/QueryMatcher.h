@@ -6,6 +6,9 @@
 #define MMSEQS_QUERYTEMPLATEMATCHEREXACTMATCH_H
 
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "itoa.h"
 #include "EvalueComputation.h"
 #include "CacheFriendlyOperations.h"
@@ -73,6 +76,33 @@ public:
         kmerGenerator->setDivideStrategy(three, two);
     }
 
+    // reuse the similar k-mer lists of recurring k-mers, only used with a substitution matrix
+    void setKmerCacheSize(size_t maxBytes) {
+        kmerGenerator->setCacheSize(maxBytes);
+    }
+
+    const KmerListCache *getKmerCache() const {
+        return kmerGenerator->getCache();
+    }
+
+    // Query batching: the k-mer lists of several queries are sorted and looked up in a single pass over the index table.
+    // matchQuery uses the collected hits if it is called for the batched queries in the order they were added.
+    void clearBatch();
+
+    // adds the query to the batch, it has to be mapped to the sequence that matchQuery is called with
+    void addToBatch(Sequence *querySeq);
+
+    bool isBatchFull() {
+        return batchKmers.size() >= MAX_BATCH_KMERS;
+    }
+
+    // looks up the k-mers of the batch, returns the number of leading queries whose hits fit into the hit buffer
+    size_t sweepBatch();
+
+    bool isBatched(size_t id) {
+        return batchNext < batchPrepared && batchQueries[batchNext].id == id;
+    }
+
     // get statistics
     const statistics_t *getStatistics() {
         return stats;
@@ -125,6 +155,47 @@ public:
         return tmpBuff - basePos;
     }
 
+    // fixed-width binary hit record: seqId, prefScore, diagonal (native byte order)
+    static const size_t BINARY_HIT_SIZE = sizeof(unsigned int) + sizeof(int) + sizeof(unsigned short);
+
+    static size_t prefilterHitToBinary(char *buff1, const hit_t &h) {
+        memcpy(buff1, &h.seqId, sizeof(unsigned int));
+        memcpy(buff1 + sizeof(unsigned int), &h.prefScore, sizeof(int));
+        memcpy(buff1 + sizeof(unsigned int) + sizeof(int), &h.diagonal, sizeof(unsigned short));
+        return BINARY_HIT_SIZE;
+    }
+
+    static hit_t parsePrefilterHitBinary(const char *data) {
+        hit_t result;
+        memcpy(&result.seqId, data, sizeof(unsigned int));
+        memcpy(&result.prefScore, data + sizeof(unsigned int), sizeof(int));
+        memcpy(&result.diagonal, data + sizeof(unsigned int) + sizeof(int), sizeof(unsigned short));
+        return result;
+    }
+
+    // entryLength is the length stored in the index (including the terminating null byte)
+    static size_t getBinaryHitCount(size_t entryLength) {
+        return (entryLength <= 1) ? 0 : (entryLength - 1) / BINARY_HIT_SIZE;
+    }
+
+    static void parsePrefilterHitsBinary(const char *data, size_t entryLength, std::vector<hit_t> &entries) {
+        const size_t hitCount = getBinaryHitCount(entryLength);
+        for (size_t i = 0; i < hitCount; i++) {
+            entries.push_back(parsePrefilterHitBinary(data + i * BINARY_HIT_SIZE));
+        }
+    }
+
+    // converts a binary prefilter entry back to the tab-separated text representation
+    static void binaryHitsToBuffer(std::string &out, const char *data, size_t entryLength) {
+        char buffer[128];
+        const size_t hitCount = getBinaryHitCount(entryLength);
+        for (size_t i = 0; i < hitCount; i++) {
+            hit_t hit = parsePrefilterHitBinary(data + i * BINARY_HIT_SIZE);
+            size_t len = prefilterHitToBuffer(buffer, hit);
+            out.append(buffer, len);
+        }
+    }
+
 protected:
     const static int KMER_SCORE = 0;
     const static int UNGAPPED_DIAGONAL_SCORE = 1;
@@ -195,6 +266,47 @@ protected:
 
     const static size_t SCORE_RANGE = 256;
 
+    // upper limit of generated k-mers of a batch, a single query can exceed it
+    const static size_t MAX_BATCH_KMERS = 1 << 21;
+    // k-mers are sorted into this many ranges of the index table
+    const static size_t BATCH_BUCKETS = 1 << 16;
+
+    struct BatchKmer {
+        // k-mer index, replaced by the offset of its entries during the sweep
+        size_t kmer;
+        // position of the k-mer in generation order
+        size_t slot;
+    };
+
+    struct BatchQuery {
+        size_t id;
+        size_t firstPosition;
+        size_t firstSlot;
+    };
+
+    // k-mers in generation order and sorted by k-mer range
+    std::vector<BatchKmer> batchKmers;
+    std::vector<BatchKmer> batchSorted;
+    std::vector<size_t> batchBuckets;
+    // hit count per slot, after the sweep the offset of its hits in databaseHits
+    std::vector<size_t> batchSlotHits;
+    // number of generated k-mers for every query position without X
+    std::vector<unsigned int> batchPositionKmers;
+    std::vector<BatchQuery> batchQueries;
+    size_t batchPrepared;
+    size_t batchNext;
+
+    // storage for the exact k-mer if only the best k-mer is matched
+    size_t exactKmer;
+
+    void computeCompositionBias(Sequence *querySeq);
+
+    // k-mer list for the current position, the threshold is adjusted by the local composition bias
+    const size_t *getKmerList(Sequence *seq, const unsigned char *kmer, float *compositionBias, size_t *kmerElementSize);
+
+    // match a batched query against its collected hits
+    size_t matchBatched(Sequence *seq);
+
     void updateScoreBins(CounterResult *result, size_t elementCount);
 
     static unsigned int computeScoreThreshold(unsigned int * scoreSizes, size_t maxHitsPerQuery) {
@@ -3,30 +3,53 @@
 //
 #include <new>
 #include <cstring>
+#include <climits>
+#include <algorithm>
+#include <vector>
 #include <sys/mman.h>
 #include "Debug.h"
 #include "Util.h"
+#include "LargeMemory.h"
 #include "SequenceLookup.h"
 
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 SequenceLookup::SequenceLookup(size_t sequenceCount, size_t dataSize)
-        : sequenceCount(sequenceCount), dataSize(dataSize), currentIndex(0), currentOffset(0), externalData(false) {
-    data = new(std::nothrow) char[dataSize + 1];
+        : sequenceCount(sequenceCount), dataSize(dataSize), currentIndex(0), currentOffset(0), externalData(false),
+          packed(NULL), bitsPerResidue(8), maxSequenceLength(0), blockOffsets(NULL), relativeOffsets(NULL), blockShift(0),
+          exceptionPositions(NULL), exceptionValues(NULL), exceptionCount(0) {
+    data = static_cast<char *>(LargeMemory::allocate(dataSize + 1));
     Util::checkAllocation(data, "Can not allocate data memory in SequenceLookup");
 
-    offsets = new(std::nothrow) size_t[sequenceCount + 1];
+    offsets = static_cast<size_t *>(LargeMemory::allocate((sequenceCount + 1) * sizeof(size_t)));
     Util::checkAllocation(offsets, "Can not allocate offsets memory in SequenceLookup");
     offsets[sequenceCount] = dataSize;
 }
 
 SequenceLookup::SequenceLookup(size_t sequenceCount)
-        : sequenceCount(sequenceCount), data(NULL), dataSize(0), offsets(NULL), currentIndex(0), currentOffset(0), externalData(true) {
+        : sequenceCount(sequenceCount), data(NULL), dataSize(0), offsets(NULL), currentIndex(0), currentOffset(0), externalData(true),
+          packed(NULL), bitsPerResidue(8), maxSequenceLength(0), blockOffsets(NULL), relativeOffsets(NULL), blockShift(0),
+          exceptionPositions(NULL), exceptionValues(NULL), exceptionCount(0) {
 }
 
 SequenceLookup::~SequenceLookup() {
     if(externalData == false){
-        delete[] data;
-        delete[] offsets;
+        LargeMemory::release(data, dataSize + 1);
+        LargeMemory::release(offsets, (sequenceCount + 1) * sizeof(size_t));
+    }
+    if (packed != NULL) {
+        LargeMemory::release(packed, (dataSize + 7) / 8 * bitsPerResidue + 8);
+        LargeMemory::release(relativeOffsets, (sequenceCount + 1) * sizeof(unsigned int));
     }
+    delete[] blockOffsets;
+    delete[] exceptionPositions;
+    delete[] exceptionValues;
 }
 
 void SequenceLookup::addSequence(unsigned char *seq, int L, size_t index, size_t offset){
@@ -73,3 +96,196 @@ void SequenceLookup::initLookupByExternalDataCopy(char *seqData, size_t *seqOffs
     memcpy(data, seqData, (dataSize + 1) * sizeof(char));
     memcpy(offsets, seqOffsets, (sequenceCount + 1) * sizeof(size_t));
 }
+
+bool SequenceLookup::pack() {
+    if (packed != NULL) {
+        return true;
+    }
+
+    // residue histogram over fixed chunks, independent of the thread count
+    const size_t CHUNKS = 1024;
+    const size_t chunkSize = std::max(dataSize / CHUNKS + 1, static_cast<size_t>(1));
+    std::vector<size_t> chunkCounts(CHUNKS * 256, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t chunk = 0; chunk < CHUNKS; chunk++) {
+        size_t *counts = &chunkCounts[chunk * 256];
+        const size_t end = std::min((chunk + 1) * chunkSize, dataSize);
+        for (size_t i = chunk * chunkSize; i < end; i++) {
+            counts[static_cast<unsigned char>(data[i])]++;
+        }
+    }
+    size_t counts[256] = { 0 };
+    for (size_t chunk = 0; chunk < CHUNKS; chunk++) {
+        for (size_t v = 0; v < 256; v++) {
+            counts[v] += chunkCounts[chunk * 256 + v];
+        }
+    }
+    int maxValue = 0;
+    for (int v = 0; v < 256; v++) {
+        if (counts[v] > 0) {
+            maxValue = v;
+        }
+    }
+    if (maxValue >= 32) {
+        return false;
+    }
+    int bits = 2;
+    while ((1 << bits) <= maxValue) {
+        bits++;
+    }
+    // an exception costs a position and a value, worth it if only few residues (e.g. N in nucleotides) need more than 2 bits
+    size_t exceptions = 0;
+    for (int v = 4; v <= maxValue; v++) {
+        exceptions += counts[v];
+    }
+    if (bits > 2 && exceptions * (sizeof(size_t) + 1) * 8 < dataSize * (bits - 2)) {
+        bits = 2;
+    } else {
+        exceptions = 0;
+    }
+    const unsigned char mask = static_cast<unsigned char>((1 << bits) - 1);
+
+    // the largest block of sequences whose residues can be addressed with 32-bit offsets
+    blockShift = 16;
+    while (blockShift > 0) {
+        bool fits = true;
+        for (size_t id = 0; id <= sequenceCount && fits; id += (static_cast<size_t>(1) << blockShift)) {
+            size_t last = std::min(id + (static_cast<size_t>(1) << blockShift) - 1, sequenceCount);
+            fits = offsets[last] - offsets[id] <= UINT_MAX;
+        }
+        if (fits) {
+            break;
+        }
+        blockShift--;
+    }
+    const size_t blockCount = (sequenceCount >> blockShift) + 1;
+    blockOffsets = new(std::nothrow) size_t[blockCount];
+    Util::checkAllocation(blockOffsets, "Can not allocate block offsets memory in SequenceLookup");
+    relativeOffsets = static_cast<unsigned int *>(LargeMemory::allocate((sequenceCount + 1) * sizeof(unsigned int)));
+    Util::checkAllocation(relativeOffsets, "Can not allocate relative offsets memory in SequenceLookup");
+    for (size_t block = 0; block < blockCount; block++) {
+        blockOffsets[block] = offsets[block << blockShift];
+    }
+    maxSequenceLength = 0;
+    for (size_t id = 0; id <= sequenceCount; id++) {
+        relativeOffsets[id] = static_cast<unsigned int>(offsets[id] - blockOffsets[id >> blockShift]);
+        if (id < sequenceCount) {
+            maxSequenceLength = std::max(maxSequenceLength, static_cast<unsigned int>(offsets[id + 1] - offsets[id]));
+        }
+    }
+
+    // groups of 8 residues fill exactly bits bytes, 8 bytes of padding allow word loads at the end
+    const size_t groups = (dataSize + 7) / 8;
+    packed = static_cast<unsigned char *>(LargeMemory::allocate(groups * bits + 8));
+    Util::checkAllocation(packed, "Can not allocate packed memory in SequenceLookup");
+    memset(packed + groups * bits, 0, 8);
+#pragma omp parallel for schedule(static)
+    for (size_t group = 0; group < groups; group++) {
+        const size_t start = group * 8;
+        const size_t end = std::min(start + 8, dataSize);
+        uint64_t word = 0;
+        for (size_t i = start; i < end; i++) {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(data[i]) & mask) << ((i - start) * bits);
+        }
+        for (int byte = 0; byte < bits; byte++) {
+            packed[group * bits + byte] = static_cast<unsigned char>(word >> (8 * byte));
+        }
+    }
+
+    if (exceptions > 0) {
+        exceptionPositions = new(std::nothrow) size_t[exceptions];
+        Util::checkAllocation(exceptionPositions, "Can not allocate exception memory in SequenceLookup");
+        exceptionValues = new(std::nothrow) unsigned char[exceptions];
+        Util::checkAllocation(exceptionValues, "Can not allocate exception memory in SequenceLookup");
+        std::vector<size_t> chunkStart(CHUNKS + 1, 0);
+        for (size_t chunk = 0; chunk < CHUNKS; chunk++) {
+            size_t inChunk = 0;
+            for (int v = 4; v <= maxValue; v++) {
+                inChunk += chunkCounts[chunk * 256 + v];
+            }
+            chunkStart[chunk + 1] = chunkStart[chunk] + inChunk;
+        }
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t chunk = 0; chunk < CHUNKS; chunk++) {
+            size_t pos = chunkStart[chunk];
+            const size_t end = std::min((chunk + 1) * chunkSize, dataSize);
+            for (size_t i = chunk * chunkSize; i < end; i++) {
+                if (static_cast<unsigned char>(data[i]) > mask) {
+                    exceptionPositions[pos] = i;
+                    exceptionValues[pos] = static_cast<unsigned char>(data[i]);
+                    pos++;
+                }
+            }
+        }
+    }
+    exceptionCount = exceptions;
+    bitsPerResidue = bits;
+
+    if (externalData == false) {
+        LargeMemory::release(data, dataSize + 1);
+        LargeMemory::release(offsets, (sequenceCount + 1) * sizeof(size_t));
+    }
+    data = NULL;
+    offsets = NULL;
+    return true;
+}
+
+// BITS is a template argument so that the group loop unrolls into constant shifts
+template <int BITS>
+static void unpackResidues(const unsigned char *packed, size_t pos, const size_t end, unsigned char *out) {
+    const uint64_t mask = (static_cast<uint64_t>(1) << BITS) - 1;
+    uint64_t word;
+    // single residues up to the next group of 8
+    while (pos < end && (pos & 7) != 0) {
+        const size_t bit = pos * BITS;
+        memcpy(&word, packed + (bit >> 3), sizeof(uint64_t));
+        *out++ = static_cast<unsigned char>((word >> (bit & 7)) & mask);
+        pos++;
+    }
+    while (pos + 8 <= end) {
+        memcpy(&word, packed + (pos >> 3) * BITS, sizeof(uint64_t));
+        // spread the 8 residues to one byte each and store them at once
+#ifdef __BMI2__
+        uint64_t residues = _pdep_u64(word, 0x0101010101010101ULL * mask);
+#else
+        uint64_t residues = 0;
+        for (size_t i = 0; i < 8; i++) {
+            residues |= ((word >> (i * BITS)) & mask) << (i * 8);
+        }
+#endif
+        memcpy(out, &residues, sizeof(uint64_t));
+        out += 8;
+        pos += 8;
+    }
+    while (pos < end) {
+        const size_t bit = pos * BITS;
+        memcpy(&word, packed + (bit >> 3), sizeof(uint64_t));
+        *out++ = static_cast<unsigned char>((word >> (bit & 7)) & mask);
+        pos++;
+    }
+}
+
+void SequenceLookup::decode(size_t offset, unsigned int length, unsigned char *buffer) {
+    const size_t end = offset + length;
+    switch (bitsPerResidue) {
+        case 2:
+            unpackResidues<2>(packed, offset, end, buffer);
+            break;
+        case 3:
+            unpackResidues<3>(packed, offset, end, buffer);
+            break;
+        case 4:
+            unpackResidues<4>(packed, offset, end, buffer);
+            break;
+        default:
+            unpackResidues<5>(packed, offset, end, buffer);
+            break;
+    }
+
+    if (exceptionCount > 0) {
+        const size_t *exceptionEnd = exceptionPositions + exceptionCount;
+        for (const size_t *it = std::lower_bound(static_cast<const size_t *>(exceptionPositions), exceptionEnd, offset); it < exceptionEnd && *it < end; ++it) {
+            buffer[*it - offset] = exceptionValues[it - exceptionPositions];
+        }
+    }
+}
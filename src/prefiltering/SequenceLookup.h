@@ -21,9 +21,45 @@ public:
     // add sequence to index
     void addSequence(Sequence * seq);
 
-    // get sequence data
+    // get sequence data, only valid as long as the lookup is not packed
     std::pair<const unsigned char *, const unsigned int> getSequence(size_t id);
 
+    // get sequence data, packed lookups decode into buffer, which needs room for getSequenceLength(id) residues
+    std::pair<const unsigned char *, const unsigned int> getSequence(size_t id, unsigned char *buffer) {
+        if (packed == NULL) {
+            return getSequence(id);
+        }
+        size_t offset = getPackedOffset(id);
+        unsigned int length = static_cast<unsigned int>(getPackedOffset(id + 1) - offset);
+        decode(offset, length, buffer);
+        return std::pair<const unsigned char *, const unsigned int>(buffer, length);
+    }
+
+    unsigned int getSequenceLength(size_t id) {
+        if (packed == NULL) {
+            return static_cast<unsigned int>(offsets[id + 1] - offsets[id]);
+        }
+        return static_cast<unsigned int>(getPackedOffset(id + 1) - getPackedOffset(id));
+    }
+
+    // stores the residues with 2 to 5 bits instead of one byte each
+    // nucleotides keep 2 bits and list their few N residues separately
+    // returns false if the residues do not fit into 5 bits, the lookup is left unchanged then
+    // afterwards getData and getOffsets return NULL, packed lookups cannot be written to an index
+    bool pack();
+
+    bool isPacked() {
+        return packed != NULL;
+    }
+
+    int getBitsPerResidue() {
+        return bitsPerResidue;
+    }
+
+    unsigned int getMaxSequenceLength() {
+        return maxSequenceLength;
+    }
+
     const char *getData();
 
     int64_t getDataSize();
@@ -50,6 +86,27 @@ private:
 
     // if data are read from mmap
     bool externalData;
+
+    // packed residues, residue i uses bits [i * bitsPerResidue, (i + 1) * bitsPerResidue)
+    unsigned char *packed;
+    int bitsPerResidue;
+    unsigned int maxSequenceLength;
+
+    // residue offset of sequence id is blockOffsets[id >> blockShift] + relativeOffsets[id]
+    size_t *blockOffsets;
+    unsigned int *relativeOffsets;
+    unsigned int blockShift;
+
+    // residues that do not fit into bitsPerResidue, sorted by position
+    size_t *exceptionPositions;
+    unsigned char *exceptionValues;
+    size_t exceptionCount;
+
+    size_t getPackedOffset(size_t id) {
+        return blockOffsets[id >> blockShift] + relativeOffsets[id];
+    }
+
+    void decode(size_t offset, unsigned int length, unsigned char *buffer);
 };
 
 
@@ -2,20 +2,29 @@
 // Created by mad on 12/15/15.
 
 #include "UngappedAlignment.h"
+#include "SimdDispatch.h"
 
 UngappedAlignment::UngappedAlignment(const unsigned int maxSeqLen,
                                      BaseMatrix *substitutionMatrix, SequenceLookup *sequenceLookup)
-        : subMatrix(substitutionMatrix), sequenceLookup(sequenceLookup) {
-    score_arr = new unsigned int[VECSIZE_INT*4];
+        : diagonalKernel(SimdDispatch::kernels().diagonalScoring),
+          lanes(diagonalKernel != NULL ? SimdDispatch::kernels().diagonalLanes : VECSIZE_INT * 4),
+          subMatrix(substitutionMatrix), sequenceLookup(sequenceLookup), laneBuffers(NULL), sequenceBuffer(NULL), placeholderResidue(0) {
+    score_arr = new unsigned int[lanes];
     diagonalCounter = new unsigned char[DIAGONALCOUNT];
-    vectorSequence = (unsigned char *) malloc_simd_int(VECSIZE_INT * 4 * maxSeqLen);
+    vectorSequence = (unsigned char *) mem_align(MAX_ALIGN_INT, lanes * maxSeqLen);
     queryProfile   = (char *) malloc_simd_int(PROFILESIZE * maxSeqLen);
     memset(queryProfile, 0, PROFILESIZE * maxSeqLen);
     aaCorrectionScore = (char *) malloc_simd_int(maxSeqLen);
-    diagonalMatches = new CounterResult*[DIAGONALCOUNT * (VECSIZE_INT * 4)];
+    diagonalMatches = new CounterResult*[DIAGONALCOUNT * lanes];
+    if (sequenceLookup != NULL && sequenceLookup->isPacked()) {
+        laneBuffers = new unsigned char[lanes * MAX_LANE_LENGTH];
+        sequenceBuffer = new unsigned char[sequenceLookup->getMaxSequenceLength() + 1];
+    }
 }
 
 UngappedAlignment::~UngappedAlignment() {
+    delete [] sequenceBuffer;
+    delete [] laneBuffers;
     delete [] diagonalMatches;
     free(aaCorrectionScore);
     free(queryProfile);
@@ -113,12 +122,12 @@ std::pair<unsigned char *, unsigned int> UngappedAlignment::mapSequences(std::pa
     for(unsigned int seqIdx = 0; seqIdx < seqCount;  seqIdx++) {
         maxLen = std::max(seqs[seqIdx].second, maxLen);
     }
-    memset(vectorSequence, 21, maxLen * VECSIZE_INT * 4 * sizeof(unsigned char));
-    for(unsigned int seqIdx = 0; seqIdx < VECSIZE_INT*4;  seqIdx++){
+    memset(vectorSequence, 21, maxLen * lanes * sizeof(unsigned char));
+    for(unsigned int seqIdx = 0; seqIdx < lanes;  seqIdx++){
         const unsigned char * seq  = seqs[seqIdx].first;
         const unsigned int seqSize = seqs[seqIdx].second;
         for(unsigned int pos = 0; pos < seqSize;  pos++){
-            vectorSequence[pos * VECSIZE_INT * 4 + seqIdx] = seq[pos];
+            vectorSequence[pos * lanes + seqIdx] = seq[pos];
         }
     }
     return std::make_pair(vectorSequence, maxLen);
@@ -138,56 +147,56 @@ void UngappedAlignment::scoreDiagonalAndUpdateHits(const char * queryProfile,
     if(queryLen >= 32768){
         for (size_t hitIdx = 0; hitIdx < hitSize; hitIdx++) {
             const unsigned int seqId = hits[hitIdx]->id;
-            std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(seqId);
+            std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(seqId, sequenceBuffer);
             int max = computeLongScore(queryProfile, queryLen, dbSeq, diagonal, bias);
             hits[hitIdx]->count = static_cast<unsigned char>(std::min(255, max));
         }
         return;
     }
-    if (hitSize > (VECSIZE_INT * 4) / 16) {
-        std::pair<unsigned char *, unsigned int> seqs[VECSIZE_INT * 4];
+    if (hitSize > lanes / 16) {
+        std::pair<unsigned char *, unsigned int> seqs[MAX_LANES];
         for (unsigned int seqIdx = 0; seqIdx < hitSize; seqIdx++) {
-            std::pair<const unsigned char *, const unsigned int> tmp = sequenceLookup->getSequence(
-                    hits[seqIdx]->id);
-            if(tmp.second >= 32768){
+            if(sequenceLookup->getSequenceLength(hits[seqIdx]->id) >= MAX_LANE_LENGTH){
                 // hack to avoid too long sequences
                 // this sequences will be processed by computeLongScore later
-                seqs[seqIdx] = std::make_pair((unsigned char *) tmp.first, (unsigned int) 1);
+                seqs[seqIdx] = std::make_pair(&placeholderResidue, (unsigned int) 1);
             }else{
+                unsigned char *buffer = (laneBuffers != NULL) ? laneBuffers + seqIdx * MAX_LANE_LENGTH : NULL;
+                std::pair<const unsigned char *, const unsigned int> tmp = sequenceLookup->getSequence(
+                        hits[seqIdx]->id, buffer);
                 seqs[seqIdx] = std::make_pair((unsigned char *) tmp.first, (unsigned int) tmp.second);
             }
         }
         std::pair<unsigned char *, unsigned int> seq = mapSequences(seqs, hitSize);
 
-        simd_int vMaxScore = simdi_setzero();
-
+        const char *profile = queryProfile;
+        const unsigned char *dbSeq = seq.first;
+        unsigned int minSeqLen = 0;
         if (diagonal >= 0 && minDistToDiagonal < queryLen) {
-            unsigned int minSeqLen = std::min(seq.second, queryLen - minDistToDiagonal);
-            simd_int ret = vectorDiagonalScoring(queryProfile + (minDistToDiagonal * PROFILESIZE), bias, minSeqLen,
-                                                 seq.first);
-            vMaxScore = simdui8_max(ret, vMaxScore);
+            minSeqLen = std::min(seq.second, queryLen - minDistToDiagonal);
+            profile = queryProfile + (minDistToDiagonal * PROFILESIZE);
         } else if (diagonal < 0 && minDistToDiagonal < seq.second) {
-            unsigned int minSeqLen = std::min(seq.second - minDistToDiagonal, queryLen);
-            simd_int ret = vectorDiagonalScoring(queryProfile, bias, minSeqLen,
-                                                 seq.first + minDistToDiagonal * VECSIZE_INT * 4);
-            vMaxScore = simdui8_max(ret, vMaxScore);
+            minSeqLen = std::min(seq.second - minDistToDiagonal, queryLen);
+            dbSeq = seq.first + minDistToDiagonal * lanes;
+        }
+        if (diagonalKernel != NULL) {
+            diagonalKernel(profile, bias, minSeqLen, dbSeq, score_arr);
+        } else {
+            extractScores(score_arr, vectorDiagonalScoring(profile, bias, minSeqLen, dbSeq));
         }
-        extractScores(score_arr, vMaxScore);
         // update score
         for(size_t hitIdx = 0; hitIdx < hitSize; hitIdx++){
             hits[hitIdx]->count = score_arr[hitIdx];
-            if(seqs[hitIdx].second == 1){
-                std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(hits[hitIdx]->id);
-                if(dbSeq.second >= 32768){
-                    int max = computeLongScore(queryProfile, queryLen, dbSeq, diagonal, bias);
-                    hits[hitIdx]->count = static_cast<unsigned char>(std::min(255-bias, max));
-                }
+            if(seqs[hitIdx].second == 1 && sequenceLookup->getSequenceLength(hits[hitIdx]->id) >= MAX_LANE_LENGTH){
+                std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(hits[hitIdx]->id, sequenceBuffer);
+                int max = computeLongScore(queryProfile, queryLen, dbSeq, diagonal, bias);
+                hits[hitIdx]->count = static_cast<unsigned char>(std::min(255-bias, max));
             }
         }
     }else {
         for (size_t hitIdx = 0; hitIdx < hitSize; hitIdx++) {
             const unsigned int seqId = hits[hitIdx]->id;
-            std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(seqId);
+            std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(seqId, sequenceBuffer);
             int max;
             if(dbSeq.second >= 32768){
                 max = computeLongScore(queryProfile, queryLen, dbSeq, diagonal, bias);
@@ -231,11 +240,11 @@ void UngappedAlignment::computeScores(const char *queryProfile,
 //            continue;
 //        }
         const unsigned short currDiag = results[i].diagonal;
-        diagonalMatches[currDiag * (VECSIZE_INT * 4) + diagonalCounter[currDiag]] = &results[i];
+        diagonalMatches[currDiag * lanes + diagonalCounter[currDiag]] = &results[i];
         diagonalCounter[currDiag]++;
-        if(diagonalCounter[currDiag] >= (VECSIZE_INT * 4) ) {
+        if(diagonalCounter[currDiag] >= lanes ) {
             scoreDiagonalAndUpdateHits(queryProfile, queryLen, static_cast<short>(currDiag),
-                                       &diagonalMatches[currDiag * (VECSIZE_INT * 4)], diagonalCounter[currDiag], bias);
+                                       &diagonalMatches[currDiag * lanes], diagonalCounter[currDiag], bias);
             diagonalCounter[currDiag] = 0;
         }
     }
@@ -243,7 +252,7 @@ void UngappedAlignment::computeScores(const char *queryProfile,
     for(size_t i = 0; i < DIAGONALCOUNT; i++){
         if(diagonalCounter[i] > 0){
             scoreDiagonalAndUpdateHits(queryProfile, queryLen, static_cast<short>(i),
-                                       &diagonalMatches[i * (VECSIZE_INT * 4)], diagonalCounter[i], bias);
+                                       &diagonalMatches[i * lanes], diagonalCounter[i], bias);
         }
         diagonalCounter[i] = 0;
     }
@@ -359,7 +368,7 @@ int UngappedAlignment::computeSingelSequenceScores(const char *queryProfile, con
 
 
 int UngappedAlignment::scoreSingelSequenceByCounterResult(CounterResult &result) {
-    std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(result.id);
+    std::pair<const unsigned char *, const unsigned int> dbSeq =  sequenceLookup->getSequence(result.id, sequenceBuffer);
     unsigned short minDistToDiagonal = distanceFromDiagonal(result.diagonal);
     return scoreSingleSequence(dbSeq, result.diagonal, minDistToDiagonal);
 }
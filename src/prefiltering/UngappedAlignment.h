@@ -9,6 +9,7 @@
 #include "simd.h"
 #include "CacheFriendlyOperations.h"
 #include "SequenceLookup.h"
+#include "SimdDispatch.h"
 class UngappedAlignment {
 
 public:
@@ -50,6 +51,14 @@ public:
 private:
     const static unsigned int DIAGONALCOUNT = 0xFFFF + 1;
     const static unsigned int PROFILESIZE = 32;
+    const static unsigned int MAX_LANES = 64;
+    // longer db sequences are scored by computeLongScore
+    const static unsigned int MAX_LANE_LENGTH = 32768;
+
+    // wider kernel from SimdDispatch, NULL if vectorDiagonalScoring is used
+    const SimdDispatch::diagonal_kernel diagonalKernel;
+    // number of db sequences scored in parallel
+    const unsigned int lanes;
 
     unsigned int *score_arr;
     unsigned char *vectorSequence;
@@ -61,9 +70,13 @@ private:
     char * aaCorrectionScore;
     BaseMatrix *subMatrix;
     SequenceLookup *sequenceLookup;
+    // decode buffers for packed sequence lookups, NULL otherwise
+    unsigned char *laneBuffers;
+    unsigned char *sequenceBuffer;
+    unsigned char placeholderResidue;
 
-    // this function bins the hit_t by diagonals by distributing each hit in an array of 256 * 16(sse)/32(avx2)
-    // the function scoreDiagonalAndUpdateHits is called for each bin that reaches its maximum (16 or 32)
+    // this function bins the hit_t by diagonals by distributing each hit in an array of 256 * 16(sse)/32(avx2)/64(avx512)
+    // the function scoreDiagonalAndUpdateHits is called for each bin that reaches its maximum (16, 32 or 64)
     void computeScores(const char *queryProfile,
                        const unsigned int queryLen,
                        CounterResult * results,
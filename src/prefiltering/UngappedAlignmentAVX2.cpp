@@ -0,0 +1,29 @@
+#include "UngappedAlignmentAVX2.h"
+
+#include <immintrin.h>
+
+void UngappedAlignmentAVX2::vectorDiagonalScoring(const char *profile, const char bias, const unsigned int seqLen,
+                                                    const unsigned char *dbSeq, unsigned int *scores) {
+    __m256i vscore = _mm256_setzero_si256();
+    __m256i vMaxScore = _mm256_setzero_si256();
+    const __m256i vBias = _mm256_set1_epi8(bias);
+    const __m256i fiveten = _mm256_set1_epi8(15);
+    for (unsigned int pos = 0; pos < seqLen; pos++) {
+        const __m256i template01 = _mm256_load_si256((const __m256i *) &dbSeq[pos * LANES]);
+        // scores 0 - 15 and 16 - 31 of the position in both 128-bit lanes
+        const __m256i score_matrix_vec01 = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *) &profile[pos * 32]));
+        const __m256i score_matrix_vec16 = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *) &profile[pos * 32 + 16]));
+        const __m256i lookup_mask16 = _mm256_cmpgt_epi8(template01, fiveten);
+        const __m256i score_vec_8bit = _mm256_blendv_epi8(_mm256_shuffle_epi8(score_matrix_vec01, template01),
+                                                          _mm256_shuffle_epi8(score_matrix_vec16, template01),
+                                                          lookup_mask16);
+        vscore = _mm256_adds_epu8(vscore, score_vec_8bit);
+        vscore = _mm256_subs_epu8(vscore, vBias);
+        vMaxScore = _mm256_max_epu8(vMaxScore, vscore);
+    }
+    unsigned char maxScores[LANES] __attribute__((aligned(32)));
+    _mm256_store_si256((__m256i *) maxScores, vMaxScore);
+    for (unsigned int i = 0; i < LANES; i++) {
+        scores[i] = maxScores[i];
+    }
+}
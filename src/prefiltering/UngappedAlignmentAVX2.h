@@ -0,0 +1,16 @@
+#ifndef MMSEQS_UNGAPPEDALIGNMENTAVX2_H
+#define MMSEQS_UNGAPPEDALIGNMENTAVX2_H
+
+// 256-bit version of UngappedAlignment::vectorDiagonalScoring. This translation unit is compiled with
+// AVX2 code generation, it is only called through SimdDispatch::kernels().
+class UngappedAlignmentAVX2 {
+public:
+    static const unsigned int LANES = 32;
+
+    // scores the diagonal of 32 db sequences in parallel, dbSeq holds one byte per sequence and position
+    // (32 byte aligned), the profile 32 scores per query position
+    static void vectorDiagonalScoring(const char *profile, const char bias, const unsigned int seqLen,
+                                      const unsigned char *dbSeq, unsigned int *scores);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include "UngappedAlignmentAVX512.h"
+
+#include <immintrin.h>
+
+void UngappedAlignmentAVX512::vectorDiagonalScoring(const char *profile, const char bias, const unsigned int seqLen,
+                                                    const unsigned char *dbSeq, unsigned int *scores) {
+    __m512i vscore = _mm512_setzero_si512();
+    __m512i vMaxScore = _mm512_setzero_si512();
+    const __m512i vBias = _mm512_set1_epi8(bias);
+    const __m512i fiveten = _mm512_set1_epi8(15);
+    for (unsigned int pos = 0; pos < seqLen; pos++) {
+        const __m512i template01 = _mm512_load_si512((const __m512i *) &dbSeq[pos * LANES]);
+        // scores 0 - 15 and 16 - 31 of the position in every 128-bit lane
+        const __m512i score_matrix_vec01 = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_load_si128((const __m128i *) &profile[pos * 32]));
+        const __m512i score_matrix_vec16 = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_load_si128((const __m128i *) &profile[pos * 32 + 16]));
+        const __mmask64 lookup_mask16 = _mm512_cmpgt_epi8_mask(template01, fiveten);
+        const __m512i score_vec_8bit = _mm512_mask_blend_epi8(lookup_mask16,
+                                                              _mm512_shuffle_epi8(score_matrix_vec01, template01),
+                                                              _mm512_shuffle_epi8(score_matrix_vec16, template01));
+        vscore = _mm512_adds_epu8(vscore, score_vec_8bit);
+        vscore = _mm512_subs_epu8(vscore, vBias);
+        vMaxScore = _mm512_max_epu8(vMaxScore, vscore);
+    }
+    unsigned char maxScores[LANES] __attribute__((aligned(64)));
+    _mm512_store_si512((__m512i *) maxScores, vMaxScore);
+    for (unsigned int i = 0; i < LANES; i++) {
+        scores[i] = maxScores[i];
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef MMSEQS_UNGAPPEDALIGNMENTAVX512_H
+#define MMSEQS_UNGAPPEDALIGNMENTAVX512_H
+
+// 512-bit version of UngappedAlignment::vectorDiagonalScoring. This translation unit is compiled with
+// AVX-512 code generation, it is only called through SimdDispatch::kernels().
+class UngappedAlignmentAVX512 {
+public:
+    static const unsigned int LANES = 64;
+
+    // scores the diagonal of 64 db sequences in parallel, dbSeq holds one byte per sequence and position
+    // (64 byte aligned), the profile 32 scores per query position
+    static void vectorDiagonalScoring(const char *profile, const char bias, const unsigned int seqLen,
+                                      const unsigned char *dbSeq, unsigned int *scores);
+};
+
+#endif
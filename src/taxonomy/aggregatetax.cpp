@@ -22,6 +22,7 @@ int aggregate(const bool useAln, int argc, const char **argv, const Command& com
     // open mapping of set to sequence
     DBReader<unsigned int> setToSeqReader(par.db2.c_str(), par.db2Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     setToSeqReader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    setToSeqReader.requireTextResult("aggregatetax");
 
     // open tax assignments per sequence
     DBReader<unsigned int> taxSeqReader(par.db3.c_str(), par.db3Index.c_str(), par.threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
@@ -32,6 +33,7 @@ int aggregate(const bool useAln, int argc, const char **argv, const Command& com
     if (useAln == true) {
         alnSeqReader = new DBReader<unsigned int>(par.db4.c_str(), par.db4Index.c_str(), par.threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
         alnSeqReader->open(DBReader<unsigned int>::NOSORT);
+        alnSeqReader->requireTextResult("aggregatetax");
     }
 
     // output is either db4 or db5
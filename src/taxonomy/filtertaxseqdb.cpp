@@ -21,7 +21,9 @@ int filtertaxseqdb(int argc, const char **argv, const Command& command) {
     
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
-    const bool isCompressed = reader.isCompressed();
+    // entries of block compressed databases are copied decompressed
+    const bool isBlockCompressed = reader.isBlockCompressed();
+    const bool isCompressed = reader.isCompressed() && isBlockCompressed == false;
 
     DBWriter writer(par.db2.c_str(), par.db2Index.c_str(), par.threads, 0, Parameters::DBTYPE_OMIT_FILE);
     writer.open();
@@ -57,7 +59,7 @@ int filtertaxseqdb(int argc, const char **argv, const Command& command) {
                 if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
                     writer.writeIndexEntry(key, offset, length, thread_idx);
                 } else {
-                    char* data = reader.getDataUncompressed(i);
+                    char* data = isBlockCompressed ? reader.getData(i, thread_idx) : reader.getDataUncompressed(i);
                     size_t originalLength = reader.getEntryLen(i);
                     size_t entryLength = std::max(originalLength, static_cast<size_t>(1)) - 1;
 
@@ -80,6 +82,9 @@ int filtertaxseqdb(int argc, const char **argv, const Command& command) {
         DBReader<unsigned int>::softlinkDb(par.db1, par.db2, DBFiles::SEQUENCE_NO_DATA_INDEX);
     } else {
         DBWriter::writeDbtypeFile(par.db2.c_str(), reader.getDbtype(), isCompressed);
+        if (isCompressed) {
+            DBReader<unsigned int>::copyDictionary(par.db1, par.db2);
+        }
         DBReader<unsigned int>::softlinkDb(par.db1, par.db2, DBFiles::SEQUENCE_ANCILLARY);
     }
 
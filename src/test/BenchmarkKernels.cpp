@@ -0,0 +1,882 @@
+// Benchmarks of the hot kernels on deterministic synthetic data.
+//
+// benchmark_kernels [--filter <substring>] [--min-time <seconds>] [--repeats <n>] [--tmp <dir>] [--out <file>]
+//     runs all benchmarks whose "name/case" contains the filter and writes one TSV line per case
+// benchmark_kernels compare <baseline.tsv> <current.tsv> [--threshold <fraction>]
+//     compares two runs, exits with 1 if a case got slower by more than the threshold (default 0.05)
+//     or its checksum changed
+//
+// Every case reports the median time per operation over all repeats and a checksum of the results,
+// which has to be the same on every platform and SIMD level.
+#include "Parameters.h"
+#include "SubstitutionMatrix.h"
+#include "NucleotideMatrix.h"
+#include "ExtendedSubstitutionMatrix.h"
+#include "Sequence.h"
+#include "KmerGenerator.h"
+#include "IndexTable.h"
+#include "IndexBuilder.h"
+#include "SequenceLookup.h"
+#include "QueryMatcher.h"
+#include "Prefiltering.h"
+#include "PrefilteringIndexReader.h"
+#include "UngappedAlignment.h"
+#include "StripedSmithWaterman.h"
+#include "BandedNucleotideAligner.h"
+#include "EvalueComputation.h"
+#include "DBReader.h"
+#include "DBWriter.h"
+#include "KmerPositionSort.h"
+#include "FileUtil.h"
+#include "SimdDispatch.h"
+#include "Timer.h"
+#include "Debug.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const char* binary_name = "benchmark_kernels";
+// the Prefiltering helpers used below link the index reader that checks it
+const char* index_version_compatible = MMSEQS_INDEX_VERSION;
+
+// the C library generators differ between platforms, the inputs must not
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint32_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<uint32_t>(state >> 33);
+    }
+
+    // uniform in [0, 1)
+    double uniform() {
+        return next() / 2147483648.0;
+    }
+
+private:
+    uint64_t state;
+};
+
+// samples residues with the background frequencies of a matrix, X is never sampled
+class ResidueSampler {
+public:
+    ResidueSampler(const BaseMatrix &matrix, int residues) {
+        double sum = 0;
+        for (int i = 0; i < residues; ++i) {
+            sum += matrix.pBack[i];
+            letters.push_back(matrix.num2aa[i]);
+            cumulative.push_back(sum);
+        }
+        for (size_t i = 0; i < cumulative.size(); ++i) {
+            cumulative[i] /= sum;
+        }
+    }
+
+    char sample(Random &rng) const {
+        const double r = rng.uniform();
+        size_t i = std::lower_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin();
+        return letters[std::min(i, letters.size() - 1)];
+    }
+
+    std::string sequence(Random &rng, size_t length) const {
+        std::string seq;
+        seq.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            seq.push_back(sample(rng));
+        }
+        return seq;
+    }
+
+    // homolog with roughly the given identity and 2% insertions and deletions each
+    std::string mutate(Random &rng, const std::string &seq, double identity) const {
+        std::string out;
+        out.reserve(seq.size() + seq.size() / 10);
+        for (size_t i = 0; i < seq.size(); ++i) {
+            const double r = rng.uniform();
+            if (r < 0.02) {
+                continue;
+            } else if (r < 0.04) {
+                out.push_back(sample(rng));
+                out.push_back(seq[i]);
+            } else if (r < 0.04 + (1.0 - identity)) {
+                out.push_back(sample(rng));
+            } else {
+                out.push_back(seq[i]);
+            }
+        }
+        return out;
+    }
+
+private:
+    std::vector<char> letters;
+    std::vector<double> cumulative;
+};
+
+struct Result {
+    std::string name;
+    std::string param;
+    std::string unit;
+    double unitsPerOp;
+    double nsPerOp;
+    size_t checksum;
+};
+
+class Runner {
+public:
+    Runner(const std::string &filter, double minTime, size_t repeats) : filter(filter), minTime(minTime), repeats(repeats) {}
+
+    bool selected(const std::string &name, const std::string &param = "") const {
+        if (filter.empty()) {
+            return true;
+        }
+        const std::string full = name + "/" + param;
+        if (param.empty()) {
+            // a group is set up if any of its cases can match
+            return full.find(filter) != std::string::npos || filter.find(name + "/") == 0 || name.find(filter) != std::string::npos;
+        }
+        return full.find(filter) != std::string::npos;
+    }
+
+    // op runs one operation and adds to the checksum, prepare restores its input outside of the timing
+    void run(const std::string &name, const std::string &param, const std::string &unit, double unitsPerOp,
+             const std::function<void(size_t &)> &op, const std::function<void()> &prepare = std::function<void()>()) {
+        if (selected(name, param) == false) {
+            return;
+        }
+        // the first operation is a warm up and defines the checksum
+        size_t checksum = 0;
+        if (prepare) {
+            prepare();
+        }
+        op(checksum);
+
+        std::vector<double> perOp;
+        const double repeatTime = minTime / repeats;
+        for (size_t r = 0; r < repeats; ++r) {
+            double elapsed = 0;
+            size_t ops = 0;
+            while (elapsed < repeatTime || ops == 0) {
+                if (prepare) {
+                    prepare();
+                }
+                size_t ignored = 0;
+                Timer timer;
+                op(ignored);
+                elapsed += timer.getTimediff();
+                ops++;
+            }
+            perOp.push_back(elapsed / ops);
+        }
+        std::sort(perOp.begin(), perOp.end());
+        Result result;
+        result.name = name;
+        result.param = param;
+        result.unit = unit;
+        result.unitsPerOp = unitsPerOp;
+        result.nsPerOp = perOp[perOp.size() / 2] * 1e9;
+        result.checksum = checksum;
+        results.push_back(result);
+        // progress goes to stderr, the results to stdout
+        std::cerr << name << "/" << param << "\t" << (result.nsPerOp / 1e6) << " ms/op\t"
+                  << (unitsPerOp / perOp[perOp.size() / 2] / 1e6) << " M" << unit << "/s\n";
+    }
+
+    std::vector<Result> results;
+
+private:
+    std::string filter;
+    double minTime;
+    size_t repeats;
+};
+
+static std::string formatParam(const char *key1, int value1, const char *key2 = NULL, int value2 = 0) {
+    std::ostringstream ss;
+    ss << key1 << "=" << value1;
+    if (key2 != NULL) {
+        ss << "," << key2 << "=" << value2;
+    }
+    return ss.str();
+}
+
+static void writeSequenceDb(const std::string &name, const std::vector<std::string> &sequences, int dbtype) {
+    DBWriter writer(name.c_str(), (name + ".index").c_str(), 1, Parameters::WRITER_ASCII_MODE, dbtype);
+    writer.open();
+    std::string entry;
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        entry = sequences[i];
+        entry.push_back('\n');
+        writer.writeData(entry.c_str(), entry.size(), i, 0);
+    }
+    writer.close(true);
+}
+
+static void removeDb(const std::string &name) {
+    const std::string files[] = { name, name + ".index", name + ".dbtype" };
+    for (size_t i = 0; i < 3; ++i) {
+        if (FileUtil::fileExists(files[i].c_str())) {
+            FileUtil::remove(files[i].c_str());
+        }
+    }
+}
+
+static const int QUERY_LENGTHS[] = { 100, 300, 1000 };
+static const int AA_ALPHABETS[] = { 21, 13 };
+
+static BaseMatrix *getAminoAcidMatrix(Parameters &par, int alphabetSize, float bitFactor) {
+    MultiParam<NuclAA<int>> alphabet(NuclAA<int>(alphabetSize, 5));
+    return Prefiltering::getSubstitutionMatrix(par.scoringMatrixFile, alphabet, bitFactor, false, false);
+}
+
+static void benchKmerGenerator(Runner &runner, Parameters &par) {
+    if (runner.selected("kmergenerator") == false) {
+        return;
+    }
+    const int kmerSizes[] = { 6, 7 };
+    for (size_t a = 0; a < sizeof(AA_ALPHABETS) / sizeof(int); ++a) {
+        for (size_t k = 0; k < sizeof(kmerSizes) / sizeof(int); ++k) {
+            const int alphabetSize = AA_ALPHABETS[a];
+            const int kmerSize = kmerSizes[k];
+            const std::string param = formatParam("alph", alphabetSize, "k", kmerSize);
+            if (runner.selected("kmergenerator", param) == false) {
+                continue;
+            }
+            BaseMatrix *subMat = getAminoAcidMatrix(par, alphabetSize, 8.0);
+            Random rng(1);
+            ResidueSampler sampler(*subMat, subMat->alphabetSize - 1);
+            const std::string query = sampler.sequence(rng, 1000);
+
+            subMat->alphabetSize = subMat->alphabetSize - 1;
+            ScoreMatrix two = ExtendedSubstitutionMatrix::calcScoreMatrix(*subMat, 2);
+            ScoreMatrix three = ExtendedSubstitutionMatrix::calcScoreMatrix(*subMat, 3);
+            subMat->alphabetSize = subMat->alphabetSize + 1;
+            const short kmerThr = Prefiltering::getKmerThreshold(5.7, false, false, par.kmerScore.values, kmerSize);
+            KmerGenerator generator(kmerSize, subMat->alphabetSize - 1, kmerThr);
+            generator.setDivideStrategy(&three, &two);
+
+            Sequence seq(query.size(), Parameters::DBTYPE_AMINO_ACIDS, subMat, kmerSize, false, false);
+            seq.mapSequence(0, 0, query.c_str(), query.size());
+            size_t kmers = 0;
+            while (seq.hasNextKmer()) {
+                kmers += generator.generateKmerList(seq.nextKmer()).second;
+            }
+            runner.run("kmergenerator", param, "kmers", kmers, [&](size_t &checksum) {
+                seq.resetCurrPos();
+                while (seq.hasNextKmer()) {
+                    std::pair<size_t *, size_t> list = generator.generateKmerList(seq.nextKmer());
+                    checksum += list.second;
+                    if (list.second > 0) {
+                        checksum += list.first[0];
+                    }
+                }
+            });
+            ExtendedSubstitutionMatrix::freeScoreMatrix(three);
+            ExtendedSubstitutionMatrix::freeScoreMatrix(two);
+            delete subMat;
+        }
+    }
+}
+
+static void benchQueryMatcher(Runner &runner, Parameters &par, const std::string &tmpDir) {
+    if (runner.selected("querymatcher") == false) {
+        return;
+    }
+    const int kmerSize = 6;
+    const size_t dbSize = 20000;
+    const size_t queries = 20;
+    for (size_t a = 0; a < sizeof(AA_ALPHABETS) / sizeof(int); ++a) {
+        const int alphabetSize = AA_ALPHABETS[a];
+        bool any = false;
+        for (size_t l = 0; l < sizeof(QUERY_LENGTHS) / sizeof(int); ++l) {
+            any |= runner.selected("querymatcher", formatParam("alph", alphabetSize, "len", QUERY_LENGTHS[l]));
+        }
+        if (any == false) {
+            continue;
+        }
+        BaseMatrix *kmerSubMat = getAminoAcidMatrix(par, alphabetSize, 8.0);
+        BaseMatrix *ungappedSubMat = getAminoAcidMatrix(par, alphabetSize, 2.0);
+        Random rng(2);
+        ResidueSampler sampler(*kmerSubMat, kmerSubMat->alphabetSize - 1);
+        std::vector<std::string> targets;
+        for (size_t i = 0; i < dbSize; ++i) {
+            targets.push_back(sampler.sequence(rng, 50 + rng.next() % 500));
+        }
+        const std::string dbName = tmpDir + "/querymatcher_db";
+        writeSequenceDb(dbName, targets, Parameters::DBTYPE_AMINO_ACIDS);
+        DBReader<unsigned int> tdbr(dbName.c_str(), (dbName + ".index").c_str(), 1, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
+        tdbr.open(DBReader<unsigned int>::NOSORT);
+
+        const short kmerThr = Prefiltering::getKmerThreshold(5.7, false, false, par.kmerScore.values, kmerSize);
+        IndexTable indexTable(kmerSubMat->alphabetSize - 1, kmerSize, false);
+        SequenceLookup *sequenceLookup = NULL;
+        Sequence tseq(tdbr.getMaxSeqLen(), Parameters::DBTYPE_AMINO_ACIDS, kmerSubMat, kmerSize, false, true);
+        IndexBuilder::fillDatabase(&indexTable, NULL, &sequenceLookup, *kmerSubMat, &tseq, &tdbr, 0, tdbr.getSize(), kmerThr, false, false, 0.9);
+
+        kmerSubMat->alphabetSize = kmerSubMat->alphabetSize - 1;
+        ScoreMatrix two = ExtendedSubstitutionMatrix::calcScoreMatrix(*kmerSubMat, 2);
+        ScoreMatrix three = ExtendedSubstitutionMatrix::calcScoreMatrix(*kmerSubMat, 3);
+        kmerSubMat->alphabetSize = kmerSubMat->alphabetSize + 1;
+
+        for (size_t l = 0; l < sizeof(QUERY_LENGTHS) / sizeof(int); ++l) {
+            const int length = QUERY_LENGTHS[l];
+            const std::string param = formatParam("alph", alphabetSize, "len", length);
+            if (runner.selected("querymatcher", param) == false) {
+                continue;
+            }
+            // queries are homologs of db sequences, so that diagonals get matched and scored
+            std::vector<Sequence *> querySeqs;
+            double residues = 0;
+            for (size_t i = 0; i < queries; ++i) {
+                std::string source = targets[rng.next() % dbSize];
+                while (source.size() < static_cast<size_t>(length)) {
+                    source += sampler.sequence(rng, length - source.size());
+                }
+                const std::string query = sampler.mutate(rng, source.substr(0, length), 0.5);
+                Sequence *seq = new Sequence(length * 2, Parameters::DBTYPE_AMINO_ACIDS, kmerSubMat, kmerSize, false, true);
+                seq->mapSequence(i, i, query.c_str(), query.size());
+                querySeqs.push_back(seq);
+                residues += query.size();
+            }
+            QueryMatcher matcher(&indexTable, sequenceLookup, kmerSubMat, ungappedSubMat, kmerThr, kmerSize, dbSize,
+                                 std::max(tdbr.getMaxSeqLen(), static_cast<unsigned int>(length * 2)), 300, true, 1.0, true, 15, false, false);
+            matcher.setSubstitutionMatrix(&three, &two);
+            runner.run("querymatcher", param, "residues", residues, [&](size_t &checksum) {
+                for (size_t i = 0; i < querySeqs.size(); ++i) {
+                    querySeqs[i]->resetCurrPos();
+                    std::pair<hit_t *, size_t> hits = matcher.matchQuery(querySeqs[i], UINT_MAX, false);
+                    checksum += hits.second;
+                    for (size_t j = 0; j < hits.second; ++j) {
+                        checksum += hits.first[j].seqId * 31 + hits.first[j].prefScore;
+                    }
+                }
+            });
+            // same queries looked up in k-mer order, the checksum has to match the unbatched case
+            runner.run("querymatcher", param + ",batch=" + SSTR(queries), "residues", residues, [&](size_t &checksum) {
+                matcher.clearBatch();
+                for (size_t i = 0; i < querySeqs.size(); ++i) {
+                    matcher.addToBatch(querySeqs[i]);
+                }
+                matcher.sweepBatch();
+                for (size_t i = 0; i < querySeqs.size(); ++i) {
+                    querySeqs[i]->resetCurrPos();
+                    std::pair<hit_t *, size_t> hits = matcher.matchQuery(querySeqs[i], UINT_MAX, false);
+                    checksum += hits.second;
+                    for (size_t j = 0; j < hits.second; ++j) {
+                        checksum += hits.first[j].seqId * 31 + hits.first[j].prefScore;
+                    }
+                }
+            });
+            // repeated runs reuse the cached k-mer lists, the checksum has to match the uncached case
+            matcher.setKmerCacheSize(64 * 1024 * 1024);
+            runner.run("querymatcher", param + ",cache=64M", "residues", residues, [&](size_t &checksum) {
+                for (size_t i = 0; i < querySeqs.size(); ++i) {
+                    querySeqs[i]->resetCurrPos();
+                    std::pair<hit_t *, size_t> hits = matcher.matchQuery(querySeqs[i], UINT_MAX, false);
+                    checksum += hits.second;
+                    for (size_t j = 0; j < hits.second; ++j) {
+                        checksum += hits.first[j].seqId * 31 + hits.first[j].prefScore;
+                    }
+                }
+            });
+            matcher.setKmerCacheSize(0);
+            for (size_t i = 0; i < querySeqs.size(); ++i) {
+                delete querySeqs[i];
+            }
+        }
+        ExtendedSubstitutionMatrix::freeScoreMatrix(three);
+        ExtendedSubstitutionMatrix::freeScoreMatrix(two);
+        delete sequenceLookup;
+        tdbr.close();
+        removeDb(dbName);
+        delete ungappedSubMat;
+        delete kmerSubMat;
+    }
+}
+
+static void benchUngappedAlignment(Runner &runner, Parameters &par) {
+    if (runner.selected("ungapped") == false) {
+        return;
+    }
+    SubstitutionMatrix subMat(par.scoringMatrixFile.values.aminoacid().c_str(), 2.0, 0.0);
+    ResidueSampler sampler(subMat, subMat.alphabetSize - 1);
+    const size_t targets = 4096;
+    for (size_t l = 0; l < sizeof(QUERY_LENGTHS) / sizeof(int); ++l) {
+        const int length = QUERY_LENGTHS[l];
+        const std::string param = formatParam("len", length);
+        if (runner.selected("ungapped", param) == false) {
+            continue;
+        }
+        Random rng(3);
+        const std::string query = sampler.sequence(rng, length);
+        std::vector<std::string> sequences;
+        size_t residues = 0;
+        for (size_t i = 0; i < targets; ++i) {
+            sequences.push_back((i % 4 == 0) ? sampler.mutate(rng, query, 0.4) : sampler.sequence(rng, length));
+            residues += sequences.back().size();
+        }
+        SequenceLookup lookup(targets, residues);
+        Sequence tseq(length * 2, Parameters::DBTYPE_AMINO_ACIDS, &subMat, 0, false, false);
+        for (size_t i = 0; i < targets; ++i) {
+            tseq.mapSequence(i, i, sequences[i].c_str(), sequences[i].size());
+            lookup.addSequence(&tseq);
+        }
+        lookup.getOffsets()[targets] = residues;
+
+        Sequence qseq(length * 2, Parameters::DBTYPE_AMINO_ACIDS, &subMat, 0, false, false);
+        qseq.mapSequence(0, 0, query.c_str(), query.size());
+        UngappedAlignment ungapped(length * 2, &subMat, &lookup);
+        std::vector<float> bias(length * 2, 0.0f);
+        std::vector<CounterResult> results(targets);
+        std::vector<unsigned short> diagonals(targets);
+        for (size_t i = 0; i < targets; ++i) {
+            diagonals[i] = static_cast<unsigned short>(rng.next() % 8);
+        }
+        runner.run("ungapped", param, "residues", residues, [&](size_t &checksum) {
+            ungapped.processQuery(&qseq, bias.data(), results.data(), targets);
+            for (size_t i = 0; i < targets; ++i) {
+                checksum += results[i].count;
+            }
+        }, [&]() {
+            for (size_t i = 0; i < targets; ++i) {
+                results[i].id = i;
+                results[i].diagonal = diagonals[i];
+                results[i].count = 0;
+            }
+        });
+
+        // same targets decoded from a bit packed lookup, the checksum has to match the unpacked case
+        SequenceLookup packedLookup(targets, residues);
+        for (size_t i = 0; i < targets; ++i) {
+            tseq.mapSequence(i, i, sequences[i].c_str(), sequences[i].size());
+            packedLookup.addSequence(&tseq);
+        }
+        packedLookup.getOffsets()[targets] = residues;
+        packedLookup.pack();
+        UngappedAlignment packedUngapped(length * 2, &subMat, &packedLookup);
+        runner.run("ungapped", param + ",packed", "residues", residues, [&](size_t &checksum) {
+            packedUngapped.processQuery(&qseq, bias.data(), results.data(), targets);
+            for (size_t i = 0; i < targets; ++i) {
+                checksum += results[i].count;
+            }
+        }, [&]() {
+            for (size_t i = 0; i < targets; ++i) {
+                results[i].id = i;
+                results[i].diagonal = diagonals[i];
+                results[i].count = 0;
+            }
+        });
+    }
+}
+
+static void benchSmithWaterman(Runner &runner, Parameters &par) {
+    if (runner.selected("smithwaterman") == false) {
+        return;
+    }
+    SubstitutionMatrix subMat(par.scoringMatrixFile.values.aminoacid().c_str(), 2.0, 0.0);
+    ResidueSampler sampler(subMat, subMat.alphabetSize - 1);
+    std::vector<int8_t> tinySubMat(subMat.alphabetSize * subMat.alphabetSize);
+    for (int i = 0; i < subMat.alphabetSize; i++) {
+        for (int j = 0; j < subMat.alphabetSize; j++) {
+            tinySubMat[i * subMat.alphabetSize + j] = static_cast<int8_t>(subMat.subMatrix[i][j]);
+        }
+    }
+    const int gapOpen = par.gapOpen.values.aminoacid();
+    const int gapExtend = par.gapExtend.values.aminoacid();
+    EvalueComputation evaluer(100000000, &subMat, gapOpen, gapExtend);
+    const size_t targets = 64;
+    // mode 0 computes score and end position, mode 3 adds start position and backtrace
+    const int modes[] = { 0, 3 };
+    const char *modeNames[] = { "score", "backtrace" };
+    for (size_t m = 0; m < 2; ++m) {
+        for (size_t l = 0; l < sizeof(QUERY_LENGTHS) / sizeof(int); ++l) {
+            const int length = QUERY_LENGTHS[l];
+            const std::string param = std::string("mode=") + modeNames[m] + "," + formatParam("len", length);
+            if (runner.selected("smithwaterman", param) == false) {
+                continue;
+            }
+            Random rng(4);
+            const std::string query = sampler.sequence(rng, length);
+            Sequence qseq(length * 2, Parameters::DBTYPE_AMINO_ACIDS, &subMat, 0, false, false);
+            qseq.mapSequence(0, 0, query.c_str(), query.size());
+            std::vector<Sequence *> tseqs;
+            double cells = 0;
+            for (size_t i = 0; i < targets; ++i) {
+                const std::string target = (i % 2 == 0) ? sampler.mutate(rng, query, 0.3 + 0.01 * i) : sampler.sequence(rng, length);
+                Sequence *tseq = new Sequence(length * 2, Parameters::DBTYPE_AMINO_ACIDS, &subMat, 0, false, false);
+                tseq->mapSequence(i, i, target.c_str(), target.size());
+                tseqs.push_back(tseq);
+                cells += static_cast<double>(qseq.L) * tseq->L;
+            }
+            SmithWaterman aligner(length * 2, subMat.alphabetSize, false, 1.0, Parameters::DBTYPE_AMINO_ACIDS);
+            aligner.ssw_init(&qseq, tinySubMat.data(), &subMat);
+            std::string backtrace;
+            runner.run("smithwaterman", param, "cells", cells, [&](size_t &checksum) {
+                for (size_t i = 0; i < tseqs.size(); ++i) {
+                    backtrace.clear();
+                    s_align aln = aligner.ssw_align(tseqs[i]->numSequence, tseqs[i]->numConsensusSequence,
+                                                    tseqs[i]->getAlignmentProfile(), tseqs[i]->L, backtrace,
+                                                    gapOpen, gapExtend, modes[m], 1000000, &evaluer, 0, 0.0, 0.0,
+                                                    qseq.L / 2, i);
+                    checksum += aln.score1 * 7 + aln.qEndPos1 * 3 + aln.dbEndPos1 + backtrace.size();
+                    if (modes[m] != 0) {
+                        checksum += aln.qStartPos1 + aln.dbStartPos1;
+                    }
+                }
+            });
+            for (size_t i = 0; i < tseqs.size(); ++i) {
+                delete tseqs[i];
+            }
+        }
+    }
+}
+
+static void benchBandedNucleotide(Runner &runner, Parameters &par) {
+    if (runner.selected("banded") == false) {
+        return;
+    }
+    NucleotideMatrix subMat(par.scoringMatrixFile.values.nucleotide().c_str(), 1.0, 0.0);
+    ResidueSampler sampler(subMat, 4);
+    const int gapOpen = par.gapOpen.values.nucleotide();
+    const int gapExtend = par.gapExtend.values.nucleotide();
+    EvalueComputation evaluer(100000000, &subMat, gapOpen, gapExtend);
+    const size_t targets = 64;
+    for (size_t l = 0; l < sizeof(QUERY_LENGTHS) / sizeof(int); ++l) {
+        const int length = QUERY_LENGTHS[l];
+        const std::string param = formatParam("len", length);
+        if (runner.selected("banded", param) == false) {
+            continue;
+        }
+        Random rng(5);
+        const std::string query = sampler.sequence(rng, length);
+        Sequence qseq(length * 2, Parameters::DBTYPE_NUCLEOTIDES, &subMat, 0, false, false);
+        qseq.mapSequence(0, 0, query.c_str(), query.size());
+        std::vector<Sequence *> tseqs;
+        double bases = 0;
+        for (size_t i = 0; i < targets; ++i) {
+            const std::string target = sampler.mutate(rng, query, 0.7 + 0.004 * i);
+            Sequence *tseq = new Sequence(length * 2, Parameters::DBTYPE_NUCLEOTIDES, &subMat, 0, false, false);
+            tseq->mapSequence(i, i, target.c_str(), target.size());
+            tseqs.push_back(tseq);
+            bases += tseq->L;
+        }
+        BandedNucleotideAligner aligner(&subMat, length * 2, gapOpen, gapExtend, par.zdrop);
+        aligner.initQuery(&qseq);
+        std::string backtrace;
+        runner.run("banded", param, "bases", bases, [&](size_t &checksum) {
+            for (size_t i = 0; i < tseqs.size(); ++i) {
+                backtrace.clear();
+                s_align aln = aligner.align(tseqs[i], 0, false, backtrace, &evaluer);
+                checksum += aln.score1 * 7 + aln.qStartPos1 * 5 + aln.qEndPos1 * 3 + aln.dbEndPos1 + backtrace.size();
+            }
+        });
+        for (size_t i = 0; i < tseqs.size(); ++i) {
+            delete tseqs[i];
+        }
+    }
+}
+
+// k-mers of sequence families as linclust extracts them, sorted with the radix and the comparison sort
+static void benchKmerSort(Runner &runner, Parameters &par) {
+    if (runner.selected("kmersort") == false) {
+        return;
+    }
+    const size_t families = 4000;
+    const size_t members = 10;
+    const size_t kmerSize = 10;
+    const size_t kmersPerSeq = 21;
+    BaseMatrix *subMat = getAminoAcidMatrix(par, 21, 2.0);
+    Random rng(7);
+    ResidueSampler sampler(*subMat, subMat->alphabetSize - 1);
+    std::vector<KmerPosition<short>> input;
+    std::vector<std::pair<size_t, short>> kmers;
+    for (size_t f = 0; f < families; ++f) {
+        const std::string root = sampler.sequence(rng, 100 + rng.next() % 400);
+        for (size_t m = 0; m < members; ++m) {
+            const std::string seq = (m == 0) ? root : sampler.mutate(rng, root, 0.9);
+            kmers.clear();
+            for (size_t pos = 0; pos + kmerSize <= seq.size(); ++pos) {
+                kmers.push_back(std::make_pair(Util::hash(seq.c_str() + pos, kmerSize), static_cast<short>(pos)));
+            }
+            // linclust keeps the k-mers with the smallest hashes
+            std::sort(kmers.begin(), kmers.end());
+            for (size_t i = 0; i < std::min(kmersPerSeq, kmers.size()); ++i) {
+                KmerPosition<short> entry;
+                entry.kmer = kmers[i].first;
+                entry.id = static_cast<unsigned int>(f * members + m);
+                entry.seqLen = static_cast<short>(seq.size());
+                entry.pos = kmers[i].second;
+                input.push_back(entry);
+            }
+        }
+    }
+    delete subMat;
+
+    // groups as assigned after the first sort: the longest sequence is the representative, pos the diagonal
+    std::vector<KmerPosition<short>> groups(input);
+    SORT_PARALLEL(groups.begin(), groups.end(), KmerPosition<short>::compareRepSequenceAndIdAndPos);
+    for (size_t start = 0; start < groups.size();) {
+        size_t end = start;
+        const KmerPosition<short> rep = groups[start];
+        while (end < groups.size() && groups[end].kmer == rep.kmer) {
+            groups[end].kmer = rep.id;
+            groups[end].pos = static_cast<short>(rep.pos - groups[end].pos);
+            end++;
+        }
+        start = end;
+    }
+
+    const std::string param = formatParam("entries", static_cast<int>(input.size()));
+    std::vector<KmerPosition<short>> data;
+    for (size_t order = 0; order < 2; ++order) {
+        const std::vector<KmerPosition<short>> &source = (order == 0) ? input : groups;
+        const std::string orderName = (order == 0) ? "pos," : "diag,";
+        for (size_t engine = 0; engine < 2; ++engine) {
+            const std::string engineName = (engine == 0) ? "radix," : "comparison,";
+            runner.run("kmersort", orderName + engineName + param, "entries", source.size(), [&](size_t &checksum) {
+                if (order == 0 && engine == 0) {
+                    KmerPositionSort::radixSort<KmerPositionRadixKey<short, false, true>>(data.data(), data.size());
+                } else if (order == 0) {
+                    SORT_PARALLEL(data.begin(), data.end(), KmerPosition<short>::compareRepSequenceAndIdAndPos);
+                } else if (engine == 0) {
+                    KmerPositionSort::radixSort<KmerPositionRadixKey<short, false, false>>(data.data(), data.size());
+                } else {
+                    SORT_PARALLEL(data.begin(), data.end(), KmerPosition<short>::compareRepSequenceAndIdAndDiag);
+                }
+                for (size_t i = 0; i < data.size(); ++i) {
+                    checksum += (i + 1) * (data[i].kmer + data[i].id * 3 + static_cast<unsigned short>(data[i].pos));
+                }
+            }, [&]() {
+                data = source;
+            });
+        }
+    }
+}
+
+static void benchDatabase(Runner &runner, const std::string &tmpDir) {
+    if (runner.selected("dbreader") == false && runner.selected("dbwriter") == false) {
+        return;
+    }
+    const size_t entries = 100000;
+    const size_t entryLength = 300;
+    Random rng(6);
+    std::vector<std::string> data;
+    double bytes = 0;
+    for (size_t i = 0; i < entries; ++i) {
+        std::string entry;
+        const size_t length = entryLength / 2 + rng.next() % entryLength;
+        for (size_t j = 0; j < length; ++j) {
+            entry.push_back('A' + rng.next() % 26);
+        }
+        entry.push_back('\n');
+        bytes += entry.size();
+        data.push_back(entry);
+    }
+
+    const std::string dbName = tmpDir + "/dbwriter_db";
+    const std::string param = formatParam("entries", entries);
+    runner.run("dbwriter", "writeData," + param, "bytes", bytes, [&](size_t &checksum) {
+        DBWriter writer(dbName.c_str(), (dbName + ".index").c_str(), 1, Parameters::WRITER_ASCII_MODE, Parameters::DBTYPE_GENERIC_DB);
+        writer.open();
+        for (size_t i = 0; i < entries; ++i) {
+            writer.writeData(data[i].c_str(), data[i].size(), i, 0);
+        }
+        writer.close(true);
+        checksum += FileUtil::getFileSize(dbName) + FileUtil::getFileSize(dbName + ".index");
+    }, [&]() {
+        removeDb(dbName);
+    });
+
+    // four splits with interleaved keys, as written by the target split prefilter
+    const size_t splits = 4;
+    std::vector<std::pair<std::string, std::string>> splitFiles;
+    for (size_t s = 0; s < splits; ++s) {
+        const std::string splitName = dbName + "_" + SSTR(s);
+        splitFiles.push_back(std::make_pair(splitName, splitName + ".index"));
+    }
+    runner.run("dbwriter", "mergeResults," + formatParam("entries", entries, "splits", splits), "bytes", bytes, [&](size_t &checksum) {
+        DBWriter::mergeResults(dbName, dbName + ".index", splitFiles);
+        checksum += FileUtil::getFileSize(dbName) + FileUtil::getFileSize(dbName + ".index");
+    }, [&]() {
+        removeDb(dbName);
+        for (size_t s = 0; s < splits; ++s) {
+            DBWriter writer(splitFiles[s].first.c_str(), splitFiles[s].second.c_str(), 1, Parameters::WRITER_ASCII_MODE, Parameters::DBTYPE_GENERIC_DB);
+            writer.open();
+            for (size_t i = s; i < entries; i += splits) {
+                writer.writeData(data[i].c_str(), data[i].size(), i, 0);
+            }
+            writer.close(true);
+        }
+    });
+
+    if (FileUtil::fileExists(dbName.c_str()) == false) {
+        DBWriter writer(dbName.c_str(), (dbName + ".index").c_str(), 1, Parameters::WRITER_ASCII_MODE, Parameters::DBTYPE_GENERIC_DB);
+        writer.open();
+        for (size_t i = 0; i < entries; ++i) {
+            writer.writeData(data[i].c_str(), data[i].size(), i, 0);
+        }
+        writer.close(true);
+    }
+    runner.run("dbreader", "open," + param, "entries", entries, [&](size_t &checksum) {
+        DBReader<unsigned int> reader(dbName.c_str(), (dbName + ".index").c_str(), 1, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
+        reader.open(DBReader<unsigned int>::NOSORT);
+        checksum += reader.getSize() + reader.getDataSize();
+        reader.close();
+    });
+
+    DBReader<unsigned int> reader(dbName.c_str(), (dbName + ".index").c_str(), 1, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
+    reader.open(DBReader<unsigned int>::NOSORT);
+    runner.run("dbreader", "getData," + param, "bytes", bytes, [&](size_t &checksum) {
+        for (size_t i = 0; i < reader.getSize(); ++i) {
+            const char *entry = reader.getData(i, 0);
+            checksum += static_cast<unsigned char>(entry[0]) + static_cast<unsigned char>(entry[reader.getEntryLen(i) - 2]);
+        }
+    });
+    reader.close();
+    removeDb(dbName);
+}
+
+static bool readResults(const char *file, std::map<std::string, Result> &results) {
+    std::ifstream in(file);
+    if (in.fail()) {
+        Debug(Debug::ERROR) << "Could not open " << file << "\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> columns = Util::split(line, "\t");
+        if (columns.size() < 7) {
+            Debug(Debug::ERROR) << "Invalid line in " << file << ": " << line << "\n";
+            return false;
+        }
+        Result result;
+        result.name = columns[0];
+        result.param = columns[1];
+        result.unit = columns[2];
+        result.unitsPerOp = strtod(columns[3].c_str(), NULL);
+        result.nsPerOp = strtod(columns[4].c_str(), NULL);
+        result.checksum = strtoull(columns[6].c_str(), NULL, 10);
+        results[result.name + "/" + result.param] = result;
+    }
+    return true;
+}
+
+static int compare(const char *baselineFile, const char *currentFile, double threshold) {
+    std::map<std::string, Result> baseline;
+    std::map<std::string, Result> current;
+    if (readResults(baselineFile, baseline) == false || readResults(currentFile, current) == false) {
+        return EXIT_FAILURE;
+    }
+    bool failed = false;
+    Debug(Debug::INFO) << "#case\tbaseline_ns_per_op\tcurrent_ns_per_op\tchange\tstatus\n";
+    for (std::map<std::string, Result>::const_iterator it = current.begin(); it != current.end(); ++it) {
+        std::map<std::string, Result>::const_iterator base = baseline.find(it->first);
+        if (base == baseline.end()) {
+            Debug(Debug::INFO) << it->first << "\t-\t" << SSTR(static_cast<size_t>(it->second.nsPerOp)) << "\t-\tNEW\n";
+            continue;
+        }
+        const double change = it->second.nsPerOp / base->second.nsPerOp - 1.0;
+        const char *status = "OK";
+        if (it->second.checksum != base->second.checksum) {
+            status = "CHANGED";
+            failed = true;
+        } else if (change > threshold) {
+            status = "REGRESSION";
+            failed = true;
+        } else if (change < -threshold) {
+            status = "FASTER";
+        }
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(0) << it->first << "\t" << base->second.nsPerOp << "\t" << it->second.nsPerOp << "\t"
+             << std::showpos << std::setprecision(1) << (change * 100) << "%\t" << status << "\n";
+        Debug(Debug::INFO) << line.str();
+    }
+    for (std::map<std::string, Result>::const_iterator it = baseline.begin(); it != baseline.end(); ++it) {
+        if (current.find(it->first) == current.end()) {
+            Debug(Debug::INFO) << it->first << "\t" << SSTR(static_cast<size_t>(it->second.nsPerOp)) << "\t-\t-\tMISSING\n";
+        }
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, const char **argv) {
+    if (argc >= 2 && strcmp(argv[1], "compare") == 0) {
+        if (argc < 4) {
+            Debug(Debug::ERROR) << "Usage: " << binary_name << " compare <baseline.tsv> <current.tsv> [--threshold <fraction>]\n";
+            return EXIT_FAILURE;
+        }
+        double threshold = 0.05;
+        for (int i = 4; i + 1 < argc; i += 2) {
+            if (strcmp(argv[i], "--threshold") == 0) {
+                threshold = strtod(argv[i + 1], NULL);
+            }
+        }
+        return compare(argv[2], argv[3], threshold);
+    }
+
+    std::string filter;
+    std::string tmpDir = "/tmp";
+    std::string outFile;
+    double minTime = 1.0;
+    size_t repeats = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && strcmp(argv[i], "--filter") == 0) {
+            filter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--min-time") == 0) {
+            minTime = strtod(argv[++i], NULL);
+        } else if (i + 1 < argc && strcmp(argv[i], "--repeats") == 0) {
+            repeats = std::max(1, atoi(argv[++i]));
+        } else if (i + 1 < argc && strcmp(argv[i], "--tmp") == 0) {
+            tmpDir = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--out") == 0) {
+            outFile = argv[++i];
+        } else {
+            Debug(Debug::ERROR) << "Usage: " << binary_name << " [--filter <substring>] [--min-time <seconds>] [--repeats <n>] [--tmp <dir>] [--out <file>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    Parameters &par = Parameters::getInstance();
+    par.initMatrices();
+    // keep the DBWriter and DBReader messages out of the results
+    Debug::setDebugLevel(Debug::WARNING);
+
+    Runner runner(filter, minTime, repeats);
+    benchKmerGenerator(runner, par);
+    benchQueryMatcher(runner, par, tmpDir);
+    benchUngappedAlignment(runner, par);
+    benchSmithWaterman(runner, par);
+    benchBandedNucleotide(runner, par);
+    benchKmerSort(runner, par);
+    benchDatabase(runner, tmpDir);
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "# simd=" << SimdDispatch::kernelName() << " baseline=" << SimdDispatch::baselineName() << "\n";
+    out << "#name\tcase\tunit\tunits_per_op\tns_per_op\tunits_per_s\tchecksum\n";
+    for (size_t i = 0; i < runner.results.size(); ++i) {
+        const Result &r = runner.results[i];
+        out << r.name << "\t" << r.param << "\t" << r.unit << "\t" << r.unitsPerOp << "\t" << r.nsPerOp << "\t"
+            << (r.unitsPerOp / (r.nsPerOp * 1e-9)) << "\t" << r.checksum << "\n";
+    }
+    if (outFile.empty()) {
+        std::cout << out.str();
+    } else {
+        std::ofstream file(outFile.c_str());
+        file << out.str();
+    }
+    return EXIT_SUCCESS;
+}
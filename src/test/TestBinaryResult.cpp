@@ -0,0 +1,140 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AlignmentSymmetry.h"
+#include "DBReader.h"
+#include "DBWriter.h"
+#include "Matcher.h"
+#include "QueryMatcher.h"
+#include "Parameters.h"
+#include "ResultView.h"
+
+const char* binary_name = "test_binaryresult";
+
+static void check(bool condition, const char *what) {
+    if (condition == false) {
+        Debug(Debug::ERROR) << "Check failed: " << what << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+static bool sameResult(const Matcher::result_t &a, const Matcher::result_t &b) {
+    return a.dbKey == b.dbKey && a.score == b.score && a.qcov == b.qcov && a.dbcov == b.dbcov
+           && a.seqId == b.seqId && a.eval == b.eval && a.alnLength == b.alnLength
+           && a.qStartPos == b.qStartPos && a.qEndPos == b.qEndPos && a.qLen == b.qLen
+           && a.dbStartPos == b.dbStartPos && a.dbEndPos == b.dbEndPos && a.dbLen == b.dbLen
+           && a.backtrace == b.backtrace;
+}
+
+int main (int, const char**) {
+    Parameters& par = Parameters::getInstance();
+    par.initMatrices();
+
+    const int prefDbtype = DBReader<unsigned int>::setExtendedDbtype(Parameters::DBTYPE_PREFILTER_RES, Parameters::DBTYPE_EXTENDED_BINARY_RESULT);
+    DBWriter prefWriter("dataBinaryPref", "dataBinaryPref.index", 1, Parameters::WRITER_ASCII_MODE, prefDbtype);
+    prefWriter.open();
+    std::string buffer;
+    char hitBuffer[QueryMatcher::BINARY_HIT_SIZE];
+    for (unsigned int i = 0; i < 3; i++) {
+        hit_t hit;
+        // ids with null bytes make sure entries are not delimited by strlen
+        hit.seqId = i * 256;
+        hit.prefScore = 100 - i;
+        hit.diagonal = static_cast<unsigned short>(static_cast<short>(-1 * i));
+        size_t len = QueryMatcher::prefilterHitToBinary(hitBuffer, hit);
+        buffer.append(hitBuffer, len);
+    }
+    prefWriter.writeData(buffer.c_str(), buffer.size(), 1, 0);
+    prefWriter.writeData("", 0, 2, 0);
+    prefWriter.close();
+
+    DBReader<unsigned int> prefReader("dataBinaryPref", "dataBinaryPref.index", 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
+    prefReader.open(DBReader<unsigned int>::NOSORT);
+    std::cout << "Binary: " << prefReader.isBinaryResult() << std::endl;
+    check(prefReader.isBinaryResult(), "prefilter dbtype is binary");
+    check(prefReader.getSize() == 2, "prefilter entry count");
+    for (size_t i = 0; i < prefReader.getSize(); i++) {
+        std::string text;
+        Matcher::binaryEntryToBuffer(text, prefReader.getData(i, 0), prefReader.getEntryLen(i), prefReader.getDbtype());
+        std::cout << "Query " << prefReader.getDbKey(i) << " hits " << QueryMatcher::getBinaryHitCount(prefReader.getEntryLen(i)) << "\n" << text;
+        std::vector<hit_t> hits;
+        QueryMatcher::parsePrefilterHitsBinary(prefReader.getData(i, 0), prefReader.getEntryLen(i), hits);
+        check(hits.size() == (prefReader.getDbKey(i) == 1 ? 3 : 0), "prefilter hit count");
+        for (unsigned int j = 0; j < hits.size(); j++) {
+            check(hits[j].seqId == j * 256, "prefilter hit id");
+            check(hits[j].prefScore == static_cast<int>(100 - j), "prefilter hit score");
+            check(hits[j].diagonal == static_cast<unsigned short>(static_cast<short>(-1 * j)), "prefilter hit diagonal");
+        }
+    }
+    prefReader.close();
+
+    std::vector<Matcher::result_t> results;
+    results.emplace_back(10, 50, 0.9, 0.8, 0.75, 1e-10, 20, 0, 19, 20, 1, 20, 25, "MMMMMIIMMMMMMMDMMMMMMM");
+    results.emplace_back(0, 30, 0.5, 0.4, 0.3, 1e-3, 10, 5, 14, 20, 0, 9, 30, "");
+    std::string alnBuffer;
+    Matcher::resultsToBinary(alnBuffer, results, true);
+
+    std::vector<Matcher::result_t> parsed;
+    Matcher::readAlignmentResultsBinary(parsed, alnBuffer.c_str(), alnBuffer.size() + 1, false);
+    for (size_t i = 0; i < parsed.size(); i++) {
+        std::cout << parsed[i].dbKey << "\t" << parsed[i].eval << "\t" << parsed[i].backtrace
+                  << "\t" << (parsed[i].backtrace == results[i].backtrace ? "OK" : "MISMATCH") << std::endl;
+    }
+    check(parsed.size() == results.size(), "alignment record count");
+    for (size_t i = 0; i < parsed.size(); i++) {
+        check(sameResult(parsed[i], results[i]), "alignment record round trip");
+    }
+
+    std::string text;
+    const int alnDbtype = DBReader<unsigned int>::setExtendedDbtype(Parameters::DBTYPE_ALIGNMENT_RES, Parameters::DBTYPE_EXTENDED_BINARY_RESULT);
+    Matcher::binaryEntryToBuffer(text, alnBuffer.c_str(), alnBuffer.size() + 1, alnDbtype);
+    std::cout << text;
+
+    // the same entry walked as binary records and as text lines
+    ResultView<Matcher::result_t> binaryView(alnBuffer.c_str(), alnBuffer.size() + 1, alnDbtype);
+    ResultView<Matcher::result_t> textView(text.c_str(), text.size(), Parameters::DBTYPE_ALIGNMENT_RES);
+    std::cout << "View sizes " << binaryView.size() << " " << textView.size() << std::endl;
+    check(binaryView.size() == results.size() && textView.size() == results.size(), "view sizes");
+    ResultView<Matcher::result_t>::iterator textIt = textView.begin();
+    for (ResultView<Matcher::result_t>::iterator it = binaryView.begin(); it != binaryView.end(); ++it, ++textIt) {
+        std::cout << it->dbKey << "\t" << textIt->dbKey << "\t" << it->backtrace
+                  << "\t" << (it->backtrace == textIt->backtrace ? "OK" : "MISMATCH") << std::endl;
+        // the text format rounds the scores, the integer fields have to match exactly
+        check(it->dbKey == textIt->dbKey && it->score == textIt->score && it->qStartPos == textIt->qStartPos
+              && it->qEndPos == textIt->qEndPos && it->dbStartPos == textIt->dbStartPos && it->dbEndPos == textIt->dbEndPos
+              && it->backtrace == textIt->backtrace, "binary and text views");
+    }
+
+    // clustering reads the score and identity column, both formats have to give the same values
+    std::vector<Matcher::result_t> identities;
+    const float offGrid[] = { 0.9f, 0.57f, 0.5696f, 0.1234f, 0.999f, 0.0005f };
+    for (unsigned int i = 0; i <= 1000; i++) {
+        identities.emplace_back(i, i * 3, 0.5, 0.5, i / 1000.0f, 1e-5, 10, 0, 9, 10, 0, 9, 10, "");
+    }
+    for (size_t i = 0; i < sizeof(offGrid) / sizeof(offGrid[0]); i++) {
+        identities.emplace_back(2000 + i, 7, 0.5, 0.5, offGrid[i], 1e-5, 10, 0, 9, 10, 0, 9, 10, "");
+    }
+    std::string identityBuffer;
+    Matcher::resultsToBinary(identityBuffer, identities, false);
+    std::string identityText;
+    Matcher::binaryEntryToBuffer(identityText, identityBuffer.c_str(), identityBuffer.size() + 1, alnDbtype);
+    ResultView<AlignmentIdentityRecord> identityBinary(identityBuffer.c_str(), identityBuffer.size() + 1, alnDbtype);
+    ResultView<AlignmentIdentityRecord> identityTextView(identityText.c_str(), identityText.size(), Parameters::DBTYPE_ALIGNMENT_RES);
+    check(identityBinary.size() == identities.size() && identityTextView.size() == identities.size(), "identity view sizes");
+    ResultView<AlignmentIdentityRecord>::iterator identityIt = identityTextView.begin();
+    for (ResultView<AlignmentIdentityRecord>::iterator it = identityBinary.begin(); it != identityBinary.end(); ++it, ++identityIt) {
+        if (it->score != identityIt->score) {
+            std::cout << "Identity " << it->dbKey << " binary " << it->score << " text " << identityIt->score << std::endl;
+        }
+        check(it->dbKey == identityIt->dbKey && it->score == identityIt->score, "binary and text identity");
+    }
+
+    ResultView<AlignmentScoreRecord> scoreBinary = identityBinary.as<AlignmentScoreRecord>();
+    ResultView<AlignmentScoreRecord> scoreText = identityTextView.as<AlignmentScoreRecord>();
+    ResultView<AlignmentScoreRecord>::iterator scoreIt = scoreText.begin();
+    for (ResultView<AlignmentScoreRecord>::iterator it = scoreBinary.begin(); it != scoreBinary.end(); ++it, ++scoreIt) {
+        check(it->dbKey == scoreIt->dbKey && it->score == scoreIt->score, "binary and text score");
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "Command.h"
+#include "CommandDeclarations.h"
+#include "DBReader.h"
+#include "FileUtil.h"
+#include "KSeqWrapper.h"
+#include "Parameters.h"
+#include "Util.h"
+
+const char* binary_name = "test_createdb";
+
+static void check(bool condition, const char *what) {
+    if (condition == false) {
+        Debug(Debug::ERROR) << "Check failed: " << what << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+static std::string sequenceLines(unsigned int key, size_t length, size_t lineLength, const char *newline) {
+    const char residues[] = "ACDEFGHIKLMNPQRSTVWY";
+    std::string lines;
+    for (size_t i = 0; i < length; i++) {
+        lines.push_back(residues[(key * 7 + i * 13) % 20]);
+        if ((i + 1) % lineLength == 0 || i + 1 == length) {
+            lines.append(newline);
+        }
+    }
+    return lines;
+}
+
+// headers and sequences as kseq reads them
+static void readReference(const std::string &fasta, std::vector<std::string> &headers, std::vector<std::string> &sequences) {
+    KSeqBuffer kseq(fasta.c_str(), fasta.size());
+    while (kseq.ReadEntry()) {
+        std::string header(kseq.entry.name.s, kseq.entry.name.l);
+        if (kseq.entry.comment.l > 0) {
+            header.append(" ");
+            header.append(kseq.entry.comment.s, kseq.entry.comment.l);
+        }
+        headers.push_back(header + "\n");
+        sequences.push_back(std::string(kseq.entry.sequence.s, kseq.entry.sequence.l) + "\n");
+    }
+}
+
+static std::string readDb(const std::string &name, std::vector<std::string> &entries) {
+    DBReader<unsigned int> reader(name.c_str(), (name + ".index").c_str(), 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
+    reader.open(DBReader<unsigned int>::NOSORT);
+    std::string all;
+    for (size_t i = 0; i < reader.getSize(); i++) {
+        check(reader.getDbKey(i) == i, "keys follow the input order");
+        entries.push_back(reader.getData(i, 0));
+        all.append(entries.back());
+    }
+    reader.close();
+    return all;
+}
+
+int main (int, const char**) {
+    Parameters& par = Parameters::getInstance();
+
+    // records around the chunk and part boundaries, line endings and header forms kseq has to agree with
+    std::string fasta;
+    for (unsigned int key = 0; key < 120000; key++) {
+        switch (key % 9) {
+            case 0:
+                fasta.append(">id" + SSTR(key) + " comment with spaces\n");
+                break;
+            case 1:
+                fasta.append(">id" + SSTR(key) + "\tcomment after a tab\r\n");
+                break;
+            case 2:
+                fasta.append(">id" + SSTR(key) + "\r\n");
+                break;
+            case 3:
+                fasta.append(">id" + SSTR(key) + " \n");
+                break;
+            case 4:
+                fasta.append(">sp|P" + SSTR(key) + "|NAME  two spaces\n\n");
+                break;
+            default:
+                fasta.append(">id" + SSTR(key) + "\n");
+                break;
+        }
+        if (key % 1000 == 17) {
+            // empty sequence
+            continue;
+        }
+        const size_t length = 20 + (key * 31) % 700;
+        fasta.append(sequenceLines(key, length, key % 2 ? 60 : length, key % 9 == 1 ? "\r\n" : "\n"));
+        if (key % 50 == 3) {
+            fasta.append("\n");
+        }
+    }
+    // a record that is larger than a chunk and a last line without newline
+    fasta.append(">large record\n");
+    fasta.append(sequenceLines(1, 20 * 1024 * 1024, 80, "\n"));
+    fasta.append(">last\nMKVL");
+
+    FILE *file = FileUtil::openFileOrDie("dataCreatedb.fasta", "w", false);
+    check(fwrite(fasta.c_str(), 1, fasta.size(), file) == fasta.size(), "write fasta");
+    fclose(file);
+
+    std::vector<std::string> headers;
+    std::vector<std::string> sequences;
+    readReference(fasta, headers, sequences);
+
+    Command command = {"createdb", createdb, &par.createdb, COMMAND_DATABASE_CREATION, "", NULL, "", "<i:fastaFile> <o:sequenceDB>",
+                       CITATION_MMSEQS2, {{"fastaFile", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA | DbType::VARIADIC, &DbValidator::flatfileStdinAndGeneric },
+                                          {"sequenceDB", DbType::ACCESS_MODE_OUTPUT, DbType::NEED_DATA, &DbValidator::flatfile }}};
+    std::string shuffled;
+    // threads, shuffle, createdb mode. Multiline input makes the soft mode start over in the hard mode.
+    const char *configs[][3] = { { "1", "0", "0" }, { "3", "0", "0" }, { "8", "0", "1" }, { "1", "1", "0" }, { "8", "1", "0" } };
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        const std::string out = "dataCreatedbOut" + SSTR(i);
+        const bool shuffle = configs[i][1][0] == '1';
+        // every run parses its parameters again
+        for (size_t j = 0; j < par.createdb.size(); j++) {
+            par.createdb[j]->wasSet = false;
+        }
+        const char *argv[] = { "dataCreatedb.fasta", out.c_str(), "--threads", configs[i][0], "--shuffle", configs[i][1], "--createdb-mode", configs[i][2], "-v", "1" };
+        check(createdb(10, argv, command) == EXIT_SUCCESS, "createdb succeeded");
+
+        std::vector<std::string> dbHeaders;
+        std::vector<std::string> dbSequences;
+        const std::string all = readDb(out + "_h", dbHeaders) + readDb(out, dbSequences);
+        check(dbHeaders.size() == headers.size() && dbSequences.size() == sequences.size(), "entry count");
+        if (shuffle) {
+            // the shuffled order has to be the same for every number of threads
+            check(shuffled.empty() || shuffled == all, "shuffled output does not depend on the threads");
+            shuffled = all;
+        } else {
+            for (size_t j = 0; j < headers.size(); j++) {
+                check(dbHeaders[j] == headers[j], "header matches kseq");
+                check(dbSequences[j] == sequences[j], "sequence matches kseq");
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
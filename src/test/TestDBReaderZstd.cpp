@@ -127,7 +127,7 @@ int main (int, const char**) {
 
     writer.writeData((char*)data,strlen(data), 1,0);
     writer.close();
-    DBReader<unsigned int> reader("dataLinear", "dataLinear.index", 1, 0);
+    DBReader<unsigned int> reader("dataLinear", "dataLinear.index", 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
     reader.open(0);
     reader.readMmapedDataInMemory();
     reader.printMagicNumber();
@@ -138,4 +138,25 @@ int main (int, const char**) {
     }
     reader.close();
 
+    // entries of a block compressed database are read from their frame and from the decompressed data
+    DBWriter blockInput("dataBlocksInput", "dataBlocksInput.index", 1, 0, Parameters::DBTYPE_NUCLEOTIDES);
+    blockInput.open();
+    for (unsigned int key = 0; key < 20; key++) {
+        blockInput.writeData(data + key * 30, 30 + key, key, 0);
+    }
+    blockInput.close();
+    DBWriter::compressBlocks("dataBlocksInput", "dataBlocksInput.index", "dataBlocks", "dataBlocks.index", 128, 1);
+    DBReader<unsigned int> blockReader("dataBlocks", "dataBlocks.index", 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
+    blockReader.open(DBReader<unsigned int>::NOSORT);
+    for (int pass = 0; pass < 2; pass++) {
+        size_t mismatches = 0;
+        for (unsigned int key = 0; key < 20; key++) {
+            const char *entry = blockReader.getDataByDBKey(key, 0);
+            mismatches += (strlen(entry) != 30 + key || strncmp(entry, data + key * 30, 30 + key) != 0);
+        }
+        std::cout << "Block compressed " << (pass == 0 ? "frames" : "in memory") << ": " << mismatches << " mismatches" << std::endl;
+        blockReader.readMmapedDataInMemory();
+    }
+    blockReader.close();
+
 }
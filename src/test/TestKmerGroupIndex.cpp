@@ -0,0 +1,166 @@
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "KmerGroupIndex.h"
+#include "KmerPositionSort.h"
+#include "Parameters.h"
+#include "Util.h"
+
+const char* binary_name = "test_kmergroupindex";
+
+static void check(bool condition, const char *what) {
+    if (condition == false) {
+        Debug(Debug::ERROR) << "Check failed: " << what << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+static KmerPosition<short> kmerPosition(size_t kmer, unsigned int id, short seqLen, short pos) {
+    KmerPosition<short> position;
+    position.kmer = kmer;
+    position.id = id;
+    position.seqLen = seqLen;
+    position.pos = pos;
+    return position;
+}
+
+// k-mers of the sequences [firstKey, lastKey], every k-mer is shared by a few sequences
+static std::vector<KmerPosition<short> > kmersOfSequences(unsigned int firstKey, unsigned int lastKey, size_t hashStart, size_t hashEnd) {
+    std::vector<KmerPosition<short> > kmers;
+    for (unsigned int key = firstKey; key <= lastKey; key++) {
+        for (size_t kmer = hashStart + key % 3; kmer <= hashEnd; kmer += 3 + key % 5) {
+            kmers.push_back(kmerPosition(kmer, key, static_cast<short>(100 + key), static_cast<short>(kmer % 50)));
+        }
+    }
+    KmerPositionSort::sortByPos<false, short>(kmers.data(), kmers.size());
+    return kmers;
+}
+
+// groups without a sequence of the previous index, all groups if there is none
+static size_t groupCount(const std::vector<KmerPosition<short> > &kmers, const KmerGroupIndexReader *previous) {
+    size_t count = 0;
+    for (size_t i = 0; i < kmers.size(); ) {
+        bool isIndexed = false;
+        size_t j = i;
+        while (j < kmers.size() && kmers[j].kmer == kmers[i].kmer) {
+            isIndexed |= (previous != NULL && kmers[j].id <= previous->getMaxKey());
+            j++;
+        }
+        count += isIndexed ? 0 : 1;
+        i = j;
+    }
+    return count;
+}
+
+int main (int, const char**) {
+    Parameters& par = Parameters::getInstance();
+    par.kmerSize = 10;
+    par.kmersPerSequence = 21;
+    par.ignoreMultiKmer = false;
+
+    const size_t hashRanges[][2] = { { 0, 999 }, { 1000, 1999 } };
+    const unsigned int oldMaxKey = 19;
+    const unsigned int newMaxKey = 39;
+
+    // initial index of the sequences 0 to 19 with one run per hash range
+    std::vector<std::vector<KmerPosition<short> > > oldKmers;
+    {
+        KmerGroupIndexWriter writer("dataKmerGroupIndex", kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, oldMaxKey));
+        for (size_t i = 0; i < 2; i++) {
+            // the upper part of the hash range is left for groups of new sequences
+            oldKmers.push_back(kmersOfSequences(0, oldMaxKey, hashRanges[i][0], hashRanges[i][0] + 599));
+            writer.writeRun<false, short>(oldKmers[i].data(), oldKmers[i].size(), hashRanges[i][0], hashRanges[i][1], NULL);
+        }
+        writer.close();
+    }
+    size_t oldEntries = 0;
+    {
+        KmerGroupIndexReader reader("dataKmerGroupIndex");
+        check(reader.getMaxKey() == oldMaxKey, "max key of the initial index");
+        check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)), "same k-mer parameters are compatible");
+        check(reader.getRuns().size() == 2, "one run per hash range");
+        for (size_t i = 0; i < 2; i++) {
+            const KmerGroupIndexRun &run = reader.getRuns()[i];
+            check(run.hashStart == hashRanges[i][0] && run.hashEnd == hashRanges[i][1], "hash range of the run");
+            check(run.offset == oldEntries, "runs follow each other");
+            check(run.count == groupCount(oldKmers[i], NULL), "one entry per k-mer group");
+            // the first entry of every group is kept, that is the longest sequence
+            size_t entry = run.offset;
+            for (size_t j = 0; j < oldKmers[i].size(); j++) {
+                if (j == 0 || oldKmers[i][j].kmer != oldKmers[i][j - 1].kmer) {
+                    const KmerGroupIndexEntry &indexed = reader.getEntries()[entry++];
+                    check(indexed.kmer == oldKmers[i][j].kmer && indexed.id == oldKmers[i][j].id, "group head");
+                    check(indexed.seqLen == oldKmers[i][j].seqLen && indexed.pos == oldKmers[i][j].pos, "group head position");
+                }
+            }
+            oldEntries += run.count;
+        }
+    }
+
+    // the update keeps the previous runs and adds the groups that only contain new sequences
+    size_t newEntries = 0;
+    {
+        KmerGroupIndexReader previous("dataKmerGroupIndex");
+        KmerGroupIndexWriter writer("dataKmerGroupIndexUpdated", kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey));
+        writer.copyRuns(previous);
+        for (size_t i = 0; i < 2; i++) {
+            std::vector<KmerPosition<short> > kmers = kmersOfSequences(oldMaxKey + 1, newMaxKey, hashRanges[i][0], hashRanges[i][1]);
+            const size_t size = kmers.size();
+            kmers.resize(size * 2);
+            size_t added = previous.appendIndexedKmers<false, short>(kmers.data(), size, kmers.size(), hashRanges[i][0], hashRanges[i][1]);
+            check(added > 0, "new k-mers join indexed groups");
+            for (size_t j = size; j < size + added; j++) {
+                check(kmers[j].id <= oldMaxKey, "joined entries are indexed sequences");
+            }
+            kmers.resize(size + added);
+            KmerPositionSort::sortByPos<false, short>(kmers.data(), kmers.size());
+            writer.writeRun<false, short>(kmers.data(), kmers.size(), hashRanges[i][0], hashRanges[i][1], &previous);
+            newEntries += groupCount(kmers, &previous);
+        }
+        writer.close();
+    }
+    check(newEntries > 0, "the update adds groups");
+    {
+        KmerGroupIndexReader reader("dataKmerGroupIndexUpdated");
+        KmerGroupIndexReader previous("dataKmerGroupIndex");
+        check(reader.getMaxKey() == newMaxKey, "max key of the updated index");
+        check(reader.getRuns().size() == 4, "previous runs are kept");
+        size_t entries = 0;
+        for (size_t i = 0; i < reader.getRuns().size(); i++) {
+            const KmerGroupIndexRun &run = reader.getRuns()[i];
+            check(run.offset == entries, "runs follow each other");
+            for (size_t j = 0; j < run.count; j++) {
+                const KmerGroupIndexEntry &entry = reader.getEntries()[run.offset + j];
+                check(entry.kmer >= run.hashStart && entry.kmer <= run.hashEnd, "entry belongs to the hash range");
+                check(j == 0 || reader.getEntries()[run.offset + j - 1].kmer < entry.kmer, "one entry per k-mer in a run");
+                if (i < 2) {
+                    const KmerGroupIndexEntry &old = previous.getEntries()[previous.getRuns()[i].offset + j];
+                    check(memcmp(&entry, &old, sizeof(KmerGroupIndexEntry)) == 0, "copied entry");
+                } else {
+                    check(entry.id > oldMaxKey, "new groups only contain new sequences");
+                }
+            }
+            entries += run.count;
+        }
+        check(entries == oldEntries + newEntries, "entry count of the updated index");
+    }
+
+    // an index can only be updated with the k-mer parameters it was built with
+    KmerGroupIndexReader reader("dataKmerGroupIndexUpdated");
+    par.kmersPerSequence = 22;
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)) == false, "kmer-per-seq is compared");
+    par.kmersPerSequence = 21;
+    const float kmersPerSequenceScale = par.kmersPerSequenceScale.values.aminoacid();
+    par.kmersPerSequenceScale.values.aminoacid(kmersPerSequenceScale + 0.5f);
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)) == false, "kmer-per-seq-scale is compared");
+    par.kmersPerSequenceScale.values.aminoacid(kmersPerSequenceScale);
+    par.ignoreMultiKmer = true;
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)) == false, "ignore-multi-kmer is compared");
+    par.ignoreMultiKmer = false;
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)), "restored parameters are compatible");
+    par.kmerSize = 11;
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_AMINO_ACIDS, newMaxKey)) == false, "k-mer size is compared");
+    check(reader.isCompatible(kmerGroupIndexHeader(par, Parameters::DBTYPE_NUCLEOTIDES, newMaxKey)) == false, "sequence type is compared");
+    return EXIT_SUCCESS;
+}
@@ -77,4 +77,22 @@ int main (int, const char**) {
             std::cout << "Wrong data" << std::endl;
         }
     }
+
+    const char *sequences[] = { S1char, S2char, S3char, S4char };
+    if (lookup.pack() == false) {
+        std::cout << "Could not pack" << std::endl;
+    }
+    std::cout << "Packed with " << lookup.getBitsPerResidue() << " bits per residue" << std::endl;
+    unsigned char *buffer = new unsigned char[lookup.getMaxSequenceLength() + 1];
+    for (size_t id = 0; id < 4; id++) {
+        std::pair<const unsigned char *, const unsigned int> res = lookup.getSequence(id, buffer);
+        if (res.second != strlen(sequences[id]))
+            std::cout << "Diff length" << std::endl;
+        for (size_t i = 0; i < res.second; i++) {
+            if (subMat.num2aa[res.first[i]] != sequences[id][i]) {
+                std::cout << "Wrong packed data" << std::endl;
+            }
+        }
+    }
+    delete[] buffer;
 }
@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "Command.h"
+#include "CommandDeclarations.h"
+#include "DBReader.h"
+#include "DBWriter.h"
+#include "FileUtil.h"
+#include "Parameters.h"
+#include "Util.h"
+
+const char* binary_name = "test_subdbdictionary";
+
+static void check(bool condition, const char *what) {
+    if (condition == false) {
+        Debug(Debug::ERROR) << "Check failed: " << what << "\n";
+        EXIT(EXIT_FAILURE);
+    }
+}
+
+static std::string sequence(unsigned int key) {
+    const char *motifs[] = { "MKVLAAGIVGLLLA", "PEGRSTWQHHNDC", "ALKKFGEEVLRAAQ", "TTSDYPLWKNMVGE" };
+    std::string seq;
+    for (unsigned int i = 0; i < 4 + key % 7; i++) {
+        seq.append(motifs[(key + i * 3) % 4]);
+    }
+    seq.append(SSTR(key));
+    seq.append(1, '\n');
+    return seq;
+}
+
+int main (int, const char**) {
+    Parameters& par = Parameters::getInstance();
+
+    const unsigned int entries = 2000;
+    DBWriter input("dataSubDbInput", "dataSubDbInput.index", 1, 0, Parameters::DBTYPE_AMINO_ACIDS);
+    input.open();
+    for (unsigned int key = 0; key < entries; key++) {
+        std::string seq = sequence(key);
+        input.writeData(seq.c_str(), seq.size(), key, 0);
+    }
+    input.close(true);
+    DBWriter::compressWithDictionary("dataSubDbInput", "dataSubDbInput.index", "dataSubDbDict", "dataSubDbDict.index", 4096, 1);
+    check(FileUtil::fileExists(DBReader<unsigned int>::dictionaryName("dataSubDbDict").c_str()), "dictionary was trained");
+
+    FILE *keys = FileUtil::openFileOrDie("dataSubDbKeys", "w", false);
+    for (unsigned int key = 0; key < entries; key += 3) {
+        fprintf(keys, "%u\n", key);
+    }
+    fclose(keys);
+
+    // the hard copy keeps the compressed entries and needs the dictionary of its source
+    Command command = {"createsubdb", createsubdb, &par.createsubdb, COMMAND_SET, "", NULL, "", "<i:subsetFile|DB> <i:DB> <o:DB>",
+                       CITATION_MMSEQS2, {{"subsetFile", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA, &DbValidator::allDbAndFlat },
+                                          {"DB", DbType::ACCESS_MODE_INPUT, DbType::NEED_DATA, &DbValidator::allDb },
+                                          {"DB", DbType::ACCESS_MODE_OUTPUT, DbType::NEED_DATA, &DbValidator::allDb }}};
+    const char *argv[] = { "dataSubDbKeys", "dataSubDbDict", "dataSubDbSub" };
+    check(createsubdb(3, argv, command) == EXIT_SUCCESS, "createsubdb succeeded");
+
+    DBReader<unsigned int> reader("dataSubDbSub", "dataSubDbSub.index", 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
+    reader.open(DBReader<unsigned int>::NOSORT);
+    check(reader.isCompressed(), "subset stays compressed");
+    check(reader.getSize() == (entries + 2) / 3, "subset has every third entry");
+    for (size_t i = 0; i < reader.getSize(); i++) {
+        const unsigned int key = reader.getDbKey(i);
+        check(key % 3 == 0, "subset keys");
+        check(std::string(reader.getData(i, 0)) == sequence(key), "subset entry decompresses to its sequence");
+    }
+    reader.close();
+    return EXIT_SUCCESS;
+}
@@ -65,6 +65,7 @@ int alignbykmer(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> dbr_res(par.db3.c_str(), par.db3Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     dbr_res.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    dbr_res.requireTextResult("alignbykmer");
 
     if(dbr_res.isSortedByOffset() && qdbr->isSortedByOffset()){
         qdbr->setSequentialAdvice();
@@ -86,6 +86,10 @@ int appenddbtoindex(int argc, const char **argv, const Command &command) {
 
         DBReader<unsigned int> reader(inDb.c_str(), inIndexName.c_str(), 1, DBReader<unsigned int>::USE_DATA | DBReader<unsigned int>::USE_INDEX);
         reader.open(DBReader<unsigned int>::HARDNOSORT);
+        // the data is copied as is, block compressed data has to be decompressed first
+        if (reader.isBlockCompressed()) {
+            reader.readMmapedDataInMemory();
+        }
 
         char* data = DBReader<unsigned int>::serialize(reader);
         size_t inSize = DBReader<unsigned int>::indexMemorySize(reader);
@@ -13,7 +13,10 @@ int doCompression(int argc, const char **argv, const Command& command, bool shou
 
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::NOSORT);
-    if (shouldCompress == true && reader.isCompressed() == true) {
+    const bool useBlocks = shouldCompress && par.compressionBlockSize > 0;
+    const bool useDictionary = shouldCompress && par.compressionDictSize > 0 && useBlocks == false;
+    if (shouldCompress == true && reader.isCompressed() == true && useBlocks == reader.isBlockCompressed()
+        && (useDictionary == false || reader.hasDictionary())) {
         Debug(Debug::INFO) << "Database is already compressed.\n";
         return EXIT_SUCCESS;
     }
@@ -22,9 +25,18 @@ int doCompression(int argc, const char **argv, const Command& command, bool shou
         return EXIT_SUCCESS;
     }
 
+    if (useBlocks) {
+        reader.close();
+        DBWriter::compressBlocks(par.db1, par.db1Index, par.db2, par.db2Index, par.compressionBlockSize, par.threads);
+        return EXIT_SUCCESS;
+    }
+
     int dbtype = reader.getDbtype();
     dbtype = shouldCompress ? dbtype | (1 << 31) : dbtype & ~(1 << 31);
     DBWriter writer(par.db2.c_str(), par.db2Index.c_str(), par.threads, shouldCompress, dbtype);
+    if (useDictionary) {
+        writer.setDictionary(DBWriter::trainDictionary(reader, par.compressionDictSize));
+    }
     writer.open();
     Debug::Progress progress(reader.getSize());
 
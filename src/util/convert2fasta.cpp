@@ -24,6 +24,13 @@ int convert2fasta(int argc, const char **argv, const Command& command) {
 
     DBReader<unsigned int> db_header(par.hdr1.c_str(), par.hdr1Index.c_str(), 1, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
     db_header.open(DBReader<unsigned int>::NOSORT);
+    // the whole database is written, block compressed data is decompressed in parallel up front
+    if (db.isBlockCompressed()) {
+        db.readMmapedDataInMemory();
+    }
+    if (db_header.isBlockCompressed()) {
+        db_header.readMmapedDataInMemory();
+    }
 
     FILE* fastaFP = fopen(par.db2.c_str(), "w");
     if(fastaFP == NULL) {
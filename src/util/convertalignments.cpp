@@ -254,6 +254,11 @@ int convertalignments(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> alnDbr(par.db3.c_str(), par.db3Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     alnDbr.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    const bool isBinary = alnDbr.isBinaryResult();
+    if (isBinary && Parameters::isEqualDbtype(alnDbr.getDbtype(), Parameters::DBTYPE_ALIGNMENT_RES) == false) {
+        Debug(Debug::ERROR) << "Binary " << alnDbr.getDbTypeName() << " input is not supported by convertalis.\n";
+        EXIT(EXIT_FAILURE);
+    }
 
     size_t localThreads = 1;
 #ifdef OPENMP
@@ -277,8 +282,14 @@ int convertalignments(int argc, const char **argv, const Command &command) {
         std::string header = "@HD\tVN:1.4\tSO:queryname\n";
         resultWriter.writeAdd(header.c_str(), header.size(), 0);
 
+        std::string binaryAsText;
         for (size_t i = 0; i < alnDbr.getSize(); i++) {
             char *data = alnDbr.getData(i, 0);
+            if (isBinary) {
+                binaryAsText.clear();
+                Matcher::binaryEntryToBuffer(binaryAsText, data, alnDbr.getEntryLen(i), alnDbr.getDbtype());
+                data = (char *) binaryAsText.c_str();
+            }
             while (*data != '\0') {
                 char dbKeyBuffer[255 + 1];
                 Util::parseKey(data, dbKeyBuffer);
@@ -398,9 +409,17 @@ int convertalignments(int argc, const char **argv, const Command &command) {
             }
 
             char *data = alnDbr.getData(i, thread_idx);
-            while (*data != '\0') {
-                Matcher::result_t res = Matcher::parseAlignmentRecord(data, true);
-                data = Util::skipLine(data);
+            const size_t binaryCount = isBinary ? Matcher::getBinaryResultCount(data, alnDbr.getEntryLen(i)) : 0;
+            size_t binaryIdx = 0;
+            while (isBinary ? (binaryIdx < binaryCount) : (*data != '\0')) {
+                Matcher::result_t res;
+                if (isBinary) {
+                    res = Matcher::parseAlignmentRecordBinary(data, binaryIdx, true);
+                    binaryIdx++;
+                } else {
+                    res = Matcher::parseAlignmentRecord(data, true);
+                    data = Util::skipLine(data);
+                }
 
                 if (res.backtrace.empty() && needBacktrace == true) {
                     Debug(Debug::ERROR) << "Backtrace cigar is missing in the alignment result. Please recompute the alignment with the -a flag.\n"
@@ -12,6 +12,151 @@
 #include "KSeqWrapper.h"
 #include "itoa.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+// FASTA input is read in chunks that end at a record start. A chunk is split into parts at record starts,
+// the parts are parsed in parallel and their records get the keys of their position in the input.
+struct FastaRecord {
+    char *header;
+    size_t nameLength;
+    // including the newline
+    size_t headerLength;
+    char *sequence;
+    size_t sequenceLength;
+};
+
+static const size_t FASTA_CHUNK_SIZE = 16 * 1024 * 1024;
+
+static char *nextFastaRecord(char *data, char *end) {
+    while (data < end) {
+        char *newline = (char *) memchr(data, '\n', end - data);
+        if (newline == NULL || newline + 1 >= end) {
+            return end;
+        }
+        if (newline[1] == '>') {
+            return newline + 1;
+        }
+        data = newline + 1;
+    }
+    return end;
+}
+
+static char *lastFastaRecord(char *begin, char *end) {
+    for (char *data = end - 1; data > begin; data--) {
+        if (*data == '>' && data[-1] == '\n') {
+            return data;
+        }
+    }
+    return begin;
+}
+
+// Parses the records of a part in place with the same results as kseq_read: the header is terminated by a newline
+// with one space between name and comment, the sequence lines are joined. Fails on FASTQ quality lines.
+static bool parseFastaPart(char *data, char *end, std::vector<FastaRecord> &records) {
+    while (data < end) {
+        FastaRecord record;
+        // skip '>' or '@'
+        data++;
+        record.header = data;
+        while (data < end && isspace(static_cast<unsigned char>(*data)) == 0) {
+            data++;
+        }
+        char *nameEnd = data;
+        record.nameLength = nameEnd - record.header;
+        char *headerEnd = nameEnd;
+        if (data < end && *data != '\n') {
+            // the comment starts after the first whitespace and ends with the line
+            char *comment = data + 1;
+            data = (char *) memchr(comment, '\n', end - comment);
+            if (data == NULL) {
+                data = end;
+            }
+            char *commentEnd = data;
+            if (commentEnd - comment > 1 && commentEnd[-1] == '\r') {
+                commentEnd--;
+            }
+            if (commentEnd > comment) {
+                *nameEnd = ' ';
+                headerEnd = commentEnd;
+            }
+        }
+        // only the last line of the input can end at the chunk end, the chunk has one byte to spare
+        *headerEnd = '\n';
+        record.headerLength = headerEnd - record.header + 1;
+        if (data < end) {
+            data++;
+        }
+
+        record.sequence = data;
+        char *out = data;
+        while (data < end && *data != '>' && *data != '@') {
+            if (*data == '+') {
+                return false;
+            }
+            if (*data == '\n') {
+                data++;
+                continue;
+            }
+            char *lineStart = data;
+            data = (char *) memchr(lineStart, '\n', end - lineStart);
+            if (data == NULL) {
+                data = end;
+            }
+            memmove(out, lineStart, data - lineStart);
+            out += data - lineStart;
+            if (out - record.sequence > 1 && out[-1] == '\r') {
+                out--;
+            }
+            if (data < end) {
+                data++;
+            }
+        }
+        record.sequenceLength = out - record.sequence;
+        records.push_back(record);
+    }
+    return true;
+}
+
+static bool isNucleotideSequence(const char *sequence, size_t length) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < length; i++) {
+        switch (toupper(sequence[i])) {
+            case 'T':
+            case 'A':
+            case 'G':
+            case 'C':
+            case 'U':
+            case 'N':
+                cnt++;
+                break;
+        }
+    }
+    const float nuclDNAFraction = static_cast<float>(cnt) / static_cast<float>(length);
+    return nuclDNAFraction > 0.9;
+}
+
+// header has to end with a newline
+static void writeEntry(DBWriter &hdrWriter, DBWriter &seqWriter, const char *header, size_t headerLength,
+                       const char *sequence, size_t length, unsigned int id, unsigned int splitIdx, unsigned int identifierOffset) {
+    if (Util::parseFastaHeader(header).empty()) {
+        // An identifier is necessary for these two cases, so we should just give up
+        Debug(Debug::WARNING) << "Cannot extract identifier from entry " << (id - identifierOffset) << "\n";
+    }
+    const char newline = '\n';
+    hdrWriter.writeData(header, headerLength, id, splitIdx);
+    seqWriter.writeStart(splitIdx);
+    seqWriter.writeAdd(sequence, length, splitIdx);
+    seqWriter.writeAdd(&newline, 1, splitIdx);
+    seqWriter.writeEnd(id, splitIdx, true);
+}
+
 int createdb(int argc, const char **argv, const Command& command) {
     Parameters &par = Parameters::getInstance();
     par.parseParameters(argc, argv, command, true, Parameters::PARSE_VARIADIC, 0);
@@ -64,14 +209,17 @@ int createdb(int argc, const char **argv, const Command& command) {
         par.compressed = 0;
     }
 
+    // entries are compressed in blocks or with a trained dictionary once all of them are known
+    const bool useBlocks = par.compressed && par.compressionBlockSize > 0;
+    const bool useDictionary = par.compressed && par.compressionDictSize > 0 && useBlocks == false;
+    const int writerMode = (useDictionary || useBlocks) ? Parameters::WRITER_ASCII_MODE : par.compressed;
+
     std::string hdrDataFile = dataFile + "_h";
     std::string hdrIndexFile = dataFile + "_h.index";
 
     unsigned int entries_num = 0;
     size_t sampleCount = 0;
 
-    const char newline = '\n';
-
     const size_t testForNucSequence = 100;
     size_t isNuclCnt = 0;
     Debug::Progress progress;
@@ -84,14 +232,18 @@ int createdb(int argc, const char **argv, const Command& command) {
     std::string sourceFile = dataFile + ".source";
 
     redoComputation:
+    // the soft mode can fall back to the hard mode after reading entries
+    entries_num = 0;
+    sampleCount = 0;
+    isNuclCnt = 0;
     FILE *source = fopen(sourceFile.c_str(), "w");
     if (source == NULL) {
         Debug(Debug::ERROR) << "Cannot open " << sourceFile << " for writing\n";
         EXIT(EXIT_FAILURE);
     }
-    DBWriter hdrWriter(hdrDataFile.c_str(), hdrIndexFile.c_str(), shuffleSplits, par.compressed, Parameters::DBTYPE_GENERIC_DB);
+    DBWriter hdrWriter(hdrDataFile.c_str(), hdrIndexFile.c_str(), shuffleSplits, writerMode, Parameters::DBTYPE_GENERIC_DB);
     hdrWriter.open();
-    DBWriter seqWriter(dataFile.c_str(), indexFile.c_str(), shuffleSplits, par.compressed, (dbType == -1) ? Parameters::DBTYPE_OMIT_FILE : dbType );
+    DBWriter seqWriter(dataFile.c_str(), indexFile.c_str(), shuffleSplits, writerMode, (dbType == -1) ? Parameters::DBTYPE_OMIT_FILE : dbType );
     seqWriter.open();
     size_t headerFileOffset = 0;
     size_t seqFileOffset = 0;
@@ -104,10 +256,16 @@ int createdb(int argc, const char **argv, const Command& command) {
         fileCount = reader->getSize();
     }
 
+    std::string header;
+    header.reserve(1024);
+    size_t chunkCapacity = 0;
+    char *chunk = NULL;
+    const size_t parts = static_cast<size_t>(par.threads) * 4;
+    std::vector<std::vector<FastaRecord>> partRecords(parts);
+    std::vector<unsigned int> partFirstId(parts);
+    std::vector<char *> partStart(parts + 1);
     for (size_t fileIdx = 0; fileIdx < fileCount; fileIdx++) {
         unsigned int numEntriesInCurrFile = 0;
-        std::string header;
-        header.reserve(1024);
 
         std::string sourceName;
         if (dbInput == true) {
@@ -148,6 +306,96 @@ int createdb(int argc, const char **argv, const Command& command) {
             }
             goto redoComputation;
         }
+        if (par.createdbMode == Parameters::SEQUENCE_SPLIT_MODE_HARD && kseq->PeekChar() == '>') {
+            size_t filled = 0;
+            bool eof = false;
+            while (eof == false || filled > 0) {
+                if (eof == false) {
+                    if (filled == chunkCapacity) {
+                        chunkCapacity = std::max(FASTA_CHUNK_SIZE, chunkCapacity * 2);
+                        // one byte to terminate a last line without newline
+                        chunk = (char *) realloc(chunk, chunkCapacity + 1);
+                        Util::checkAllocation(chunk, "Cannot allocate FASTA chunk");
+                    }
+                    filled += kseq->ReadRaw(chunk + filled, chunkCapacity - filled);
+                    eof = filled < chunkCapacity;
+                }
+                char *chunkEnd = chunk + filled;
+                if (eof == false) {
+                    chunkEnd = lastFastaRecord(chunk, chunk + filled);
+                    if (chunkEnd == chunk) {
+                        // a single record does not fit, the chunk grows on the next read
+                        continue;
+                    }
+                }
+
+                partStart[0] = chunk;
+                partStart[parts] = chunkEnd;
+                for (size_t i = 1; i < parts; i++) {
+                    partStart[i] = std::max(partStart[i - 1], nextFastaRecord(chunk + (chunkEnd - chunk) * i / parts, chunkEnd));
+                }
+                bool hasQuality = false;
+#pragma omp parallel for schedule(dynamic, 1)
+                for (size_t i = 0; i < parts; i++) {
+                    partRecords[i].clear();
+                    if (parseFastaPart(partStart[i], partStart[i + 1], partRecords[i]) == false) {
+                        hasQuality = true;
+                    }
+                }
+                if (hasQuality) {
+                    Debug(Debug::ERROR) << "Fasta file " << sourceName << " contains a FASTQ quality line\n";
+                    EXIT(EXIT_FAILURE);
+                }
+
+                for (size_t i = 0; i < parts; i++) {
+                    partFirstId[i] = par.identifierOffset + entries_num;
+                    for (size_t j = 0; j < partRecords[i].size(); j++) {
+                        progress.updateProgress();
+                        const FastaRecord &record = partRecords[i][j];
+                        if (record.nameLength == 0) {
+                            Debug(Debug::ERROR) << "Fasta entry " << entries_num << " is invalid\n";
+                            EXIT(EXIT_FAILURE);
+                        }
+                        if (dbType == -1 && (sampleCount < 10 || (sampleCount % 100) == 0)) {
+                            if (sampleCount < testForNucSequence && isNucleotideSequence(record.sequence, record.sequenceLength)) {
+                                isNuclCnt += true;
+                            }
+                            sampleCount++;
+                        }
+                        sourceLookup[(par.identifierOffset + entries_num) % shuffleSplits].emplace_back(fileIdx);
+                        entries_num++;
+                        numEntriesInCurrFile++;
+                    }
+                }
+
+                // every split is written in order by one thread, so the output does not depend on the number of threads
+#pragma omp parallel
+                {
+                    unsigned int thread_idx = 0;
+                    unsigned int threads = 1;
+#ifdef OPENMP
+                    thread_idx = (unsigned int) omp_get_thread_num();
+                    threads = (unsigned int) omp_get_num_threads();
+#endif
+                    for (size_t i = 0; i < parts; i++) {
+                        for (size_t j = 0; j < partRecords[i].size(); j++) {
+                            const unsigned int id = partFirstId[i] + j;
+                            const unsigned int splitIdx = id % shuffleSplits;
+                            if (splitIdx % threads != thread_idx) {
+                                continue;
+                            }
+                            const FastaRecord &record = partRecords[i][j];
+                            writeEntry(hdrWriter, seqWriter, record.header, record.headerLength, record.sequence, record.sequenceLength,
+                                       id, splitIdx, par.identifierOffset);
+                        }
+                    }
+                }
+
+                filled = (chunk + filled) - chunkEnd;
+                memmove(chunk, chunkEnd, filled);
+            }
+            // the input is consumed, so ReadEntry below returns false
+        }
         while (kseq->ReadEntry()) {
             progress.updateProgress();
             const KSeqWrapper::KSeqEntry &e = kseq->entry;
@@ -156,43 +404,12 @@ int createdb(int argc, const char **argv, const Command& command) {
                 EXIT(EXIT_FAILURE);
             }
 
-            // header
-            if (par.createdbMode == Parameters::SEQUENCE_SPLIT_MODE_HARD) {
-                header.append(e.name.s, e.name.l);
-                if (e.comment.l > 0) {
-                    header.append(" ", 1);
-                    header.append(e.comment.s, e.comment.l);
-                }
-
-                std::string headerId = Util::parseFastaHeader(header.c_str());
-                if (headerId.empty()) {
-                    // An identifier is necessary for these two cases, so we should just give up
-                    Debug(Debug::WARNING) << "Cannot extract identifier from entry " << entries_num << "\n";
-                }
-                header.push_back('\n');
-            }
             unsigned int id = par.identifierOffset + entries_num;
             if (dbType == -1) {
                 // check for the first 10 sequences if they are nucleotide sequences
                 if (sampleCount < 10 || (sampleCount % 100) == 0) {
-                    if (sampleCount < testForNucSequence) {
-                        size_t cnt = 0;
-                        for (size_t i = 0; i < e.sequence.l; i++) {
-                            switch (toupper(e.sequence.s[i])) {
-                                case 'T':
-                                case 'A':
-                                case 'G':
-                                case 'C':
-                                case 'U':
-                                case 'N':
-                                    cnt++;
-                                    break;
-                            }
-                        }
-                        const float nuclDNAFraction = static_cast<float>(cnt) / static_cast<float>(e.sequence.l);
-                        if (nuclDNAFraction > 0.9) {
-                            isNuclCnt += true;
-                        }
+                    if (sampleCount < testForNucSequence && isNucleotideSequence(e.sequence.s, e.sequence.l)) {
+                        isNuclCnt += true;
                     }
                     sampleCount++;
                 }
@@ -216,23 +433,24 @@ int createdb(int argc, const char **argv, const Command& command) {
             }
 
             // Finally write down the entry
-            unsigned int splitIdx = id % shuffleSplits;
-            sourceLookup[splitIdx].emplace_back(fileIdx);
             if (par.createdbMode == Parameters::SEQUENCE_SPLIT_MODE_SOFT) {
+                sourceLookup[id % shuffleSplits].emplace_back(fileIdx);
                 // +2 to emulate the \n\0
                 hdrWriter.writeIndexEntry(id, headerFileOffset + e.headerOffset, (e.sequenceOffset-e.headerOffset)+1, 0);
                 seqWriter.writeIndexEntry(id, seqFileOffset + e.sequenceOffset, e.sequence.l+2, 0);
             } else {
-                hdrWriter.writeData(header.c_str(), header.length(), id, splitIdx);
-                seqWriter.writeStart(splitIdx);
-                seqWriter.writeAdd(e.sequence.s, e.sequence.l, splitIdx);
-                seqWriter.writeAdd(&newline, 1, splitIdx);
-                seqWriter.writeEnd(id, splitIdx, true);
+                header.assign(e.name.s, e.name.l);
+                if (e.comment.l > 0) {
+                    header.append(" ", 1);
+                    header.append(e.comment.s, e.comment.l);
+                }
+                header.push_back('\n');
+                sourceLookup[id % shuffleSplits].emplace_back(fileIdx);
+                writeEntry(hdrWriter, seqWriter, header.c_str(), header.length(), e.sequence.s, e.sequence.l, id, id % shuffleSplits, par.identifierOffset);
             }
 
             entries_num++;
             numEntriesInCurrFile++;
-            header.clear();
         }
         delete kseq;
         if (filenames.size() > 1 && par.createdbMode == Parameters::SEQUENCE_SPLIT_MODE_SOFT) {
@@ -254,7 +472,7 @@ int createdb(int argc, const char **argv, const Command& command) {
         } else {
             dbType = Parameters::DBTYPE_AMINO_ACIDS;
         }
-        seqWriter.writeDbtypeFile(seqWriter.getDataFileName(), dbType ,par.compressed);
+        seqWriter.writeDbtypeFile(seqWriter.getDataFileName(), dbType, writerMode);
     }
     Debug(Debug::INFO) << "Database type: " << Parameters::getDbTypeName(dbType) << "\n";
     if (dbInput == true) {
@@ -276,6 +494,17 @@ int createdb(int argc, const char **argv, const Command& command) {
         DBWriter::createRenumberedDB(dataFile, indexFile, "", "", DBReader<unsigned int>::LINEAR_ACCCESS);
         DBWriter::createRenumberedDB(hdrDataFile, hdrIndexFile, "", "", DBReader<unsigned int>::LINEAR_ACCCESS);
     }
+    if (useBlocks) {
+        DBWriter::compressBlocks(dataFile, indexFile, dataFile + "_blocks", dataFile + "_blocks.index", par.compressionBlockSize, par.threads);
+        DBReader<unsigned int>::moveDb(dataFile + "_blocks", dataFile);
+        DBWriter::compressBlocks(hdrDataFile, hdrIndexFile, hdrDataFile + "_blocks", hdrDataFile + "_blocks.index", par.compressionBlockSize, par.threads);
+        DBReader<unsigned int>::moveDb(hdrDataFile + "_blocks", hdrDataFile);
+    } else if (useDictionary) {
+        DBWriter::compressWithDictionary(dataFile, indexFile, dataFile + "_dict", dataFile + "_dict.index", par.compressionDictSize, par.threads);
+        DBReader<unsigned int>::moveDb(dataFile + "_dict", dataFile);
+        DBWriter::compressWithDictionary(hdrDataFile, hdrIndexFile, hdrDataFile + "_dict", hdrDataFile + "_dict.index", par.compressionDictSize, par.threads);
+        DBReader<unsigned int>::moveDb(hdrDataFile + "_dict", hdrDataFile);
+    }
     if (par.createdbMode == Parameters::SEQUENCE_SPLIT_MODE_SOFT) {
         if (filenames.size() == 1) {
             FileUtil::symlinkAbs(filenames[0], dataFile);
@@ -326,8 +555,10 @@ int createdb(int argc, const char **argv, const Command& command) {
             EXIT(EXIT_FAILURE);
         }
         readerHeader.close();
+        DBReader<unsigned int>::writeBinaryLookup(dataFile, par.threads);
     }
     delete[] sourceLookup;
+    free(chunk);
 
     return EXIT_SUCCESS;
 }
@@ -30,7 +30,9 @@ int createsubdb(int argc, const char **argv, const Command& command) {
     }
     DBReader<unsigned int> reader(par.db2.c_str(), par.db2Index.c_str(), 1, dbMode);
     reader.open(DBReader<unsigned int>::NOSORT);
-    const bool isCompressed = reader.isCompressed();
+    // entries of block compressed databases are copied decompressed
+    const bool isBlockCompressed = reader.isBlockCompressed();
+    const bool isCompressed = reader.isCompressed() && isBlockCompressed == false;
 
     DBWriter writer(par.db3.c_str(), par.db3Index.c_str(), 1, 0, Parameters::DBTYPE_OMIT_FILE);
     writer.open();
@@ -64,7 +66,7 @@ int createsubdb(int argc, const char **argv, const Command& command) {
         if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
             writer.writeIndexEntry(key, reader.getOffset(id), reader.getEntryLen(id), 0);
         } else {
-            char* data = reader.getDataUncompressed(id);
+            char* data = isBlockCompressed ? reader.getData(id, 0) : reader.getDataUncompressed(id);
             size_t originalLength = reader.getEntryLen(id);
             size_t entryLength = std::max(originalLength, static_cast<size_t>(1)) - 1;
 
@@ -86,8 +88,13 @@ int createsubdb(int argc, const char **argv, const Command& command) {
     writer.close(shouldMerge, !isOrdered);
     if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
         DBReader<unsigned int>::softlinkDb(par.db2, par.db3, DBFiles::DATA);
+        DBWriter::writeDbtypeFile(par.db3.c_str(), reader.getDbtype(), reader.isCompressed(), isBlockCompressed);
+    } else {
+        DBWriter::writeDbtypeFile(par.db3.c_str(), reader.getDbtype(), isCompressed);
+        if (isCompressed) {
+            DBReader<unsigned int>::copyDictionary(par.db2, par.db3);
+        }
     }
-    DBWriter::writeDbtypeFile(par.db3.c_str(), reader.getDbtype(), isCompressed);
     DBReader<unsigned int>::softlinkDb(par.db2, par.db3, DBFiles::SEQUENCE_ANCILLARY);
 
     free(line);
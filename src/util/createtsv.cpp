@@ -5,6 +5,7 @@
 #include "Util.h"
 #include "IndexReader.h"
 #include "FileUtil.h"
+#include "Matcher.h"
 
 #ifdef OPENMP
 #include <omp.h>
@@ -58,6 +59,7 @@ int createtsv(int argc, const char **argv, const Command &command) {
         reader = new DBReader<unsigned int>(par.db2.c_str(), par.db2Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     }
     reader->open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    const bool isBinary = reader->isBinaryResult();
 
     const std::string& dataFile = hasTargetDB ? par.db4 : par.db3;
     const std::string& indexFile = hasTargetDB ? par.db4Index : par.db3Index;
@@ -80,6 +82,11 @@ int createtsv(int argc, const char **argv, const Command &command) {
         std::string outputBuffer;
         outputBuffer.reserve(10 * 1024);
 
+        std::string binaryAsText;
+        if (isBinary) {
+            binaryAsText.reserve(10 * 1024);
+        }
+
 #pragma omp for schedule(dynamic, 1000)
         for (size_t i = 0; i < reader->getSize(); ++i) {
             unsigned int queryKey = reader->getDbKey(i);
@@ -103,6 +110,11 @@ int createtsv(int argc, const char **argv, const Command &command) {
             size_t entryIndex = 0;
 
             char *data = reader->getData(i, thread_idx);
+            if (isBinary) {
+                binaryAsText.clear();
+                Matcher::binaryEntryToBuffer(binaryAsText, data, reader->getEntryLen(i), reader->getDbtype());
+                data = (char *) binaryAsText.c_str();
+            }
             while (*data != '\0') {
                 if(targetColumn != SIZE_T_MAX){
                     size_t foundElements = Util::getWordsOfLine(data, columnPointer, 255);
@@ -16,6 +16,7 @@
 #include "FastSort.h"
 #include "IntervalArray.h"
 #include "IndexReader.h"
+#include "ResultView.h"
 
 #include <stack>
 #include <map>
@@ -243,10 +244,9 @@ int expandaln(int argc, const char **argv, const Command& command, bool returnAl
                 SubstitutionMatrix::calcLocalAaBiasCorrection(&subMat, aSeq.numSequence, aSeq.L, compositionBias, par.compBiasCorrectionScale);
             }
 
-            char *data = resultAbReader->getData(i, thread_idx);
-            while (*data != '\0') {
-                Matcher::result_t resultAb = Matcher::parseAlignmentRecord(data, false);
-                data = Util::skipLine(data);
+            ResultView<Matcher::result_t> resultsAb = ResultView<Matcher::result_t>::fromReader(*resultAbReader, i, thread_idx);
+            for (ResultView<Matcher::result_t>::iterator abIt = resultsAb.begin(); abIt != resultsAb.end(); ++abIt) {
+                const Matcher::result_t &resultAb = *abIt;
                 if(returnAlnRes == false && resultAb.eval > par.evalProfile){
                     continue;
                 }
@@ -260,9 +260,14 @@ int expandaln(int argc, const char **argv, const Command& command, bool returnAl
 //                if (isCa3m) {
 //                    unsigned int key;
 //                    CompressedA3M::extractMatcherResults(key, resultsBc, resultBcReader.getData(bResId, thread_idx), resultBcReader.getEntryLen(bResId), *cReader, false);
-                Matcher::readAlignmentResults(resultsBc, resultBcReader->getData(bResId, thread_idx), false);
-
+                ResultView<Matcher::result_t> bcView = ResultView<Matcher::result_t>::fromReader(*resultBcReader, bResId, thread_idx);
+                // only filtering needs all B->C results at once, otherwise they are translated while decoding
+                ResultView<Matcher::result_t>::iterator bcIt = bcView.end();
                 if (filterBc) {
+                    for (ResultView<Matcher::result_t>::iterator it = bcView.begin(); it != bcView.end(); ++it) {
+                        resultsBc.emplace_back();
+                        it.decode(resultsBc.back());
+                    }
                     for (size_t k = 0; k < resultsBc.size(); ++k) {
                         Matcher::result_t &resultBc = resultsBc[k];
                         if (resultBc.backtrace.size() == 0) {
@@ -287,11 +292,13 @@ int expandaln(int argc, const char **argv, const Command& command, bool returnAl
                     resultsBc.insert(resultsBc.begin(), query);
                     MultipleAlignment::deleteMSA(&res);
                     subSeqSet.clear();
+                } else {
+                    bcIt = bcView.begin();
                 }
                 //std::stable_sort(resultsBc.begin(), resultsBc.end(), compareHitsByKeyScore);
 
-                for (size_t k = 0; k < resultsBc.size(); ++k) {
-                    Matcher::result_t &resultBc = resultsBc[k];
+                for (size_t k = 0; filterBc ? (k < resultsBc.size()) : (bcIt != bcView.end()); ++k, ++bcIt) {
+                    const Matcher::result_t &resultBc = filterBc ? resultsBc[k] : *bcIt;
                     if (resultBc.backtrace.size() == 0) {
                         Debug(Debug::ERROR) << "Alignment must contain a backtrace\n";
                         EXIT(EXIT_FAILURE);
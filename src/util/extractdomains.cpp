@@ -319,6 +319,7 @@ int doExtract(Parameters &par, DBReader<unsigned int> &blastTabReader,
 int doExtract(Parameters &par, const unsigned int mpiRank, const unsigned int mpiNumProc) {
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    reader.requireTextResult("extractdomains");
 
     size_t dbFrom = 0;
     size_t dbSize = 0;
@@ -350,6 +351,7 @@ int doExtract(Parameters &par) {
 
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    reader.requireTextResult("extractdomains");
     resultSize = reader.getSize();
 
     int status = doExtract(par, reader, std::make_pair(par.db3, par.db3Index), 0, resultSize);
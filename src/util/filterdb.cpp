@@ -6,6 +6,8 @@
 #include "FileUtil.h"
 #include "ExpressionParser.h"
 #include "FastSort.h"
+#include "Matcher.h"
+#include "ResultView.h"
 #include <fstream>
 #include <random>
 #include <iostream>
@@ -97,7 +99,14 @@ int filterdb(int argc, const char **argv, const Command &command) {
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
 
-    DBWriter writer(par.db2.c_str(), par.db2Index.c_str(), par.threads, par.compressed, reader.getDbtype());
+    // columns of binary results are filtered in their text representation
+    const bool isBinary = reader.isBinaryResult();
+    int outDbtype = reader.getDbtype();
+    if (isBinary) {
+        outDbtype &= ~(Parameters::DBTYPE_EXTENDED_BINARY_RESULT << 16);
+    }
+
+    DBWriter writer(par.db2.c_str(), par.db2Index.c_str(), par.threads, par.compressed, outDbtype);
     writer.open();
 
     // FILE_FILTERING
@@ -238,7 +247,7 @@ int filterdb(int argc, const char **argv, const Command &command) {
 
         std::vector<std::pair<double, std::string>> toSort;
 
-        char dbKeyBuffer[255 + 1];
+        std::string binaryAsText;
 
         // EXPRESSION_FILTERING
         ExpressionParser* parser = NULL;
@@ -257,23 +266,28 @@ int filterdb(int argc, const char **argv, const Command &command) {
         for (size_t id = 0; id < reader.getSize(); ++id) {
             progress.updateProgress();
 
-            char *data = reader.getData(id, thread_idx);
+            const char *data = reader.getData(id, thread_idx);
             unsigned int queryKey = reader.getDbKey(id);
-            size_t dataLength = reader.getEntryLen(id);
+            // the index of compressed databases stores the compressed length
+            size_t dataLength = reader.isCompressed() ? strlen(data) + 1 : reader.getEntryLen(id);
+            if (isBinary) {
+                binaryAsText.clear();
+                Matcher::binaryEntryToBuffer(binaryAsText, data, dataLength, reader.getDbtype());
+                data = binaryAsText.c_str();
+                dataLength = binaryAsText.size() + 1;
+            }
             int counter = 0;
 
             bool addSelfMatch = false;
 
-            while (*data != '\0') {
+            ResultView<unsigned int> lines(data, dataLength, outDbtype);
+            for (ResultView<unsigned int>::iterator it = lines.begin(); it != lines.end(); ++it) {
                 if (shouldAddSelfMatch) {
-                    Util::parseKey(data, dbKeyBuffer);
-                    const unsigned int curKey = (unsigned int) strtoul(dbKeyBuffer, NULL, 10);
-                    addSelfMatch = (queryKey == curKey);
+                    addSelfMatch = (queryKey == *it);
                 }
 
-                if (!Util::getLine(data, dataLength, lineBuffer, LINE_BUFFER_SIZE)) {
+                if (!Util::getLine(it.line(), dataLength, lineBuffer, LINE_BUFFER_SIZE)) {
                     Debug(Debug::WARNING) << "Identifier was too long and was cut off!\n";
-                    data = Util::skipLine(data);
                     continue;
                 }
 
@@ -475,7 +489,6 @@ int filterdb(int argc, const char **argv, const Command &command) {
                         buffer.append(1, '\n');
                     }
                 }
-                data = Util::skipLine(data);
             }
 
             if (mode == SORT_ENTRIES) {
@@ -26,6 +26,8 @@ int mergedbs(int argc, const char **argv, const Command& command) {
         std::string indexName = par.filenames[i + 2] + ".index";
         filesToMerge[i] = new DBReader<unsigned int>(par.filenames[i + 2].c_str(), indexName.c_str(), 1, DBReader<unsigned int>::USE_DATA | DBReader<unsigned int>::USE_INDEX);
         filesToMerge[i]->open(DBReader<unsigned int>::NOSORT);
+        // binary entries start with their record count and cannot be concatenated
+        filesToMerge[i]->requireTextResult("mergedbs");
     }
 
     DBWriter writer(par.db2.c_str(), par.db2Index.c_str(), 1, par.compressed, filesToMerge[0]->getDbtype());
@@ -259,6 +259,7 @@ int offsetalignment(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> alnDbr(par.db5.c_str(), par.db5Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     alnDbr.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    alnDbr.requireTextResult("offsetalignment");
 
     size_t localThreads = 1;
 #ifdef OPENMP
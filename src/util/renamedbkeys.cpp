@@ -21,7 +21,7 @@ void copyEntry(unsigned int oldKey, unsigned int newKey, DBReader<unsigned int>&
     if (subDbMode == Parameters::SUBDB_MODE_SOFT) {
         writer.writeIndexEntry(newKey, reader.getOffset(id), reader.getEntryLen(id), 0);
     } else {
-        char *data = reader.getDataUncompressed(id);
+        char *data = reader.isBlockCompressed() ? reader.getData(id, 0) : reader.getDataUncompressed(id);
         size_t originalLength = reader.getEntryLen(id);
         size_t entryLength = std::max(originalLength, static_cast<size_t>(1)) - 1;
 
@@ -57,7 +57,9 @@ int renamedbkeys(int argc, const char **argv, const Command &command) {
     }
     DBReader<unsigned int> reader(par.db2.c_str(), par.db2Index.c_str(), 1, mode);
     reader.open(DBReader<unsigned int>::NOSORT);
-    const bool isCompressed = reader.isCompressed();
+    // entries of block compressed databases are copied decompressed, soft links keep the blocks
+    const bool isSoft = par.subDbMode == Parameters::SUBDB_MODE_SOFT;
+    const bool isCompressed = reader.isCompressed() && reader.isBlockCompressed() == false;
 
     FILE* newMappingFile = NULL;
     std::vector<std::pair<unsigned int, unsigned int>> mapping;
@@ -77,7 +79,7 @@ int renamedbkeys(int argc, const char **argv, const Command &command) {
     if (FileUtil::fileExists(par.hdr2dbtype.c_str())) {
         headerReader = new DBReader<unsigned int>(par.hdr2.c_str(), par.hdr2Index.c_str(), 1, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
         headerReader->open(DBReader<unsigned int>::NOSORT);
-        isHeaderCompressed = headerReader->isCompressed();
+        isHeaderCompressed = headerReader->isCompressed() && headerReader->isBlockCompressed() == false;
     }
 
     DBWriter writer(par.db3.c_str(), par.db3Index.c_str(), 1, 0, Parameters::DBTYPE_OMIT_FILE);
@@ -134,9 +136,11 @@ int renamedbkeys(int argc, const char **argv, const Command &command) {
     }
     // merge any kind of sequence database
     writer.close(headerWriter != NULL);
-    DBWriter::writeDbtypeFile(par.db3.c_str(), reader.getDbtype(), isCompressed);
+    DBWriter::writeDbtypeFile(par.db3.c_str(), reader.getDbtype(), isSoft ? reader.isCompressed() : isCompressed, isSoft && reader.isBlockCompressed());
     if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
         DBReader<unsigned int>::softlinkDb(par.db2, par.db3, DBFiles::DATA);
+    } else if (isCompressed) {
+        DBReader<unsigned int>::copyDictionary(par.db2, par.db3);
     }
     if (newMappingFile != NULL) {
         SORT_PARALLEL(newMapping.begin(), newMapping.end(), compareToFirst);
@@ -167,9 +171,12 @@ int renamedbkeys(int argc, const char **argv, const Command &command) {
     if (headerWriter != NULL) {
         headerWriter->close(true);
         delete headerWriter;
-        DBWriter::writeDbtypeFile(par.hdr3.c_str(), headerReader->getDbtype(), isHeaderCompressed);
+        DBWriter::writeDbtypeFile(par.hdr3.c_str(), headerReader->getDbtype(), isSoft ? headerReader->isCompressed() : isHeaderCompressed,
+                                  isSoft && headerReader->isBlockCompressed());
         if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
             DBReader<unsigned int>::softlinkDb(par.db2, par.db3, DBFiles::HEADER);
+        } else if (isHeaderCompressed) {
+            DBReader<unsigned int>::copyDictionary(par.hdr2, par.hdr3);
         }
     }
     if (par.subDbMode == Parameters::SUBDB_MODE_SOFT) {
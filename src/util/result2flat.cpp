@@ -20,6 +20,7 @@ int result2flat(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> dbr_data(par.db3.c_str(), par.db3Index.c_str(),  1, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     dbr_data.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    dbr_data.requireTextResult("result2flat");
 
     FILE *fastaFP = fopen(par.db4.c_str(), "w");
 
@@ -8,6 +8,7 @@
 #include "DBConcat.h"
 #include "HeaderSummarizer.h"
 #include "CompressedA3M.h"
+#include "ResultView.h"
 
 #ifdef OPENMP
 #include <omp.h>
@@ -180,7 +181,6 @@ int result2msa(int argc, const char **argv, const Command &command) {
             kept[i] = 1;
         }
 
-        char dbKey[255];
         const char *entry[255];
         std::string accession;
 
@@ -234,13 +234,11 @@ int result2msa(int argc, const char **argv, const Command &command) {
 
 
             bool isQueryInit = false;
-            char *data = resultReader.getData(id, thread_idx);
-            while (*data != '\0') {
-                Util::parseKey(data, dbKey);
-                const unsigned int key = (unsigned int) strtoul(dbKey, NULL, 10);
+            ResultView<unsigned int> targets = ResultView<unsigned int>::fromReader(resultReader, id, thread_idx);
+            for (ResultView<unsigned int>::iterator it = targets.begin(); it != targets.end(); ++it) {
+                const unsigned int key = *it;
                 // in the same database case, we have the query repeated
                 if (key == queryKey && sameDatabase == true) {
-                    data = Util::skipLine(data);
                     continue;
                 }
 
@@ -253,10 +251,22 @@ int result2msa(int argc, const char **argv, const Command &command) {
                 seqSet.emplace_back(std::vector<unsigned char>(edgeSequence.numSequence, edgeSequence.numSequence + edgeSequence.L));
                 seqKeys.emplace_back(key);
 
-                const size_t columns = Util::getWordsOfLine(data, entry, 255);
-                if (columns > Matcher::ALN_RES_WITHOUT_BT_COL_CNT) {
-                    alnResults.emplace_back(Matcher::parseAlignmentRecord(data));
+                bool hasBacktrace;
+                if (targets.isBinary()) {
+                    alnResults.emplace_back();
+                    it.decodeAs(alnResults.back());
+                    hasBacktrace = alnResults.back().backtrace.empty() == false;
+                    if (hasBacktrace == false) {
+                        alnResults.pop_back();
+                    }
                 } else {
+                    hasBacktrace = Util::getWordsOfLine(it.line(), entry, 255) > Matcher::ALN_RES_WITHOUT_BT_COL_CNT;
+                    if (hasBacktrace) {
+                        alnResults.emplace_back();
+                        it.decodeAs(alnResults.back());
+                    }
+                }
+                if (hasBacktrace == false) {
                     // Recompute if not all the backtraces are present
                     if (isQueryInit == false) {
                         matcher.initQuery(&centerSequence);
@@ -264,7 +274,6 @@ int result2msa(int argc, const char **argv, const Command &command) {
                     }
                     alnResults.emplace_back(matcher.getSWResult(&edgeSequence, INT_MAX, false, 0, 0.0, FLT_MAX, Matcher::SCORE_COV_SEQID, 0, false));
                 }
-                data = Util::skipLine(data);
             }
 
             MultipleAlignment::MSAResult res = aligner.computeMSA(&centerSequence, seqSet, alnResults, !par.allowDeletion);
@@ -43,6 +43,7 @@ int result2profile(int argc, const char **argv, const Command &command, bool ret
 
     DBReader<unsigned int> resultReader(par.db3.c_str(), par.db3Index.c_str(), par.threads, DBReader<unsigned int>::USE_DATA | DBReader<unsigned int>::USE_INDEX);
     resultReader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    resultReader.requireTextResult("result2profile");
     size_t dbFrom = 0;
     size_t dbSize = 0;
 #ifdef HAVE_MPI
@@ -112,7 +113,7 @@ int result2profile(int argc, const char **argv, const Command &command, bool ret
     } else if (par.pcmode == Parameters::PCMODE_CONTEXT_SPECIFIC) {
         type = DBReader<unsigned int>::setExtendedDbtype(type, Parameters::DBTYPE_EXTENDED_CONTEXT_PSEUDO_COUNTS);
     }
-    DBWriter resultWriter(tmpOutput.first.c_str(), tmpOutput.second.c_str(), localThreads, par.compressed, type);
+    DBWriter resultWriter(tmpOutput.first.c_str(), tmpOutput.second.c_str(), localThreads, par.compressed | (par.asyncWrite ? Parameters::WRITER_ASYNC_MODE : 0), type);
     resultWriter.open();
 
     // + 1 for query
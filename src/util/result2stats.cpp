@@ -55,6 +55,7 @@ StatsComputer::StatsComputer(const Parameters &par)
           targetDb(par.db2), targetDbIndex(par.db2Index), tsvOut(par.tsvOut) {
     resultReader = new DBReader<unsigned int>(par.db3.c_str(), par.db3Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     resultReader->open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    resultReader->requireTextResult("result2stats");
     this->threads = par.threads;
 
     const bool shouldCompress = tsvOut == false && par.compressed == true;
@@ -21,9 +21,11 @@ int subtractdbs(int argc, const char **argv, const Command& command) {
     Debug(Debug::INFO) << "Remove " << par.db2 << " ids from " << par.db1 << "\n";
     DBReader<unsigned int> leftDbr(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
     leftDbr.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    leftDbr.requireTextResult("subtractdbs");
 
     DBReader<unsigned int> rightDbr(par.db2.c_str(), par.db2Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX | DBReader<unsigned int>::USE_DATA);
     rightDbr.open(DBReader<unsigned int>::NOSORT);
+    rightDbr.requireTextResult("subtractdbs");
 
     DBWriter writer(par.db3.c_str(), par.db3Index.c_str(), par.threads, par.compressed, leftDbr.getDbtype());
     writer.open();
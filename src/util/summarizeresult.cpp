@@ -16,6 +16,7 @@ int summarizeresult(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    reader.requireTextResult("summarizeresult");
 
 #ifdef HAVE_MPI
     size_t dbFrom = 0;
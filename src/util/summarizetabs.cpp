@@ -182,6 +182,7 @@ int doAnnotate(Parameters &par, DBReader<unsigned int> &blastTabReader,
 int doAnnotate(Parameters &par, const unsigned int mpiRank, const unsigned int mpiNumProc) {
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    reader.requireTextResult("summarizetabs");
 
     size_t dbFrom = 0;
     size_t dbSize = 0;
@@ -210,6 +211,7 @@ int doAnnotate(Parameters &par, const unsigned int mpiRank, const unsigned int m
 int doAnnotate(Parameters &par) {
     DBReader<unsigned int> reader(par.db1.c_str(), par.db1Index.c_str(), par.threads, DBReader<unsigned int>::USE_INDEX|DBReader<unsigned int>::USE_DATA);
     reader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    reader.requireTextResult("summarizetabs");
     size_t resultSize = reader.getSize();
     int status = doAnnotate(par, reader, std::make_pair(par.db3, par.db3Index), 0, resultSize, false);
     reader.close();
@@ -10,6 +10,7 @@
 #include "PrefilteringIndexReader.h"
 #include "IndexReader.h"
 #include "FastSort.h"
+#include "ResultView.h"
 
 #ifdef OPENMP
 #include <omp.h>
@@ -39,6 +40,11 @@ int doswap(Parameters& par, bool isGeneralMode) {
     std::string parOutDbStr(parOutDb);
     std::string parOutDbIndexStr(parOutDbIndex);
 
+    if (DBReader<unsigned int>::isBinaryResult(FileUtil::parseDbType(parResultDb))) {
+        Debug(Debug::ERROR) << "Binary result databases are not supported by swapresults.\n";
+        EXIT(EXIT_FAILURE);
+    }
+
     BaseMatrix *subMat = NULL;
     EvalueComputation *evaluer = NULL;
     size_t aaResSize = 0;
@@ -56,16 +62,12 @@ int doswap(Parameters& par, bool isGeneralMode) {
 #ifdef OPENMP
             thread_idx = omp_get_thread_num();
 #endif
-            char key[255];
 #pragma omp for schedule(dynamic, 100) reduction(max:maxTargetId)
             for (size_t i = 0; i < resultReader.getSize(); ++i) {
                 progress.updateProgress();
-                char *data = resultReader.getData(i, thread_idx);
-                while (*data != '\0') {
-                    Util::parseKey(data, key);
-                    unsigned int dbKey = std::strtoul(key, NULL, 10);
-                    maxTargetId = std::max(maxTargetId, dbKey);
-                    data = Util::skipLine(data);
+                ResultView<unsigned int> targets = ResultView<unsigned int>::fromReader(resultReader, i, thread_idx);
+                for (ResultView<unsigned int>::iterator it = targets.begin(); it != targets.end(); ++it) {
+                    maxTargetId = std::max(maxTargetId, *it);
                 }
             }
         };
@@ -123,18 +125,14 @@ int doswap(Parameters& par, bool isGeneralMode) {
                 char *tmpBuff = Itoa::u32toa_sse2((uint32_t) resultId, queryKeyStr);
                 *(tmpBuff) = '\0';
                 size_t queryKeyLen = strlen(queryKeyStr);
-                char *data = resultDbr.getData(i, thread_idx);
-                char dbKeyBuffer[255 + 1];
-                while (*data != '\0') {
-                    Util::parseKey(data, dbKeyBuffer);
-                    size_t targetKeyLen = strlen(dbKeyBuffer);
-                    const unsigned int dbKey = (unsigned int) strtoul(dbKeyBuffer, NULL, 10);
-                    char *nextLine = Util::skipLine(data);
-                    size_t lineLen = nextLine - data;
+                ResultView<unsigned int> targets = ResultView<unsigned int>::fromReader(resultDbr, i, thread_idx);
+                for (ResultView<unsigned int>::iterator it = targets.begin(); it != targets.end(); ++it) {
+                    size_t targetKeyLen = Util::skipNoneWhitespace(it.line());
+                    const unsigned int dbKey = *it;
+                    size_t lineLen = it.lineLength();
                     lineLen -= targetKeyLen;
                     lineLen += queryKeyLen;
                     __sync_fetch_and_add(&(targetElementSize[dbKey]), lineLen);
-                    data = nextLine;
                 }
             }
         }
@@ -181,29 +179,26 @@ int doswap(Parameters& par, bool isGeneralMode) {
 #pragma omp for schedule(dynamic, 10)
             for (size_t i = 0; i < resultSize; ++i) {
                 progress.updateProgress();
-                char *data = resultDbr.getData(i, thread_idx);
                 unsigned int queryKey = resultDbr.getDbKey(i);
                 char queryKeyStr[1024];
                 char *tmpBuff = Itoa::u32toa_sse2((uint32_t) queryKey, queryKeyStr);
                 *(tmpBuff) = '\0';
                 size_t queryKeyLen = strlen(queryKeyStr);
-                char dbKeyBuffer[255 + 1];
-                while (*data != '\0') {
-                    Util::parseKey(data, dbKeyBuffer);
-                    size_t targetKeyLen = strlen(dbKeyBuffer);
-                    char *nextLine = Util::skipLine(data);
-                    size_t oldLineLen = nextLine - data;
+                ResultView<unsigned int> targets = ResultView<unsigned int>::fromReader(resultDbr, i, thread_idx);
+                for (ResultView<unsigned int>::iterator it = targets.begin(); it != targets.end(); ++it) {
+                    const char *data = it.line();
+                    size_t targetKeyLen = Util::skipNoneWhitespace(data);
+                    size_t oldLineLen = it.lineLength();
                     size_t newLineLen = oldLineLen;
                     newLineLen -= targetKeyLen;
                     newLineLen += queryKeyLen;
-                    const unsigned int dbKey = (unsigned int) strtoul(dbKeyBuffer, NULL, 10);
+                    const unsigned int dbKey = *it;
                     // update offset but do not copy memory
                     size_t offset = __sync_fetch_and_add(&(targetElementSize[dbKey]), newLineLen) - prevBytesToWrite;
                     if(dbKey >= prevDbKeyToWrite && dbKey <=  dbKeyToWrite){
                         memcpy(&tmpData[offset], queryKeyStr, queryKeyLen);
                         memcpy(&tmpData[offset + queryKeyLen], data + targetKeyLen, oldLineLen - targetKeyLen);
                     }
-                    data = nextLine;
                 }
             }
         }
@@ -245,8 +240,10 @@ int doswap(Parameters& par, bool isGeneralMode) {
             // we are reusing this vector also for the prefiltering results
             // qcov is used for pScore because its the first float value
             // and alnLength for diagonal because its the first int value after
+            // elements are never removed, so their backtrace capacity is reused between entries
             std::vector<Matcher::result_t> curRes;
             curRes.reserve(300);
+            size_t resCount = 0;
 
             char buffer[1024 + 32768*4];
             std::string ss;
@@ -267,32 +264,40 @@ int doswap(Parameters& par, bool isGeneralMode) {
                 }
 
                 bool evalBreak = false;
-                while (dataSize > 0) {
-                    if (isAlignmentResult) {
-                        Matcher::result_t res = Matcher::parseAlignmentRecord(data, true);
+                if (isAlignmentResult) {
+                    ResultView<Matcher::result_t> alignments(data, dataSize, resultDbr.getDbtype(), true);
+                    for (ResultView<Matcher::result_t>::iterator it = alignments.begin(); it != alignments.end(); ++it) {
+                        if (resCount == curRes.size()) {
+                            curRes.emplace_back();
+                        }
+                        Matcher::result_t &res = curRes[resCount];
+                        it.decode(res);
                         Matcher::result_t::swapResult(res, *evaluer, hasBacktrace);
                         if (res.eval > par.evalThr) {
                             evalBreak = true;
                         } else {
-                            curRes.emplace_back(res);
-			}
-                    } else {
-                        hit_t hit = QueryMatcher::parsePrefilterHit(data);
+                            resCount++;
+                        }
+                    }
+                } else {
+                    ResultView<hit_t> hits(data, dataSize, resultDbr.getDbtype());
+                    for (ResultView<hit_t>::iterator it = hits.begin(); it != hits.end(); ++it) {
+                        hit_t hit = *it;
                         hit.diagonal = static_cast<unsigned short>(static_cast<short>(hit.diagonal) * -1);
-                        curRes.emplace_back(hit.seqId, hit.prefScore, 0, 0, 0, -static_cast<float>(hit.prefScore), hit.diagonal, 0, 0, 0, 0, 0, 0, "");
+                        if (resCount == curRes.size()) {
+                            curRes.emplace_back();
+                        }
+                        curRes[resCount] = Matcher::result_t(hit.seqId, hit.prefScore, 0, 0, 0, -static_cast<float>(hit.prefScore), hit.diagonal, 0, 0, 0, 0, 0, 0, "");
+                        resCount++;
                     }
-                    char *nextLine = Util::skipLine(data);
-                    size_t lineLen = nextLine - data;
-                    dataSize -= lineLen;
-                    data = nextLine;
                 }
 
-                if (curRes.empty() == false) {
-                    if (curRes.size() > 1) {
-                        SORT_SERIAL(curRes.begin(), curRes.end(), Matcher::compareHits);
+                if (resCount > 0) {
+                    if (resCount > 1) {
+                        SORT_SERIAL(curRes.begin(), curRes.begin() + resCount, Matcher::compareHits);
                     }
 
-                    for (size_t j = 0; j < curRes.size(); j++) {
+                    for (size_t j = 0; j < resCount; j++) {
                         const Matcher::result_t &res = curRes[j];
                         if (isAlignmentResult) {
                             size_t len = Matcher::resultToBuffer(buffer, res, hasBacktrace, false);
@@ -310,7 +315,7 @@ int doswap(Parameters& par, bool isGeneralMode) {
                     resultWriter.writeData(ss.c_str(), ss.size(), i, thread_idx);
                     ss.clear();
 
-                    curRes.clear();
+                    resCount = 0;
                 } else if (evalBreak == true || targetElementExists[i] == 1) {
                     resultWriter.writeData(&empty, 0, i, thread_idx);
                 }
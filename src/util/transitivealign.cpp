@@ -38,6 +38,7 @@ int transitivealign(int argc, const char **argv, const Command &command) {
 
     DBReader<unsigned int> alnReader(par.db2.c_str(), par.db2Index.c_str(), par.threads, DBReader<unsigned int>::USE_DATA|DBReader<unsigned int>::USE_INDEX);
     alnReader.open(DBReader<unsigned int>::LINEAR_ACCCESS);
+    alnReader.requireTextResult("transitivealign");
 
     SubstitutionMatrix::FastMatrix fastMatrix = SubstitutionMatrix::createAsciiSubMat(*subMat);
 
@@ -233,9 +233,13 @@ int clusteringworkflow(int argc, const char **argv, const Command& command) {
         int swapedCovMode = Util::swapCoverageMode(par.covMode);
         int tmpCovMode = par.covMode;
         par.covMode = swapedCovMode;
+        // the reassignment results go through subtractdbs, swapdb and mergedbs, which only read text results
+        bool tmpBinaryResult = par.binaryResult;
+        par.binaryResult = false;
         cmd.addVariable("PREFILTER_REASSIGN_PAR", par.createParameterString(par.prefilter).c_str());
         par.covMode = tmpCovMode;
         cmd.addVariable("ALIGNMENT_REASSIGN_PAR", par.createParameterString(par.align).c_str());
+        par.binaryResult = tmpBinaryResult;
         cmd.addVariable("MERGEDBS_PAR", par.createParameterString(par.mergedbs).c_str());
 
         std::string program = tmpDir + "/cascaded_clustering.sh";
@@ -269,6 +269,23 @@ int search(int argc, const char **argv, const Command& command) {
         EXIT(EXIT_FAILURE);
     }
 
+    // binary results are only understood by prefilter, align and the convert modules
+    const bool isPlainSearch = (searchMode & (Parameters::SEARCH_MODE_FLAG_QUERY_TRANSLATED | Parameters::SEARCH_MODE_FLAG_TARGET_TRANSLATED
+                                              | Parameters::SEARCH_MODE_FLAG_QUERY_NUCLEOTIDE | Parameters::SEARCH_MODE_FLAG_TARGET_NUCLEOTIDE)) == 0;
+    if (par.binaryResult && (par.numIterations > 1 || par.sensSteps > 1 || par.lcaSearch || isUngappedMode || isPlainSearch == false)) {
+        par.printUsageMessage(command, MMseqsParameter::COMMAND_ALIGN | MMseqsParameter::COMMAND_PREFILTER);
+        Debug(Debug::ERROR) << "--binary-result is only supported for single step amino acid searches\n";
+        EXIT(EXIT_FAILURE);
+    }
+
+    // prefilteralign replaces the prefilter and align calls of the single step search
+    if (par.streamSearch && (par.numIterations > 1 || par.sensSteps > 1 || par.lcaSearch || isUngappedMode || isPlainSearch == false
+                             || par.exhaustiveSearch || (searchMode & Parameters::SEARCH_MODE_FLAG_TARGET_PROFILE))) {
+        par.printUsageMessage(command, MMseqsParameter::COMMAND_ALIGN | MMseqsParameter::COMMAND_PREFILTER);
+        Debug(Debug::ERROR) << "--stream-search is only supported for single step amino acid searches against sequences\n";
+        EXIT(EXIT_FAILURE);
+    }
+
     // validate and set parameters for iterative search
     if (par.numIterations > 1) {
         // commmented out to test iterativepp workflow
@@ -456,6 +473,16 @@ int search(int argc, const char **argv, const Command& command) {
 
         FileUtil::writeFile(tmpDir + "/blastpgp.sh", blastpgp_sh, blastpgp_sh_len);
         program = std::string(tmpDir + "/blastpgp.sh");
+    } else if (par.streamSearch) {
+        // the hits stay in memory, so nothing but the result is written
+        std::vector<std::string> args;
+        args.push_back("prefilteralign");
+        args.push_back(par.db1);
+        args.push_back(targetDB);
+        args.push_back(par.db3);
+        std::vector<std::string> params = Util::split(par.createParameterString(par.prefilteralign), " ");
+        args.insert(args.end(), params.begin(), params.end());
+        cmd.execProgram(getenv("MMSEQS"), args);
     } else {
         if (par.sensSteps > 1) {
             if (par.startSens > par.sensitivity) {